@@ -16,6 +16,11 @@ $(1)_OBJECTS = $$(patsubst applications/%.cpp, $$(BUILD_DIRECTORY)/applications/
 TARGETS += $$($(1)_BINARY) $$($(1)_ASSETS)
 OBJECTS += $$($(1)_OBJECTS)
 
+$(BUILD_DIRECTORY_APPS)/$($(1)_NAME)/%.markup: applications/$($(1)_NAME)/%.markup toolbox/markup-compiler.py
+	$$(DIRECTORY_GUARD)
+	@echo [$(1)] [MARKUP] $$<
+	@markup-compiler.py $$< $$@
+
 $(BUILD_DIRECTORY_APPS)/$($(1)_NAME)/%: applications/$($(1)_NAME)/%
 	$$(DIRECTORY_GUARD)
 	cp $$< $$@
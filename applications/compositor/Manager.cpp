@@ -51,12 +51,12 @@ Window *manager_get_window_at(Vec2i position)
 void manager_register_window(Window *window)
 {
     manager_set_focus_window(window);
-    renderer_region_dirty(window->bound());
+    renderer_content_dirty(window->bound(), nullptr);
 }
 
 void manager_unregister_window(Window *window)
 {
-    renderer_region_dirty(window->bound());
+    renderer_content_dirty(window->bound(), nullptr);
     list_remove(_managed_windows, window);
 
     manager_set_focus_window((Window *)list_peek(_managed_windows));
@@ -6,9 +6,15 @@
 #include "compositor/Renderer.h"
 #include "compositor/Window.h"
 
+// Transparent windows are drawn over a blurred copy of what is behind them.
+#define BACKDROP_BLUR_RADIUS (48)
+
 static OwnPtr<Framebuffer> _framebuffer;
 static RefPtr<Bitmap> _wallpaper;
 
+// The wallpaper scaled to the resolution once, so compositing it is a copy.
+static RefPtr<Bitmap> _scaled_wallpaper;
+
 static Vector<Recti> _dirty_regions;
 
 void renderer_initialize()
@@ -16,7 +22,7 @@ void renderer_initialize()
     _framebuffer = Framebuffer::open().take_value();
     _wallpaper = Bitmap::load_from_or_placeholder("/Files/Wallpapers/mountains.png");
 
-    renderer_region_dirty(_framebuffer->resolution());
+    renderer_content_dirty(_framebuffer->resolution(), nullptr);
 }
 
 void renderer_region_dirty(Recti new_region)
@@ -59,10 +65,63 @@ void renderer_region_dirty(Recti new_region)
     }
 }
 
-void renderer_composite_wallpaper(Recti region)
+void renderer_content_dirty(Recti region, Window *window)
+{
+    bool in_front = window == nullptr;
+
+    manager_iterate_back_to_front([&](Window *other) {
+        if (other == window)
+        {
+            in_front = true;
+        }
+        else if (in_front &&
+                 (other->flags() & WINDOW_TRANSPARENT) &&
+                 other->bound().colide_with(region.expended({BACKDROP_BLUR_RADIUS})))
+        {
+            // The blur spreads the change around, repaint the whole window.
+            other->backdrop_dirty(true);
+            renderer_region_dirty(other->bound());
+        }
+
+        return Iteration::CONTINUE;
+    });
+
+    renderer_region_dirty(region);
+}
+
+static Bitmap &renderer_scaled_wallpaper()
 {
-    double scale_x = _wallpaper->width() / (double)_framebuffer->resolution().width();
-    double scale_y = _wallpaper->height() / (double)_framebuffer->resolution().height();
+    Vec2i resolution = _framebuffer->resolution().size();
+
+    if (_wallpaper->size() == resolution)
+    {
+        return *_wallpaper;
+    }
+
+    if (_scaled_wallpaper == nullptr)
+    {
+        auto scaled_or_result = Bitmap::create_shared(resolution.x(), resolution.y());
+
+        if (!scaled_or_result.success())
+        {
+            return *_wallpaper;
+        }
+
+        _scaled_wallpaper = scaled_or_result.take_value();
+
+        Painter painter(_scaled_wallpaper);
+        painter.blit_bitmap_no_alpha(*_wallpaper, _wallpaper->bound(), _scaled_wallpaper->bound());
+    }
+
+    return *_scaled_wallpaper;
+}
+
+static void renderer_composite_wallpaper(Painter &painter, Recti region)
+{
+    Bitmap &wallpaper = renderer_scaled_wallpaper();
+
+    double scale_x = wallpaper.width() / (double)_framebuffer->resolution().width();
+    double scale_y = wallpaper.height() / (double)_framebuffer->resolution().height();
 
     Recti source(
         region.x() * scale_x,
@@ -70,35 +129,60 @@ void renderer_composite_wallpaper(Recti region)
         region.width() * scale_x,
         region.height() * scale_y);
 
-    _framebuffer->painter().blit_bitmap_no_alpha(*_wallpaper, source, region);
+    painter.blit_bitmap_no_alpha(wallpaper, source, region);
+}
+
+void renderer_composite_wallpaper(Recti region)
+{
+    renderer_composite_wallpaper(_framebuffer->painter(), region);
     _framebuffer->mark_dirty(region);
 }
 
-void renderer_composite_region(Recti region, Window *window_transparent)
+// What is behind `window`, blurred. It is only composited and blurred
+// again when renderer_content_dirty() reported a change below the window.
+static Bitmap &renderer_backdrop(Window *window)
 {
-    renderer_composite_wallpaper(region);
+    Recti bound = window->bound();
 
-    manager_iterate_back_to_front([&](Window *window) {
-        if (window == window_transparent)
-        {
-            return Iteration::STOP;
-        }
+    if (!window->backdrop() || window->backdrop()->size() != bound.size())
+    {
+        window->backdrop(Bitmap::create_shared(bound.width(), bound.height()).take_value());
+        window->backdrop_dirty(true);
+    }
 
-        if (window->bound().colide_with(region))
-        {
-            Recti destination = window->bound().clipped_with(region);
+    if (window->backdrop_dirty())
+    {
+        Painter painter(window->backdrop());
+        painter.transform(-bound.position());
 
-            Recti source(
-                destination.position() - window->bound().position(),
-                destination.size());
+        renderer_composite_wallpaper(painter, bound);
 
-            _framebuffer->painter().blit_bitmap(window->frontbuffer(), source, destination);
-        }
+        manager_iterate_back_to_front([&](Window *behind) {
+            if (behind == window)
+            {
+                return Iteration::STOP;
+            }
 
-        return Iteration::CONTINUE;
-    });
+            if (behind->bound().colide_with(bound))
+            {
+                Recti destination = behind->bound().clipped_with(bound);
 
-    _framebuffer->mark_dirty(region);
+                Recti source(
+                    destination.position() - behind->bound().position(),
+                    destination.size());
+
+                painter.blit_bitmap(behind->frontbuffer(), source, destination);
+            }
+
+            return Iteration::CONTINUE;
+        });
+
+        painter.blur_rectangle(bound, BACKDROP_BLUR_RADIUS);
+
+        window->backdrop_dirty(false);
+    }
+
+    return *window->backdrop();
 }
 
 void renderer_region(Recti region)
@@ -121,8 +205,7 @@ void renderer_region(Recti region)
 
             if (window->flags() & WINDOW_TRANSPARENT)
             {
-                renderer_composite_region(destination, window);
-                //_framebuffer->painter().blur_rectangle(destination, 48);
+                _framebuffer->painter().blit_bitmap_no_alpha(renderer_backdrop(window), source, destination);
                 _framebuffer->painter().blit_bitmap(window->frontbuffer(), source, destination);
             }
             else
@@ -186,7 +269,8 @@ void renderer_repaint_dirty()
 bool renderer_set_resolution(int width, int height)
 {
     auto result = _framebuffer->set_resolution(Vec2i(width, height));
-    renderer_region_dirty(renderer_bound());
+    _scaled_wallpaper = nullptr;
+    renderer_content_dirty(renderer_bound(), nullptr);
     return result == SUCCESS;
 }
 
@@ -194,6 +278,7 @@ void renderer_set_wallaper(RefPtr<Bitmap> wallaper)
 {
     _wallpaper = wallaper;
     _wallpaper->filtering(BITMAP_FILTERING_LINEAR);
+    _scaled_wallpaper = nullptr;
 
-    renderer_region_dirty(renderer_bound());
+    renderer_content_dirty(renderer_bound(), nullptr);
 }
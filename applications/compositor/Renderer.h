@@ -7,8 +7,17 @@ void renderer_initialize();
 
 Recti renderer_bound();
 
+struct Window;
+
+// Repaint `region` on the next frame, for changes that can't be seen through
+// a transparent window, like the cursor moving.
 void renderer_region_dirty(Recti region);
 
+// The content of `window` changed in `region`, or the wallpaper or the
+// layout of the windows did when it is nullptr. The blurred backdrop of
+// the transparent windows in front of it is redone.
+void renderer_content_dirty(Recti region, Window *window);
+
 void renderer_repaint_dirty();
 
 bool renderer_set_resolution(int width, int height);
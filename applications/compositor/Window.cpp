@@ -51,20 +51,20 @@ Recti Window::cursor_capture_bound()
 
 void Window::move(Vec2i new_position)
 {
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 
     _bound = _bound.moved(new_position);
 
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 }
 
 void Window::resize(Recti new_bound)
 {
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 
     _bound = new_bound;
 
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 }
 
 void Window::send_event(Event event)
@@ -167,7 +167,7 @@ void Window::handle_double_click(Vec2i position)
 
 void Window::get_focus()
 {
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 
     Event event = {};
     event.type = Event::GOT_FOCUS;
@@ -176,7 +176,7 @@ void Window::get_focus()
 
 void Window::lost_focus()
 {
-    renderer_region_dirty(bound());
+    renderer_content_dirty(bound(), nullptr);
 
     Event event = {};
     event.type = Event::LOST_FOCUS;
@@ -215,5 +215,5 @@ void Window::flip_buffers(int frontbuffer_handle, Vec2i frontbuffer_size, int ba
         _backbuffer = new_backbuffer.take_value();
     }
 
-    renderer_region_dirty(region.offset(bound().position()));
+    renderer_content_dirty(region.offset(bound().position()), this);
 }
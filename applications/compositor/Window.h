@@ -23,6 +23,11 @@ private:
     RefPtr<Bitmap> _frontbuffer;
     RefPtr<Bitmap> _backbuffer;
 
+    // Blurred copy of what is behind a transparent window, kept until
+    // something changes underneath it.
+    RefPtr<Bitmap> _backdrop;
+    bool _backdrop_dirty = true;
+
 public:
     int id() { return _id; }
     WindowFlag flags() { return _flags; };
@@ -40,6 +45,14 @@ public:
         return *_frontbuffer;
     }
 
+    RefPtr<Bitmap> backdrop() { return _backdrop; }
+
+    void backdrop(RefPtr<Bitmap> backdrop) { _backdrop = backdrop; }
+
+    bool backdrop_dirty() { return _backdrop_dirty; }
+
+    void backdrop_dirty(bool dirty) { _backdrop_dirty = dirty; }
+
     Window(
         int id,
         WindowFlag flags,
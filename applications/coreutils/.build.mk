@@ -35,11 +35,11 @@ UTILS = \
 	YES \
 	PWD	\
 	PLAY \
-<<<<<<< HEAD
-	PIANO
-=======
-	MIXPLAY 
->>>>>>> 90485a20... mixer : works but ipc slower than ac97 consumption
+	PIANO \
+	MIXPLAY \
+	IOBENCH \
+	NETBENCH \
+	TCPBENCH
 
 __TESTEXEC_LIBS =
 __TESTEXEC_NAME = __testexec
@@ -155,6 +155,15 @@ PIANO_NAME = piano
 MIXPLAY_LIBS = 
 MIXPLAY_NAME = mixplay
 
+IOBENCH_LIBS =
+IOBENCH_NAME = iobench
+
+NETBENCH_LIBS =
+NETBENCH_NAME = netbench
+
+TCPBENCH_LIBS =
+TCPBENCH_NAME = tcpbench
+
 define UTIL_TEMPLATE =
 
 $(1)_BINARY  = $(BUILD_DIRECTORY_UTILS)/$($(1)_NAME)
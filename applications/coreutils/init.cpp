@@ -16,6 +16,11 @@ int main(int argc, char **argv)
 
     environment() = json::parse_file("/Configs/environment.json");
 
+    if (filesystem_exist(NETWORK_DEVICE_PATH, FILE_TYPE_DEVICE))
+    {
+        process_run("network", nullptr);
+    }
+
     if (filesystem_exist(FRAMEBUFFER_DEVICE_PATH, FILE_TYPE_DEVICE))
     {
         int splash_pid = -1;
@@ -0,0 +1,209 @@
+#include <abi/IOCall.h>
+
+#include <libsystem/cmdline/CMDLine.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/system/Random.h>
+#include <libsystem/system/System.h>
+
+#include <stdlib.h>
+
+static int sequential_block = 1024;
+static int sequential_total = 64;
+static int random_block = 4;
+static int random_count = 2048;
+static bool with_writes = false;
+
+static const char *usages[] = {
+    "[OPTION]... DEVICE",
+    nullptr,
+};
+
+static CommandLineOption options[] = {
+    COMMANDLINE_OPT_HELP,
+    COMMANDLINE_OPT_INT("block", 'b', sequential_block,
+                        "Size in KiB of each sequential transfer",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_INT("total", 't', sequential_total,
+                        "MiB transferred sequentially",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_INT("random-block", 'r', random_block,
+                        "Size in KiB of each random transfer",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_INT("count", 'n', random_count,
+                        "Number of random transfers",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_BOOL("write", 'w', with_writes,
+                         "Also write, THIS DESTROYS THE CONTENT OF THE DEVICE",
+                         COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_END};
+
+static CommandLine cmdline = CMDLINE(
+    usages,
+    options,
+    "Measure the sequential throughput and random transfers per second of a block device.",
+    "Options can be combined.");
+
+typedef size_t (*Transfer)(Stream *stream, void *buffer, size_t size);
+
+static size_t transfer_read(Stream *stream, void *buffer, size_t size)
+{
+    return stream_read(stream, buffer, size);
+}
+
+static size_t transfer_write(Stream *stream, void *buffer, size_t size)
+{
+    return stream_write(stream, buffer, size);
+}
+
+static void report(const char *name, size_t bytes, size_t count, uint elapsed)
+{
+    elapsed = MAX(elapsed, 1u);
+
+    printf("%-18s %6d KiB/s %8d IO/s (%d transfers in %d ms)\n",
+           name,
+           (int)((uint64_t)bytes * 1000 / 1024 / elapsed),
+           (int)((uint64_t)count * 1000 / elapsed),
+           (int)count,
+           (int)elapsed);
+}
+
+static Result sequential(Stream *stream, const char *name, Transfer transfer, uint8_t *buffer, size_t disk_size)
+{
+    size_t block = sequential_block * 1024;
+    size_t total = MIN((size_t)sequential_total * 1024 * 1024, disk_size / block * block);
+    size_t count = total / block;
+
+    stream_seek(stream, 0, WHENCE_START);
+
+    uint start = system_get_ticks();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (transfer(stream, buffer, block) != block)
+        {
+            return handle_get_error(stream);
+        }
+    }
+
+    // Writes only count once they reached the disk.
+    if (transfer == transfer_write && stream_call(stream, IOCALL_DISK_SYNC, nullptr) != SUCCESS)
+    {
+        return handle_get_error(stream);
+    }
+
+    report(name, total, count, system_get_ticks() - start);
+
+    return SUCCESS;
+}
+
+static Result random_access(Stream *stream, const char *name, Transfer transfer, uint8_t *buffer, size_t disk_size)
+{
+    size_t block = random_block * 1024;
+    size_t blocks = disk_size / block;
+
+    if (blocks == 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    Random random = random_create();
+
+    uint start = system_get_ticks();
+
+    for (int i = 0; i < random_count; i++)
+    {
+        stream_seek(stream, random_uint32_max(&random, blocks) * block, WHENCE_START);
+
+        if (transfer(stream, buffer, block) != block)
+        {
+            return handle_get_error(stream);
+        }
+    }
+
+    if (transfer == transfer_write && stream_call(stream, IOCALL_DISK_SYNC, nullptr) != SUCCESS)
+    {
+        return handle_get_error(stream);
+    }
+
+    report(name, block * random_count, random_count, system_get_ticks() - start);
+
+    return SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    argc = cmdline_parse(&cmdline, argc, argv);
+
+    if (argc < 2)
+    {
+        cmdline_callback_help(&cmdline, nullptr);
+        return PROCESS_FAILURE;
+    }
+
+    if (sequential_block <= 0 || sequential_total <= 0 || random_block <= 0 || random_count <= 0)
+    {
+        stream_format(err_stream, "%s: sizes and counts must be positive\n", argv[0]);
+        return PROCESS_FAILURE;
+    }
+
+    Stream *stream = stream_open(argv[1], with_writes ? OPEN_READ | OPEN_WRITE : OPEN_READ);
+
+    if (handle_has_error(stream))
+    {
+        handle_printf_error(stream, "%s: Couldn't open %s", argv[0], argv[1]);
+        return PROCESS_FAILURE;
+    }
+
+    stream_set_read_buffer_mode(stream, STREAM_BUFFERED_NONE);
+    stream_set_write_buffer_mode(stream, STREAM_BUFFERED_NONE);
+
+    IOCallDiskGeometryArgs geometry{};
+
+    if (stream_call(stream, IOCALL_DISK_GET_GEOMETRY, &geometry) != SUCCESS)
+    {
+        handle_printf_error(stream, "%s: %s is not a disk", argv[0], argv[1]);
+        stream_close(stream);
+        return PROCESS_FAILURE;
+    }
+
+    // Seeking is limited to what an int can hold.
+    size_t disk_size = MIN(geometry.sector_count * geometry.sector_size, (uint64_t)0x7fffffff);
+
+    printf("%s: %d MiB, %d bytes sectors\n", argv[1], (int)(geometry.sector_count * geometry.sector_size / 1024 / 1024), (int)geometry.sector_size);
+
+    uint8_t *buffer = (uint8_t *)malloc(MAX(sequential_block, random_block) * 1024);
+
+    for (int i = 0; i < MAX(sequential_block, random_block) * 1024; i++)
+    {
+        buffer[i] = i;
+    }
+
+    Result result = sequential(stream, "sequential read", transfer_read, buffer, disk_size);
+
+    if (result == SUCCESS)
+    {
+        result = random_access(stream, "random read", transfer_read, buffer, disk_size);
+    }
+
+    if (result == SUCCESS && with_writes)
+    {
+        result = sequential(stream, "sequential write", transfer_write, buffer, disk_size);
+    }
+
+    if (result == SUCCESS && with_writes)
+    {
+        result = random_access(stream, "random write", transfer_write, buffer, disk_size);
+    }
+
+    free(buffer);
+    stream_close(stream);
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: %s: %s\n", argv[0], argv[1], get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -37,19 +37,19 @@ int main(int argc, char const *argv[])
     if (args.argc() == 0)
     {
         StreamScanner scanner{in_stream};
-        auto root = markup::parse(scanner);
+        auto document = markup::parse(scanner);
 
         Prettifier pretty{options};
-        markup::prettify(pretty, root);
+        markup::prettify(pretty, document.root());
         printf("%s", pretty.finalize().cstring());
     }
     else
     {
         args.argv().foreach ([&](auto &path) {
-            auto root = markup::parse_file(path.cstring());
+            auto document = markup::parse_file(path.cstring());
 
             Prettifier pretty{options};
-            markup::prettify(pretty, root);
+            markup::prettify(pretty, document.root());
             printf("%s", pretty.finalize().cstring());
 
             return Iteration::CONTINUE;
@@ -0,0 +1,189 @@
+#include <abi/IOCall.h>
+
+#include <libsystem/cmdline/CMDLine.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/system/Memory.h>
+#include <libsystem/system/System.h>
+
+static int frame_count = 100000;
+static int frame_size = 64;
+static bool use_copies = false;
+
+static const char *usages[] = {
+    "[OPTION]... DEVICE",
+    nullptr,
+};
+
+static CommandLineOption options[] = {
+    COMMANDLINE_OPT_HELP,
+    COMMANDLINE_OPT_INT("count", 'n', frame_count,
+                        "Number of frames to send",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_INT("size", 's', frame_size,
+                        "Size in bytes of each frame",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_BOOL("copy", 'c', use_copies,
+                         "Send with write() instead of the shared packet rings",
+                         COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_END};
+
+static CommandLine cmdline = CMDLINE(
+    usages,
+    options,
+    "Measure how many frames per second a network device sends.",
+    "Frames are broadcast with the local experimental ethertype.");
+
+static void report(const char *name, int count, uint elapsed)
+{
+    elapsed = MAX(elapsed, 1u);
+
+    printf("%-10s %8d frames/s (%d frames in %d ms)\n",
+           name,
+           (int)((uint64_t)count * 1000 / elapsed),
+           count,
+           (int)elapsed);
+}
+
+static Result send_with_copies(Stream *stream, const uint8_t *frame)
+{
+    uint start = system_get_ticks();
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        if (stream_write(stream, frame, frame_size) != (size_t)frame_size)
+        {
+            return handle_get_error(stream);
+        }
+    }
+
+    report("sent", frame_count, system_get_ticks() - start);
+
+    return SUCCESS;
+}
+
+static Result send_with_rings(Stream *stream, const uint8_t *frame)
+{
+    IOCallNetworkRingsArgs args{};
+
+    if (stream_call(stream, IOCALL_NETWORK_GET_RINGS, &args) != SUCCESS)
+    {
+        return handle_get_error(stream);
+    }
+
+    uintptr_t address = 0;
+    size_t size = 0;
+
+    Result result = memory_include(args.memory_handle, &address, &size);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    auto rings = reinterpret_cast<NetworkRings *>(address);
+    auto buffers = reinterpret_cast<uint8_t *>(address + NETWORK_BUFFERS_OFFSET);
+
+    int sent = 0;
+    int received = 0;
+
+    uint start = system_get_ticks();
+
+    while (sent < frame_count)
+    {
+        while (!rings->received.empty())
+        {
+            NetworkPacket packet = rings->received.pop();
+            rings->refill.push({packet.buffer, 0});
+            received++;
+        }
+
+        while (sent < frame_count && !rings->completed.empty())
+        {
+            NetworkPacket packet = rings->completed.pop();
+
+            memcpy(buffers + packet.buffer * NETWORK_BUFFER_SIZE + NETWORK_BUFFER_HEADROOM, frame, frame_size);
+            rings->transmit.push({packet.buffer, (uint16_t)frame_size});
+
+            sent++;
+        }
+
+        // Once for the whole batch, this also gives back the sent buffers.
+        result = stream_call(stream, IOCALL_NETWORK_KICK, nullptr);
+
+        if (result != SUCCESS)
+        {
+            break;
+        }
+    }
+
+    uint elapsed = system_get_ticks() - start;
+
+    memory_free(address);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    report("sent", sent, elapsed);
+    report("received", received, elapsed);
+
+    return SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    argc = cmdline_parse(&cmdline, argc, argv);
+
+    if (argc < 2)
+    {
+        cmdline_callback_help(&cmdline, nullptr);
+        return PROCESS_FAILURE;
+    }
+
+    if (frame_count <= 0 || frame_size < 14 || frame_size > NETWORK_FRAME_SIZE)
+    {
+        stream_format(err_stream, "%s: frames must be between 14 and %d bytes\n", argv[0], NETWORK_FRAME_SIZE);
+        return PROCESS_FAILURE;
+    }
+
+    Stream *stream = stream_open(argv[1], OPEN_READ | OPEN_WRITE);
+
+    if (handle_has_error(stream))
+    {
+        handle_printf_error(stream, "%s: Couldn't open %s", argv[0], argv[1]);
+        return PROCESS_FAILURE;
+    }
+
+    stream_set_write_buffer_mode(stream, STREAM_BUFFERED_NONE);
+
+    IOCallNetworkSateAgs state{};
+
+    if (stream_call(stream, IOCALL_NETWORK_GET_STATE, &state) != SUCCESS)
+    {
+        handle_printf_error(stream, "%s: %s is not a network device", argv[0], argv[1]);
+        stream_close(stream);
+        return PROCESS_FAILURE;
+    }
+
+    uint8_t frame[NETWORK_FRAME_SIZE] = {};
+
+    memset(frame, 0xff, 6);
+    memcpy(frame + 6, state.mac_address.bytes, 6);
+    frame[12] = 0x88;
+    frame[13] = 0xb5;
+
+    Result result = use_copies ? send_with_copies(stream, frame) : send_with_rings(stream, frame);
+
+    stream_close(stream);
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: %s: %s\n", argv[0], argv[1], get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
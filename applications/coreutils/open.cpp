@@ -27,7 +27,7 @@ Result open(const char *raw_path)
         return ERR_NO_SUCH_FILE_OR_DIRECTORY;
     }
 
-    auto &file_type = file_extensions.get(extension);
+    auto &file_type = file_extensions.get(extension.view());
 
     if (!file_type.is(json::STRING))
     {
@@ -42,7 +42,7 @@ Result open(const char *raw_path)
         return ERR_NO_SUCH_FILE_OR_DIRECTORY;
     }
 
-    auto file_type_info = file_types.get(file_type.as_string());
+    auto file_type_info = file_types.get(file_type.as_string().view());
 
     if (!file_type_info.is(json::OBJECT))
     {
@@ -0,0 +1,211 @@
+#include <libsystem/cmdline/CMDLine.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/network/NetworkSocket.h>
+#include <libsystem/system/System.h>
+
+#include <stdlib.h>
+
+#define TCPBENCH_CHUNK_SIZE (16 * 1024)
+
+static int total_size = 16;
+static bool listen = false;
+
+static const char *usages[] = {
+    "[OPTION]... ADDRESS PORT",
+    "--listen PORT",
+    nullptr,
+};
+
+static CommandLineOption options[] = {
+    COMMANDLINE_OPT_HELP,
+    COMMANDLINE_OPT_INT("total", 't', total_size,
+                        "Number of MiB to send",
+                        COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_BOOL("listen", 'l', listen,
+                         "Wait for a connection and count what it sends",
+                         COMMANDLINE_NO_CALLBACK),
+    COMMANDLINE_OPT_END};
+
+static CommandLine cmdline = CMDLINE(
+    usages,
+    options,
+    "Measure the throughput of a TCP connection through the network service.",
+    "With QEMU user networking the host is 10.0.2.2, 'nc -l PORT > /dev/null' on it receives.");
+
+static void report(const char *name, uint64_t bytes, uint elapsed)
+{
+    elapsed = MAX(elapsed, 1u);
+
+    printf("%-10s %8u KiB/s (%u KiB in %d ms)\n",
+           name,
+           (uint)(bytes * 1000 / 1024 / elapsed),
+           (uint)(bytes / 1024),
+           (int)elapsed);
+}
+
+static Result send(NetworkEndpoint remote)
+{
+    auto socket_or_result = network_socket_open(NETWORK_SOCKET_TCP);
+
+    if (!socket_or_result.success())
+    {
+        return socket_or_result.result();
+    }
+
+    NetworkSocket *socket = socket_or_result.take_value();
+
+    Result result = network_socket_connect(socket, remote);
+
+    static uint8_t chunk[TCPBENCH_CHUNK_SIZE];
+
+    for (size_t i = 0; i < TCPBENCH_CHUNK_SIZE; i++)
+    {
+        chunk[i] = i;
+    }
+
+    uint64_t total = (uint64_t)total_size * 1024 * 1024;
+    uint64_t sent = 0;
+
+    uint start = system_get_ticks();
+
+    while (result == SUCCESS && sent < total)
+    {
+        auto sent_or_result = network_socket_send(socket, chunk, MIN(total - sent, (uint64_t)TCPBENCH_CHUNK_SIZE));
+
+        result = sent_or_result.result();
+
+        if (result == SUCCESS)
+        {
+            sent += sent_or_result.value();
+        }
+    }
+
+    // The last send buffer is still on its way, which is little next to
+    // the total, and the peer doesn't have to close for this to end.
+    if (result == SUCCESS)
+    {
+        result = network_socket_shutdown(socket);
+    }
+
+    uint elapsed = system_get_ticks() - start;
+
+    network_socket_close(socket);
+
+    if (result == SUCCESS)
+    {
+        report("sent", sent, elapsed);
+    }
+
+    return result;
+}
+
+static Result receive(uint16_t port)
+{
+    auto socket_or_result = network_socket_open(NETWORK_SOCKET_TCP);
+
+    if (!socket_or_result.success())
+    {
+        return socket_or_result.result();
+    }
+
+    NetworkSocket *listener = socket_or_result.take_value();
+
+    Result result = network_socket_bind(listener, {IPV4_ANY, port});
+
+    if (result == SUCCESS)
+    {
+        result = network_socket_listen(listener, 1);
+    }
+
+    if (result != SUCCESS)
+    {
+        network_socket_close(listener);
+        return result;
+    }
+
+    NetworkEndpoint peer = {};
+    auto accepted = network_socket_accept(listener, &peer);
+
+    network_socket_close(listener);
+
+    if (!accepted.success())
+    {
+        return accepted.result();
+    }
+
+    NetworkSocket *socket = accepted.take_value();
+
+    printf("Connection from %d.%d.%d.%d:%d\n", peer.address[0], peer.address[1], peer.address[2], peer.address[3], peer.port);
+
+    static uint8_t chunk[TCPBENCH_CHUNK_SIZE];
+
+    uint64_t received = 0;
+    uint start = system_get_ticks();
+
+    while (true)
+    {
+        auto received_or_result = network_socket_receive(socket, chunk, TCPBENCH_CHUNK_SIZE);
+
+        result = received_or_result.result();
+
+        if (result != SUCCESS || received_or_result.value() == 0)
+        {
+            break;
+        }
+
+        received += received_or_result.value();
+    }
+
+    uint elapsed = system_get_ticks() - start;
+
+    network_socket_close(socket);
+
+    if (result == SUCCESS)
+    {
+        report("received", received, elapsed);
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    argc = cmdline_parse(&cmdline, argc, argv);
+
+    if ((listen && argc < 2) || (!listen && argc < 3) || total_size <= 0)
+    {
+        cmdline_callback_help(&cmdline, nullptr);
+        return PROCESS_FAILURE;
+    }
+
+    Result result;
+
+    if (listen)
+    {
+        result = receive(atoi(argv[1]));
+    }
+    else
+    {
+        NetworkEndpoint remote = {};
+
+        if (!ipv4_address_parse(argv[1], remote.address))
+        {
+            stream_format(err_stream, "%s: %s is not an IPv4 address\n", argv[0], argv[1]);
+            return PROCESS_FAILURE;
+        }
+
+        remote.port = atoi(argv[2]);
+
+        result = send(remote);
+    }
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: %s\n", argv[0], get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
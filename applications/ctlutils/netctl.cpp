@@ -1,10 +1,236 @@
 #include <libsystem/core/CString.h>
 #include <libsystem/io/Stream.h>
+#include <libsystem/network/DNS.h>
+#include <libsystem/network/NetworkSocket.h>
+#include <libsystem/system/Random.h>
+
+static void print_address(const char *name, IPv4Address address)
+{
+    printf("%s: %d.%d.%d.%d\n", name, address[0], address[1], address[2], address[3]);
+}
+
+static void print_configuration()
+{
+    NetworkConfiguration configuration = {};
+
+    Result result = network_get_configuration(&configuration);
+
+    if (result != SUCCESS)
+    {
+        printf("Network service: %s\n", get_result_description(result));
+        return;
+    }
+
+    if (!configuration.configured)
+    {
+        printf("IPv4: not configured yet\n");
+    }
+    else
+    {
+        print_address("IPv4", configuration.address);
+        print_address("Netmask", configuration.netmask);
+        print_address("Gateway", configuration.gateway);
+        print_address("DNS", configuration.dns);
+        printf("Lease: %us\n", configuration.lease);
+    }
+
+    printf("Packets: %u received in %u batches, %u sent, %u dropped (%s)\n",
+           configuration.received,
+           configuration.batches,
+           configuration.transmitted,
+           configuration.dropped,
+           configuration.shared_rings ? "shared rings" : "read/write");
+}
+
+// Skips a name, compressed or not.
+static size_t dns_skip_name(const uint8_t *message, size_t size, size_t offset)
+{
+    while (offset < size)
+    {
+        uint8_t length = message[offset];
+
+        if ((length & DNS_POINTER) == DNS_POINTER)
+        {
+            return offset + 2;
+        }
+
+        if (length == 0)
+        {
+            return offset + 1;
+        }
+
+        offset += 1 + length;
+    }
+
+    return size + 1;
+}
+
+static Result resolve(const char *name)
+{
+    NetworkConfiguration configuration = {};
+
+    Result result = network_get_configuration(&configuration);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (!configuration.configured || configuration.dns.empty())
+    {
+        return ERR_NETWORK_UNREACHABLE;
+    }
+
+    uint8_t query[DNS_MESSAGE_SIZE] = {};
+
+    Random random = random_create();
+    uint16_t identifier = random_uint32(&random);
+
+    auto header = reinterpret_cast<DNSHeader *>(query);
+    header->identifier = identifier;
+    header->flags = DNS_FLAG_RECURSION_DESIRED;
+    header->questions = 1;
+
+    size_t size = sizeof(DNSHeader);
+
+    // Labels with their length in front of them, "a.b" is "\1a\1b\0".
+    for (const char *label = name; *label;)
+    {
+        size_t length = 0;
+
+        while (label[length] && label[length] != '.')
+        {
+            length++;
+        }
+
+        if (length == 0 || length > 63 || size + length + 6 > DNS_MESSAGE_SIZE)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        query[size++] = length;
+        memcpy(query + size, label, length);
+        size += length;
+
+        label += length;
+
+        if (*label == '.')
+        {
+            label++;
+        }
+    }
+
+    query[size++] = 0;
+    query[size++] = 0;
+    query[size++] = DNS_TYPE_A;
+    query[size++] = 0;
+    query[size++] = DNS_CLASS_INTERNET;
+
+    auto socket_or_result = network_socket_open(NETWORK_SOCKET_UDP);
+
+    if (!socket_or_result.success())
+    {
+        return socket_or_result.result();
+    }
+
+    NetworkSocket *socket = socket_or_result.take_value();
+
+    result = network_socket_connect(socket, {configuration.dns, DNS_PORT});
+
+    if (result == SUCCESS)
+    {
+        result = network_socket_send(socket, query, size).result();
+    }
+
+    uint8_t reply[DNS_MESSAGE_SIZE];
+    size_t reply_size = 0;
+
+    // Answers to something else are from an older query.
+    while (result == SUCCESS)
+    {
+        auto received = network_socket_receive(socket, reply, DNS_MESSAGE_SIZE);
+
+        if (!received.success())
+        {
+            result = received.result();
+            break;
+        }
+
+        reply_size = received.value();
+
+        auto reply_header = reinterpret_cast<DNSHeader *>(reply);
+
+        if (reply_size >= sizeof(DNSHeader) &&
+            reply_header->identifier() == identifier &&
+            (reply_header->flags() & DNS_FLAG_RESPONSE))
+        {
+            break;
+        }
+    }
+
+    network_socket_close(socket);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    auto reply_header = reinterpret_cast<DNSHeader *>(reply);
+
+    if (reply_header->flags() & DNS_RESPONSE_CODE)
+    {
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+    }
+
+    size_t offset = sizeof(DNSHeader);
+
+    for (size_t i = 0; i < reply_header->questions(); i++)
+    {
+        offset = dns_skip_name(reply, reply_size, offset) + 4;
+    }
+
+    bool found = false;
+
+    for (size_t i = 0; i < reply_header->answers() && offset + 10 <= reply_size; i++)
+    {
+        offset = dns_skip_name(reply, reply_size, offset);
+
+        if (offset + 10 > reply_size)
+        {
+            break;
+        }
+
+        uint16_t type = (reply[offset] << 8) | reply[offset + 1];
+        uint16_t length = (reply[offset + 8] << 8) | reply[offset + 9];
+
+        offset += 10;
+
+        if (type == DNS_TYPE_A && length == 4 && offset + 4 <= reply_size)
+        {
+            printf("%s: %d.%d.%d.%d\n", name, reply[offset], reply[offset + 1], reply[offset + 2], reply[offset + 3]);
+            found = true;
+        }
+
+        offset += length;
+    }
+
+    return found ? SUCCESS : ERR_NO_SUCH_FILE_OR_DIRECTORY;
+}
 
 int main(int argc, char **argv)
 {
-    __unused(argc);
-    __unused(argv);
+    if (argc == 3 && strcmp(argv[1], "-r") == 0)
+    {
+        Result result = resolve(argv[2]);
+
+        if (result != SUCCESS)
+        {
+            stream_format(err_stream, "%s: %s: %s\n", argv[0], argv[2], get_result_description(result));
+            return PROCESS_FAILURE;
+        }
+
+        return PROCESS_SUCCESS;
+    }
 
     Stream *network_device = stream_open(NETWORK_DEVICE_PATH, OPEN_READ | OPEN_WRITE);
 
@@ -16,6 +242,8 @@ int main(int argc, char **argv)
 
         printf("MAC: %02x:%02x:%02x:%02x:%02x:%02x\n",
                state.mac_address[0], state.mac_address[1], state.mac_address[2], state.mac_address[3], state.mac_address[4], state.mac_address[5]);
+
+        print_configuration();
     }
 
     stream_close(network_device);
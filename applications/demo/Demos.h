@@ -14,6 +14,8 @@ void lines_draw(Painter &painter, Recti screen, float time);
 
 void path_draw(Painter &Painter, Recti screen, float time);
 
+void fonts_draw(Painter &painter, Recti screen, float time);
+
 typedef void (*DrawDemoCallback)(Painter &painter, Recti screen, float time);
 
 struct Demo
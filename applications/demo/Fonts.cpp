@@ -0,0 +1,29 @@
+#include "demo/Demos.h"
+
+void fonts_draw(Painter &painter, Recti screen, float)
+{
+    painter.clear(Colors::WHITE);
+
+    int sizes[] = {10, 12, 14, 16, 20, 24, 32, 48, 64};
+
+    Vec2i position = screen.position() + Vec2i(16, 0);
+
+    for (int size : sizes)
+    {
+        auto font_or_error = Font::create("Roboto/Roboto-Regular", size);
+
+        if (!font_or_error.success())
+        {
+            return;
+        }
+
+        auto font = font_or_error.take_value();
+
+        position = position + Vec2i(0, font->mesure_string("A").height() + 4);
+
+        char text[64];
+        snprintf(text, 64, "%dpx The quick brown fox jumps over the lazy dog", size);
+
+        painter.draw_string(*font, text, position, Colors::BLACK);
+    }
+}
@@ -4,6 +4,7 @@
 
 static Demo _demos[] = {
     {"Path", path_draw},
+    {"Fonts", fonts_draw},
     {"Latency", latency_draw},
     {"Colors", colors_draw},
     {"Graphics", graphics_draw},
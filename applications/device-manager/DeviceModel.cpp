@@ -12,7 +12,7 @@ enum Column
 
 int DeviceModel::rows()
 {
-    return _data.length();
+    return _data.root().length();
 }
 
 int DeviceModel::columns()
@@ -43,21 +43,21 @@ String DeviceModel::header(int column)
 
 Variant DeviceModel::data(int row, int column)
 {
-    auto &device = _data.get(row);
+    auto &device = _data.root().get((size_t)row);
 
     switch (column)
     {
     case COLUMN_NAME:
-        return device.get("name").as_string();
+        return String{device.get("name").as_string()};
 
     case COLUMN_DESCRIPTION:
-        return device.get("description").as_string();
+        return String{device.get("description").as_string()};
 
     case COLUMN_PATH:
-        return device.get("path").as_string();
+        return String{device.get("path").as_string()};
 
     case COLUMN_ADDRESS:
-        return device.get("address").as_string();
+        return String{device.get("address").as_string()};
 
     default:
         ASSERT_NOT_REACHED();
@@ -66,7 +66,31 @@ Variant DeviceModel::data(int row, int column)
 
 void DeviceModel::update()
 {
-    _data = json::parse_file("/System/devices");
-
+    auto data = json::Document::load_file("/System/devices");
+
+    auto &old_devices = _data.root();
+    auto &new_devices = data.root();
+
+    // Devices aren't listed in any particular order, a device whose path
+    // doesn't match is taken as removed. This is exact for devices going
+    // away or coming at the end of the list and still correct otherwise.
+    did_diff_rows(
+        old_devices.length(), new_devices.length(),
+        [&](int old_row, int new_row) {
+            return old_devices.get(old_row).get("path").as_string() ==
+                           new_devices.get(new_row).get("path").as_string()
+                       ? 0
+                       : -1;
+        },
+        [&](int old_row, int new_row) {
+            auto &old_device = old_devices.get(old_row);
+            auto &new_device = new_devices.get(new_row);
+
+            return old_device.get("name").as_string() == new_device.get("name").as_string() &&
+                   old_device.get("description").as_string() == new_device.get("description").as_string() &&
+                   old_device.get("address").as_string() == new_device.get("address").as_string();
+        });
+
+    _data = move(data);
     did_update();
 }
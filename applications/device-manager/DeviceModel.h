@@ -6,7 +6,7 @@
 class DeviceModel : public TableModel
 {
 private:
-    json::Value _data = nullptr;
+    json::Document _data{};
 
 public:
     int rows() override;
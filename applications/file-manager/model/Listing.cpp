@@ -2,49 +2,19 @@
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
 #include <libsystem/io/Directory.h>
-#include <libsystem/json/Json.h>
 
 #include "file-manager/model/Listing.h"
 
 namespace file_manager
 {
 
-static auto get_icon_for_node(String current_directory, DirectoryEntry *entry)
+// Rows keep the order of the directory: entries are appended when they are
+// created and the others keep their place when one goes away. A row which
+// doesn't match the next one anymore was removed, what is left at the end
+// of the new listing was inserted.
+static int compare_nodes(const FileSystemNode &left, const FileSystemNode &right)
 {
-    if (entry->stat.type == FILE_TYPE_DIRECTORY)
-    {
-        char manifest_path[PATH_LENGTH];
-
-        snprintf(manifest_path, PATH_LENGTH, "%s/%s/manifest.json", current_directory.cstring(), entry->name);
-
-        auto root = json::parse_file(manifest_path);
-
-        if (root.is(json::OBJECT))
-        {
-            auto icon_name = root.get("icon");
-
-            if (icon_name.is(json::STRING))
-            {
-                return Icon::get(icon_name.as_string());
-            }
-        }
-
-        return Icon::get("folder");
-    }
-    else if (entry->stat.type == FILE_TYPE_PIPE ||
-             entry->stat.type == FILE_TYPE_DEVICE ||
-             entry->stat.type == FILE_TYPE_SOCKET)
-    {
-        return Icon::get("pipe");
-    }
-    else if (entry->stat.type == FILE_TYPE_TERMINAL)
-    {
-        return Icon::get("console-network");
-    }
-    else
-    {
-        return Icon::get("file");
-    }
+    return left.name == right.name ? 0 : -1;
 }
 
 enum Column
@@ -62,6 +32,10 @@ Listing::Listing(RefPtr<Navigation> navigation)
     _observer = navigation->observe([this](auto &) {
         update();
     });
+
+    _loader = own<Invoker>([this]() {
+        load_pending();
+    });
 }
 
 int Listing::rows()
@@ -127,12 +101,30 @@ Variant Listing::data(int row, int column)
 
 void Listing::update()
 {
-    _files.clear();
+    String current = _navigation->current().string();
+
+    _pending.clear();
+    _pending_next = 0;
+    _loader->cancel();
+
+    // Refreshing the same directory reports only what changed and reloads
+    // the icons, anything else is a whole new listing.
+    bool refreshing = current == _listed_directory;
+
+    if (refreshing)
+    {
+        _cache.invalidate(current);
+    }
+
+    Vector<FileSystemNode> files{};
 
-    auto directory = directory_open(_navigation->current().string().cstring(), OPEN_READ);
+    auto directory = directory_open(current.cstring(), OPEN_READ);
 
     if (handle_has_error(directory))
     {
+        _files.clear();
+        _listed_directory = "";
+
         directory_close(directory);
         return;
     }
@@ -143,15 +135,90 @@ void Listing::update()
         FileSystemNode node{
             .name = {entry.name, FILE_NAME_LENGTH},
             .type = entry.stat.type,
-            .icon = get_icon_for_node(_navigation->current().string(), &entry),
+            .icon = nullptr,
             .size = entry.stat.size,
+            .loaded = true,
         };
 
-        _files.push_back(node);
+        FileMetadata metadata;
+
+        if (_cache.lookup(current, node.name, node.type, metadata))
+        {
+            node.icon = metadata.icon;
+        }
+        else
+        {
+            node.icon = icon_for_type(node.type);
+            node.loaded = node.type != FILE_TYPE_DIRECTORY;
+
+            if (node.loaded)
+            {
+                _cache.store(current, node.name, {node.type, node.icon});
+            }
+        }
+
+        files.push_back(node);
     }
 
     directory_close(directory);
 
+    if (refreshing)
+    {
+        did_diff_rows(
+            _files.count(), files.count(),
+            [&](int old_row, int new_row) {
+                return compare_nodes(_files[old_row], files[new_row]);
+            },
+            [&](int old_row, int new_row) {
+                return _files[old_row].size == files[new_row].size;
+            });
+    }
+
+    _files = move(files);
+    _listed_directory = current;
+
+    // Rows are in place by now, icons fill in from the top.
+    for (size_t i = 0; i < _files.count(); i++)
+    {
+        if (!_files[i].loaded)
+        {
+            _pending.push_back(i);
+        }
+    }
+
+    if (_pending.any())
+    {
+        _loader->invoke_later();
+    }
+
+    did_update();
+}
+
+void Listing::load_pending()
+{
+    for (size_t i = 0; i < LOAD_BATCH && _pending_next < _pending.count(); i++)
+    {
+        int row = _pending[_pending_next++];
+        auto &node = _files[row];
+
+        node.icon = icon_for_directory(_listed_directory, node.name);
+        node.loaded = true;
+
+        _cache.store(_listed_directory, node.name, {node.type, node.icon});
+
+        did_change_rows(row, 1);
+    }
+
+    if (_pending_next < _pending.count())
+    {
+        _loader->invoke_later();
+    }
+    else
+    {
+        _pending.clear();
+        _pending_next = 0;
+    }
+
     did_update();
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <libsystem/eventloop/Invoker.h>
 #include <libutils/Path.h>
 #include <libutils/Vector.h>
 #include <libwidget/model/TableModel.h>
 
+#include "file-manager/model/MetadataCache.h"
 #include "file-manager/model/Navigation.h"
 
 namespace file_manager
@@ -15,6 +17,7 @@ struct FileSystemNode
     FileType type;
     RefPtr<Icon> icon;
     size_t size;
+    bool loaded;
 };
 
 class Listing : public TableModel
@@ -22,8 +25,20 @@ class Listing : public TableModel
 private:
     RefPtr<Navigation> _navigation;
     Vector<FileSystemNode> _files{};
+    String _listed_directory{};
     OwnPtr<Observer<Navigation>> _observer;
 
+    // Rows waiting for their icon, loaded a few at a time from the event
+    // loop so the listing shows up right away.
+    static constexpr size_t LOAD_BATCH = 8;
+
+    MetadataCache _cache{};
+    Vector<int> _pending{};
+    size_t _pending_next = 0;
+    OwnPtr<Invoker> _loader;
+
+    void load_pending();
+
 public:
     Listing(RefPtr<Navigation> navigation);
 
@@ -0,0 +1,86 @@
+#include <libsystem/core/CString.h>
+#include <libsystem/json/Json.h>
+
+#include "file-manager/model/MetadataCache.h"
+
+namespace file_manager
+{
+
+bool MetadataCache::lookup(const String &directory, const String &name, FileType type, FileMetadata &metadata)
+{
+    if (!_directories.has_key(directory))
+    {
+        return false;
+    }
+
+    auto &entries = _directories[directory];
+
+    if (!entries.has_key(name))
+    {
+        return false;
+    }
+
+    if (entries[name].type != type)
+    {
+        entries.remove_key(name);
+        return false;
+    }
+
+    metadata = entries[name];
+    return true;
+}
+
+void MetadataCache::store(const String &directory, const String &name, FileMetadata metadata)
+{
+    _directories[directory][name] = metadata;
+}
+
+void MetadataCache::invalidate(const String &directory)
+{
+    _directories.remove_key(directory);
+}
+
+RefPtr<Icon> icon_for_type(FileType type)
+{
+    if (type == FILE_TYPE_DIRECTORY)
+    {
+        return Icon::get("folder");
+    }
+    else if (type == FILE_TYPE_PIPE ||
+             type == FILE_TYPE_DEVICE ||
+             type == FILE_TYPE_SOCKET)
+    {
+        return Icon::get("pipe");
+    }
+    else if (type == FILE_TYPE_TERMINAL)
+    {
+        return Icon::get("console-network");
+    }
+    else
+    {
+        return Icon::get("file");
+    }
+}
+
+RefPtr<Icon> icon_for_directory(const String &directory, const String &name)
+{
+    char manifest_path[PATH_LENGTH];
+
+    snprintf(manifest_path, PATH_LENGTH, "%s/%s/manifest.json", directory.cstring(), name.cstring());
+
+    auto root = json::parse_file(manifest_path);
+
+    if (root.is(json::OBJECT))
+    {
+        auto icon_name = root.get("icon");
+
+        if (icon_name.is(json::STRING))
+        {
+            return Icon::get(icon_name.as_string());
+        }
+    }
+
+    return Icon::get("folder");
+}
+
+} // namespace file_manager
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <abi/Filesystem.h>
+#include <libgraphic/Icon.h>
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+
+namespace file_manager
+{
+
+struct FileMetadata
+{
+    FileType type;
+    RefPtr<Icon> icon;
+};
+
+// Icons of the entries of the directories already visited, keyed by the
+// path of the directory then the name of the entry. Going back to a
+// directory doesn't open and parse every manifest in it again.
+//
+// There is no change notification from the filesystem, an entry whose
+// type changed is dropped when it is looked up and refreshing a directory
+// drops all of it.
+class MetadataCache
+{
+private:
+    HashMap<String, HashMap<String, FileMetadata>> _directories{};
+
+public:
+    bool lookup(const String &directory, const String &name, FileType type, FileMetadata &metadata);
+
+    void store(const String &directory, const String &name, FileMetadata metadata);
+
+    void invalidate(const String &directory);
+};
+
+// The icon of a directory comes from its manifest, which is too slow to
+// read while listing a large directory. Everything else only depends on
+// the type of the entry.
+RefPtr<Icon> icon_for_type(FileType type);
+
+RefPtr<Icon> icon_for_directory(const String &directory, const String &name);
+
+} // namespace file_manager
@@ -0,0 +1,4 @@
+APPS += NETWORK
+
+NETWORK_NAME = network
+NETWORK_LIBS =
@@ -0,0 +1,514 @@
+#include <libsystem/Assert.h>
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/system/System.h>
+
+#include "network/Client.h"
+#include "network/Interface.h"
+
+// Connections given by ACCEPT, until a new socket attaches to them.
+struct Unclaimed
+{
+    uint32_t id;
+    TCPSocket *socket;
+    TimeStamp deadline;
+};
+
+static Vector<Client *> _clients{};
+static Vector<Unclaimed> _unclaimed{};
+static uint32_t _next_unclaimed_id = 1;
+
+static NetworkMessage client_ack(Result result)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_ACK;
+    message.result = result;
+
+    return message;
+}
+
+static bool client_handle_open(Client *client, NetworkMessage &request)
+{
+    if (client->tcp || client->udp)
+    {
+        client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+        return true;
+    }
+
+    if (request.value == NETWORK_SOCKET_TCP)
+    {
+        client->tcp = tcp_open();
+    }
+    else if (request.value == NETWORK_SOCKET_UDP)
+    {
+        client->udp = udp_open();
+    }
+    else
+    {
+        client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+        return true;
+    }
+
+    client->reply(client_ack(SUCCESS), nullptr);
+
+    return true;
+}
+
+static bool client_handle_attach(Client *client, NetworkMessage &request)
+{
+    for (size_t i = 0; i < _unclaimed.count(); i++)
+    {
+        if (_unclaimed[i].id == request.value && !client->tcp && !client->udp)
+        {
+            client->tcp = _unclaimed[i].socket;
+            _unclaimed.remove_index(i);
+
+            client->reply(client_ack(SUCCESS), nullptr);
+
+            return true;
+        }
+    }
+
+    client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+
+    return true;
+}
+
+static bool client_handle_bind(Client *client, NetworkMessage &request)
+{
+    Result result = client->tcp ? tcp_bind(client->tcp, request.endpoint)
+                                : udp_bind(client->udp, request.endpoint);
+
+    client->reply(client_ack(result), nullptr);
+
+    return true;
+}
+
+static bool client_handle_connect(Client *client, NetworkMessage &request)
+{
+    if (client->udp)
+    {
+        client->reply(client_ack(udp_connect(client->udp, request.endpoint)), nullptr);
+        return true;
+    }
+
+    TCPSocket *socket = client->tcp;
+
+    if (!client->started)
+    {
+        Result result = tcp_connect(socket, request.endpoint);
+
+        if (result != SUCCESS)
+        {
+            client->reply(client_ack(result), nullptr);
+            return true;
+        }
+
+        client->started = true;
+    }
+
+    if (socket->state == TCP_SYN_SENT || socket->state == TCP_SYN_RECEIVED)
+    {
+        return false;
+    }
+
+    if (socket->state == TCP_CLOSED)
+    {
+        client->reply(client_ack(socket->error != SUCCESS ? socket->error : ERR_CONNECTION_REFUSED), nullptr);
+    }
+    else
+    {
+        client->reply(client_ack(SUCCESS), nullptr);
+    }
+
+    return true;
+}
+
+static bool client_handle_listen(Client *client, NetworkMessage &request)
+{
+    if (!client->tcp)
+    {
+        client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+        return true;
+    }
+
+    client->reply(client_ack(tcp_listen(client->tcp, request.value)), nullptr);
+
+    return true;
+}
+
+static bool client_handle_accept(Client *client)
+{
+    if (!client->tcp || client->tcp->state != TCP_LISTEN)
+    {
+        client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+        return true;
+    }
+
+    TCPSocket *accepted = tcp_accept(client->tcp);
+
+    if (!accepted)
+    {
+        return false;
+    }
+
+    Unclaimed unclaimed = {
+        .id = _next_unclaimed_id++,
+        .socket = accepted,
+        .deadline = system_get_ticks() + CLIENT_ATTACH_TIMEOUT,
+    };
+
+    _unclaimed.push_back(unclaimed);
+
+    NetworkMessage message = client_ack(SUCCESS);
+    message.value = unclaimed.id;
+    message.endpoint = accepted->remote;
+
+    client->reply(message, nullptr);
+
+    return true;
+}
+
+static Result client_tcp_error(TCPSocket *socket)
+{
+    return socket->error != SUCCESS ? socket->error : ERR_NOT_CONNECTED;
+}
+
+static bool client_handle_send(Client *client, NetworkMessage &request)
+{
+    if (client->udp)
+    {
+        auto result = udp_send(client->udp, request.endpoint, client->payload(), request.size);
+
+        NetworkMessage message = client_ack(result.result());
+        message.value = result.success() ? result.value() : 0;
+
+        client->reply(message, nullptr);
+
+        return true;
+    }
+
+    TCPSocket *socket = client->tcp;
+
+    if (socket->state == TCP_SYN_SENT || socket->state == TCP_SYN_RECEIVED)
+    {
+        return false;
+    }
+
+    if ((socket->state != TCP_ESTABLISHED && socket->state != TCP_CLOSE_WAIT) || socket->fin_queued)
+    {
+        client->reply(client_ack(client_tcp_error(socket)), nullptr);
+        return true;
+    }
+
+    if (!tcp_can_send(socket))
+    {
+        return false;
+    }
+
+    // Whatever fits, the rest comes with the next request.
+    NetworkMessage message = client_ack(SUCCESS);
+    message.value = tcp_send(socket, client->payload(), request.size);
+
+    client->reply(message, nullptr);
+
+    return true;
+}
+
+static bool client_handle_receive(Client *client, NetworkMessage &request)
+{
+    size_t wanted = MIN(request.value, NETWORK_MESSAGE_PAYLOAD_SIZE);
+
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_DATA;
+
+    uint8_t payload[NETWORK_MESSAGE_PAYLOAD_SIZE];
+
+    if (client->udp)
+    {
+        UDPDatagram *datagram = udp_take(client->udp);
+
+        if (!datagram)
+        {
+            return false;
+        }
+
+        // What doesn't fit is lost, as with any datagram socket.
+        message.endpoint = datagram->from;
+        message.size = MIN(wanted, datagram->size);
+        memcpy(payload, datagram->data, message.size);
+
+        delete datagram;
+
+        client->reply(message, payload);
+
+        return true;
+    }
+
+    TCPSocket *socket = client->tcp;
+
+    if (socket->receive_buffer.used() > 0)
+    {
+        message.endpoint = socket->remote;
+        message.size = tcp_read(socket, payload, wanted);
+
+        client->reply(message, payload);
+
+        return true;
+    }
+
+    if (socket->fin_received)
+    {
+        client->reply(message, nullptr);
+        return true;
+    }
+
+    if (socket->state == TCP_CLOSED || socket->state == TCP_LISTEN)
+    {
+        client->reply(client_ack(client_tcp_error(socket)), nullptr);
+        return true;
+    }
+
+    return false;
+}
+
+static bool client_handle_shutdown(Client *client)
+{
+    if (client->tcp)
+    {
+        tcp_shutdown(client->tcp);
+    }
+
+    client->reply(client_ack(SUCCESS), nullptr);
+
+    return true;
+}
+
+// Whether the request was answered, otherwise it is tried again later.
+static bool client_handle_request(Client *client)
+{
+    NetworkMessage &request = client->message();
+
+    if (request.type == NETWORK_MESSAGE_GET_CONFIGURATION)
+    {
+        NetworkMessage message = {};
+        message.type = NETWORK_MESSAGE_CONFIGURATION;
+        message.size = sizeof(NetworkConfiguration);
+
+        client->reply(message, &interface_configuration());
+
+        return true;
+    }
+
+    if (request.type == NETWORK_MESSAGE_OPEN)
+    {
+        return client_handle_open(client, request);
+    }
+
+    if (request.type == NETWORK_MESSAGE_ATTACH)
+    {
+        return client_handle_attach(client, request);
+    }
+
+    if (!client->tcp && !client->udp)
+    {
+        client->reply(client_ack(ERR_INVALID_ARGUMENT), nullptr);
+        return true;
+    }
+
+    switch (request.type)
+    {
+    case NETWORK_MESSAGE_BIND:
+        return client_handle_bind(client, request);
+
+    case NETWORK_MESSAGE_CONNECT:
+        return client_handle_connect(client, request);
+
+    case NETWORK_MESSAGE_LISTEN:
+        return client_handle_listen(client, request);
+
+    case NETWORK_MESSAGE_ACCEPT:
+        return client_handle_accept(client);
+
+    case NETWORK_MESSAGE_SEND:
+        return client_handle_send(client, request);
+
+    case NETWORK_MESSAGE_RECEIVE:
+        return client_handle_receive(client, request);
+
+    case NETWORK_MESSAGE_SHUTDOWN:
+        return client_handle_shutdown(client);
+
+    default:
+        logger_error("Invalid message from client %08x", client);
+        client->disconnected = true;
+
+        return true;
+    }
+}
+
+static void client_update(Client *client)
+{
+    if (client->disconnected || !client->pending)
+    {
+        return;
+    }
+
+    if (client_handle_request(client))
+    {
+        client->pending = false;
+        client->started = false;
+        client->request_size = 0;
+    }
+}
+
+void client_request_callback(Client *client, Connection *connection, PollEvent events)
+{
+    assert(events & POLL_READ);
+
+    // Nothing more is expected before the reply.
+    if (client->pending)
+    {
+        uint8_t byte;
+        connection_receive(connection, &byte, 1);
+
+        if (!handle_has_error(connection))
+        {
+            logger_error("Client %08x sent a request before the reply to the previous one", client);
+        }
+
+        client->disconnected = true;
+        client_destroy_disconnected();
+
+        return;
+    }
+
+    size_t expected = sizeof(NetworkMessage);
+
+    if (client->request_size >= sizeof(NetworkMessage))
+    {
+        expected += client->message().size;
+    }
+
+    size_t received = connection_receive(connection, client->request + client->request_size, expected - client->request_size);
+
+    if (handle_has_error(connection) || received == 0)
+    {
+        client->disconnected = true;
+        client_destroy_disconnected();
+
+        return;
+    }
+
+    client->request_size += received;
+
+    if (client->request_size == sizeof(NetworkMessage) && client->message().size > NETWORK_MESSAGE_PAYLOAD_SIZE)
+    {
+        logger_error("Got a message with an invalid size from client %08x", client);
+
+        client->disconnected = true;
+        client_destroy_disconnected();
+
+        return;
+    }
+
+    if (client->request_size < sizeof(NetworkMessage) ||
+        client->request_size < sizeof(NetworkMessage) + client->message().size)
+    {
+        return;
+    }
+
+    client->pending = true;
+    client_update(client);
+
+    // What the request caused is sent right away, not at the next batch.
+    interface_flush();
+
+    client_destroy_disconnected();
+}
+
+Client::Client(Connection *connection)
+{
+    this->connection = connection;
+    this->notifier = notifier_create(
+        this,
+        HANDLE(connection),
+        POLL_READ,
+        (NotifierCallback)client_request_callback);
+
+    _clients.push_back(this);
+}
+
+Client::~Client()
+{
+    if (tcp)
+    {
+        tcp_close(tcp);
+    }
+
+    if (udp)
+    {
+        udp_close(udp);
+    }
+
+    _clients.remove_value(this);
+    notifier_destroy(notifier);
+    connection_close(connection);
+}
+
+void Client::reply(NetworkMessage message, const void *payload)
+{
+    if (disconnected)
+    {
+        return;
+    }
+
+    assert(message.size <= NETWORK_MESSAGE_PAYLOAD_SIZE);
+
+    // In one write, the client is waiting on nothing else so it always fits.
+    uint8_t buffer[sizeof(NetworkMessage) + NETWORK_MESSAGE_PAYLOAD_SIZE];
+    memcpy(buffer, &message, sizeof(NetworkMessage));
+    memcpy(buffer + sizeof(NetworkMessage), payload, message.size);
+
+    connection_send(connection, buffer, sizeof(NetworkMessage) + message.size);
+
+    if (handle_has_error(connection))
+    {
+        logger_error("Failed to reply to %08x: %s", this, handle_error_string(connection));
+        disconnected = true;
+    }
+}
+
+void client_update_all()
+{
+    for (size_t i = 0; i < _clients.count(); i++)
+    {
+        client_update(_clients[i]);
+    }
+}
+
+void client_tick(TimeStamp now)
+{
+    for (size_t i = _unclaimed.count(); i > 0; i--)
+    {
+        if (_unclaimed[i - 1].deadline <= now)
+        {
+            tcp_close(_unclaimed[i - 1].socket);
+            _unclaimed.remove_index(i - 1);
+        }
+    }
+}
+
+void client_destroy_disconnected()
+{
+    for (size_t i = _clients.count(); i > 0; i--)
+    {
+        Client *client = _clients[i - 1];
+
+        if (client->disconnected)
+        {
+            delete client;
+        }
+    }
+}
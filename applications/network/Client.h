@@ -0,0 +1,45 @@
+#pragma once
+
+#include <libsystem/Time.h>
+#include <libsystem/eventloop/Notifier.h>
+#include <libsystem/io/Connection.h>
+#include <libsystem/network/NetworkProtocol.h>
+
+#include "network/TCP.h"
+#include "network/UDP.h"
+
+// How long an accepted connection waits for its ATTACH.
+#define CLIENT_ATTACH_TIMEOUT (5000)
+
+struct Client
+{
+    Notifier *notifier = nullptr;
+    Connection *connection = nullptr;
+    bool disconnected = false;
+
+    TCPSocket *tcp = nullptr;
+    UDPSocket *udp = nullptr;
+
+    // The request being read, then waiting to be answered.
+    uint8_t request[sizeof(NetworkMessage) + NETWORK_MESSAGE_PAYLOAD_SIZE];
+    size_t request_size = 0;
+    bool pending = false;
+    bool started = false;
+
+    Client(Connection *connection);
+
+    ~Client();
+
+    NetworkMessage &message() { return *reinterpret_cast<NetworkMessage *>(request); }
+
+    const uint8_t *payload() { return request + sizeof(NetworkMessage); }
+
+    void reply(NetworkMessage message, const void *payload);
+};
+
+// Answers the requests that can complete since the last time.
+void client_update_all();
+
+void client_tick(TimeStamp now);
+
+void client_destroy_disconnected();
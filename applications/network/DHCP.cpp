@@ -0,0 +1,314 @@
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/network/ARP.h>
+#include <libsystem/network/DHCP.h>
+#include <libsystem/system/Random.h>
+#include <libsystem/system/System.h>
+
+#include "network/DHCP.h"
+#include "network/Interface.h"
+#include "network/UDP.h"
+
+enum DHCPState
+{
+    DHCP_SELECTING,
+    DHCP_REQUESTING,
+    DHCP_BOUND,
+    DHCP_RENEWING,
+};
+
+struct DHCPOffer
+{
+    uint8_t type;
+    IPv4Address server;
+    IPv4Address netmask;
+    IPv4Address router;
+    IPv4Address dns;
+    uint32_t lease;
+};
+
+static DHCPState _state = DHCP_SELECTING;
+static uint32_t _transaction = 0;
+static Random _random = {};
+
+static IPv4Address _offered = {};
+static IPv4Address _server = {};
+
+static TimeStamp _next_event = 0;
+static Timeout _retry_interval = DHCP_RETRY_INTERVAL;
+static TimeStamp _lease_end = 0;
+
+static size_t dhcp_option(uint8_t *options, size_t offset, uint8_t code, const void *data, uint8_t size)
+{
+    options[offset] = code;
+    options[offset + 1] = size;
+    memcpy(options + offset + 2, data, size);
+
+    return offset + 2 + size;
+}
+
+static void dhcp_send(uint8_t type)
+{
+    DHCPPacket packet = {};
+
+    packet.operation = DHCP_BOOT_REQUEST;
+    packet.hardware_type = ARP_HARDWARE_ETHERNET;
+    packet.hardware_size = sizeof(MacAddress);
+    packet.transaction = _transaction;
+    packet.magic = DHCP_MAGIC_COOKIE;
+
+    MacAddress mac_address = interface_device().mac_address();
+    memcpy(packet.client_hardware, mac_address.bytes, sizeof(MacAddress));
+
+    // Without an address, the reply can't be sent to it.
+    if (_state != DHCP_RENEWING)
+    {
+        packet.flags = DHCP_FLAG_BROADCAST;
+    }
+
+    size_t offset = dhcp_option(packet.options, 0, DHCP_OPTION_MESSAGE_TYPE, &type, 1);
+
+    if (_state == DHCP_REQUESTING)
+    {
+        offset = dhcp_option(packet.options, offset, DHCP_OPTION_REQUESTED_ADDRESS, _offered.bytes, 4);
+        offset = dhcp_option(packet.options, offset, DHCP_OPTION_SERVER_IDENTIFIER, _server.bytes, 4);
+    }
+    else if (_state == DHCP_RENEWING)
+    {
+        packet.client_address = interface_address();
+    }
+
+    uint8_t parameters[] = {
+        DHCP_OPTION_SUBNET_MASK,
+        DHCP_OPTION_ROUTER,
+        DHCP_OPTION_DNS,
+        DHCP_OPTION_LEASE_TIME,
+    };
+
+    offset = dhcp_option(packet.options, offset, DHCP_OPTION_PARAMETER_LIST, parameters, sizeof(parameters));
+    packet.options[offset] = DHCP_OPTION_END;
+
+    IPv4Address source = _state == DHCP_RENEWING ? interface_address() : IPV4_ANY;
+    IPv4Address destination = _state == DHCP_RENEWING ? _server : IPV4_BROADCAST;
+
+    udp_send_raw(source, DHCP_CLIENT_PORT, {destination, DHCP_SERVER_PORT}, &packet, sizeof(packet));
+}
+
+static void dhcp_retry_later()
+{
+    _next_event = system_get_ticks() + _retry_interval;
+    _retry_interval = MIN(_retry_interval * 2, (Timeout)DHCP_MAX_RETRY_INTERVAL);
+}
+
+static void dhcp_discover()
+{
+    _state = DHCP_SELECTING;
+    _transaction = random_uint32(&_random);
+    _retry_interval = DHCP_RETRY_INTERVAL;
+
+    dhcp_send(DHCP_DISCOVER);
+    dhcp_retry_later();
+}
+
+static void dhcp_request()
+{
+    _retry_interval = DHCP_RETRY_INTERVAL;
+
+    dhcp_send(DHCP_REQUEST);
+    dhcp_retry_later();
+}
+
+static bool dhcp_parse(const uint8_t *options, size_t size, DHCPOffer &offer)
+{
+    size_t i = 0;
+
+    while (i < size)
+    {
+        uint8_t code = options[i];
+
+        if (code == DHCP_OPTION_END)
+        {
+            break;
+        }
+
+        if (code == DHCP_OPTION_PAD)
+        {
+            i++;
+            continue;
+        }
+
+        if (i + 1 >= size || i + 2 + options[i + 1] > size)
+        {
+            return false;
+        }
+
+        uint8_t length = options[i + 1];
+        const uint8_t *value = options + i + 2;
+
+        IPv4Address address = {};
+
+        if (length >= 4)
+        {
+            memcpy(address.bytes, value, 4);
+        }
+
+        switch (code)
+        {
+        case DHCP_OPTION_MESSAGE_TYPE:
+            offer.type = length >= 1 ? value[0] : 0;
+            break;
+
+        case DHCP_OPTION_SERVER_IDENTIFIER:
+            offer.server = address;
+            break;
+
+        case DHCP_OPTION_SUBNET_MASK:
+            offer.netmask = address;
+            break;
+
+        case DHCP_OPTION_ROUTER:
+            offer.router = address;
+            break;
+
+        case DHCP_OPTION_DNS:
+            offer.dns = address;
+            break;
+
+        case DHCP_OPTION_LEASE_TIME:
+            offer.lease = length >= 4 ? address.value() : 0;
+            break;
+
+        default:
+            break;
+        }
+
+        i += 2 + length;
+    }
+
+    return offer.type != 0;
+}
+
+static void dhcp_bound(IPv4Address address, const DHCPOffer &offer)
+{
+    IPv4Address netmask = offer.netmask.empty() ? IPv4Address{{255, 255, 255, 0}} : offer.netmask;
+
+    interface_configure(address, netmask, offer.router, offer.dns, offer.lease);
+
+    _state = DHCP_BOUND;
+    _server = offer.server;
+
+    // A lease longer than a couple of renewals, infinite ones included, is
+    // renewed before it could ever expire.
+    uint64_t lease = (uint64_t)offer.lease * 1000;
+    Timeout renew = clamp(lease / 2, (uint64_t)DHCP_MIN_RENEW_INTERVAL, (uint64_t)DHCP_MAX_RENEW_INTERVAL);
+
+    TimeStamp now = system_get_ticks();
+
+    _next_event = now + renew;
+    _lease_end = lease > 2ull * DHCP_MAX_RENEW_INTERVAL ? 0 : now + MAX(lease, (uint64_t)renew);
+}
+
+void dhcp_initialize()
+{
+    _random = random_create();
+
+    dhcp_discover();
+}
+
+void dhcp_receive(const uint8_t *data, size_t size)
+{
+    if (size < offsetof(DHCPPacket, options))
+    {
+        return;
+    }
+
+    auto packet = reinterpret_cast<const DHCPPacket *>(data);
+
+    MacAddress mac_address = interface_device().mac_address();
+
+    if (packet->operation != DHCP_BOOT_REPLY ||
+        packet->transaction() != _transaction ||
+        packet->magic() != DHCP_MAGIC_COOKIE ||
+        memcmp(packet->client_hardware, mac_address.bytes, sizeof(MacAddress)) != 0)
+    {
+        return;
+    }
+
+    DHCPOffer offer = {};
+
+    if (!dhcp_parse(packet->options, size - offsetof(DHCPPacket, options), offer))
+    {
+        return;
+    }
+
+    if (offer.type == DHCP_OFFER && _state == DHCP_SELECTING)
+    {
+        _offered = packet->your_address;
+        _server = offer.server.empty() ? packet->server_address : offer.server;
+        _state = DHCP_REQUESTING;
+
+        dhcp_request();
+    }
+    else if (offer.type == DHCP_ACK && (_state == DHCP_REQUESTING || _state == DHCP_RENEWING))
+    {
+        if (offer.server.empty())
+        {
+            offer.server = _server;
+        }
+
+        dhcp_bound(packet->your_address, offer);
+    }
+    else if (offer.type == DHCP_NAK && (_state == DHCP_REQUESTING || _state == DHCP_RENEWING))
+    {
+        logger_warn("The DHCP server refused the address, starting over");
+
+        interface_unconfigure();
+        dhcp_discover();
+    }
+}
+
+void dhcp_tick(TimeStamp now)
+{
+    if (_state != DHCP_SELECTING && _lease_end && _lease_end <= now)
+    {
+        logger_warn("The DHCP lease expired");
+
+        _lease_end = 0;
+
+        interface_unconfigure();
+        dhcp_discover();
+
+        return;
+    }
+
+    if (now < _next_event)
+    {
+        return;
+    }
+
+    switch (_state)
+    {
+    case DHCP_SELECTING:
+        dhcp_send(DHCP_DISCOVER);
+        dhcp_retry_later();
+        break;
+
+    case DHCP_REQUESTING:
+        dhcp_send(DHCP_REQUEST);
+        dhcp_retry_later();
+        break;
+
+    case DHCP_BOUND:
+        _state = DHCP_RENEWING;
+        _transaction = random_uint32(&_random);
+
+        dhcp_request();
+        break;
+
+    case DHCP_RENEWING:
+        dhcp_send(DHCP_REQUEST);
+        dhcp_retry_later();
+        break;
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <libsystem/Time.h>
+
+// Until the first request is answered, a request is sent again after
+// DHCP_RETRY_INTERVAL, twice as long each time up to DHCP_MAX_RETRY_INTERVAL.
+#define DHCP_RETRY_INTERVAL (4000)
+#define DHCP_MAX_RETRY_INTERVAL (64000)
+
+// Bounds on when the lease is renewed, half of it otherwise.
+#define DHCP_MIN_RENEW_INTERVAL (60 * 1000)
+#define DHCP_MAX_RENEW_INTERVAL (24 * 60 * 60 * 1000)
+
+void dhcp_initialize();
+
+void dhcp_receive(const uint8_t *data, size_t size);
+
+void dhcp_tick(TimeStamp now);
@@ -0,0 +1,214 @@
+#include <abi/IOCall.h>
+
+#include <libsystem/Logger.h>
+#include <libsystem/io/Handle.h>
+#include <libsystem/system/Memory.h>
+
+#include "network/Device.h"
+
+OwnPtr<Device> Device::open(const char *path)
+{
+    Stream *stream = stream_open(path, OPEN_READ | OPEN_WRITE);
+
+    if (handle_has_error(stream))
+    {
+        logger_error("Failed to open %s: %s", path, handle_error_string(stream));
+        stream_close(stream);
+        return nullptr;
+    }
+
+    stream_set_read_buffer_mode(stream, STREAM_BUFFERED_NONE);
+    stream_set_write_buffer_mode(stream, STREAM_BUFFERED_NONE);
+
+    IOCallNetworkSateAgs state = {};
+
+    if (stream_call(stream, IOCALL_NETWORK_GET_STATE, &state) != SUCCESS)
+    {
+        logger_error("%s is not a network device", path);
+        stream_close(stream);
+        return nullptr;
+    }
+
+    return own<Device>(stream, state.mac_address);
+}
+
+Device::Device(Stream *stream, MacAddress mac_address)
+    : _stream(stream), _mac_address(mac_address)
+{
+    IOCallNetworkRingsArgs args = {};
+
+    if (stream_call(_stream, IOCALL_NETWORK_GET_RINGS, &args) == SUCCESS)
+    {
+        size_t size = 0;
+
+        if (memory_include(args.memory_handle, &_rings_address, &size) == SUCCESS &&
+            size >= NETWORK_RINGS_MEMORY_SIZE)
+        {
+            _rings = reinterpret_cast<NetworkRings *>(_rings_address);
+            _buffers = reinterpret_cast<uint8_t *>(_rings_address + NETWORK_BUFFERS_OFFSET);
+
+            return;
+        }
+
+        if (_rings_address)
+        {
+            memory_free(_rings_address);
+            _rings_address = 0;
+        }
+    }
+
+    logger_info("No shared rings, falling back to read() and write()");
+
+    _buffers = new uint8_t[NETWORK_BUFFER_COUNT * NETWORK_BUFFER_SIZE];
+
+    for (uint16_t i = 0; i < NETWORK_BUFFER_COUNT; i++)
+    {
+        _spares.push_back(i);
+    }
+}
+
+Device::~Device()
+{
+    if (_rings)
+    {
+        memory_free(_rings_address);
+    }
+    else
+    {
+        delete[] _buffers;
+    }
+
+    stream_close(_stream);
+}
+
+bool Device::readable()
+{
+    Handle *handle = HANDLE(_stream);
+    PollEvent events = POLL_READ;
+
+    Handle *selected = nullptr;
+    PollEvent selected_events = 0;
+
+    return handle_poll(&handle, &events, 1, &selected, &selected_events, 0) == SUCCESS &&
+           selected == handle;
+}
+
+size_t Device::receive(NetworkPacket *packets, size_t count)
+{
+    size_t received = 0;
+
+    if (_rings)
+    {
+        while (received < count && !_rings->received.empty())
+        {
+            NetworkPacket packet = _rings->received.pop();
+
+            if (packet.buffer >= NETWORK_RECEIVE_BUFFERS || packet.length > NETWORK_FRAME_SIZE)
+            {
+                continue;
+            }
+
+            packets[received++] = packet;
+        }
+
+        return received;
+    }
+
+    while (received < count && !_spares.empty() && readable())
+    {
+        uint16_t buffer = _spares.pop_back();
+
+        size_t length = stream_read(_stream, frame(buffer), NETWORK_FRAME_SIZE);
+
+        if (handle_has_error(_stream) || length == 0)
+        {
+            _spares.push_back(buffer);
+            break;
+        }
+
+        packets[received++] = {buffer, (uint16_t)length};
+    }
+
+    return received;
+}
+
+void Device::release(uint16_t buffer)
+{
+    if (_rings)
+    {
+        _rings->refill.push({buffer, 0});
+        _kick = true;
+    }
+    else
+    {
+        _spares.push_back(buffer);
+    }
+}
+
+bool Device::allocate(uint16_t &buffer)
+{
+    if (!_spares.empty())
+    {
+        buffer = _spares.pop_back();
+        return true;
+    }
+
+    if (!_rings)
+    {
+        return false;
+    }
+
+    if (_rings->completed.empty())
+    {
+        // Sent buffers are given back when the driver is kicked.
+        stream_call(_stream, IOCALL_NETWORK_KICK, nullptr);
+        _kick = false;
+    }
+
+    while (!_rings->completed.empty())
+    {
+        NetworkPacket packet = _rings->completed.pop();
+
+        if (packet.buffer >= NETWORK_RECEIVE_BUFFERS && packet.buffer < NETWORK_BUFFER_COUNT)
+        {
+            buffer = packet.buffer;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Device::free(uint16_t buffer)
+{
+    _spares.push_back(buffer);
+}
+
+void Device::transmit(uint16_t buffer, size_t length)
+{
+    if (_rings)
+    {
+        _rings->transmit.push({buffer, (uint16_t)length});
+        _kick = true;
+    }
+    else
+    {
+        stream_write(_stream, frame(buffer), length);
+
+        if (handle_has_error(_stream))
+        {
+            logger_warn("Failed to send a frame: %s", handle_error_string(_stream));
+        }
+
+        _spares.push_back(buffer);
+    }
+}
+
+void Device::flush()
+{
+    if (_kick)
+    {
+        stream_call(_stream, IOCALL_NETWORK_KICK, nullptr);
+        _kick = false;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <abi/Network.h>
+
+#include <libsystem/io/Stream.h>
+#include <libutils/OwnPtr.h>
+#include <libutils/Vector.h>
+
+// Frames are handled in place, in a pool of NETWORK_BUFFER_COUNT buffers
+// laid out like the shared rings of abi/Network.h. When the device has
+// rings, the pool is the one the driver fills and sends from. Otherwise
+// the daemon owns it and moves frames with read() and write().
+class Device
+{
+private:
+    Stream *_stream = nullptr;
+    MacAddress _mac_address = {};
+
+    uintptr_t _rings_address = 0;
+    NetworkRings *_rings = nullptr;
+    uint8_t *_buffers = nullptr;
+
+    // Transmit buffers taken but not sent, all of the buffers not in use
+    // without rings.
+    Vector<uint16_t> _spares{};
+
+    bool _kick = false;
+
+    bool readable();
+
+public:
+    bool shared_rings() { return _rings != nullptr; }
+
+    MacAddress mac_address() { return _mac_address; }
+
+    Stream *stream() { return _stream; }
+
+    static OwnPtr<Device> open(const char *path);
+
+    Device(Stream *stream, MacAddress mac_address);
+
+    ~Device();
+
+    uint8_t *frame(uint16_t buffer)
+    {
+        return _buffers + buffer * NETWORK_BUFFER_SIZE + NETWORK_BUFFER_HEADROOM;
+    }
+
+    // Takes at most `count` received frames, each must be released.
+    size_t receive(NetworkPacket *packets, size_t count);
+
+    void release(uint16_t buffer);
+
+    // A buffer to build a frame in, it goes back with transmit() or free().
+    bool allocate(uint16_t &buffer);
+
+    void free(uint16_t buffer);
+
+    void transmit(uint16_t buffer, size_t length);
+
+    // Lets the driver know about everything done since the last time,
+    // once for a whole batch.
+    void flush();
+};
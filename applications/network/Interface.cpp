@@ -0,0 +1,518 @@
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/network/ARP.h>
+#include <libsystem/network/ICMP.h>
+#include <libsystem/system/System.h>
+
+#include "network/Interface.h"
+#include "network/TCP.h"
+#include "network/UDP.h"
+
+struct ARPPending
+{
+    uint16_t buffer;
+    uint16_t length;
+};
+
+// An entry with an empty address is free. Until it is resolved, `expire`
+// is when the request is sent again.
+struct ARPEntry
+{
+    IPv4Address address;
+    MacAddress mac_address;
+    bool resolved;
+    TimeStamp expire;
+    int retries;
+
+    ARPPending pending[ARP_MAX_PENDING];
+    size_t pending_count;
+};
+
+static OwnPtr<Device> _device;
+static NetworkConfiguration _configuration = {};
+static ARPEntry _arp_cache[ARP_CACHE_SIZE] = {};
+static uint16_t _identification = 0;
+
+void interface_initialize(OwnPtr<Device> device)
+{
+    _device = device;
+
+    _configuration.mac_address = _device->mac_address();
+    _configuration.shared_rings = _device->shared_rings();
+}
+
+Device &interface_device()
+{
+    return *_device;
+}
+
+NetworkConfiguration &interface_configuration()
+{
+    return _configuration;
+}
+
+bool interface_configured()
+{
+    return _configuration.configured;
+}
+
+IPv4Address interface_address()
+{
+    return _configuration.address;
+}
+
+void interface_configure(IPv4Address address, IPv4Address netmask, IPv4Address gateway, IPv4Address dns, uint32_t lease)
+{
+    _configuration.configured = true;
+    _configuration.address = address;
+    _configuration.netmask = netmask;
+    _configuration.gateway = gateway;
+    _configuration.dns = dns;
+    _configuration.lease = lease;
+
+    logger_info("Configured %d.%d.%d.%d/%d.%d.%d.%d via %d.%d.%d.%d",
+                address[0], address[1], address[2], address[3],
+                netmask[0], netmask[1], netmask[2], netmask[3],
+                gateway[0], gateway[1], gateway[2], gateway[3]);
+}
+
+void interface_unconfigure()
+{
+    _configuration.configured = false;
+    _configuration.address = IPV4_ANY;
+    _configuration.netmask = IPV4_ANY;
+    _configuration.gateway = IPV4_ANY;
+    _configuration.dns = IPV4_ANY;
+    _configuration.lease = 0;
+}
+
+static void transmit(uint16_t buffer, size_t length)
+{
+    _device->transmit(buffer, length);
+    _configuration.transmitted++;
+}
+
+/* --- ARP ------------------------------------------------------------------ */
+
+static ARPEntry *arp_find(IPv4Address address)
+{
+    for (size_t i = 0; i < ARP_CACHE_SIZE; i++)
+    {
+        if (!_arp_cache[i].address.empty() && _arp_cache[i].address == address)
+        {
+            return &_arp_cache[i];
+        }
+    }
+
+    return nullptr;
+}
+
+static void arp_forget(ARPEntry &entry)
+{
+    for (size_t i = 0; i < entry.pending_count; i++)
+    {
+        _device->free(entry.pending[i].buffer);
+        _configuration.dropped++;
+    }
+
+    entry = {};
+}
+
+// Takes a free entry, or the one closest to expiring.
+static ARPEntry &arp_insert(IPv4Address address)
+{
+    ARPEntry *victim = &_arp_cache[0];
+
+    for (size_t i = 0; i < ARP_CACHE_SIZE; i++)
+    {
+        if (_arp_cache[i].address.empty())
+        {
+            victim = &_arp_cache[i];
+            break;
+        }
+
+        if (_arp_cache[i].expire < victim->expire)
+        {
+            victim = &_arp_cache[i];
+        }
+    }
+
+    arp_forget(*victim);
+    victim->address = address;
+
+    return *victim;
+}
+
+static void arp_send(uint16_t operation, MacAddress target_hardware, IPv4Address target)
+{
+    uint16_t buffer;
+
+    if (!_device->allocate(buffer))
+    {
+        return;
+    }
+
+    uint8_t *frame = _device->frame(buffer);
+
+    auto ethernet = reinterpret_cast<EthernetHeader *>(frame);
+    ethernet->destination = operation == ARP_OPERATION_REQUEST ? ETHERNET_BROADCAST : target_hardware;
+    ethernet->source = _device->mac_address();
+    ethernet->type = ETHERNET_TYPE_ARP;
+
+    auto arp = reinterpret_cast<ARPPacket *>(frame + sizeof(EthernetHeader));
+    arp->hardware_type = ARP_HARDWARE_ETHERNET;
+    arp->protocol_type = ETHERNET_TYPE_IPV4;
+    arp->hardware_size = sizeof(MacAddress);
+    arp->protocol_size = sizeof(IPv4Address);
+    arp->operation = operation;
+    arp->sender_hardware = _device->mac_address();
+    arp->sender_protocol = _configuration.address;
+    arp->target_hardware = target_hardware;
+    arp->target_protocol = target;
+
+    // Short frames are padded by the device.
+    transmit(buffer, sizeof(EthernetHeader) + sizeof(ARPPacket));
+}
+
+static void arp_resolved(ARPEntry &entry, MacAddress mac_address)
+{
+    entry.mac_address = mac_address;
+    entry.resolved = true;
+    entry.expire = system_get_ticks() + ARP_CACHE_LIFETIME;
+
+    for (size_t i = 0; i < entry.pending_count; i++)
+    {
+        auto ethernet = reinterpret_cast<EthernetHeader *>(_device->frame(entry.pending[i].buffer));
+        ethernet->destination = mac_address;
+
+        transmit(entry.pending[i].buffer, entry.pending[i].length);
+    }
+
+    entry.pending_count = 0;
+}
+
+static void arp_receive(const uint8_t *data, size_t size)
+{
+    if (size < sizeof(ARPPacket))
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    auto arp = reinterpret_cast<const ARPPacket *>(data);
+
+    if (arp->hardware_type() != ARP_HARDWARE_ETHERNET ||
+        arp->protocol_type() != ETHERNET_TYPE_IPV4 ||
+        arp->hardware_size != sizeof(MacAddress) ||
+        arp->protocol_size != sizeof(IPv4Address) ||
+        arp->sender_protocol.empty())
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    // Merge first, as RFC 826 says, then learn about whoever is asking for us.
+    ARPEntry *entry = arp_find(arp->sender_protocol);
+
+    bool for_us = _configuration.configured && arp->target_protocol == _configuration.address;
+
+    if (!entry && for_us)
+    {
+        entry = &arp_insert(arp->sender_protocol);
+    }
+
+    if (entry)
+    {
+        arp_resolved(*entry, arp->sender_hardware);
+    }
+
+    if (for_us && arp->operation() == ARP_OPERATION_REQUEST)
+    {
+        arp_send(ARP_OPERATION_REPLY, arp->sender_hardware, arp->sender_protocol);
+    }
+}
+
+/* --- IPv4 ----------------------------------------------------------------- */
+
+uint8_t *interface_ipv4_payload(uint16_t buffer)
+{
+    return _device->frame(buffer) + INTERFACE_IPV4_HEADROOM;
+}
+
+static bool is_broadcast(IPv4Address address)
+{
+    if (address == IPV4_BROADCAST)
+    {
+        return true;
+    }
+
+    uint32_t host_mask = ~_configuration.netmask.value();
+
+    return _configuration.configured &&
+           host_mask != 0 &&
+           (address.value() & host_mask) == host_mask &&
+           (address.value() & ~host_mask) == (_configuration.address.value() & ~host_mask);
+}
+
+static IPv4Address next_hop(IPv4Address destination)
+{
+    uint32_t netmask = _configuration.netmask.value();
+
+    if ((destination.value() & netmask) == (_configuration.address.value() & netmask))
+    {
+        return destination;
+    }
+
+    return _configuration.gateway;
+}
+
+Result interface_ipv4_send(uint16_t buffer, IPv4Address source, IPv4Address destination, uint8_t protocol, size_t size)
+{
+    if (size > INTERFACE_IPV4_MTU)
+    {
+        _device->free(buffer);
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    uint8_t *frame = _device->frame(buffer);
+
+    auto ip = reinterpret_cast<IPv4Header *>(frame + sizeof(EthernetHeader));
+    ip->version_and_length = (IPV4_VERSION << 4) | (sizeof(IPv4Header) / 4);
+    ip->service = 0;
+    ip->total_length = sizeof(IPv4Header) + size;
+    ip->identification = _identification++;
+    ip->fragment = IPV4_FLAG_DONT_FRAGMENT;
+    ip->ttl = IPV4_DEFAULT_TTL;
+    ip->protocol = protocol;
+    ip->checksum = 0;
+    ip->source = source;
+    ip->destination = destination;
+    ip->checksum = checksum(ip, sizeof(IPv4Header));
+
+    auto ethernet = reinterpret_cast<EthernetHeader *>(frame);
+    ethernet->source = _device->mac_address();
+    ethernet->type = ETHERNET_TYPE_IPV4;
+
+    size_t length = INTERFACE_IPV4_HEADROOM + size;
+
+    if (is_broadcast(destination))
+    {
+        ethernet->destination = ETHERNET_BROADCAST;
+        transmit(buffer, length);
+
+        return SUCCESS;
+    }
+
+    IPv4Address hop = _configuration.configured ? next_hop(destination) : IPV4_ANY;
+
+    if (hop.empty())
+    {
+        _device->free(buffer);
+        return ERR_NETWORK_UNREACHABLE;
+    }
+
+    ARPEntry *entry = arp_find(hop);
+
+    if (entry && entry->resolved)
+    {
+        ethernet->destination = entry->mac_address;
+        transmit(buffer, length);
+
+        return SUCCESS;
+    }
+
+    if (!entry)
+    {
+        entry = &arp_insert(hop);
+        entry->expire = system_get_ticks() + ARP_RETRY_INTERVAL;
+
+        arp_send(ARP_OPERATION_REQUEST, {}, hop);
+    }
+
+    if (entry->pending_count == ARP_MAX_PENDING)
+    {
+        // As if it was lost on the way.
+        _device->free(buffer);
+        _configuration.dropped++;
+
+        return SUCCESS;
+    }
+
+    entry->pending[entry->pending_count++] = {buffer, (uint16_t)length};
+
+    return SUCCESS;
+}
+
+static void icmp_receive(const IPv4Header &ip, const uint8_t *data, size_t size)
+{
+    if (size < sizeof(ICMPHeader) || size > INTERFACE_IPV4_MTU || checksum(data, size) != 0)
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    auto icmp = reinterpret_cast<const ICMPHeader *>(data);
+
+    if (icmp->type != ICMP_ECHO_REQUEST || !_configuration.configured || is_broadcast(ip.destination))
+    {
+        return;
+    }
+
+    uint16_t buffer;
+
+    if (!_device->allocate(buffer))
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    uint8_t *payload = interface_ipv4_payload(buffer);
+    memcpy(payload, data, size);
+
+    auto reply = reinterpret_cast<ICMPHeader *>(payload);
+    reply->type = ICMP_ECHO_REPLY;
+    reply->checksum = 0;
+    reply->checksum = checksum(payload, size);
+
+    interface_ipv4_send(buffer, _configuration.address, ip.source, IPV4_PROTOCOL_ICMP, size);
+}
+
+static void ipv4_receive(const uint8_t *data, size_t size)
+{
+    auto ip = reinterpret_cast<const IPv4Header *>(data);
+
+    if (size < sizeof(IPv4Header) ||
+        ip->version() != IPV4_VERSION ||
+        ip->header_size() < sizeof(IPv4Header) ||
+        ip->header_size() > size ||
+        ip->total_length() < ip->header_size() ||
+        ip->total_length() > size ||
+        checksum(ip, ip->header_size()) != 0)
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    // Nothing sent from here is fragmented, and nobody fragments on the
+    // way to a local network.
+    if (ip->fragment() & (IPV4_FLAG_MORE_FRAGMENTS | IPV4_FRAGMENT_OFFSET))
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    // Until there is an address, DHCP replies may be sent to the one offered.
+    if (_configuration.configured &&
+        ip->destination != _configuration.address &&
+        !is_broadcast(ip->destination))
+    {
+        return;
+    }
+
+    const uint8_t *payload = data + ip->header_size();
+    size_t payload_size = ip->total_length() - ip->header_size();
+
+    switch (ip->protocol)
+    {
+    case IPV4_PROTOCOL_ICMP:
+        icmp_receive(*ip, payload, payload_size);
+        break;
+
+    case IPV4_PROTOCOL_UDP:
+        udp_receive(*ip, payload, payload_size);
+        break;
+
+    case IPV4_PROTOCOL_TCP:
+        tcp_receive(*ip, payload, payload_size);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* --- Ethernet ------------------------------------------------------------- */
+
+static void ethernet_receive(const uint8_t *frame, size_t length)
+{
+    if (length < sizeof(EthernetHeader))
+    {
+        _configuration.dropped++;
+        return;
+    }
+
+    auto ethernet = reinterpret_cast<const EthernetHeader *>(frame);
+
+    if (!mac_address_equals(ethernet->destination, _device->mac_address()) &&
+        !mac_address_equals(ethernet->destination, ETHERNET_BROADCAST))
+    {
+        return;
+    }
+
+    const uint8_t *data = frame + sizeof(EthernetHeader);
+    size_t size = length - sizeof(EthernetHeader);
+
+    switch (ethernet->type())
+    {
+    case ETHERNET_TYPE_ARP:
+        arp_receive(data, size);
+        break;
+
+    case ETHERNET_TYPE_IPV4:
+        ipv4_receive(data, size);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void interface_poll()
+{
+    NetworkPacket packets[INTERFACE_BATCH_SIZE];
+
+    size_t count = _device->receive(packets, INTERFACE_BATCH_SIZE);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ethernet_receive(_device->frame(packets[i].buffer), packets[i].length);
+        _device->release(packets[i].buffer);
+    }
+
+    if (count > 0)
+    {
+        _configuration.received += count;
+        _configuration.batches++;
+    }
+}
+
+void interface_flush()
+{
+    tcp_flush();
+
+    _device->flush();
+}
+
+void interface_tick(TimeStamp now)
+{
+    for (size_t i = 0; i < ARP_CACHE_SIZE; i++)
+    {
+        ARPEntry &entry = _arp_cache[i];
+
+        if (entry.address.empty() || now < entry.expire)
+        {
+            continue;
+        }
+
+        if (entry.resolved || entry.retries == ARP_MAX_RETRIES)
+        {
+            arp_forget(entry);
+            continue;
+        }
+
+        entry.retries++;
+        entry.expire = now + ARP_RETRY_INTERVAL;
+
+        arp_send(ARP_OPERATION_REQUEST, {}, entry.address);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <libsystem/Time.h>
+#include <libsystem/network/Ethernet.h>
+#include <libsystem/network/IPv4.h>
+#include <libsystem/network/NetworkProtocol.h>
+
+#include "network/Device.h"
+
+// Frames taken from the device each time it is readable, the replies
+// they cause are sent together at the end of the batch.
+#define INTERFACE_BATCH_SIZE (64)
+
+#define INTERFACE_IPV4_HEADROOM (sizeof(EthernetHeader) + sizeof(IPv4Header))
+#define INTERFACE_IPV4_MTU (ETHERNET_MTU - sizeof(IPv4Header))
+
+#define ARP_CACHE_SIZE (32)
+#define ARP_CACHE_LIFETIME (5 * 60 * 1000)
+#define ARP_RETRY_INTERVAL (1000)
+#define ARP_MAX_RETRIES (3)
+
+// Packets kept for a neighbour while its address is being resolved.
+#define ARP_MAX_PENDING (8)
+
+void interface_initialize(OwnPtr<Device> device);
+
+Device &interface_device();
+
+NetworkConfiguration &interface_configuration();
+
+bool interface_configured();
+
+IPv4Address interface_address();
+
+void interface_configure(IPv4Address address, IPv4Address netmask, IPv4Address gateway, IPv4Address dns, uint32_t lease);
+
+void interface_unconfigure();
+
+// Processes a batch of received frames, what they cause is held back
+// until interface_flush().
+void interface_poll();
+
+// Sends what the batch caused and lets the device know, once for all of it.
+void interface_flush();
+
+void interface_tick(TimeStamp now);
+
+// Upper layers build their packets in place, behind the room left for the
+// Ethernet and IPv4 headers.
+uint8_t *interface_ipv4_payload(uint16_t buffer);
+
+// Sends `size` bytes of payload from a buffer given by the device, the
+// buffer is consumed whatever happens.
+Result interface_ipv4_send(uint16_t buffer, IPv4Address source, IPv4Address destination, uint8_t protocol, size_t size);
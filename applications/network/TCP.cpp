@@ -0,0 +1,1688 @@
+#include <libsystem/Logger.h>
+#include <libsystem/system/Random.h>
+#include <libsystem/system/System.h>
+
+#include "network/Interface.h"
+#include "network/TCP.h"
+
+struct TCPOptions
+{
+    uint16_t mss = 0;
+    int window_scale = -1;
+    bool sack_permitted = false;
+    TCPRange sack[TCP_MAX_SACK_BLOCKS] = {};
+    size_t sack_count = 0;
+};
+
+struct TCPSegment
+{
+    uint32_t sequence;
+    uint32_t acknowledgment;
+    uint8_t flags;
+    uint16_t window;
+    TCPOptions options;
+
+    const uint8_t *payload;
+    size_t size;
+};
+
+static Vector<TCPSocket *> _sockets{};
+
+static bool _random_initialized = false;
+static Random _random = {};
+
+static uint16_t _next_ephemeral_port = TCP_EPHEMERAL_FIRST;
+
+static bool before(uint32_t left, uint32_t right)
+{
+    return tcp_sequence_before(left, right);
+}
+
+static bool before_or_equal(uint32_t left, uint32_t right)
+{
+    return tcp_sequence_before_or_equal(left, right);
+}
+
+static uint32_t read32(const uint8_t *bytes)
+{
+    return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static void write32(uint8_t *bytes, uint32_t value)
+{
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+/* --- Sockets -------------------------------------------------------------- */
+
+static uint32_t tcp_initial_sequence()
+{
+    if (!_random_initialized)
+    {
+        _random = random_create();
+        _random_initialized = true;
+    }
+
+    return random_uint32(&_random);
+}
+
+// Just enough for the whole receive buffer to be advertised.
+static uint8_t tcp_window_shift()
+{
+    uint8_t shift = 0;
+
+    while ((TCP_RECEIVE_BUFFER_SIZE >> shift) > 0xffff && shift < TCP_MAX_WINDOW_SCALE)
+    {
+        shift++;
+    }
+
+    return shift;
+}
+
+static bool tcp_port_in_use(uint16_t port)
+{
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        TCPSocket *socket = _sockets[i];
+
+        if (socket->local.port == port &&
+            socket->state != TCP_TIME_WAIT &&
+            (socket->state != TCP_CLOSED || socket->owned))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint16_t tcp_ephemeral_port()
+{
+    for (size_t i = TCP_EPHEMERAL_FIRST; i <= 0xffff; i++)
+    {
+        uint16_t port = _next_ephemeral_port;
+
+        _next_ephemeral_port = port == 0xffff ? TCP_EPHEMERAL_FIRST : port + 1;
+
+        if (!tcp_port_in_use(port))
+        {
+            return port;
+        }
+    }
+
+    return 0;
+}
+
+static TCPSocket *tcp_find(uint16_t local_port, NetworkEndpoint remote)
+{
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        TCPSocket *socket = _sockets[i];
+
+        if (socket->state != TCP_CLOSED &&
+            socket->state != TCP_LISTEN &&
+            socket->local.port == local_port &&
+            socket->remote.port == remote.port &&
+            socket->remote.address == remote.address)
+        {
+            return socket;
+        }
+    }
+
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        TCPSocket *socket = _sockets[i];
+
+        if (socket->state == TCP_LISTEN && socket->local.port == local_port)
+        {
+            return socket;
+        }
+    }
+
+    return nullptr;
+}
+
+static void tcp_collect()
+{
+    for (size_t i = _sockets.count(); i > 0; i--)
+    {
+        TCPSocket *socket = _sockets[i - 1];
+
+        if (socket->state == TCP_CLOSED && !socket->owned)
+        {
+            _sockets.remove_index(i - 1);
+            delete socket;
+        }
+    }
+}
+
+/* --- Output --------------------------------------------------------------- */
+
+static size_t tcp_options_size(TCPSocket *socket)
+{
+    if (socket->sack_permitted && socket->out_of_order_count > 0)
+    {
+        return 4 + 8 * socket->out_of_order_count;
+    }
+
+    return 0;
+}
+
+// The MSS doesn't account for options, the data makes room for them.
+static size_t tcp_segment_capacity(TCPSocket *socket)
+{
+    return socket->send_mss - tcp_options_size(socket);
+}
+
+static size_t tcp_build_options(TCPSocket *socket, uint8_t flags, uint8_t *options)
+{
+    size_t size = 0;
+
+    if (flags & TCP_SYN)
+    {
+        options[size++] = TCP_OPTION_MSS;
+        options[size++] = 4;
+        options[size++] = TCP_MSS >> 8;
+        options[size++] = TCP_MSS & 0xff;
+
+        // Offered on a SYN, only agreed to on a SYN-ACK.
+        bool offer = !(flags & TCP_ACK);
+
+        if (offer || socket->window_scaling)
+        {
+            options[size++] = TCP_OPTION_NOP;
+            options[size++] = TCP_OPTION_WINDOW_SCALE;
+            options[size++] = 3;
+            options[size++] = socket->receive_scale;
+        }
+
+        if (offer || socket->sack_permitted)
+        {
+            options[size++] = TCP_OPTION_NOP;
+            options[size++] = TCP_OPTION_NOP;
+            options[size++] = TCP_OPTION_SACK_PERMITTED;
+            options[size++] = 2;
+        }
+    }
+    else if (tcp_options_size(socket) > 0)
+    {
+        options[size++] = TCP_OPTION_NOP;
+        options[size++] = TCP_OPTION_NOP;
+        options[size++] = TCP_OPTION_SACK;
+        options[size++] = 2 + 8 * socket->out_of_order_count;
+
+        for (size_t i = 0; i < socket->out_of_order_count; i++)
+        {
+            write32(options + size, socket->out_of_order[i].start);
+            write32(options + size + 4, socket->out_of_order[i].end);
+            size += 8;
+        }
+    }
+
+    return size;
+}
+
+static bool tcp_transmit(
+    NetworkEndpoint local,
+    NetworkEndpoint remote,
+    uint32_t sequence,
+    uint32_t acknowledgment,
+    uint8_t flags,
+    uint16_t window,
+    const uint8_t *options,
+    size_t options_size,
+    const TCPBuffer *data,
+    size_t offset,
+    size_t size)
+{
+    uint16_t buffer;
+
+    if (!interface_device().allocate(buffer))
+    {
+        return false;
+    }
+
+    uint8_t *payload = interface_ipv4_payload(buffer);
+
+    auto header = reinterpret_cast<TCPHeader *>(payload);
+    header->source_port = local.port;
+    header->destination_port = remote.port;
+    header->sequence = sequence;
+    header->acknowledgment = acknowledgment;
+    header->data_offset = ((sizeof(TCPHeader) + options_size) / 4) << 4;
+    header->flags = flags;
+    header->window = window;
+    header->checksum = 0;
+    header->urgent = 0;
+
+    memcpy(payload + sizeof(TCPHeader), options, options_size);
+
+    if (size > 0)
+    {
+        data->read(offset, payload + sizeof(TCPHeader) + options_size, size);
+    }
+
+    size_t length = sizeof(TCPHeader) + options_size + size;
+
+    uint32_t sum = ipv4_pseudo_header_sum(local.address, remote.address, IPV4_PROTOCOL_TCP, length);
+    header->checksum = checksum_finalize(checksum_add(sum, payload, length));
+
+    return interface_ipv4_send(buffer, local.address, remote.address, IPV4_PROTOCOL_TCP, length) == SUCCESS;
+}
+
+static uint16_t tcp_advertise(TCPSocket *socket, bool syn)
+{
+    uint32_t window = socket->receive_buffer.available();
+
+    // The window of a SYN is never scaled.
+    if (syn)
+    {
+        window = MIN(window, 0xffffu);
+        socket->advertised_edge = socket->receive_next + window;
+
+        return window;
+    }
+
+    window = MIN(window >> socket->receive_scale, 0xffffu);
+    socket->advertised_edge = socket->receive_next + (window << socket->receive_scale);
+
+    return window;
+}
+
+// A segment of the connection, its data is in the send buffer at `sequence`.
+static void tcp_segment(TCPSocket *socket, uint32_t sequence, uint8_t flags, size_t size)
+{
+    if (socket->state != TCP_SYN_SENT)
+    {
+        flags |= TCP_ACK;
+    }
+
+    uint8_t options[TCP_MAX_OPTIONS_SIZE];
+    size_t options_size = tcp_build_options(socket, flags, options);
+
+    uint16_t window = tcp_advertise(socket, flags & TCP_SYN);
+
+    tcp_transmit(
+        socket->local,
+        socket->remote,
+        sequence,
+        (flags & TCP_ACK) ? socket->receive_next : 0,
+        flags,
+        window,
+        options,
+        options_size,
+        &socket->send_buffer,
+        sequence - socket->send_unacknowledged,
+        size);
+
+    socket->ack_pending = false;
+}
+
+static void tcp_acknowledge(TCPSocket *socket)
+{
+    tcp_segment(socket, socket->send_next, TCP_ACK, 0);
+}
+
+// Answers a segment nobody expects.
+static void tcp_reset(NetworkEndpoint local, NetworkEndpoint remote, const TCPSegment &segment)
+{
+    if (segment.flags & TCP_RST)
+    {
+        return;
+    }
+
+    if (segment.flags & TCP_ACK)
+    {
+        tcp_transmit(local, remote, segment.acknowledgment, 0, TCP_RST, 0, nullptr, 0, nullptr, 0, 0);
+    }
+    else
+    {
+        uint32_t length = segment.size + !!(segment.flags & TCP_SYN) + !!(segment.flags & TCP_FIN);
+        tcp_transmit(local, remote, 0, segment.sequence + length, TCP_RST | TCP_ACK, 0, nullptr, 0, nullptr, 0, 0);
+    }
+}
+
+static void tcp_arm(TCPSocket *socket)
+{
+    if (!socket->retransmit_at)
+    {
+        socket->retransmit_at = system_get_ticks() + socket->rto;
+    }
+}
+
+static void tcp_drop(TCPSocket *socket, Result error)
+{
+    if (socket->listener)
+    {
+        socket->listener->accept_queue.remove_value(socket);
+        socket->listener = nullptr;
+    }
+
+    socket->state = TCP_CLOSED;
+    socket->error = error;
+    socket->retransmit_at = 0;
+    socket->linger_until = 0;
+}
+
+static void tcp_abort(TCPSocket *socket, Result error)
+{
+    tcp_transmit(socket->local, socket->remote, socket->send_next, 0, TCP_RST, 0, nullptr, 0, nullptr, 0, 0);
+    tcp_drop(socket, error);
+}
+
+static void tcp_linger(TCPSocket *socket, Timeout timeout)
+{
+    socket->retransmit_at = 0;
+    socket->linger_until = system_get_ticks() + timeout;
+}
+
+// Moves `sequence` past what the peer already has, and tells where the
+// next range it has starts.
+static uint32_t tcp_skip_sacked(TCPSocket *socket, uint32_t sequence, uint32_t *next_sacked)
+{
+    bool moved = true;
+
+    while (moved)
+    {
+        moved = false;
+
+        for (size_t i = 0; i < socket->scoreboard_count; i++)
+        {
+            TCPRange range = socket->scoreboard[i];
+
+            if (before_or_equal(range.start, sequence) && before(sequence, range.end))
+            {
+                sequence = range.end;
+                moved = true;
+            }
+        }
+    }
+
+    *next_sacked = socket->send_unacknowledged + socket->send_buffer.used();
+
+    for (size_t i = 0; i < socket->scoreboard_count; i++)
+    {
+        if (before(sequence, socket->scoreboard[i].start) && before(socket->scoreboard[i].start, *next_sacked))
+        {
+            *next_sacked = socket->scoreboard[i].start;
+        }
+    }
+
+    return sequence;
+}
+
+static bool tcp_can_output(TCPSocket *socket)
+{
+    return socket->state == TCP_ESTABLISHED ||
+           socket->state == TCP_CLOSE_WAIT ||
+           socket->state == TCP_FIN_WAIT_1 ||
+           socket->state == TCP_CLOSING ||
+           socket->state == TCP_LAST_ACK;
+}
+
+// Sends as much as the windows allow, skipping what the peer told it has.
+// A probe sends a byte into a closed window.
+static void tcp_output(TCPSocket *socket, bool probe = false)
+{
+    if (!tcp_can_output(socket))
+    {
+        if (socket->ack_pending && (socket->state == TCP_FIN_WAIT_2 || socket->state == TCP_TIME_WAIT))
+        {
+            tcp_acknowledge(socket);
+        }
+
+        return;
+    }
+
+    uint32_t data_end = socket->send_unacknowledged + socket->send_buffer.used();
+    uint32_t congestion_window = socket->congestion_window;
+
+    // RFC 3042, the first duplicate acknowledgments each let a new segment
+    // out so there is enough after a loss to tell about it.
+    if (!socket->recovering)
+    {
+        congestion_window += MIN(socket->duplicate_acks, 2) * socket->send_mss;
+    }
+
+    uint32_t window = MIN(socket->send_window, congestion_window);
+
+    if (probe)
+    {
+        window = MAX(window, 1u);
+    }
+
+    uint32_t window_end = socket->send_unacknowledged + window;
+
+    while (before(socket->send_next, data_end))
+    {
+        uint32_t next_sacked;
+        socket->send_next = tcp_skip_sacked(socket, socket->send_next, &next_sacked);
+
+        if (!before(socket->send_next, data_end) || !before(socket->send_next, window_end))
+        {
+            break;
+        }
+
+        uint32_t sequence = socket->send_next;
+
+        size_t size = MIN(data_end - sequence, tcp_segment_capacity(socket));
+        size = MIN(size, window_end - sequence);
+
+        if (before(next_sacked, sequence + size))
+        {
+            size = next_sacked - sequence;
+        }
+
+        // No tiny segment because of the window while others are in flight,
+        // the acknowledgments will open it.
+        if (size < tcp_segment_capacity(socket) &&
+            size < data_end - sequence &&
+            sequence != socket->send_unacknowledged)
+        {
+            break;
+        }
+
+        uint8_t flags = 0;
+
+        if (sequence + size == data_end)
+        {
+            flags |= TCP_PSH;
+
+            if (socket->fin_queued)
+            {
+                flags |= TCP_FIN;
+                socket->fin_sent = true;
+            }
+        }
+
+        if (!socket->timing && sequence == socket->send_max)
+        {
+            socket->timing = true;
+            socket->timed_sequence = sequence;
+            socket->timed_since = system_get_ticks();
+        }
+
+        tcp_segment(socket, sequence, flags, size);
+
+        socket->send_next = sequence + size + !!(flags & TCP_FIN);
+
+        if (before(socket->send_max, socket->send_next))
+        {
+            socket->send_max = socket->send_next;
+        }
+
+        tcp_arm(socket);
+    }
+
+    if (socket->fin_queued && socket->send_next == data_end)
+    {
+        tcp_segment(socket, data_end, TCP_FIN, 0);
+
+        socket->fin_sent = true;
+        socket->send_next = data_end + 1;
+
+        if (before(socket->send_max, socket->send_next))
+        {
+            socket->send_max = socket->send_next;
+        }
+
+        tcp_arm(socket);
+    }
+
+    if (socket->ack_pending)
+    {
+        tcp_acknowledge(socket);
+    }
+}
+
+/* --- Loss recovery -------------------------------------------------------- */
+
+static void tcp_scoreboard_add(TCPSocket *socket, TCPRange range)
+{
+    if (before(range.start, socket->send_unacknowledged))
+    {
+        range.start = socket->send_unacknowledged;
+    }
+
+    if (before(socket->send_max, range.end))
+    {
+        range.end = socket->send_max;
+    }
+
+    if (!before(range.start, range.end))
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < socket->scoreboard_count;)
+    {
+        TCPRange other = socket->scoreboard[i];
+
+        if (before(range.end, other.start) || before(other.end, range.start))
+        {
+            i++;
+            continue;
+        }
+
+        range.start = before(other.start, range.start) ? other.start : range.start;
+        range.end = before(range.end, other.end) ? other.end : range.end;
+
+        socket->scoreboard[i] = socket->scoreboard[--socket->scoreboard_count];
+    }
+
+    if (socket->scoreboard_count == TCP_SCOREBOARD_SIZE)
+    {
+        // Forgetting the highest range only costs sending it again.
+        size_t highest = 0;
+
+        for (size_t i = 1; i < socket->scoreboard_count; i++)
+        {
+            if (before(socket->scoreboard[highest].start, socket->scoreboard[i].start))
+            {
+                highest = i;
+            }
+        }
+
+        if (before(socket->scoreboard[highest].start, range.start))
+        {
+            return;
+        }
+
+        socket->scoreboard[highest] = range;
+        return;
+    }
+
+    socket->scoreboard[socket->scoreboard_count++] = range;
+}
+
+static void tcp_scoreboard_trim(TCPSocket *socket)
+{
+    for (size_t i = 0; i < socket->scoreboard_count;)
+    {
+        TCPRange &range = socket->scoreboard[i];
+
+        if (before_or_equal(range.end, socket->send_unacknowledged))
+        {
+            range = socket->scoreboard[--socket->scoreboard_count];
+            continue;
+        }
+
+        if (before(range.start, socket->send_unacknowledged))
+        {
+            range.start = socket->send_unacknowledged;
+        }
+
+        i++;
+    }
+}
+
+static uint32_t tcp_sacked_bytes(TCPSocket *socket)
+{
+    uint32_t bytes = 0;
+
+    for (size_t i = 0; i < socket->scoreboard_count; i++)
+    {
+        bytes += socket->scoreboard[i].end - socket->scoreboard[i].start;
+    }
+
+    return bytes;
+}
+
+// Sends again the first hole below what the peer has, or the first segment
+// when it told nothing.
+static void tcp_retransmit_hole(TCPSocket *socket)
+{
+    uint32_t data_end = socket->send_unacknowledged + socket->send_buffer.used();
+    uint32_t highest = socket->send_unacknowledged + 1;
+
+    for (size_t i = 0; i < socket->scoreboard_count; i++)
+    {
+        if (before(highest, socket->scoreboard[i].end))
+        {
+            highest = socket->scoreboard[i].end;
+        }
+    }
+
+    uint32_t sequence = socket->send_unacknowledged;
+
+    if (before(sequence, socket->recovery_next))
+    {
+        sequence = socket->recovery_next;
+    }
+
+    uint32_t next_sacked;
+    sequence = tcp_skip_sacked(socket, sequence, &next_sacked);
+
+    if (!before(sequence, highest) || !before(sequence, data_end))
+    {
+        return;
+    }
+
+    size_t size = MIN(data_end - sequence, tcp_segment_capacity(socket));
+
+    if (before(next_sacked, sequence + size))
+    {
+        size = next_sacked - sequence;
+    }
+
+    tcp_segment(socket, sequence, sequence + size == data_end ? TCP_PSH : 0, size);
+
+    socket->recovery_next = sequence + size;
+    socket->timing = false;
+}
+
+static void tcp_enter_recovery(TCPSocket *socket)
+{
+    uint32_t flight = socket->send_max - socket->send_unacknowledged;
+
+    socket->slow_start_threshold = MAX(flight / 2, 2u * socket->send_mss);
+    socket->congestion_window = socket->slow_start_threshold + 3 * socket->send_mss;
+    socket->recovering = true;
+    socket->recovery_end = socket->send_max;
+    socket->recovery_next = socket->send_unacknowledged;
+
+    tcp_retransmit_hole(socket);
+}
+
+static void tcp_duplicate_ack(TCPSocket *socket)
+{
+    socket->duplicate_acks++;
+
+    if (socket->recovering)
+    {
+        socket->congestion_window += socket->send_mss;
+        tcp_retransmit_hole(socket);
+
+        return;
+    }
+
+    // RFC 5827, with less than four segments in flight and nothing new to
+    // send there is no third duplicate to wait for.
+    int threshold = 3;
+    uint32_t data_end = socket->send_unacknowledged + socket->send_buffer.used();
+
+    if (socket->send_max == data_end)
+    {
+        uint32_t in_flight = (socket->send_max - socket->send_unacknowledged + socket->send_mss - 1) / socket->send_mss;
+        threshold = clamp((int)in_flight - 1, 1, 3);
+    }
+
+    // With SACK, a loss shows as soon as enough came after it (RFC 6675).
+    if (socket->duplicate_acks >= threshold || tcp_sacked_bytes(socket) >= 3u * socket->send_mss)
+    {
+        tcp_enter_recovery(socket);
+    }
+}
+
+static void tcp_rtt_sample(TCPSocket *socket, uint32_t rtt)
+{
+    rtt = MAX(rtt, 1u);
+
+    if (socket->smoothed_rtt == 0)
+    {
+        socket->smoothed_rtt = rtt;
+        socket->rtt_variance = rtt / 2;
+    }
+    else
+    {
+        uint32_t delta = socket->smoothed_rtt > rtt ? socket->smoothed_rtt - rtt : rtt - socket->smoothed_rtt;
+
+        socket->rtt_variance = (3 * socket->rtt_variance + delta) / 4;
+        socket->smoothed_rtt = (7 * socket->smoothed_rtt + rtt) / 8;
+    }
+
+    socket->rto = socket->smoothed_rtt + MAX(4 * socket->rtt_variance, 1u);
+    socket->rto = MIN(MAX(socket->rto, (uint32_t)TCP_MIN_RTO), (uint32_t)TCP_MAX_RTO);
+}
+
+static void tcp_acknowledged(TCPSocket *socket, uint32_t acknowledgment)
+{
+    uint32_t acked = acknowledgment - socket->send_unacknowledged;
+
+    socket->send_buffer.consume(MIN(acked, socket->send_buffer.used()));
+    socket->send_unacknowledged = acknowledgment;
+
+    if (before(socket->send_next, acknowledgment))
+    {
+        socket->send_next = acknowledgment;
+    }
+
+    tcp_scoreboard_trim(socket);
+
+    if (socket->timing && before(socket->timed_sequence, acknowledgment))
+    {
+        tcp_rtt_sample(socket, system_get_ticks() - socket->timed_since);
+        socket->timing = false;
+    }
+
+    if (socket->recovering)
+    {
+        if (before(acknowledgment, socket->recovery_end))
+        {
+            // A partial acknowledgment, the next hole is lost too.
+            socket->congestion_window = socket->congestion_window > acked
+                                            ? socket->congestion_window - acked + socket->send_mss
+                                            : socket->send_mss;
+
+            tcp_retransmit_hole(socket);
+        }
+        else
+        {
+            socket->recovering = false;
+            socket->congestion_window = socket->slow_start_threshold;
+            socket->duplicate_acks = 0;
+        }
+    }
+    else
+    {
+        socket->duplicate_acks = 0;
+
+        // Counting bytes, a batch acknowledged at once grows the window as
+        // much as the segments acknowledged one by one.
+        if (socket->congestion_window < socket->slow_start_threshold)
+        {
+            socket->congestion_window += acked;
+        }
+        else
+        {
+            socket->avoidance_bytes += acked;
+
+            if (socket->avoidance_bytes >= socket->congestion_window)
+            {
+                socket->avoidance_bytes -= socket->congestion_window;
+                socket->congestion_window += socket->send_mss;
+            }
+        }
+
+        socket->congestion_window = MIN(socket->congestion_window, 4u * TCP_SEND_BUFFER_SIZE);
+    }
+
+    bool unsent = before(socket->send_next, socket->send_unacknowledged + socket->send_buffer.used());
+
+    socket->retransmit_at = 0;
+
+    // Something still in flight, or a closed window to probe.
+    if (socket->send_max != socket->send_unacknowledged || (unsent && socket->send_window == 0))
+    {
+        tcp_arm(socket);
+    }
+}
+
+static void tcp_timeout(TCPSocket *socket)
+{
+    socket->retransmit_at = 0;
+
+    if (++socket->retransmits > TCP_MAX_RETRANSMITS)
+    {
+        tcp_abort(socket, TIMEOUT);
+        return;
+    }
+
+    socket->rto = MIN(socket->rto * 2, (uint32_t)TCP_MAX_RTO);
+    socket->timing = false;
+
+    if (socket->state == TCP_SYN_SENT || socket->state == TCP_SYN_RECEIVED)
+    {
+        tcp_segment(socket, socket->send_initial, TCP_SYN, 0);
+        tcp_arm(socket);
+
+        return;
+    }
+
+    if (!tcp_can_output(socket))
+    {
+        return;
+    }
+
+    if (socket->send_max == socket->send_unacknowledged)
+    {
+        tcp_output(socket, true);
+        tcp_arm(socket);
+
+        return;
+    }
+
+    uint32_t flight = socket->send_max - socket->send_unacknowledged;
+
+    socket->slow_start_threshold = MAX(flight / 2, 2u * socket->send_mss);
+    socket->congestion_window = socket->send_mss;
+    socket->avoidance_bytes = 0;
+    socket->recovering = false;
+    socket->duplicate_acks = 0;
+
+    // RFC 2018, what the peer has may still be thrown away.
+    socket->scoreboard_count = 0;
+
+    socket->send_next = socket->send_unacknowledged;
+
+    if (socket->fin_sent && socket->send_buffer.used() == 0)
+    {
+        socket->fin_sent = false;
+    }
+
+    tcp_output(socket);
+    tcp_arm(socket);
+}
+
+/* --- Input ---------------------------------------------------------------- */
+
+static TCPOptions tcp_parse_options(const uint8_t *options, size_t size)
+{
+    TCPOptions result;
+
+    size_t i = 0;
+
+    while (i < size)
+    {
+        uint8_t kind = options[i];
+
+        if (kind == TCP_OPTION_END)
+        {
+            break;
+        }
+
+        if (kind == TCP_OPTION_NOP)
+        {
+            i++;
+            continue;
+        }
+
+        if (i + 1 >= size)
+        {
+            break;
+        }
+
+        uint8_t length = options[i + 1];
+
+        if (length < 2 || i + length > size)
+        {
+            break;
+        }
+
+        const uint8_t *value = options + i + 2;
+
+        if (kind == TCP_OPTION_MSS && length == 4)
+        {
+            result.mss = (value[0] << 8) | value[1];
+        }
+        else if (kind == TCP_OPTION_WINDOW_SCALE && length == 3)
+        {
+            result.window_scale = MIN(value[0], TCP_MAX_WINDOW_SCALE);
+        }
+        else if (kind == TCP_OPTION_SACK_PERMITTED && length == 2)
+        {
+            result.sack_permitted = true;
+        }
+        else if (kind == TCP_OPTION_SACK)
+        {
+            for (size_t j = 0; j + 8 <= (size_t)length - 2 && result.sack_count < TCP_MAX_SACK_BLOCKS; j += 8)
+            {
+                result.sack[result.sack_count++] = {read32(value + j), read32(value + j + 4)};
+            }
+        }
+
+        i += length;
+    }
+
+    return result;
+}
+
+// What a SYN tells about the peer.
+static void tcp_synchronize(TCPSocket *socket, const TCPSegment &segment)
+{
+    socket->receive_next = segment.sequence + 1;
+
+    socket->send_mss = segment.options.mss ? MIN(segment.options.mss, (uint16_t)TCP_MSS) : TCP_DEFAULT_MSS;
+    socket->send_mss = MAX(socket->send_mss, (uint16_t)64);
+
+    socket->window_scaling = segment.options.window_scale >= 0;
+    socket->send_scale = socket->window_scaling ? segment.options.window_scale : 0;
+    socket->receive_scale = socket->window_scaling ? tcp_window_shift() : 0;
+
+    socket->sack_permitted = segment.options.sack_permitted;
+
+    socket->congestion_window = TCP_INITIAL_WINDOW * socket->send_mss;
+}
+
+static void tcp_start(TCPSocket *socket)
+{
+    socket->send_initial = tcp_initial_sequence();
+    socket->send_unacknowledged = socket->send_initial;
+    socket->send_next = socket->send_initial + 1;
+    socket->send_max = socket->send_initial + 1;
+}
+
+static void tcp_listen_receive(TCPSocket *listener, NetworkEndpoint local, NetworkEndpoint remote, const TCPSegment &segment)
+{
+    if (segment.flags & TCP_RST)
+    {
+        return;
+    }
+
+    if (segment.flags & TCP_ACK)
+    {
+        tcp_reset(local, remote, segment);
+        return;
+    }
+
+    if (!(segment.flags & TCP_SYN))
+    {
+        return;
+    }
+
+    size_t pending = 0;
+
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        if (_sockets[i]->listener == listener)
+        {
+            pending++;
+        }
+    }
+
+    // Dropped, the peer tries again.
+    if (pending >= listener->backlog)
+    {
+        return;
+    }
+
+    auto socket = new TCPSocket();
+
+    socket->owned = false;
+    socket->listener = listener;
+    socket->local = local;
+    socket->remote = remote;
+    socket->state = TCP_SYN_RECEIVED;
+
+    tcp_synchronize(socket, segment);
+    tcp_start(socket);
+
+    socket->send_window = segment.window;
+
+    _sockets.push_back(socket);
+
+    tcp_segment(socket, socket->send_initial, TCP_SYN, 0);
+    tcp_arm(socket);
+}
+
+static void tcp_syn_sent_receive(TCPSocket *socket, const TCPSegment &segment)
+{
+    bool has_ack = segment.flags & TCP_ACK;
+
+    if (has_ack &&
+        (before_or_equal(segment.acknowledgment, socket->send_initial) ||
+         before(socket->send_max, segment.acknowledgment)))
+    {
+        tcp_reset(socket->local, socket->remote, segment);
+        return;
+    }
+
+    if (segment.flags & TCP_RST)
+    {
+        if (has_ack)
+        {
+            tcp_drop(socket, ERR_CONNECTION_REFUSED);
+        }
+
+        return;
+    }
+
+    if (!(segment.flags & TCP_SYN))
+    {
+        return;
+    }
+
+    tcp_synchronize(socket, segment);
+
+    if (!has_ack)
+    {
+        // Both ends opened at once.
+        socket->state = TCP_SYN_RECEIVED;
+        tcp_segment(socket, socket->send_initial, TCP_SYN, 0);
+
+        return;
+    }
+
+    if (socket->retransmits == 0)
+    {
+        tcp_rtt_sample(socket, system_get_ticks() - socket->timed_since);
+    }
+
+    socket->state = TCP_ESTABLISHED;
+    socket->send_unacknowledged = segment.acknowledgment;
+    socket->send_window = segment.window;
+    socket->send_window_sequence = segment.sequence;
+    socket->send_window_acknowledgment = segment.acknowledgment;
+    socket->retransmit_at = 0;
+    socket->retransmits = 0;
+    socket->timing = false;
+    socket->ack_pending = true;
+}
+
+static void tcp_out_of_order_add(TCPSocket *socket, TCPRange range)
+{
+    for (size_t i = 0; i < socket->out_of_order_count;)
+    {
+        TCPRange other = socket->out_of_order[i];
+
+        if (before(range.end, other.start) || before(other.end, range.start))
+        {
+            i++;
+            continue;
+        }
+
+        range.start = before(other.start, range.start) ? other.start : range.start;
+        range.end = before(range.end, other.end) ? other.end : range.end;
+
+        for (size_t j = i + 1; j < socket->out_of_order_count; j++)
+        {
+            socket->out_of_order[j - 1] = socket->out_of_order[j];
+        }
+
+        socket->out_of_order_count--;
+    }
+
+    // The oldest is forgotten when there are too many, its data will come
+    // again.
+    size_t count = MIN(socket->out_of_order_count + 1, (size_t)TCP_MAX_SACK_BLOCKS);
+
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        socket->out_of_order[i] = socket->out_of_order[i - 1];
+    }
+
+    socket->out_of_order[0] = range;
+    socket->out_of_order_count = count;
+}
+
+static void tcp_receive_data(TCPSocket *socket, uint32_t sequence, const uint8_t *data, size_t size)
+{
+    if (before(sequence, socket->receive_next))
+    {
+        uint32_t duplicate = socket->receive_next - sequence;
+
+        if (duplicate >= size)
+        {
+            tcp_acknowledge(socket);
+            return;
+        }
+
+        data += duplicate;
+        size -= duplicate;
+        sequence = socket->receive_next;
+    }
+
+    size_t offset = sequence - socket->receive_next;
+    size_t room = socket->receive_buffer.available();
+
+    if (offset >= room)
+    {
+        tcp_acknowledge(socket);
+        return;
+    }
+
+    size = MIN(size, room - offset);
+
+    socket->receive_buffer.write(socket->receive_buffer.used() + offset, data, size);
+
+    if (offset > 0)
+    {
+        // Right away, the duplicate acknowledgment and its SACK blocks
+        // are what the sender recovers from the loss with.
+        tcp_out_of_order_add(socket, {sequence, (uint32_t)(sequence + size)});
+        tcp_acknowledge(socket);
+
+        return;
+    }
+
+    bool filled_hole = socket->out_of_order_count > 0;
+
+    socket->receive_buffer.commit(size);
+    socket->receive_next += size;
+
+    bool merged = true;
+
+    while (merged)
+    {
+        merged = false;
+
+        for (size_t i = 0; i < socket->out_of_order_count; i++)
+        {
+            TCPRange range = socket->out_of_order[i];
+
+            if (before(socket->receive_next, range.start))
+            {
+                continue;
+            }
+
+            if (before(socket->receive_next, range.end))
+            {
+                socket->receive_buffer.commit(range.end - socket->receive_next);
+                socket->receive_next = range.end;
+            }
+
+            for (size_t j = i + 1; j < socket->out_of_order_count; j++)
+            {
+                socket->out_of_order[j - 1] = socket->out_of_order[j];
+            }
+
+            socket->out_of_order_count--;
+            merged = true;
+
+            break;
+        }
+    }
+
+    if (filled_hole)
+    {
+        tcp_acknowledge(socket);
+    }
+    else
+    {
+        // Once for the whole batch.
+        socket->ack_pending = true;
+    }
+}
+
+static void tcp_check_fin(TCPSocket *socket)
+{
+    if (!socket->fin_seen || socket->fin_received || socket->receive_next != socket->fin_sequence)
+    {
+        return;
+    }
+
+    socket->receive_next++;
+    socket->fin_received = true;
+    socket->ack_pending = true;
+
+    if (socket->state == TCP_ESTABLISHED)
+    {
+        socket->state = TCP_CLOSE_WAIT;
+    }
+    else if (socket->state == TCP_FIN_WAIT_1)
+    {
+        socket->state = TCP_CLOSING;
+    }
+    else if (socket->state == TCP_FIN_WAIT_2)
+    {
+        socket->state = TCP_TIME_WAIT;
+        tcp_linger(socket, TCP_TIME_WAIT_TIMEOUT);
+    }
+}
+
+static bool tcp_in_window(TCPSocket *socket, uint32_t sequence, uint32_t window)
+{
+    return before_or_equal(socket->receive_next, sequence) &&
+           before(sequence, socket->receive_next + window);
+}
+
+static void tcp_synchronized_receive(TCPSocket *socket, const TCPSegment &segment)
+{
+    uint32_t length = segment.size + !!(segment.flags & TCP_SYN) + !!(segment.flags & TCP_FIN);
+    uint32_t window = socket->receive_buffer.available();
+
+    bool acceptable;
+
+    if (length == 0)
+    {
+        acceptable = window == 0 ? segment.sequence == socket->receive_next
+                                 : tcp_in_window(socket, segment.sequence, window);
+    }
+    else
+    {
+        acceptable = window != 0 &&
+                     (tcp_in_window(socket, segment.sequence, window) ||
+                      tcp_in_window(socket, segment.sequence + length - 1, window));
+    }
+
+    if (!acceptable)
+    {
+        if (!(segment.flags & TCP_RST))
+        {
+            tcp_acknowledge(socket);
+        }
+
+        if (socket->state == TCP_TIME_WAIT && (segment.flags & TCP_FIN))
+        {
+            tcp_linger(socket, TCP_TIME_WAIT_TIMEOUT);
+        }
+
+        return;
+    }
+
+    // RFC 5961, only an exact match resets, others get a challenge.
+    if (segment.flags & TCP_RST)
+    {
+        if (segment.sequence == socket->receive_next)
+        {
+            tcp_drop(socket, ERR_CONNECTION_RESET);
+        }
+        else
+        {
+            tcp_acknowledge(socket);
+        }
+
+        return;
+    }
+
+    if (segment.flags & TCP_SYN)
+    {
+        tcp_acknowledge(socket);
+        return;
+    }
+
+    if (!(segment.flags & TCP_ACK))
+    {
+        return;
+    }
+
+    if (socket->state == TCP_SYN_RECEIVED)
+    {
+        if (before_or_equal(segment.acknowledgment, socket->send_unacknowledged) ||
+            before(socket->send_max, segment.acknowledgment))
+        {
+            tcp_reset(socket->local, socket->remote, segment);
+            return;
+        }
+
+        socket->state = TCP_ESTABLISHED;
+        socket->send_unacknowledged = socket->send_initial + 1;
+        socket->send_window = segment.window << socket->send_scale;
+        socket->send_window_sequence = segment.sequence;
+        socket->send_window_acknowledgment = segment.acknowledgment;
+        socket->retransmit_at = 0;
+        socket->retransmits = 0;
+
+        if (socket->listener)
+        {
+            socket->listener->accept_queue.push_back(socket);
+        }
+    }
+
+    if (before(socket->send_max, segment.acknowledgment))
+    {
+        tcp_acknowledge(socket);
+        return;
+    }
+
+    if (before_or_equal(socket->send_unacknowledged, segment.acknowledgment))
+    {
+        socket->retransmits = 0;
+
+        uint32_t old_window = socket->send_window;
+
+        if (before(socket->send_window_sequence, segment.sequence) ||
+            (socket->send_window_sequence == segment.sequence &&
+             before_or_equal(socket->send_window_acknowledgment, segment.acknowledgment)))
+        {
+            socket->send_window = segment.window << socket->send_scale;
+            socket->send_window_sequence = segment.sequence;
+            socket->send_window_acknowledgment = segment.acknowledgment;
+        }
+
+        if (socket->sack_permitted)
+        {
+            for (size_t i = 0; i < segment.options.sack_count; i++)
+            {
+                tcp_scoreboard_add(socket, segment.options.sack[i]);
+            }
+        }
+
+        if (before(socket->send_unacknowledged, segment.acknowledgment))
+        {
+            tcp_acknowledged(socket, segment.acknowledgment);
+        }
+        else if (segment.size == 0 &&
+                 !(segment.flags & TCP_FIN) &&
+                 socket->send_window == old_window &&
+                 socket->send_max != socket->send_unacknowledged)
+        {
+            tcp_duplicate_ack(socket);
+        }
+
+        bool fin_acknowledged = socket->fin_sent &&
+                                socket->send_buffer.used() == 0 &&
+                                socket->send_unacknowledged == socket->send_max;
+
+        if (fin_acknowledged && socket->state == TCP_FIN_WAIT_1)
+        {
+            socket->state = TCP_FIN_WAIT_2;
+            socket->retransmit_at = 0;
+
+            if (!socket->owned)
+            {
+                tcp_linger(socket, TCP_FIN_WAIT_TIMEOUT);
+            }
+        }
+        else if (fin_acknowledged && socket->state == TCP_CLOSING)
+        {
+            socket->state = TCP_TIME_WAIT;
+            tcp_linger(socket, TCP_TIME_WAIT_TIMEOUT);
+        }
+        else if (fin_acknowledged && socket->state == TCP_LAST_ACK)
+        {
+            tcp_drop(socket, SUCCESS);
+            return;
+        }
+    }
+
+    bool receiving = socket->state == TCP_ESTABLISHED ||
+                     socket->state == TCP_FIN_WAIT_1 ||
+                     socket->state == TCP_FIN_WAIT_2;
+
+    if (!receiving)
+    {
+        return;
+    }
+
+    if (segment.size > 0)
+    {
+        tcp_receive_data(socket, segment.sequence, segment.payload, segment.size);
+    }
+
+    if (segment.flags & TCP_FIN)
+    {
+        socket->fin_seen = true;
+        socket->fin_sequence = segment.sequence + segment.size;
+    }
+
+    tcp_check_fin(socket);
+}
+
+void tcp_receive(const IPv4Header &ip, const uint8_t *data, size_t size)
+{
+    if (size < sizeof(TCPHeader) || ip.destination != interface_address())
+    {
+        return;
+    }
+
+    auto header = reinterpret_cast<const TCPHeader *>(data);
+    size_t header_size = header->header_size();
+
+    if (header_size < sizeof(TCPHeader) || header_size > size)
+    {
+        return;
+    }
+
+    uint32_t sum = ipv4_pseudo_header_sum(ip.source, ip.destination, IPV4_PROTOCOL_TCP, size);
+
+    if (checksum_finalize(checksum_add(sum, data, size)) != 0)
+    {
+        interface_configuration().dropped++;
+        return;
+    }
+
+    TCPSegment segment = {
+        .sequence = header->sequence(),
+        .acknowledgment = header->acknowledgment(),
+        .flags = header->flags,
+        .window = header->window(),
+        .options = tcp_parse_options(data + sizeof(TCPHeader), header_size - sizeof(TCPHeader)),
+        .payload = data + header_size,
+        .size = size - header_size,
+    };
+
+    NetworkEndpoint local = {ip.destination, header->destination_port()};
+    NetworkEndpoint remote = {ip.source, header->source_port()};
+
+    TCPSocket *socket = tcp_find(local.port, remote);
+
+    if (!socket)
+    {
+        tcp_reset(local, remote, segment);
+    }
+    else if (socket->state == TCP_LISTEN)
+    {
+        tcp_listen_receive(socket, local, remote, segment);
+    }
+    else if (socket->state == TCP_SYN_SENT)
+    {
+        tcp_syn_sent_receive(socket, segment);
+    }
+    else
+    {
+        tcp_synchronized_receive(socket, segment);
+    }
+}
+
+void tcp_flush()
+{
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        tcp_output(_sockets[i]);
+    }
+
+    tcp_collect();
+}
+
+void tcp_tick(TimeStamp now)
+{
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        TCPSocket *socket = _sockets[i];
+
+        if (socket->linger_until && socket->linger_until <= now)
+        {
+            tcp_drop(socket, SUCCESS);
+        }
+        else if (socket->retransmit_at && socket->retransmit_at <= now)
+        {
+            tcp_timeout(socket);
+        }
+    }
+
+    tcp_collect();
+}
+
+/* --- Client side ---------------------------------------------------------- */
+
+TCPSocket *tcp_open()
+{
+    auto socket = new TCPSocket();
+
+    _sockets.push_back(socket);
+
+    return socket;
+}
+
+void tcp_close(TCPSocket *socket)
+{
+    socket->owned = false;
+
+    switch (socket->state)
+    {
+    case TCP_LISTEN:
+        for (size_t i = 0; i < _sockets.count(); i++)
+        {
+            if (_sockets[i]->listener == socket)
+            {
+                tcp_abort(_sockets[i], SUCCESS);
+            }
+        }
+
+        tcp_drop(socket, SUCCESS);
+        break;
+
+    case TCP_SYN_SENT:
+        tcp_drop(socket, SUCCESS);
+        break;
+
+    case TCP_SYN_RECEIVED:
+    case TCP_ESTABLISHED:
+    case TCP_CLOSE_WAIT:
+        // RFC 2525, closing on data nobody will read resets.
+        if (socket->receive_buffer.used() > 0)
+        {
+            tcp_abort(socket, SUCCESS);
+        }
+        else
+        {
+            tcp_shutdown(socket);
+        }
+        break;
+
+    case TCP_FIN_WAIT_2:
+        tcp_linger(socket, TCP_FIN_WAIT_TIMEOUT);
+        break;
+
+    default:
+        break;
+    }
+}
+
+Result tcp_bind(TCPSocket *socket, NetworkEndpoint local)
+{
+    if (socket->state != TCP_CLOSED || socket->local.port != 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (local.port == 0)
+    {
+        local.port = tcp_ephemeral_port();
+    }
+    else if (tcp_port_in_use(local.port))
+    {
+        return ERR_ADDRESS_IN_USE;
+    }
+
+    socket->local = local;
+
+    return SUCCESS;
+}
+
+Result tcp_connect(TCPSocket *socket, NetworkEndpoint remote)
+{
+    if (socket->state != TCP_CLOSED || remote.address.empty() || remote.port == 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (!interface_configured())
+    {
+        return ERR_NETWORK_UNREACHABLE;
+    }
+
+    if (socket->local.port == 0)
+    {
+        socket->local.port = tcp_ephemeral_port();
+    }
+
+    socket->local.address = interface_address();
+    socket->remote = remote;
+    socket->error = SUCCESS;
+    socket->state = TCP_SYN_SENT;
+    socket->receive_scale = tcp_window_shift();
+
+    tcp_start(socket);
+
+    socket->timed_since = system_get_ticks();
+
+    tcp_segment(socket, socket->send_initial, TCP_SYN, 0);
+    tcp_arm(socket);
+
+    return SUCCESS;
+}
+
+Result tcp_listen(TCPSocket *socket, size_t backlog)
+{
+    if (socket->state != TCP_CLOSED)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (socket->local.port == 0)
+    {
+        socket->local.port = tcp_ephemeral_port();
+    }
+
+    socket->state = TCP_LISTEN;
+    socket->backlog = MIN(MAX(backlog, (size_t)1), (size_t)64);
+
+    return SUCCESS;
+}
+
+TCPSocket *tcp_accept(TCPSocket *socket)
+{
+    if (socket->accept_queue.empty())
+    {
+        return nullptr;
+    }
+
+    TCPSocket *accepted = socket->accept_queue.take_at(0);
+
+    accepted->listener = nullptr;
+    accepted->owned = true;
+
+    return accepted;
+}
+
+bool tcp_can_send(TCPSocket *socket)
+{
+    bool sending = (socket->state == TCP_ESTABLISHED || socket->state == TCP_CLOSE_WAIT) && !socket->fin_queued;
+
+    return !sending || socket->send_buffer.available() > 0;
+}
+
+size_t tcp_send(TCPSocket *socket, const void *buffer, size_t size)
+{
+    size = MIN(size, socket->send_buffer.available());
+
+    socket->send_buffer.append(buffer, size);
+
+    tcp_output(socket);
+
+    return size;
+}
+
+size_t tcp_read(TCPSocket *socket, void *buffer, size_t size)
+{
+    size = MIN(size, socket->receive_buffer.used());
+
+    socket->receive_buffer.read(0, buffer, size);
+    socket->receive_buffer.consume(size);
+
+    // Let the peer know once the window opened by a good part, not for
+    // every read.
+    uint32_t edge = socket->receive_next + socket->receive_buffer.available();
+    uint32_t threshold = MIN((uint32_t)TCP_RECEIVE_BUFFER_SIZE / 4, 2u * (uint32_t)TCP_MSS);
+
+    bool receiving = socket->state == TCP_ESTABLISHED ||
+                     socket->state == TCP_FIN_WAIT_1 ||
+                     socket->state == TCP_FIN_WAIT_2;
+
+    if (receiving && edge - socket->advertised_edge >= threshold)
+    {
+        socket->ack_pending = true;
+    }
+
+    return size;
+}
+
+void tcp_shutdown(TCPSocket *socket)
+{
+    if (socket->fin_queued)
+    {
+        return;
+    }
+
+    if (socket->state == TCP_ESTABLISHED || socket->state == TCP_SYN_RECEIVED)
+    {
+        socket->state = TCP_FIN_WAIT_1;
+    }
+    else if (socket->state == TCP_CLOSE_WAIT)
+    {
+        socket->state = TCP_LAST_ACK;
+    }
+    else
+    {
+        return;
+    }
+
+    socket->fin_queued = true;
+
+    tcp_output(socket);
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <libsystem/Assert.h>
+#include <libsystem/Time.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/network/Ethernet.h>
+#include <libsystem/network/IPv4.h>
+#include <libsystem/network/NetworkProtocol.h>
+#include <libsystem/network/TCP.h>
+#include <libutils/Vector.h>
+
+#define TCP_MSS (ETHERNET_MTU - sizeof(IPv4Header) - sizeof(TCPHeader))
+
+// RFC 1122, when the peer doesn't tell.
+#define TCP_DEFAULT_MSS (536)
+
+#define TCP_SEND_BUFFER_SIZE (256 * 1024)
+#define TCP_RECEIVE_BUFFER_SIZE (256 * 1024)
+
+// RFC 6928, in segments.
+#define TCP_INITIAL_WINDOW (10)
+
+#define TCP_INITIAL_RTO (1000)
+#define TCP_MIN_RTO (200)
+#define TCP_MAX_RTO (60000)
+#define TCP_MAX_RETRANSMITS (8)
+
+#define TCP_TIME_WAIT_TIMEOUT (30000)
+
+// How long a closed connection waits in FIN_WAIT_2 for the peer to close.
+#define TCP_FIN_WAIT_TIMEOUT (60000)
+
+#define TCP_EPHEMERAL_FIRST (49152)
+
+// Ranges the peer told us it has, more than it can fit in a segment since
+// they are remembered across acknowledgments.
+#define TCP_SCOREBOARD_SIZE (16)
+
+enum TCPState
+{
+    TCP_CLOSED,
+    TCP_LISTEN,
+    TCP_SYN_SENT,
+    TCP_SYN_RECEIVED,
+    TCP_ESTABLISHED,
+    TCP_FIN_WAIT_1,
+    TCP_FIN_WAIT_2,
+    TCP_CLOSE_WAIT,
+    TCP_CLOSING,
+    TCP_LAST_ACK,
+    TCP_TIME_WAIT,
+};
+
+// Bytes of a stream in a circular buffer, addressed from the first one
+// kept. Writing past what is used is fine, it is how data received out of
+// order is put in place before the hole before it is filled.
+class TCPBuffer
+{
+private:
+    uint8_t *_data;
+    size_t _capacity;
+    size_t _start = 0;
+    size_t _used = 0;
+
+public:
+    size_t capacity() const { return _capacity; }
+
+    size_t used() const { return _used; }
+
+    size_t available() const { return _capacity - _used; }
+
+    TCPBuffer(size_t capacity) : _data(new uint8_t[capacity]), _capacity(capacity) {}
+
+    ~TCPBuffer() { delete[] _data; }
+
+    TCPBuffer(const TCPBuffer &) = delete;
+
+    TCPBuffer &operator=(const TCPBuffer &) = delete;
+
+    void write(size_t offset, const void *data, size_t size)
+    {
+        assert(offset + size <= _capacity);
+
+        size_t index = (_start + offset) % _capacity;
+        size_t first = MIN(size, _capacity - index);
+
+        memcpy(_data + index, data, first);
+        memcpy(_data, (const uint8_t *)data + first, size - first);
+    }
+
+    void read(size_t offset, void *data, size_t size) const
+    {
+        assert(offset + size <= _capacity);
+
+        size_t index = (_start + offset) % _capacity;
+        size_t first = MIN(size, _capacity - index);
+
+        memcpy(data, _data + index, first);
+        memcpy((uint8_t *)data + first, _data, size - first);
+    }
+
+    void append(const void *data, size_t size)
+    {
+        write(_used, data, size);
+        _used += size;
+    }
+
+    void commit(size_t size)
+    {
+        assert(_used + size <= _capacity);
+        _used += size;
+    }
+
+    void consume(size_t size)
+    {
+        assert(size <= _used);
+
+        _start = (_start + size) % _capacity;
+        _used -= size;
+    }
+};
+
+// Half open, in sequence space.
+struct TCPRange
+{
+    uint32_t start;
+    uint32_t end;
+};
+
+// Names follow RFC 793, SND.UNA is `send_unacknowledged` and so on.
+struct TCPSocket
+{
+    TCPState state = TCP_CLOSED;
+    NetworkEndpoint local = {};
+    NetworkEndpoint remote = {};
+
+    // Why the connection went away, for the next request of the client.
+    Result error = SUCCESS;
+
+    // Held by a client, or waiting to be claimed after accept(). Otherwise
+    // the stack gets rid of it once it is closed.
+    bool owned = true;
+
+    TCPSocket *listener = nullptr;
+    Vector<TCPSocket *> accept_queue{};
+    size_t backlog = 0;
+
+    // Send side, the buffer starts at `send_unacknowledged`.
+    uint32_t send_initial = 0;
+    uint32_t send_unacknowledged = 0;
+    uint32_t send_next = 0;
+    uint32_t send_max = 0;
+    uint32_t send_window = 0;
+    uint32_t send_window_sequence = 0;
+    uint32_t send_window_acknowledgment = 0;
+    uint8_t send_scale = 0;
+    uint16_t send_mss = TCP_DEFAULT_MSS;
+    TCPBuffer send_buffer{TCP_SEND_BUFFER_SIZE};
+    bool fin_queued = false;
+    bool fin_sent = false;
+
+    bool window_scaling = false;
+    bool sack_permitted = false;
+    TCPRange scoreboard[TCP_SCOREBOARD_SIZE] = {};
+    size_t scoreboard_count = 0;
+
+    // Congestion control, Reno with SACK based loss recovery.
+    uint32_t congestion_window = 0;
+    uint32_t slow_start_threshold = 0xffffffff;
+    uint32_t avoidance_bytes = 0;
+    int duplicate_acks = 0;
+    bool recovering = false;
+    uint32_t recovery_end = 0;
+    uint32_t recovery_next = 0;
+
+    // RFC 6298, one segment timed at once and never a retransmitted one.
+    bool timing = false;
+    uint32_t timed_sequence = 0;
+    TimeStamp timed_since = 0;
+    uint32_t smoothed_rtt = 0;
+    uint32_t rtt_variance = 0;
+    uint32_t rto = TCP_INITIAL_RTO;
+    TimeStamp retransmit_at = 0;
+    int retransmits = 0;
+
+    // Receive side, the buffer starts with what the client didn't read yet.
+    uint32_t receive_next = 0;
+    uint8_t receive_scale = 0;
+    TCPBuffer receive_buffer{TCP_RECEIVE_BUFFER_SIZE};
+    uint32_t advertised_edge = 0;
+    bool ack_pending = false;
+
+    // Most recently received first, as the SACK blocks are sent.
+    TCPRange out_of_order[TCP_MAX_SACK_BLOCKS] = {};
+    size_t out_of_order_count = 0;
+
+    bool fin_seen = false;
+    bool fin_received = false;
+    uint32_t fin_sequence = 0;
+
+    TimeStamp linger_until = 0;
+};
+
+TCPSocket *tcp_open();
+
+// The client is done with the socket, it goes away once closed.
+void tcp_close(TCPSocket *socket);
+
+Result tcp_bind(TCPSocket *socket, NetworkEndpoint local);
+
+Result tcp_connect(TCPSocket *socket, NetworkEndpoint remote);
+
+Result tcp_listen(TCPSocket *socket, size_t backlog);
+
+TCPSocket *tcp_accept(TCPSocket *socket);
+
+bool tcp_can_send(TCPSocket *socket);
+
+size_t tcp_send(TCPSocket *socket, const void *buffer, size_t size);
+
+size_t tcp_read(TCPSocket *socket, void *buffer, size_t size);
+
+void tcp_shutdown(TCPSocket *socket);
+
+void tcp_receive(const IPv4Header &ip, const uint8_t *data, size_t size);
+
+// Sends what was held back while a batch of frames was processed,
+// acknowledgments included.
+void tcp_flush();
+
+void tcp_tick(TimeStamp now);
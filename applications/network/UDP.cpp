@@ -0,0 +1,225 @@
+#include <libsystem/core/CString.h>
+#include <libsystem/network/DHCP.h>
+
+#include "network/DHCP.h"
+#include "network/UDP.h"
+
+static Vector<UDPSocket *> _sockets{};
+static uint16_t _next_ephemeral_port = UDP_EPHEMERAL_FIRST;
+
+static UDPSocket *udp_find(uint16_t port)
+{
+    for (size_t i = 0; i < _sockets.count(); i++)
+    {
+        if (_sockets[i]->local.port == port)
+        {
+            return _sockets[i];
+        }
+    }
+
+    return nullptr;
+}
+
+static uint16_t udp_ephemeral_port()
+{
+    for (size_t i = UDP_EPHEMERAL_FIRST; i <= 0xffff; i++)
+    {
+        uint16_t port = _next_ephemeral_port;
+
+        _next_ephemeral_port = port == 0xffff ? UDP_EPHEMERAL_FIRST : port + 1;
+
+        if (!udp_find(port))
+        {
+            return port;
+        }
+    }
+
+    return 0;
+}
+
+UDPSocket *udp_open()
+{
+    auto socket = new UDPSocket();
+
+    _sockets.push_back(socket);
+
+    return socket;
+}
+
+void udp_close(UDPSocket *socket)
+{
+    _sockets.remove_value(socket);
+
+    for (size_t i = 0; i < socket->received.count(); i++)
+    {
+        delete socket->received[i];
+    }
+
+    delete socket;
+}
+
+Result udp_bind(UDPSocket *socket, NetworkEndpoint local)
+{
+    if (socket->local.port != 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (local.port == 0)
+    {
+        local.port = udp_ephemeral_port();
+    }
+    else if (local.port == DHCP_CLIENT_PORT || udp_find(local.port))
+    {
+        return ERR_ADDRESS_IN_USE;
+    }
+
+    socket->local = local;
+
+    return SUCCESS;
+}
+
+Result udp_connect(UDPSocket *socket, NetworkEndpoint remote)
+{
+    if (remote.address.empty() || remote.port == 0)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (socket->local.port == 0)
+    {
+        socket->local.port = udp_ephemeral_port();
+    }
+
+    socket->remote = remote;
+
+    return SUCCESS;
+}
+
+ResultOr<size_t> udp_send(UDPSocket *socket, NetworkEndpoint remote, const void *data, size_t size)
+{
+    if (remote.address.empty())
+    {
+        remote = socket->remote;
+    }
+
+    if (remote.address.empty() || remote.port == 0 || size > UDP_MAX_PAYLOAD)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (!interface_configured())
+    {
+        return ERR_NETWORK_UNREACHABLE;
+    }
+
+    if (socket->local.port == 0)
+    {
+        socket->local.port = udp_ephemeral_port();
+    }
+
+    Result result = udp_send_raw(interface_address(), socket->local.port, remote, data, size);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    return size;
+}
+
+UDPDatagram *udp_take(UDPSocket *socket)
+{
+    if (socket->received.empty())
+    {
+        return nullptr;
+    }
+
+    return socket->received.take_at(0);
+}
+
+Result udp_send_raw(IPv4Address source, uint16_t source_port, NetworkEndpoint remote, const void *data, size_t size)
+{
+    uint16_t buffer;
+
+    if (!interface_device().allocate(buffer))
+    {
+        // As if it was lost on the way.
+        return SUCCESS;
+    }
+
+    uint8_t *payload = interface_ipv4_payload(buffer);
+    size_t length = sizeof(UDPHeader) + size;
+
+    auto header = reinterpret_cast<UDPHeader *>(payload);
+    header->source_port = source_port;
+    header->destination_port = remote.port;
+    header->length = length;
+    header->checksum = 0;
+
+    memcpy(payload + sizeof(UDPHeader), data, size);
+
+    uint32_t sum = ipv4_pseudo_header_sum(source, remote.address, IPV4_PROTOCOL_UDP, length);
+    uint16_t value = checksum_finalize(checksum_add(sum, payload, length));
+
+    // Zero means there is no checksum.
+    header->checksum = value == 0 ? 0xffff : value;
+
+    return interface_ipv4_send(buffer, source, remote.address, IPV4_PROTOCOL_UDP, length);
+}
+
+void udp_receive(const IPv4Header &ip, const uint8_t *data, size_t size)
+{
+    auto header = reinterpret_cast<const UDPHeader *>(data);
+
+    if (size < sizeof(UDPHeader) || header->length() < sizeof(UDPHeader) || header->length() > size)
+    {
+        interface_configuration().dropped++;
+        return;
+    }
+
+    size = header->length();
+
+    if (header->checksum() != 0)
+    {
+        uint32_t sum = ipv4_pseudo_header_sum(ip.source, ip.destination, IPV4_PROTOCOL_UDP, size);
+
+        if (checksum_finalize(checksum_add(sum, data, size)) != 0)
+        {
+            interface_configuration().dropped++;
+            return;
+        }
+    }
+
+    const uint8_t *payload = data + sizeof(UDPHeader);
+    size_t payload_size = size - sizeof(UDPHeader);
+
+    if (header->destination_port() == DHCP_CLIENT_PORT)
+    {
+        dhcp_receive(payload, payload_size);
+        return;
+    }
+
+    UDPSocket *socket = udp_find(header->destination_port());
+
+    if (!socket || socket->received.count() >= UDP_RECEIVE_QUEUE_SIZE)
+    {
+        return;
+    }
+
+    NetworkEndpoint from = {ip.source, header->source_port()};
+
+    if (!socket->remote.address.empty() &&
+        (socket->remote.address != from.address || socket->remote.port != from.port))
+    {
+        return;
+    }
+
+    auto datagram = new UDPDatagram();
+
+    datagram->from = from;
+    datagram->size = payload_size;
+    memcpy(datagram->data, payload, payload_size);
+
+    socket->received.push_back(datagram);
+}
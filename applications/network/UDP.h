@@ -0,0 +1,50 @@
+#pragma once
+
+#include <libsystem/network/IPv4.h>
+#include <libsystem/network/NetworkProtocol.h>
+#include <libsystem/network/UDP.h>
+#include <libutils/ResultOr.h>
+#include <libutils/Vector.h>
+
+#include "network/Interface.h"
+
+#define UDP_MAX_PAYLOAD (INTERFACE_IPV4_MTU - sizeof(UDPHeader))
+
+// Datagrams kept for a socket nobody reads, the next ones are dropped.
+#define UDP_RECEIVE_QUEUE_SIZE (64)
+
+#define UDP_EPHEMERAL_FIRST (49152)
+
+struct UDPDatagram
+{
+    NetworkEndpoint from;
+    size_t size;
+    uint8_t data[UDP_MAX_PAYLOAD];
+};
+
+struct UDPSocket
+{
+    NetworkEndpoint local = {};
+    NetworkEndpoint remote = {};
+
+    Vector<UDPDatagram *> received{};
+};
+
+UDPSocket *udp_open();
+
+void udp_close(UDPSocket *socket);
+
+Result udp_bind(UDPSocket *socket, NetworkEndpoint local);
+
+Result udp_connect(UDPSocket *socket, NetworkEndpoint remote);
+
+// Sends to `remote`, or to the connected end when it is empty.
+ResultOr<size_t> udp_send(UDPSocket *socket, NetworkEndpoint remote, const void *data, size_t size);
+
+// The oldest datagram received, the caller deletes it.
+UDPDatagram *udp_take(UDPSocket *socket);
+
+// For DHCP, which talks before there is an address to bind to.
+Result udp_send_raw(IPv4Address source, uint16_t source_port, NetworkEndpoint remote, const void *data, size_t size);
+
+void udp_receive(const IPv4Header &ip, const uint8_t *data, size_t size);
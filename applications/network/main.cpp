@@ -0,0 +1,97 @@
+#include <abi/Paths.h>
+
+#include <libsystem/Logger.h>
+#include <libsystem/eventloop/EventLoop.h>
+#include <libsystem/eventloop/Notifier.h>
+#include <libsystem/eventloop/Timer.h>
+#include <libsystem/io/Socket.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+
+#include "network/Client.h"
+#include "network/DHCP.h"
+#include "network/Device.h"
+#include "network/Interface.h"
+#include "network/TCP.h"
+
+// Retransmissions and timeouts are checked this often.
+#define NETWORK_TICK_INTERVAL (50)
+
+void device_callback(void *target, Stream *stream, PollEvent events)
+{
+    __unused(target);
+    __unused(stream);
+    __unused(events);
+
+    interface_poll();
+
+    // Clients waiting on what arrived are answered before the batch is
+    // flushed, so the windows they opened go out with it.
+    client_update_all();
+    interface_flush();
+
+    client_destroy_disconnected();
+}
+
+void accept_callback(void *target, Socket *socket, PollEvent events)
+{
+    __unused(target);
+    __unused(events);
+
+    Connection *incoming_connection = socket_accept(socket);
+
+    new Client(incoming_connection);
+
+    client_destroy_disconnected();
+}
+
+int main(int argc, char const *argv[])
+{
+    const char *device_path = argc > 1 ? argv[1] : NETWORK_DEVICE_PATH;
+
+    eventloop_initialize();
+
+    auto device = Device::open(device_path);
+
+    if (!device)
+    {
+        stream_format(err_stream, "%s: No network device at %s\n", argv[0], device_path);
+        return PROCESS_FAILURE;
+    }
+
+    Stream *device_stream = device->stream();
+
+    interface_initialize(device);
+
+    Socket *socket = socket_open(NETWORK_SERVICE_PATH, OPEN_CREATE);
+
+    if (handle_has_error(socket))
+    {
+        handle_printf_error(socket, "%s: Failed to open %s", argv[0], NETWORK_SERVICE_PATH);
+        return PROCESS_FAILURE;
+    }
+
+    notifier_create(nullptr, HANDLE(device_stream), POLL_READ, (NotifierCallback)device_callback);
+    notifier_create(nullptr, HANDLE(socket), POLL_ACCEPT, (NotifierCallback)accept_callback);
+
+    auto tick_timer = own<Timer>(NETWORK_TICK_INTERVAL, []() {
+        TimeStamp now = system_get_ticks();
+
+        interface_tick(now);
+        tcp_tick(now);
+        dhcp_tick(now);
+        client_tick(now);
+
+        client_update_all();
+        interface_flush();
+
+        client_destroy_disconnected();
+    });
+
+    tick_timer->start();
+
+    dhcp_initialize();
+    interface_flush();
+
+    return eventloop_run();
+}
@@ -8,6 +8,7 @@
 #include <libsystem/process/Environment.h>
 #include <libsystem/process/Launchpad.h>
 #include <libsystem/process/Process.h>
+#include <libsystem/utils/List.h>
 #include <libutils/Path.h>
 
 #include "shell/Shell.h"
@@ -57,7 +58,7 @@ Result shell_exec(ShellCommand *command, Stream *stdin, Stream *stdout, int *pid
 
     Launchpad *launchpad = launchpad_create(command->command, executable);
 
-    list_foreach(char, arg, command->arguments)
+    for (auto arg : command->arguments)
     {
         launchpad_argument(launchpad, arg);
     }
@@ -80,12 +81,12 @@ int shell_eval(ShellNode *node, Stream *stdin, Stream *stdout)
 
         if (builtin)
         {
-            // list_count(command->arguments) + 1 for argv[0] which is the command name.
-            char **argv = (char **)calloc(command->arguments->count() + 1, sizeof(argv));
+            // command->arguments.count() + 1 for argv[0] which is the command name.
+            char **argv = (char **)calloc(command->arguments.count() + 1, sizeof(argv));
             argv[0] = command->command;
             int argc = 1;
 
-            list_foreach(char, arg, command->arguments)
+            for (auto arg : command->arguments)
             {
                 argv[argc] = arg;
                 argc++;
@@ -127,17 +128,16 @@ int shell_eval(ShellNode *node, Stream *stdin, Stream *stdout)
 
         List *pipes = list_create();
 
-        for (int i = 0; i < pipeline->commands->count() - 1; i++)
+        for (size_t i = 0; i + 1 < pipeline->commands.count(); i++)
         {
             list_pushback(pipes, pipe_create());
         }
 
-        int *processes = (int *)calloc(pipeline->commands->count(), sizeof(int));
+        int *processes = (int *)calloc(pipeline->commands.count(), sizeof(int));
 
-        for (int i = 0; i < pipeline->commands->count(); i++)
+        for (size_t i = 0; i < pipeline->commands.count(); i++)
         {
-            ShellCommand *command = nullptr;
-            list_peekat(pipeline->commands, i, (void **)&command);
+            ShellCommand *command = (ShellCommand *)pipeline->commands[i];
             assert(command);
 
             Stream *command_stdin = stdin;
@@ -150,7 +150,7 @@ int shell_eval(ShellNode *node, Stream *stdin, Stream *stdout)
                 command_stdin = input_pipe->out;
             }
 
-            if (i < pipeline->commands->count() - 1)
+            if (i + 1 < pipeline->commands.count())
             {
                 Pipe *output_pipe;
                 assert(list_peekat(pipes, i, (void **)&output_pipe));
@@ -164,7 +164,7 @@ int shell_eval(ShellNode *node, Stream *stdin, Stream *stdout)
 
         int exit_value;
 
-        for (int i = 0; i < pipeline->commands->count(); i++)
+        for (size_t i = 0; i < pipeline->commands.count(); i++)
         {
             process_wait(processes[i], &exit_value);
         }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <libsystem/utils/List.h>
+#include <libutils/Arena.h>
 
 enum ShellNodeType
 {
@@ -10,13 +10,11 @@ enum ShellNodeType
     SHELL_NODE_REDIRECT,
 };
 
-struct ShellNode;
+// Nodes and their strings are allocated in the arena passed to shell_parse
+// and go away when it is reset, there is nothing to destroy one by one.
 
-typedef void (*ShellNodeDestroyCallback)(struct ShellNode *node);
-
-#define SHELL_NODE      \
-    ShellNodeType type; \
-    ShellNodeDestroyCallback destroy;
+#define SHELL_NODE \
+    ShellNodeType type;
 
 struct ShellNode
 {
@@ -28,14 +26,14 @@ struct ShellCommand
     SHELL_NODE;
 
     char *command;
-    List /* of cstring */ *arguments;
+    ArenaVector<char *> arguments;
 };
 
 struct ShellPipeline
 {
     SHELL_NODE;
 
-    List *commands;
+    ArenaVector<ShellNode *> commands;
 };
 
 struct ShellRedirect
@@ -46,10 +44,8 @@ struct ShellRedirect
     char *destination;
 };
 
-void shell_node_destroy(ShellNode *node);
-
-ShellNode *shell_command_create(char *command, List *arguments);
+ShellNode *shell_command_create(Arena &arena, char *command, ArenaVector<char *> arguments);
 
-ShellNode *shell_pipeline_create(List *commands);
+ShellNode *shell_pipeline_create(Arena &arena, ArenaVector<ShellNode *> commands);
 
-ShellNode *shell_redirect_create(ShellNode *command, char *destination);
+ShellNode *shell_redirect_create(Arena &arena, ShellNode *command, char *destination);
@@ -1,19 +1,12 @@
 #include "shell/Nodes.h"
 
-void shell_command_destroy(ShellCommand *node)
+ShellNode *shell_command_create(Arena &arena, char *command, ArenaVector<char *> arguments)
 {
-    free(node->command);
-    list_destroy_with_callback(node->arguments, free);
-}
-
-ShellNode *shell_command_create(char *command, List *arguments)
-{
-    ShellCommand *node = __create(ShellCommand);
+    ShellCommand *node = arena.make<ShellCommand>();
 
     node->type = SHELL_NODE_COMMAND;
     node->command = command;
     node->arguments = arguments;
-    node->destroy = (ShellNodeDestroyCallback)shell_command_destroy;
 
     return (ShellNode *)node;
 }
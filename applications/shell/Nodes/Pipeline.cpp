@@ -1,16 +1,10 @@
 #include "shell/Nodes.h"
 
-void shell_pipeline_destroy(ShellPipeline *node)
+ShellNode *shell_pipeline_create(Arena &arena, ArenaVector<ShellNode *> commands)
 {
-    list_destroy_with_callback(node->commands, (ListDestroyElementCallback)shell_node_destroy);
-}
-
-ShellNode *shell_pipeline_create(List *commands)
-{
-    ShellPipeline *node = __create(ShellPipeline);
+    ShellPipeline *node = arena.make<ShellPipeline>();
 
     node->type = SHELL_NODE_PIPELINE;
-    node->destroy = (ShellNodeDestroyCallback)shell_pipeline_destroy;
     node->commands = commands;
 
     return (ShellNode *)node;
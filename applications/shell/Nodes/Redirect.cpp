@@ -1,17 +1,10 @@
 #include "shell/Nodes.h"
 
-void shell_redirect_destroy(ShellRedirect *node)
+ShellNode *shell_redirect_create(Arena &arena, ShellNode *command, char *destination)
 {
-    shell_node_destroy(node->command);
-    free(node->destination);
-}
-
-ShellNode *shell_redirect_create(ShellNode *command, char *destination)
-{
-    ShellRedirect *node = __create(ShellRedirect);
+    ShellRedirect *node = arena.make<ShellRedirect>();
 
     node->type = SHELL_NODE_REDIRECT;
-    node->destroy = (ShellNodeDestroyCallback)shell_redirect_destroy;
 
     node->command = command;
     node->destination = destination;
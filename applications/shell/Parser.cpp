@@ -1,22 +1,21 @@
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
-#include <libsystem/utils/BufferBuilder.h>
 
-#include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
+#include <libutils/SpanScanner.h>
 
 #include "shell/Nodes.h"
 
 #define SHELL_WHITESPACE " \r\n\t"
 
-static void whitespace(Scanner &scan)
+static void whitespace(SpanScanner &scan)
 {
     scan.eat(SHELL_WHITESPACE);
 }
 
-static char *string(Scanner &scan)
+static char *string(SpanScanner &scan, Arena &arena)
 {
-    BufferBuilder *builder = buffer_builder_create(16);
+    ArenaString builder{arena};
 
     scan.skip('"');
 
@@ -25,28 +24,25 @@ static char *string(Scanner &scan)
     {
         if (scan.current() == '\\')
         {
-            buffer_builder_append_str(builder, scan_json_escape_sequence(scan));
-        }
-        else
-        {
-            buffer_builder_append_chr(builder, scan.current());
-            scan.foreward();
+            builder.append(scan_json_escape_sequence(scan));
         }
+
+        builder.append(scan.take_until('"', '\\'));
     }
 
     scan.skip('"');
 
-    return buffer_builder_finalize(builder);
+    return builder.finalize_cstring();
 }
 
-static char *argument(Scanner &scan)
+static char *argument(SpanScanner &scan, Arena &arena)
 {
     if (scan.current() == '"')
     {
-        return string(scan);
+        return string(scan, arena);
     }
 
-    BufferBuilder *builder = buffer_builder_create(16);
+    ArenaString builder{arena};
 
     while (!scan.current_is(SHELL_WHITESPACE) &&
            scan.do_continue())
@@ -58,21 +54,21 @@ static char *argument(Scanner &scan)
 
         if (scan.do_continue())
         {
-            buffer_builder_append_chr(builder, scan.current());
+            builder.append(scan.current());
             scan.foreward();
         }
     }
 
-    return buffer_builder_finalize(builder);
+    return builder.finalize_cstring();
 }
 
-static ShellNode *command(Scanner &scan)
+static ShellNode *command(SpanScanner &scan, Arena &arena)
 {
-    char *command_name = argument(scan);
+    char *command_name = argument(scan, arena);
 
     whitespace(scan);
 
-    List *arguments = list_create();
+    ArenaVector<char *> arguments{arena};
 
     whitespace(scan);
 
@@ -80,37 +76,37 @@ static ShellNode *command(Scanner &scan)
            scan.current() != '|' &&
            scan.current() != '>')
     {
-        list_pushback(arguments, argument(scan));
+        char *arg = argument(scan, arena);
+        arguments.push_back(arg);
         whitespace(scan);
     }
 
-    return shell_command_create(command_name, arguments);
+    return shell_command_create(arena, command_name, arguments);
 }
 
-static ShellNode *pipeline(Scanner &scan)
+static ShellNode *pipeline(SpanScanner &scan, Arena &arena)
 {
-    List *commands = list_create();
+    ArenaVector<ShellNode *> commands{arena};
 
     do
     {
         whitespace(scan);
-        list_pushback(commands, command(scan));
+        ShellNode *node = command(scan, arena);
+        commands.push_back(node);
         whitespace(scan);
     } while (scan.skip('|'));
 
-    if (commands->count() == 1)
+    if (commands.count() == 1)
     {
-        ShellNode *node = (ShellNode *)list_peek(commands);
-        list_destroy(commands);
-        return node;
+        return commands[0];
     }
 
-    return shell_pipeline_create(commands);
+    return shell_pipeline_create(arena, commands);
 }
 
-static ShellNode *redirect(Scanner &scan)
+static ShellNode *redirect(SpanScanner &scan, Arena &arena)
 {
-    ShellNode *node = pipeline(scan);
+    ShellNode *node = pipeline(scan, arena);
 
     whitespace(scan);
 
@@ -121,17 +117,17 @@ static ShellNode *redirect(Scanner &scan)
 
     whitespace(scan);
 
-    char *destination = argument(scan);
+    char *destination = argument(scan, arena);
 
-    return shell_redirect_create(node, destination);
+    return shell_redirect_create(arena, node, destination);
 }
 
-ShellNode *shell_parse(char *command_text)
+ShellNode *shell_parse(Arena &arena, char *command_text)
 {
-    StringScanner scan(command_text, strlen(command_text));
+    SpanScanner scan{command_text, strlen(command_text)};
 
     // Skip the utf8 bom header if present.
     scan_skip_utf8bom(scan);
     whitespace(scan);
-    return redirect(scan);
+    return redirect(scan, arena);
 }
@@ -12,6 +12,7 @@ struct ShellBuiltin
 
 ShellBuiltinCallback shell_get_builtin(const char *name);
 
-ShellNode *shell_parse(char *command_text);
+// The tree is allocated in `arena` and lives until it is reset.
+ShellNode *shell_parse(Arena &arena, char *command_text);
 
 int shell_eval(ShellNode *node, Stream *stdin, Stream *stdout);
@@ -32,11 +32,9 @@ int main(int argc, char **argv)
     {
         if (strcpy(argv[1], "-c"))
         {
-            ShellNode *node = shell_parse(argv[2]);
-            int command_exit_value = shell_eval(node, in_stream, out_stream);
-
-            shell_node_destroy(node);
-            return command_exit_value;
+            Arena arena{};
+            ShellNode *node = shell_parse(arena, argv[2]);
+            return shell_eval(node, in_stream, out_stream);
         }
     }
 
@@ -46,8 +44,12 @@ int main(int argc, char **argv)
 
     int command_exit_value = 0;
 
+    Arena arena{};
+
     while (true)
     {
+        ArenaScope scope{arena};
+
         shell_prompt(command_exit_value);
         char *command = nullptr;
         if (readline_readline(readline, &command) != SUCCESS)
@@ -55,7 +57,7 @@ int main(int argc, char **argv)
             return -1;
         }
 
-        ShellNode *node = shell_parse(command);
+        ShellNode *node = shell_parse(arena, command);
 
         if (command)
         {
@@ -63,7 +65,5 @@ int main(int argc, char **argv)
         }
 
         command_exit_value = shell_eval(node, in_stream, out_stream);
-
-        shell_node_destroy(node);
     }
 }
@@ -14,7 +14,7 @@ enum Column
 
 int TaskModel::rows()
 {
-    return _data.length();
+    return _data.root().length();
 }
 
 int TaskModel::columns()
@@ -48,7 +48,7 @@ String TaskModel::header(int column)
 
 Variant TaskModel::data(int row, int column)
 {
-    auto &task = _data.get((size_t)row);
+    auto &task = _data.root().get((size_t)row);
 
     switch (column)
     {
@@ -67,10 +67,10 @@ Variant TaskModel::data(int row, int column)
     }
 
     case COLUMN_NAME:
-        return task.get("name").as_string();
+        return String{task.get("name").as_string()};
 
     case COLUMN_STATE:
-        return task.get("state").as_string();
+        return String{task.get("state").as_string()};
 
     case COLUMN_CPU:
         return Variant("%2d%%", task.get("cpu").as_integer());
@@ -85,11 +85,36 @@ Variant TaskModel::data(int row, int column)
 
 void TaskModel::update()
 {
-    _data = json::parse_file("/System/processes");
+    auto data = json::Document::load_file("/System/processes");
+
+    auto &old_tasks = _data.root();
+    auto &new_tasks = data.root();
+
+    // Tasks are listed by id, only the ones that came, went or changed
+    // are repainted.
+    did_diff_rows(
+        old_tasks.length(), new_tasks.length(),
+        [&](int old_row, int new_row) {
+            int old_id = old_tasks.get(old_row).get("id").as_integer();
+            int new_id = new_tasks.get(new_row).get("id").as_integer();
+
+            return (old_id > new_id) - (old_id < new_id);
+        },
+        [&](int old_row, int new_row) {
+            auto &old_task = old_tasks.get(old_row);
+            auto &new_task = new_tasks.get(new_row);
+
+            return old_task.get("cpu").as_integer() == new_task.get("cpu").as_integer() &&
+                   old_task.get("ram").as_integer() == new_task.get("ram").as_integer() &&
+                   old_task.get("state").as_string() == new_task.get("state").as_string() &&
+                   old_task.get("name").as_string() == new_task.get("name").as_string();
+        });
+
+    _data = move(data);
     did_update();
 }
 
-static String greedy(json::Value &data, const char *field)
+static String greedy(const json::Node &data, const char *field)
 {
     size_t most_greedy_index = 0;
     int most_greedy_value = 0;
@@ -107,20 +132,20 @@ static String greedy(json::Value &data, const char *field)
         }
     }
 
-    return data
-        .get(most_greedy_index)
-        .get("name")
-        .as_string();
+    return String{data
+                      .get(most_greedy_index)
+                      .get("name")
+                      .as_string()};
 }
 
 String TaskModel::ram_greedy()
 {
-    return greedy(_data, "ram");
+    return greedy(_data.root(), "ram");
 }
 
 String TaskModel::cpu_greedy()
 {
-    return greedy(_data, "cpu");
+    return greedy(_data.root(), "cpu");
 }
 
 void TaskModel::kill_task(int row)
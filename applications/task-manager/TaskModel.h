@@ -6,7 +6,7 @@
 class TaskModel : public TableModel
 {
 private:
-    json::Value _data;
+    json::Document _data{};
 
 public:
     int rows() override;
@@ -111,3 +111,53 @@ void render_cell(Painter &painter, int x, int y, terminal::Cell cell)
 {
     render_cell(painter, x, y, cell.codepoint, cell.attributes.foreground, cell.attributes.background, cell.attributes);
 }
+
+void render_run(Painter &painter, int x, int y, const terminal::Cell *cells, int count)
+{
+    terminal::Attributes attributes = cells[0].attributes;
+    terminal::Color foreground = attributes.foreground;
+    terminal::Color background = attributes.background;
+
+    if (attributes.invert)
+    {
+        swap(foreground, background);
+    }
+
+    Recti bound = {
+        cell_bound(x, y).position(),
+        cell_size() * Vec2i(count, 1),
+    };
+
+    if (background != terminal::BACKGROUND)
+    {
+        painter.clear_rectangle(bound, color(background));
+    }
+
+    Color foreground_color = color(foreground);
+
+    if (attributes.underline)
+    {
+        painter.draw_line(
+            bound.position() + Vec2i(0, 13),
+            bound.position() + Vec2i(bound.width(), 13),
+            foreground_color);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (cells[i].codepoint == U' ')
+        {
+            continue;
+        }
+
+        Glyph &glyph = font()->glyph(cells[i].codepoint);
+        Vec2i position = bound.position() + Vec2i(i * cell_size().x(), 12);
+
+        painter.draw_glyph(*font(), glyph, position, foreground_color);
+
+        if (attributes.bold)
+        {
+            painter.draw_glyph(*font(), glyph, position + Vec2i(1, 0), foreground_color);
+        }
+    }
+}
@@ -19,3 +19,5 @@ void render_cell(
     terminal::Attributes attributes);
 
 void render_cell(Painter &painter, int x, int y, terminal::Cell cell);
+
+void render_run(Painter &painter, int x, int y, const terminal::Cell *cells, int count);
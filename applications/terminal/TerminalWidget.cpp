@@ -9,6 +9,10 @@
 
 #define TERMINAL_IO_BUFFER_SIZE 4096
 
+// Output is accumulated in the terminal and only turned into repaints once
+// per frame, so a fast producer doesn't cause a repaint for every read.
+#define TERMINAL_REPAINT_INTERVAL (1000 / 60)
+
 void terminal_widget_server_callback(TerminalWidget *widget, Stream *server, PollEvent events)
 {
     __unused(events);
@@ -23,7 +27,7 @@ void terminal_widget_server_callback(TerminalWidget *widget, Stream *server, Pol
     }
 
     widget->terminal()->write(buffer, size);
-    widget->should_repaint();
+    widget->should_flush_damage();
 }
 
 TerminalWidget::TerminalWidget(Widget *parent) : Widget(parent)
@@ -51,6 +55,13 @@ TerminalWidget::TerminalWidget(Widget *parent) : Widget(parent)
 
     _cursor_blink_timer->start();
 
+    _repaint_timer = own<Timer>(TERMINAL_REPAINT_INTERVAL, [this]() {
+        if (!flush_damage())
+        {
+            _repaint_timer->stop();
+        }
+    });
+
     Launchpad *shell_launchpad = launchpad_create("shell", "/Applications/shell/shell");
     launchpad_handle(shell_launchpad, HANDLE(_client_stream), 0);
     launchpad_handle(shell_launchpad, HANDLE(_client_stream), 1);
@@ -68,6 +79,63 @@ TerminalWidget::~TerminalWidget()
     stream_close(_client_stream);
 }
 
+bool TerminalWidget::flush_damage()
+{
+    terminal::Terminal *terminal = _terminal;
+
+    bool has_damage = false;
+    Recti damaged = Recti::empty();
+
+    auto flush = [&]() {
+        if (!damaged.is_empty())
+        {
+            should_repaint(damaged.offset(bound().position()));
+            damaged = Recti::empty();
+        }
+    };
+
+    // Consecutive damaged lines are merged in a single rectangle, a scroll
+    // ends up being one repaint instead of one per line.
+    for (int y = 0; y < terminal->height(); y++)
+    {
+        terminal::Damage damage = terminal->line_damage(y);
+
+        if (!damage.any())
+        {
+            flush();
+            continue;
+        }
+
+        has_damage = true;
+        terminal->line_undirty(y);
+
+        Recti line_damaged = cell_bound(damage.from, y).merged_with(cell_bound(damage.to - 1, y));
+
+        if (damaged.is_empty())
+        {
+            damaged = line_damaged;
+        }
+        else
+        {
+            damaged = damaged.merged_with(line_damaged);
+        }
+    }
+
+    flush();
+
+    Vec2i cursor = Vec2i(terminal->cursor().x, terminal->cursor().y);
+
+    if (cursor != _painted_cursor)
+    {
+        has_damage = true;
+
+        should_repaint(cell_bound(_painted_cursor.x(), _painted_cursor.y()).offset(bound().position()));
+        should_repaint(cell_bound(cursor.x(), cursor.y()).offset(bound().position()));
+    }
+
+    return has_damage;
+}
+
 void TerminalWidget::paint(Painter &painter, Recti rectangle)
 {
     painter.clear_rectangle(rectangle, color(THEME_ANSI_BACKGROUND));
@@ -79,13 +147,24 @@ void TerminalWidget::paint(Painter &painter, Recti rectangle)
 
     terminal::Terminal *terminal = _terminal;
 
-    for (int y = 0; y < terminal->height(); y++)
+    int from_x = MAX(rectangle.left() / cell_size().x(), 0);
+    int from_y = MAX(rectangle.top() / cell_size().y(), 0);
+    int to_x = MIN((rectangle.right() + cell_size().x() - 1) / cell_size().x(), terminal->width());
+    int to_y = MIN((rectangle.bottom() + cell_size().y() - 1) / cell_size().y(), terminal->height());
+
+    for (int y = from_y; y < to_y; y++)
     {
-        for (int x = 0; x < terminal->width(); x++)
+        const terminal::Cell *cells = terminal->cells(y);
+
+        int run_start = from_x;
+
+        for (int x = from_x + 1; x <= to_x; x++)
         {
-            terminal::Cell cell = terminal->cell_at(x, y);
-            render_cell(painter, x, y, cell);
-            terminal->cell_undirty(x, y);
+            if (x == to_x || cells[x].attributes != cells[run_start].attributes)
+            {
+                render_run(painter, run_start, y, &cells[run_start], x - run_start);
+                run_start = x;
+            }
         }
     }
 
@@ -119,6 +198,8 @@ void TerminalWidget::paint(Painter &painter, Recti rectangle)
             render_cell(painter, cx, cy, cell);
             painter.draw_rectangle(cell_bound(cx, cy), color(THEME_ANSI_CURSOR));
         }
+
+        _painted_cursor = Vec2i(cx, cy);
     }
 
     painter.pop();
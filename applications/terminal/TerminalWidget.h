@@ -17,13 +17,20 @@ private:
     Stream *_client_stream;
 
     OwnPtr<Timer> _cursor_blink_timer;
+    OwnPtr<Timer> _repaint_timer;
     Notifier *_server_notifier;
 
+    Vec2i _painted_cursor = Vec2i::zero();
+
 public:
     terminal::Terminal *terminal() { return _terminal; }
 
     void blink() { _cursor_blink = !_cursor_blink; };
 
+    void should_flush_damage() { _repaint_timer->start(); }
+
+    bool flush_damage();
+
     TerminalWidget(Widget *parent);
 
     ~TerminalWidget();
@@ -20,6 +20,9 @@ size_t arch_debug_write(const void *buffer, size_t size);
 
 TimeStamp arch_get_time();
 
+// A counter going up at a constant rate, only meaningful as a difference.
+uint64_t arch_get_cycles();
+
 __no_return void arch_reboot();
 
 __no_return void arch_shutdown();
@@ -42,6 +42,8 @@ size_t arch_debug_write(const void *buffer, size_t size) { return com_write(COM1
 
 TimeStamp arch_get_time() { return rtc_now(); }
 
+uint64_t arch_get_cycles() { return rdtsc(); }
+
 extern "C" void arch_main(void *info, uint32_t magic)
 {
     __plug_init();
@@ -86,6 +86,11 @@ TimeStamp arch_get_time()
     return rtc_now();
 }
 
+uint64_t arch_get_cycles()
+{
+    return rdtsc();
+}
+
 __no_return void arch_reboot()
 {
     logger_warn("STUB %s", __func__);
@@ -19,3 +19,47 @@
 #define VIRTIO_REGISTER_QUEUE_NOTIFY (0x10)
 #define VIRTIO_REGISTER_DEVICE_STATUS (0x12)
 #define VIRTIO_REGISTER_ISR_STATUS (0x13)
+
+// Device specific configuration, when MSI-X is disabled.
+#define VIRTIO_REGISTER_DEVICE_CONFIG (0x14)
+
+#define VIRTIO_ISR_QUEUE (1)
+#define VIRTIO_ISR_CONFIG (2)
+
+// 2.6 Split Virtqueues
+
+#define VIRTIO_QUEUE_ALIGN (4096)
+
+#define VIRTQ_DESCRIPTOR_F_NEXT (1)
+#define VIRTQ_DESCRIPTOR_F_WRITE (2)
+
+#define VIRTQ_AVAILABLE_F_NO_INTERRUPT (1)
+#define VIRTQ_USED_F_NO_NOTIFY (1)
+
+struct __packed VirtqDescriptor
+{
+    uint64_t address;
+    uint32_t length;
+    uint16_t flags;
+    uint16_t next;
+};
+
+struct __packed VirtqAvailable
+{
+    uint16_t flags;
+    uint16_t index;
+    uint16_t ring[];
+};
+
+struct __packed VirtqUsedElement
+{
+    uint32_t id;
+    uint32_t length;
+};
+
+struct __packed VirtqUsed
+{
+    uint16_t flags;
+    uint16_t index;
+    VirtqUsedElement ring[];
+};
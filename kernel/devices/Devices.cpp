@@ -9,6 +9,7 @@
 #include "kernel/bus/UNIX.h"
 #include "kernel/devices/Devices.h"
 #include "kernel/devices/Driver.h"
+#include "kernel/interrupts/Dispatcher.h"
 
 static Vector<RefPtr<Device>> *_devices = nullptr;
 
@@ -69,30 +70,6 @@ void device_iterate(IterationCallback<RefPtr<Device>> callback)
     }
 }
 
-void devices_acknowledge_interrupt(int interrupt)
-{
-    device_iterate([&](auto device) {
-        if (device->interrupt() == interrupt)
-        {
-            device->acknowledge_interrupt();
-        }
-
-        return Iteration::CONTINUE;
-    });
-}
-
-void devices_handle_interrupt(int interrupt)
-{
-    device_iterate([&](auto device) {
-        if (device->interrupt() == interrupt)
-        {
-            device->handle_interrupt();
-        }
-
-        return Iteration::CONTINUE;
-    });
-}
-
 void device_initialize()
 {
     pci_initialize();
@@ -115,7 +92,14 @@ void device_initialize()
 
         logger_info("Found a driver: %s", driver->name());
 
-        _devices->push_back(driver->instance(address));
+        auto device = driver->instance(address);
+
+        if (device->interrupt() != -1)
+        {
+            dispatcher_attach(device->interrupt(), device.naked());
+        }
+
+        _devices->push_back(device);
 
         return Iteration::CONTINUE;
     });
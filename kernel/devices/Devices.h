@@ -14,7 +14,3 @@ void device_iterate(IterationCallback<RefPtr<Device>> callback);
 String device_claim_name(DeviceClass klass);
 
 void device_initialize();
-
-void devices_acknowledge_interrupt(int interrupt);
-
-void devices_handle_interrupt(int interrupt);
@@ -1,14 +1,97 @@
 #pragma once
 
+#include <libutils/OwnPtr.h>
+
 #include "kernel/bus/Virtio.h"
 #include "kernel/devices/PCIDevice.h"
+#include "kernel/devices/VirtioQueue.h"
 
+// Legacy virtio devices, configured through the I/O ports of their first bar.
 class VirtioDevice : public PCIDevice
 {
 private:
+    uint16_t _io_base;
+
 public:
     VirtioDevice(DeviceAddress address, DeviceClass klass) : PCIDevice(address, klass)
     {
+        _io_base = bar(0).base();
+    }
+
+    // Reset the device and accept the `wanted` features it offers, those
+    // are returned.
+    uint32_t negotiate(uint32_t wanted)
+    {
+        // The device writes in memory, it has to be a bus master.
+        pci_address().write16(PCI_COMMAND, pci_address().read16(PCI_COMMAND) | 0x5);
+
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, 0);
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, VIRTIO_STATUS_ACKNOWLEDGE);
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+        uint32_t features = in32(_io_base + VIRTIO_REGISTER_DEVICE_FEATURES) & wanted;
+        out32(_io_base + VIRTIO_REGISTER_GUEST_FEATURES, features);
+
+        return features;
+    }
+
+    // Null when the device has no such queue.
+    OwnPtr<VirtioQueue> setup_queue(uint16_t index)
+    {
+        out16(_io_base + VIRTIO_REGISTER_QUEUE_SELECT, index);
+
+        uint16_t size = in16(_io_base + VIRTIO_REGISTER_QUEUE_SIZE);
+
+        if (size == 0)
+        {
+            return nullptr;
+        }
+
+        auto queue = own<VirtioQueue>(size);
+        out32(_io_base + VIRTIO_REGISTER_QUEUE_ADDRESS, queue->physical_base() / VIRTIO_QUEUE_ALIGN);
+
+        return queue;
+    }
+
+    void ready()
+    {
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER | VIRTIO_STATUS_DRIVER_OK);
+    }
+
+    void failed()
+    {
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, VIRTIO_STATUS_FAILED);
+    }
+
+    void notify(uint16_t index)
+    {
+        out16(_io_base + VIRTIO_REGISTER_QUEUE_NOTIFY, index);
+    }
+
+    // Reading it lowers the interrupt line.
+    uint8_t interrupt_status()
+    {
+        return in8(_io_base + VIRTIO_REGISTER_ISR_STATUS);
+    }
+
+    uint8_t read_config8(uint16_t offset)
+    {
+        return in8(_io_base + VIRTIO_REGISTER_DEVICE_CONFIG + offset);
+    }
+
+    uint16_t read_config16(uint16_t offset)
+    {
+        return in16(_io_base + VIRTIO_REGISTER_DEVICE_CONFIG + offset);
+    }
+
+    uint32_t read_config32(uint16_t offset)
+    {
+        return in32(_io_base + VIRTIO_REGISTER_DEVICE_CONFIG + offset);
+    }
+
+    uint64_t read_config64(uint16_t offset)
+    {
+        return read_config32(offset) | ((uint64_t)read_config32(offset + 4) << 32);
     }
 
     ~VirtioDevice()
@@ -0,0 +1,136 @@
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+
+#include "kernel/devices/VirtioQueue.h"
+
+size_t VirtioQueue::memory_size(uint16_t size)
+{
+    size_t available = sizeof(VirtqDescriptor) * size + sizeof(VirtqAvailable) + sizeof(uint16_t) * (size + 1);
+    size_t used = sizeof(VirtqUsed) + sizeof(VirtqUsedElement) * size + sizeof(uint16_t);
+
+    return __align_up(available, VIRTIO_QUEUE_ALIGN) + __align_up(used, VIRTIO_QUEUE_ALIGN);
+}
+
+VirtioQueue::VirtioQueue(uint16_t size)
+    : _size(size),
+      _free_count(size)
+{
+    _range = make<MMIORange>(memory_size(size));
+    memset((void *)_range->base(), 0, _range->size());
+
+    size_t available_offset = sizeof(VirtqDescriptor) * size;
+    size_t used_offset = __align_up(available_offset + sizeof(VirtqAvailable) + sizeof(uint16_t) * (size + 1), VIRTIO_QUEUE_ALIGN);
+
+    _descriptors = reinterpret_cast<VirtqDescriptor *>(_range->base());
+    _available = reinterpret_cast<VirtqAvailable *>(_range->base() + available_offset);
+    _used = reinterpret_cast<VirtqUsed *>(_range->base() + used_offset);
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        _descriptors[i].next = i + 1;
+    }
+
+    _tokens = new void *[size];
+}
+
+VirtioQueue::~VirtioQueue()
+{
+    delete[] _tokens;
+}
+
+bool VirtioQueue::push(const VirtioBuffer *buffers, size_t readable, size_t writable, void *token)
+{
+    size_t count = readable + writable;
+
+    assert(count > 0);
+
+    if (count > _free_count)
+    {
+        return false;
+    }
+
+    uint16_t head = _free_head;
+    uint16_t last = head;
+    uint16_t current = head;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        VirtqDescriptor &descriptor = _descriptors[current];
+
+        descriptor.address = buffers[i].physical;
+        descriptor.length = buffers[i].length;
+        descriptor.flags = (i >= readable ? VIRTQ_DESCRIPTOR_F_WRITE : 0) |
+                           (i + 1 < count ? VIRTQ_DESCRIPTOR_F_NEXT : 0);
+
+        last = current;
+        current = descriptor.next;
+    }
+
+    _free_head = _descriptors[last].next;
+    _free_count -= count;
+
+    _tokens[head] = token;
+
+    _available->ring[_available->index % _size] = head;
+
+    // The chain must be visible before the index telling the device about it.
+    __sync_synchronize();
+    _available->index++;
+
+    return true;
+}
+
+bool VirtioQueue::should_notify()
+{
+    __sync_synchronize();
+    return !(_used->flags & VIRTQ_USED_F_NO_NOTIFY);
+}
+
+bool VirtioQueue::has_used()
+{
+    __sync_synchronize();
+    return _last_used != _used->index;
+}
+
+bool VirtioQueue::pop(void **token, uint32_t *written)
+{
+    if (!has_used())
+    {
+        return false;
+    }
+
+    VirtqUsedElement &element = _used->ring[_last_used % _size];
+    _last_used++;
+
+    uint16_t head = element.id;
+    uint16_t last = head;
+    uint16_t count = 1;
+
+    while (_descriptors[last].flags & VIRTQ_DESCRIPTOR_F_NEXT)
+    {
+        last = _descriptors[last].next;
+        count++;
+    }
+
+    // Give the chain back to the free list.
+    _descriptors[last].next = _free_head;
+    _free_head = head;
+    _free_count += count;
+
+    *token = _tokens[head];
+    *written = element.length;
+
+    return true;
+}
+
+void VirtioQueue::disable_interrupts()
+{
+    _available->flags |= VIRTQ_AVAILABLE_F_NO_INTERRUPT;
+}
+
+bool VirtioQueue::enable_interrupts()
+{
+    _available->flags &= ~VIRTQ_AVAILABLE_F_NO_INTERRUPT;
+
+    return !has_used();
+}
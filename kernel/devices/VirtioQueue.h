@@ -0,0 +1,72 @@
+#pragma once
+
+#include <libutils/RefPtr.h>
+
+#include "kernel/bus/Virtio.h"
+#include "kernel/memory/MMIO.h"
+
+struct VirtioBuffer
+{
+    uintptr_t physical;
+    uint32_t length;
+};
+
+// A split virtqueue, the descriptor table, the ring of chains made
+// available to the device and the ring of the ones it is done with, all in
+// one physically contiguous range laid out the way legacy devices expect.
+//
+// Chains are pushed without telling the device, kick() does so once for a
+// whole batch, and only if the device did not ask not to be bothered.
+class VirtioQueue
+{
+private:
+    uint16_t _size;
+
+    RefPtr<MMIORange> _range;
+
+    VirtqDescriptor *_descriptors;
+    VirtqAvailable *_available;
+    VirtqUsed *_used;
+
+    uint16_t _free_head = 0;
+    uint16_t _free_count;
+    uint16_t _last_used = 0;
+
+    // What the chain starting at each descriptor was pushed with.
+    void **_tokens;
+
+    __noncopyable(VirtioQueue);
+    __nonmovable(VirtioQueue);
+
+public:
+    static size_t memory_size(uint16_t size);
+
+    uint16_t size() const { return _size; }
+
+    uint16_t free_count() const { return _free_count; }
+
+    uintptr_t physical_base() { return _range->physical_base(); }
+
+    VirtioQueue(uint16_t size);
+
+    ~VirtioQueue();
+
+    // The device reads the `readable` first buffers and writes the `writable`
+    // ones after them. False when there are not enough free descriptors.
+    bool push(const VirtioBuffer *buffers, size_t readable, size_t writable, void *token);
+
+    // Whether the device should be notified of the chains pushed so far.
+    bool should_notify();
+
+    // Take a chain the device is done with, false when there is none.
+    bool pop(void **token, uint32_t *written);
+
+    bool has_used();
+
+    // Ask the device not to raise interrupts while the used ring is drained.
+    void disable_interrupts();
+
+    // False when chains were used in the meantime, they must be drained
+    // before waiting for the next interrupt.
+    bool enable_interrupts();
+};
@@ -1,4 +1,5 @@
 #include "kernel/drivers/AC97.h"
+#include "kernel/interrupts/Dispatcher.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/tasking/Task.h"
 
@@ -93,33 +94,30 @@ void AC97::query_from_buffer(void *destination, size_t size)
     }
 }
 
-void AC97::acknowledge_interrupt()
+void AC97::refill()
 {
-    _status = in16(nabmbar + AC97_PO_SR);
+    size_t f = (_last_valid_index + 2) % AC97_BDL_LEN;
 
-    if (_status)
-    {
-        out16(nabmbar + AC97_PO_SR, _status & 0x1E);
-    }
+    query_from_buffer((void *)buffers[f]->base(), AC97_BDL_BUFFER_LEN * 2);
+    _last_valid_index = (_last_valid_index + 1) % AC97_BDL_LEN;
+    out8(nabmbar + AC97_PO_LVI, _last_valid_index);
 }
 
-void AC97::handle_interrupt()
+void AC97::acknowledge_interrupt()
 {
-    if (_status & AC97_X_SR_BCIS)
-    {
-        size_t f = (_last_valid_index + 2) % AC97_BDL_LEN;
+    uint16_t status = in16(nabmbar + AC97_PO_SR);
 
-        query_from_buffer((void *)buffers[f]->base(), AC97_BDL_BUFFER_LEN * 2);
-        _last_valid_index = (_last_valid_index + 1) % AC97_BDL_LEN;
-        out8(nabmbar + AC97_PO_LVI, _last_valid_index);
-    }
-    else if (_status & AC97_X_SR_LVBCI)
+    if (!status)
     {
-        logger_trace("IRQ is lvbci");
+        return;
     }
-    else if (_status & AC97_X_SR_FIFOE)
+
+    out16(nabmbar + AC97_PO_SR, status & 0x1E);
+
+    // Copying the next buffer takes a while, it is done by the dispatcher.
+    if (status & AC97_X_SR_BCIS)
     {
-        logger_trace("IRQ is fifoe");
+        dispatcher_enqueue([](void *ac97) { static_cast<AC97 *>(ac97)->refill(); }, this);
     }
 }
 
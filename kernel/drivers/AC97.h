@@ -70,8 +70,6 @@ struct __packed AC97BufferDescriptor
 class AC97 : public PCIDevice
 {
 private:
-    uint16_t _status;
-
     uint16_t nabmbar;
     uint16_t nambar;
 
@@ -96,6 +94,8 @@ private:
 
     void query_from_buffer(void *destination, size_t size);
 
+    void refill();
+
 public:
     AC97(DeviceAddress address);
 
@@ -103,8 +103,6 @@ public:
 
     void acknowledge_interrupt() override;
 
-    void handle_interrupt() override;
-
     bool can_write(FsHandle &handle) override;
 
     ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
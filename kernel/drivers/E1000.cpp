@@ -1,7 +1,8 @@
 #include <libsystem/Logger.h>
-#include <libsystem/utils/Hexdump.h>
+#include <libsystem/math/MinMax.h>
 
 #include "kernel/drivers/E1000.h"
+#include "kernel/interrupts/Dispatcher.h"
 
 void E1000::write_register(uint16_t offset, uint32_t value)
 {
@@ -150,16 +151,12 @@ void E1000::enable_interrupt()
 {
     write_register(E1000_REG_IMASK, 0x1F6DC);
     write_register(E1000_REG_IMASK, 0xff & ~4);
-    read_register(0xc0);
+    read_register(E1000_REG_INTERRUPT_CAUSE);
 }
 
 size_t E1000::receive_packet(void *buffer, size_t size)
 {
-    __unused(size);
-
-    logger_trace("rx");
-
-    uint32_t packet_size = _rx_descriptors[_current_rx_descriptors].length;
+    uint32_t packet_size = MIN(_rx_descriptors[_current_rx_descriptors].length, size);
     _rx_buffers[_current_rx_descriptors]->read(0, buffer, packet_size);
     _rx_descriptors[_current_rx_descriptors].status = 0;
 
@@ -172,8 +169,6 @@ size_t E1000::receive_packet(void *buffer, size_t size)
 
 size_t E1000::send_packet(const void *buffer, size_t size)
 {
-    logger_trace("tx");
-
     _tx_buffers[_current_tx_descriptors]->write(0, buffer, size);
     _tx_descriptors[_current_tx_descriptors].length = size;
     _tx_descriptors[_current_tx_descriptors].command = CMD_EOP | CMD_IFCS | CMD_RS;
@@ -208,15 +203,19 @@ E1000::E1000(DeviceAddress address) : PCIDevice(address, DeviceClass::NETWORK)
 
 void E1000::acknowledge_interrupt()
 {
-    write_register(E1000_REG_IMASK, 0x0);
+    // Reading the cause clears it and lowers the interrupt line.
+    uint32_t cause = read_register(E1000_REG_INTERRUPT_CAUSE);
+
+    if (cause & E1000_INTERRUPT_LINK_STATUS_CHANGE)
+    {
+        dispatcher_enqueue([](void *e1000) { static_cast<E1000 *>(e1000)->link_changed(); }, this);
+    }
 }
 
-void E1000::handle_interrupt()
+void E1000::link_changed()
 {
     uint32_t status = read_register(E1000_REG_STATUS);
 
-    // logger_trace("e1000 interrupt (STATUS=%08x)!", status);
-
     if (status & 4)
     {
         uint32_t flags = read_register(E1000_REG_CONTROL);
@@ -242,22 +241,14 @@ ResultOr<size_t> E1000::read(FsHandle &handle, void *buffer, size_t size)
 {
     __unused(handle);
 
-    size_t packet_size = receive_packet(buffer, size);
-    logger_trace("Packet receive (size=%u)", packet_size);
-    hexdump(buffer, packet_size);
-
-    return packet_size;
+    return receive_packet(buffer, size);
 }
 
 ResultOr<size_t> E1000::write(FsHandle &handle, const void *buffer, size_t size)
 {
     __unused(handle);
 
-    size_t packet_size = send_packet(buffer, size);
-    logger_trace("Packet send (size=%u)", packet_size);
-    hexdump(buffer, packet_size);
-
-    return packet_size;
+    return send_packet(buffer, size);
 }
 
 Result E1000::call(FsHandle &handle, IOCall request, void *args)
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <libsystem/utils/Hexdump.h>
 #include <libutils/Vector.h>
 
 #include "kernel/devices/PCIDevice.h"
@@ -10,10 +9,13 @@
 #define E1000_REG_STATUS 0x0008
 
 #define E1000_REG_EEPROM 0x0014
+#define E1000_REG_INTERRUPT_CAUSE 0x00C0
 #define E1000_REG_IMASK 0x00D0
 #define E1000_REG_MAC_LOW 0x5400
 #define E1000_REG_MAC_HIGHT 0x5404
 
+#define E1000_INTERRUPT_LINK_STATUS_CHANGE (1 << 2)
+
 #define E1000_REG_RX_CONTROL 0x0100
 #define E1000_REG_RX_LOW 0x2800
 #define E1000_REG_RX_HIGH 0x2804
@@ -138,6 +140,8 @@ private:
 
     void enable_interrupt();
 
+    void link_changed();
+
     size_t receive_packet(void *buffer, size_t size);
 
     size_t send_packet(const void *buffer, size_t size);
@@ -147,8 +151,6 @@ public:
 
     void acknowledge_interrupt() override;
 
-    void handle_interrupt() override;
-
     bool can_write(FsHandle &handle) override;
 
     bool can_read(FsHandle &handle) override;
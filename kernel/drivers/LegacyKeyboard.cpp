@@ -1,6 +1,8 @@
 #include "kernel/Configs.h"
 
 #include "kernel/drivers/LegacyKeyboard.h"
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/interrupts/Interupts.h"
 
 KeyMap *keyboard_load_keymap(const char *keymap_path)
 {
@@ -165,37 +167,72 @@ LegacyKeyboard::LegacyKeyboard(DeviceAddress address) : LegacyDevice(address, De
     _keymap = keyboard_load_keymap("/Files/Keyboards/" CONFIG_KEYBOARD_LAYOUT ".kmap");
 }
 
-void LegacyKeyboard::handle_interrupt()
+void LegacyKeyboard::handle_scancode(uint8_t scancode)
 {
-    uint8_t status = in8(PS2_STATUS);
-
-    while (((status & PS2_WHICH_BUFFER) == PS2_KEYBOARD_BUFFER) &&
-           (status & PS2_BUFFER_FULL))
+    if (_escaped)
     {
-        uint8_t scancode = in8(PS2_BUFFER);
+        Key key = scancode_to_key((scancode & 0x7F) + 0x80);
+        handle_key(key, scancode & 0x80 ? KEY_MOTION_UP : KEY_MOTION_DOWN);
 
-        if (_escaped)
+        _escaped = false;
+    }
+    else
+    {
+        if (scancode == PS2KBD_ESCAPE)
         {
-            Key key = scancode_to_key((scancode & 0x7F) + 0x80);
-            handle_key(key, scancode & 0x80 ? KEY_MOTION_UP : KEY_MOTION_DOWN);
-
-            _escaped = false;
+            _escaped = true;
         }
         else
         {
-            if (scancode == PS2KBD_ESCAPE)
-            {
-                _escaped = true;
-            }
-            else
+            Key key = scancode_to_key(scancode & 0x7F);
+            handle_key(key, scancode & 0x80 ? KEY_MOTION_UP : KEY_MOTION_DOWN);
+        }
+    }
+}
+
+void LegacyKeyboard::decode()
+{
+    while (true)
+    {
+        uint8_t scancode;
+
+        {
+            InterruptsRetainer retainer;
+
+            if (_scancodes.empty())
             {
-                Key key = scancode_to_key(scancode & 0x7F);
-                handle_key(key, scancode & 0x80 ? KEY_MOTION_UP : KEY_MOTION_DOWN);
+                _decode_queued = false;
+                return;
             }
+
+            scancode = _scancodes.get();
+        }
+
+        handle_scancode(scancode);
+    }
+}
+
+void LegacyKeyboard::acknowledge_interrupt()
+{
+    uint8_t status = in8(PS2_STATUS);
+
+    while (((status & PS2_WHICH_BUFFER) == PS2_KEYBOARD_BUFFER) &&
+           (status & PS2_BUFFER_FULL))
+    {
+        uint8_t scancode = in8(PS2_BUFFER);
+
+        if (!_scancodes.full())
+        {
+            _scancodes.put(scancode);
         }
 
         status = in8(PS2_STATUS);
     }
+
+    if (!_decode_queued && !_scancodes.empty())
+    {
+        _decode_queued = dispatcher_enqueue([](void *keyboard) { static_cast<LegacyKeyboard *>(keyboard)->decode(); }, this);
+    }
 }
 
 bool LegacyKeyboard::can_read(FsHandle &handle)
@@ -13,6 +13,12 @@ class LegacyKeyboard : public LegacyDevice
 private:
     Lock _events_lock;
     RingBuffer _events{sizeof(KeyboardPacket) * 1024};
+
+    // Read from the controller by the interrupt handler, decoded later by
+    // the dispatcher.
+    RingBuffer _scancodes{256};
+    bool _decode_queued = false;
+
     bool _escaped = false;
     KeyMap *_keymap = nullptr;
     KeyMotion _keystate[__KEY_COUNT] = {};
@@ -25,10 +31,14 @@ private:
 
     void handle_key(Key key, KeyMotion motion);
 
+    void handle_scancode(uint8_t scancode);
+
+    void decode();
+
 public:
     LegacyKeyboard(DeviceAddress address);
 
-    void handle_interrupt() override;
+    void acknowledge_interrupt() override;
 
     bool can_read(FsHandle &handle) override;
 
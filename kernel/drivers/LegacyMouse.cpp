@@ -1,4 +1,6 @@
 #include "kernel/drivers/LegacyMouse.h"
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/interrupts/Interupts.h"
 
 void LegacyMouse::wait(int type)
 {
@@ -127,7 +129,29 @@ LegacyMouse::LegacyMouse(DeviceAddress address) : LegacyDevice(address, DeviceCl
     read_register(); //Acknowledge
 }
 
-void LegacyMouse::handle_interrupt()
+void LegacyMouse::decode()
+{
+    while (true)
+    {
+        uint8_t packet;
+
+        {
+            InterruptsRetainer retainer;
+
+            if (_bytes.empty())
+            {
+                _decode_queued = false;
+                return;
+            }
+
+            packet = _bytes.get();
+        }
+
+        handle_packet(packet);
+    }
+}
+
+void LegacyMouse::acknowledge_interrupt()
 {
     uint8_t status = in8(PS2_STATUS);
 
@@ -135,9 +159,19 @@ void LegacyMouse::handle_interrupt()
            (status & PS2_BUFFER_FULL))
     {
         uint8_t packet = in8(PS2_BUFFER);
-        handle_packet(packet);
+
+        if (!_bytes.full())
+        {
+            _bytes.put(packet);
+        }
+
         status = in8(PS2_STATUS);
     }
+
+    if (!_decode_queued && !_bytes.empty())
+    {
+        _decode_queued = dispatcher_enqueue([](void *mouse) { static_cast<LegacyMouse *>(mouse)->decode(); }, this);
+    }
 }
 
 bool LegacyMouse::can_read(FsHandle &handle)
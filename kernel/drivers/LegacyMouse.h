@@ -11,6 +11,12 @@ class LegacyMouse : public LegacyDevice
 private:
     Lock _events_lock;
     RingBuffer _events{sizeof(MousePacket) * 1024};
+
+    // Read from the controller by the interrupt handler, decoded later by
+    // the dispatcher.
+    RingBuffer _bytes{256};
+    bool _decode_queued = false;
+
     int _cycle = 0;
     uint8_t _packet[4];
 
@@ -24,10 +30,12 @@ private:
 
     void handle_packet(uint8_t packet);
 
+    void decode();
+
 public:
     LegacyMouse(DeviceAddress address);
 
-    void handle_interrupt() override;
+    void acknowledge_interrupt() override;
 
     bool can_read(FsHandle &handle) override;
 
@@ -1 +1,337 @@
+#include <libsystem/Assert.h>
+#include <libsystem/Logger.h>
+#include <libsystem/math/MinMax.h>
+
 #include "kernel/drivers/VirtioBlock.h"
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Blocker.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/storage/BlockCache.h"
+#include "kernel/tasking/Task.h"
+
+class BlockerVirtioBlock : public Blocker
+{
+private:
+    VirtioBlockCompletion &_completion;
+
+public:
+    BlockerVirtioBlock(VirtioBlockCompletion &completion) : _completion(completion) {}
+
+    bool can_unblock(struct Task *task)
+    {
+        __unused(task);
+
+        return _completion.done;
+    }
+};
+
+VirtioBlock::VirtioBlock(DeviceAddress address) : VirtioDevice(address, DeviceClass::DISK)
+{
+    uint32_t features = negotiate(VIRTIO_BLOCK_F_SEG_MAX | VIRTIO_BLOCK_F_RO | VIRTIO_BLOCK_F_FLUSH);
+
+    _queue = setup_queue(0);
+
+    if (_queue == nullptr)
+    {
+        logger_error("The block device has no request queue!");
+        failed();
+        return;
+    }
+
+    _capacity = read_config64(VIRTIO_BLOCK_CONFIG_CAPACITY);
+    _read_only = features & VIRTIO_BLOCK_F_RO;
+    _can_flush = features & VIRTIO_BLOCK_F_FLUSH;
+
+    if (features & VIRTIO_BLOCK_F_SEG_MAX)
+    {
+        _max_segments = MIN(_max_segments, MAX(read_config32(VIRTIO_BLOCK_CONFIG_SEG_MAX), 1u));
+    }
+
+    // A request also needs a descriptor for its header and one for its status.
+    _max_segments = MIN(_max_segments, _queue->size() - 2u);
+
+    size_t slot_count = MAX(_queue->size() / 3, 1);
+
+    _slots_range = make<MMIORange>(sizeof(VirtioBlockSlot) * slot_count);
+    _slots = reinterpret_cast<VirtioBlockSlot *>(_slots_range->base());
+    _completions = new VirtioBlockCompletion *[slot_count];
+    _free_slots = new uint16_t[slot_count];
+
+    for (size_t i = 0; i < slot_count; i++)
+    {
+        _free_slots[_free_slot_count++] = i;
+    }
+
+    ready();
+
+    logger_info("Block device with %d sectors, up to %d segments per request", (int)_capacity, (int)_max_segments);
+}
+
+VirtioBlock::~VirtioBlock()
+{
+    delete[] _completions;
+    delete[] _free_slots;
+}
+
+bool VirtioBlock::submit(uint32_t type, uint64_t sector, const VirtioBuffer *segments, size_t count, VirtioBlockCompletion *completion)
+{
+    InterruptsRetainer retainer;
+
+    if (_free_slot_count == 0 || _queue->free_count() < count + 2)
+    {
+        return false;
+    }
+
+    uint16_t slot = _free_slots[--_free_slot_count];
+
+    _slots[slot].header = {type, 0, sector};
+    _slots[slot].status = 0xff;
+
+    uintptr_t slot_physical = _slots_range->physical_base() + slot * sizeof(VirtioBlockSlot);
+
+    VirtioBuffer buffers[VIRTIO_BLOCK_MAX_SEGMENTS + 2];
+
+    buffers[0] = {slot_physical, sizeof(VirtioBlockHeader)};
+
+    for (size_t i = 0; i < count; i++)
+    {
+        buffers[i + 1] = segments[i];
+    }
+
+    buffers[count + 1] = {slot_physical + __builtin_offsetof(VirtioBlockSlot, status), 1};
+
+    completion->done = false;
+    completion->result = SUCCESS;
+    _completions[slot] = completion;
+
+    // The device writes into the segments of reads.
+    size_t readable = type == VIRTIO_BLOCK_T_IN ? 1 : count + 1;
+    size_t writable = count + 2 - readable;
+
+    return _queue->push(buffers, readable, writable, (void *)(uintptr_t)slot);
+}
+
+void VirtioBlock::kick()
+{
+    InterruptsRetainer retainer;
+
+    if (_queue->should_notify())
+    {
+        notify(0);
+    }
+}
+
+void VirtioBlock::complete()
+{
+    do
+    {
+        _queue->disable_interrupts();
+
+        void *token;
+        uint32_t written;
+
+        while (_queue->pop(&token, &written))
+        {
+            uint16_t slot = (uintptr_t)token;
+            VirtioBlockCompletion *completion = _completions[slot];
+
+            switch (_slots[slot].status)
+            {
+            case VIRTIO_BLOCK_S_OK:
+                completion->result = SUCCESS;
+                break;
+
+            case VIRTIO_BLOCK_S_UNSUPP:
+                completion->result = ERR_OPERATION_NOT_SUPPORTED;
+                break;
+
+            default:
+                completion->result = ERR_INPUT_OUTPUT;
+                break;
+            }
+
+            completion->done = true;
+            _free_slots[_free_slot_count++] = slot;
+        }
+    } while (!_queue->enable_interrupts());
+}
+
+void VirtioBlock::acknowledge_interrupt()
+{
+    if ((interrupt_status() & VIRTIO_ISR_QUEUE) && _queue != nullptr)
+    {
+        complete();
+    }
+}
+
+void VirtioBlock::wait(VirtioBlockCompletion &completion)
+{
+    if (!completion.done)
+    {
+        task_block(scheduler_running(), new BlockerVirtioBlock(completion), -1);
+    }
+}
+
+Result VirtioBlock::storage_transfer(bool write, uint64_t offset, const uintptr_t *pages, size_t size)
+{
+    assert(offset % VIRTIO_BLOCK_SECTOR_SIZE == 0 && size % VIRTIO_BLOCK_SECTOR_SIZE == 0);
+
+    if (_queue == nullptr)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    if (write && _read_only)
+    {
+        return ERR_READ_ONLY_STREAM;
+    }
+
+    if (offset + size > storage_size())
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    uint32_t type = write ? VIRTIO_BLOCK_T_OUT : VIRTIO_BLOCK_T_IN;
+
+    VirtioBlockCompletion completions[VIRTIO_BLOCK_IN_FLIGHT];
+    size_t submitted = 0;
+    size_t finished = 0;
+
+    Result result = SUCCESS;
+
+    auto retire_oldest = [&]() {
+        VirtioBlockCompletion &completion = completions[finished % VIRTIO_BLOCK_IN_FLIGHT];
+
+        wait(completion);
+
+        if (result == SUCCESS)
+        {
+            result = completion.result;
+        }
+
+        finished++;
+    };
+
+    size_t position = 0;
+
+    while (position < size && result == SUCCESS)
+    {
+        if (submitted - finished == VIRTIO_BLOCK_IN_FLIGHT)
+        {
+            kick();
+            retire_oldest();
+            continue;
+        }
+
+        // The pages of the request, merged when they follow each other.
+        VirtioBuffer segments[VIRTIO_BLOCK_MAX_SEGMENTS];
+        size_t count = 0;
+        size_t length = 0;
+        size_t wanted = MIN(size - position, (size_t)VIRTIO_BLOCK_REQUEST_SIZE);
+
+        while (length < wanted)
+        {
+            uintptr_t physical = pages[(position + length) / ARCH_PAGE_SIZE];
+            size_t in_page = MIN((size_t)ARCH_PAGE_SIZE, wanted - length);
+
+            if (count > 0 && segments[count - 1].physical + segments[count - 1].length == physical)
+            {
+                segments[count - 1].length += in_page;
+            }
+            else if (count < _max_segments)
+            {
+                segments[count++] = {physical, (uint32_t)in_page};
+            }
+            else
+            {
+                break;
+            }
+
+            length += in_page;
+        }
+
+        uint64_t sector = (offset + position) / VIRTIO_BLOCK_SECTOR_SIZE;
+
+        if (!submit(type, sector, segments, count, &completions[submitted % VIRTIO_BLOCK_IN_FLIGHT]))
+        {
+            // The queue is full of requests from someone else.
+            kick();
+
+            if (submitted > finished)
+            {
+                retire_oldest();
+            }
+            else
+            {
+                scheduler_yield();
+            }
+
+            continue;
+        }
+
+        submitted++;
+        position += length;
+    }
+
+    kick();
+
+    while (finished < submitted)
+    {
+        retire_oldest();
+    }
+
+    return result;
+}
+
+Result VirtioBlock::storage_flush()
+{
+    if (_queue == nullptr || !_can_flush)
+    {
+        return SUCCESS;
+    }
+
+    VirtioBlockCompletion completion;
+
+    while (!submit(VIRTIO_BLOCK_T_FLUSH, 0, nullptr, 0, &completion))
+    {
+        kick();
+        scheduler_yield();
+    }
+
+    kick();
+    wait(completion);
+
+    return completion.result;
+}
+
+ResultOr<size_t> VirtioBlock::read(FsHandle &handle, void *buffer, size_t size)
+{
+    return block_cache_read(this, handle.offset(), buffer, size);
+}
+
+ResultOr<size_t> VirtioBlock::write(FsHandle &handle, const void *buffer, size_t size)
+{
+    return block_cache_write(this, handle.offset(), buffer, size);
+}
+
+Result VirtioBlock::call(FsHandle &handle, IOCall request, void *args)
+{
+    __unused(handle);
+
+    if (request == IOCALL_DISK_GET_GEOMETRY)
+    {
+        auto geometry = reinterpret_cast<IOCallDiskGeometryArgs *>(args);
+
+        geometry->sector_size = VIRTIO_BLOCK_SECTOR_SIZE;
+        geometry->sector_count = _capacity;
+
+        return SUCCESS;
+    }
+
+    if (request == IOCALL_DISK_SYNC)
+    {
+        return block_cache_sync(this);
+    }
+
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
@@ -1,16 +1,105 @@
 #pragma once
 
 #include "kernel/devices/VirtioDevice.h"
+#include "kernel/storage/BlockStorage.h"
 
-class VirtioBlock : public VirtioDevice
+// 5.2 Block Device
+
+#define VIRTIO_BLOCK_F_SEG_MAX (1 << 2)
+#define VIRTIO_BLOCK_F_RO (1 << 5)
+#define VIRTIO_BLOCK_F_FLUSH (1 << 9)
+
+#define VIRTIO_BLOCK_CONFIG_CAPACITY (0x00)
+#define VIRTIO_BLOCK_CONFIG_SEG_MAX (0x0C)
+
+#define VIRTIO_BLOCK_T_IN (0)
+#define VIRTIO_BLOCK_T_OUT (1)
+#define VIRTIO_BLOCK_T_FLUSH (4)
+
+#define VIRTIO_BLOCK_S_OK (0)
+#define VIRTIO_BLOCK_S_IOERR (1)
+#define VIRTIO_BLOCK_S_UNSUPP (2)
+
+#define VIRTIO_BLOCK_SECTOR_SIZE (512)
+
+// Transfers are split in requests of at most that many bytes, and at most
+// that many of them are kept in flight.
+#define VIRTIO_BLOCK_REQUEST_SIZE (64 * 1024)
+#define VIRTIO_BLOCK_IN_FLIGHT (32)
+
+// Data segments of one request, a page each at worst.
+#define VIRTIO_BLOCK_MAX_SEGMENTS (VIRTIO_BLOCK_REQUEST_SIZE / ARCH_PAGE_SIZE)
+
+struct __packed VirtioBlockHeader
+{
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+};
+
+// Where the device reads the header and writes the status of a request.
+struct __packed VirtioBlockSlot
+{
+    VirtioBlockHeader header;
+    uint8_t status;
+    uint8_t padding[15];
+};
+
+struct VirtioBlockCompletion
+{
+    volatile bool done;
+    Result result;
+};
+
+class VirtioBlock : public VirtioDevice, public BlockStorage
 {
 private:
+    OwnPtr<VirtioQueue> _queue;
+
+    uint64_t _capacity = 0;
+    bool _read_only = false;
+    bool _can_flush = false;
+    size_t _max_segments = VIRTIO_BLOCK_MAX_SEGMENTS;
+
+    // Header and status of each request in flight, requests take at least
+    // three descriptors so there are a third as many as descriptors.
+    RefPtr<MMIORange> _slots_range;
+    VirtioBlockSlot *_slots = nullptr;
+    VirtioBlockCompletion **_completions = nullptr;
+    uint16_t *_free_slots = nullptr;
+    size_t _free_slot_count = 0;
+
+    void complete();
+
+    void wait(VirtioBlockCompletion &completion);
+
 public:
-    VirtioBlock(DeviceAddress address) : VirtioDevice(address, DeviceClass::DISK)
-    {
-    }
+    VirtioBlock(DeviceAddress address);
+
+    ~VirtioBlock();
+
+    // Queue a request of `type` at `sector` over the physical `segments`,
+    // the device is only told about it by kick(). `completion` is filled
+    // from the interrupt handler, false when the queue is full.
+    bool submit(uint32_t type, uint64_t sector, const VirtioBuffer *segments, size_t count, VirtioBlockCompletion *completion);
+
+    void kick();
+
+    uint64_t storage_size() override { return _capacity * VIRTIO_BLOCK_SECTOR_SIZE; }
+
+    bool storage_read_only() override { return _read_only; }
+
+    // Keeps up to VIRTIO_BLOCK_IN_FLIGHT requests going at once, the device
+    // reads and writes the pages directly.
+    Result storage_transfer(bool write, uint64_t offset, const uintptr_t *pages, size_t size) override;
+
+    Result storage_flush() override;
+
+    void acknowledge_interrupt() override;
+
+    ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
+
+    ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
 
-    ~VirtioBlock()
-    {
-    }
+    Result call(FsHandle &handle, IOCall request, void *args) override;
 };
@@ -1 +1,560 @@
-#include "kernel/drivers/VirtioGraphic.h"
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+#include "kernel/drivers/VirtioNetwork.h"
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/interrupts/Interupts.h"
+
+// Frames of a same IPv4 flow go through the same queue, which keeps them in
+// order, by hashing their addresses and ports.
+static uint32_t flow_hash(const uint8_t *frame, size_t length)
+{
+    if (length < 34 || frame[12] != 0x08 || frame[13] != 0x00)
+    {
+        return 0;
+    }
+
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 26; i < MIN(length, (size_t)38); i++)
+    {
+        hash = (hash ^ frame[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+// The daemon can write anything in `head`, read it once and never look at
+// more than a ring's worth of entries, a bogus index can't keep us looping
+// with interrupts off.
+static size_t ring_pending(const NetworkRing &ring)
+{
+    uint32_t head = ring.head;
+
+    return MIN(head - ring.tail, (uint32_t)NETWORK_RING_SIZE);
+}
+
+VirtioNetwork::VirtioNetwork(DeviceAddress address) : VirtioDevice(address, DeviceClass::NETWORK)
+{
+    uint32_t features = negotiate(VIRTIO_NETWORK_F_MAC | VIRTIO_NETWORK_F_CTRL_VQ | VIRTIO_NETWORK_F_MQ);
+
+    size_t device_pairs = 1;
+
+    if ((features & VIRTIO_NETWORK_F_MQ) && (features & VIRTIO_NETWORK_F_CTRL_VQ))
+    {
+        device_pairs = MAX(read_config16(VIRTIO_NETWORK_CONFIG_MAX_PAIRS), 1);
+    }
+
+    for (size_t i = 0; i < MIN(device_pairs, (size_t)VIRTIO_NETWORK_MAX_PAIRS); i++)
+    {
+        _receive_queues[i] = setup_queue(i * 2);
+        _transmit_queues[i] = setup_queue(i * 2 + 1);
+
+        if (_receive_queues[i] == nullptr || _transmit_queues[i] == nullptr)
+        {
+            break;
+        }
+
+        _transmit_queues[i]->disable_interrupts();
+        _pair_count++;
+    }
+
+    if (_pair_count == 0)
+    {
+        logger_error("The network device has no queues!");
+        failed();
+        return;
+    }
+
+    if (features & VIRTIO_NETWORK_F_CTRL_VQ)
+    {
+        _control_index = device_pairs * 2;
+        _control_queue = setup_queue(_control_index);
+    }
+
+    if (features & VIRTIO_NETWORK_F_MAC)
+    {
+        for (size_t i = 0; i < 6; i++)
+        {
+            _mac_address.bytes[i] = read_config8(VIRTIO_NETWORK_CONFIG_MAC + i);
+        }
+    }
+
+    _rings_memory = memory_object_create(NETWORK_RINGS_MEMORY_SIZE);
+
+    if (_rings_memory->range().empty())
+    {
+        logger_error("Not enough memory for the network buffers!");
+        _pair_count = 0;
+        failed();
+        return;
+    }
+
+    _rings_range = make<MMIORange>(_rings_memory->range());
+    _rings = reinterpret_cast<NetworkRings *>(_rings_range->base());
+    memset(_rings, 0, sizeof(NetworkRings));
+
+    for (uint16_t i = 0; i < NETWORK_RECEIVE_BUFFERS; i++)
+    {
+        _rings->refill.push({i, 0});
+    }
+
+    // Nobody has the rings yet, they are empty and big enough for all the
+    // transmit buffers.
+    static_assert(NETWORK_TRANSMIT_BUFFERS <= NETWORK_RING_SIZE);
+
+    for (uint16_t i = 0; i < NETWORK_TRANSMIT_BUFFERS; i++)
+    {
+        _rings->completed.push({(uint16_t)(NETWORK_RECEIVE_BUFFERS + i), 0});
+    }
+
+    ready();
+
+    // Until told otherwise, the device only uses the first pair.
+    if (_pair_count > 1 && (_control_queue == nullptr || !set_pair_count(_pair_count)))
+    {
+        _pair_count = 1;
+    }
+
+    InterruptsRetainer retainer;
+    replenish();
+
+    logger_info("Network device with %d queue pairs", (int)_pair_count);
+}
+
+VirtioNetwork::~VirtioNetwork()
+{
+    _rings_range = nullptr;
+
+    if (_rings_memory)
+    {
+        memory_object_deref(_rings_memory);
+    }
+}
+
+bool VirtioNetwork::set_pair_count(size_t pair_count)
+{
+    _control_range = make<MMIORange>(sizeof(VirtioNetworkControl));
+
+    auto control = reinterpret_cast<VirtioNetworkControl *>(_control_range->base());
+    *control = {VIRTIO_NETWORK_CTRL_MQ, VIRTIO_NETWORK_CTRL_MQ_VQ_PAIRS_SET, (uint16_t)pair_count, 0xff};
+
+    uintptr_t physical = _control_range->physical_base();
+
+    VirtioBuffer buffers[] = {
+        {physical, 2},
+        {physical + __builtin_offsetof(VirtioNetworkControl, pairs), 2},
+        {physical + __builtin_offsetof(VirtioNetworkControl, ack), 1},
+    };
+
+    if (!_control_queue->push(buffers, 2, 1, nullptr))
+    {
+        return false;
+    }
+
+    notify(_control_index);
+
+    // This only happens once, when the device comes up.
+    void *token;
+    uint32_t written;
+
+    for (size_t i = 0; i < 1000000; i++)
+    {
+        if (_control_queue->pop(&token, &written))
+        {
+            return control->ack == VIRTIO_NETWORK_CTRL_OK;
+        }
+    }
+
+    logger_warn("The network device didn't answer, using a single queue pair");
+
+    return false;
+}
+
+bool VirtioNetwork::post_receive(size_t queue, uint16_t buffer)
+{
+    uintptr_t physical = buffer_physical(buffer);
+
+    VirtioBuffer buffers[] = {
+        {physical, VIRTIO_NETWORK_HEADER_SIZE},
+        {physical + NETWORK_BUFFER_HEADROOM, NETWORK_FRAME_SIZE},
+    };
+
+    return _receive_queues[queue]->push(buffers, 0, 2, (void *)(uintptr_t)buffer);
+}
+
+// Give the buffers in the refill ring to the receive queues, spread evenly.
+void VirtioNetwork::replenish()
+{
+    bool pushed[VIRTIO_NETWORK_MAX_PAIRS] = {};
+    size_t pending = ring_pending(_rings->refill);
+
+    for (size_t taken = 0; taken < pending; taken++)
+    {
+        NetworkPacket packet = _rings->refill.peek();
+
+        if (packet.buffer >= NETWORK_BUFFER_COUNT)
+        {
+            _rings->refill.pop();
+            continue;
+        }
+
+        bool posted = false;
+
+        for (size_t i = 0; i < _pair_count && !posted; i++)
+        {
+            size_t queue = (_next_receive_queue + i) % _pair_count;
+
+            if (post_receive(queue, packet.buffer))
+            {
+                pushed[queue] = true;
+                posted = true;
+                _next_receive_queue = (queue + 1) % _pair_count;
+            }
+        }
+
+        if (!posted)
+        {
+            break;
+        }
+
+        _rings->refill.pop();
+    }
+
+    for (size_t i = 0; i < _pair_count; i++)
+    {
+        if (pushed[i] && _receive_queues[i]->should_notify())
+        {
+            notify(i * 2);
+        }
+    }
+}
+
+// Move up to `budget` frames from the receive queues to the received ring,
+// taking from each queue in turn so a busy one doesn't starve the others.
+size_t VirtioNetwork::receive(size_t budget)
+{
+    size_t received = 0;
+    bool progress = true;
+
+    while (received < budget && progress)
+    {
+        progress = false;
+
+        for (size_t i = 0; i < _pair_count && received < budget; i++)
+        {
+            void *token;
+            uint32_t written;
+
+            if (!_receive_queues[i]->pop(&token, &written))
+            {
+                continue;
+            }
+
+            uint16_t buffer = (uintptr_t)token;
+
+            progress = true;
+            received++;
+
+            if (written <= VIRTIO_NETWORK_HEADER_SIZE || _rings->received.full())
+            {
+                // Nobody is taking frames, drop it and hand the buffer back.
+                post_receive(i, buffer);
+                continue;
+            }
+
+            _rings->received.push({buffer, (uint16_t)(written - VIRTIO_NETWORK_HEADER_SIZE)});
+        }
+    }
+
+    return received;
+}
+
+void VirtioNetwork::reclaim()
+{
+    for (size_t i = 0; i < _pair_count; i++)
+    {
+        void *token;
+        uint32_t written;
+
+        // What doesn't fit stays in the queue until the daemon makes room.
+        while (!_rings->completed.full() && _transmit_queues[i]->pop(&token, &written))
+        {
+            _rings->completed.push({(uint16_t)(uintptr_t)token, 0});
+        }
+    }
+}
+
+// Hand the frames in the transmit ring to the device, a single notification
+// per queue for the whole batch. What doesn't fit waits for the next call.
+void VirtioNetwork::transmit()
+{
+    reclaim();
+
+    bool pushed[VIRTIO_NETWORK_MAX_PAIRS] = {};
+    size_t pending = ring_pending(_rings->transmit);
+
+    for (size_t taken = 0; taken < pending; taken++)
+    {
+        NetworkPacket packet = _rings->transmit.peek();
+
+        if (packet.buffer >= NETWORK_BUFFER_COUNT)
+        {
+            _rings->transmit.pop();
+            continue;
+        }
+
+        if (packet.length == 0 || packet.length > NETWORK_FRAME_SIZE)
+        {
+            if (_rings->completed.full())
+            {
+                break;
+            }
+
+            _rings->transmit.pop();
+            _rings->completed.push({packet.buffer, 0});
+            continue;
+        }
+
+        uint8_t *address = buffer_address(packet.buffer);
+        uintptr_t physical = buffer_physical(packet.buffer);
+        size_t queue = flow_hash(address + NETWORK_BUFFER_HEADROOM, packet.length) % _pair_count;
+
+        memset(address, 0, VIRTIO_NETWORK_HEADER_SIZE);
+
+        VirtioBuffer buffers[] = {
+            {physical, VIRTIO_NETWORK_HEADER_SIZE},
+            {physical + NETWORK_BUFFER_HEADROOM, packet.length},
+        };
+
+        if (!_transmit_queues[queue]->push(buffers, 2, 0, (void *)(uintptr_t)packet.buffer))
+        {
+            break;
+        }
+
+        pushed[queue] = true;
+        _rings->transmit.pop();
+    }
+
+    for (size_t i = 0; i < _pair_count; i++)
+    {
+        if (pushed[i] && _transmit_queues[i]->should_notify())
+        {
+            notify(i * 2 + 1);
+        }
+    }
+}
+
+void VirtioNetwork::schedule_poll()
+{
+    if (_poll_pending)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < _pair_count; i++)
+    {
+        _receive_queues[i]->disable_interrupts();
+    }
+
+    _poll_pending = dispatcher_enqueue([](void *network) { static_cast<VirtioNetwork *>(network)->poll(); }, this);
+
+    if (!_poll_pending)
+    {
+        // The next interrupt will try again.
+        for (size_t i = 0; i < _pair_count; i++)
+        {
+            _receive_queues[i]->enable_interrupts();
+        }
+    }
+}
+
+void VirtioNetwork::poll()
+{
+    InterruptsRetainer retainer;
+
+    _poll_pending = false;
+
+    bool more = receive(VIRTIO_NETWORK_POLL_BUDGET) == VIRTIO_NETWORK_POLL_BUDGET;
+
+    replenish();
+    transmit();
+
+    for (size_t i = 0; i < _pair_count; i++)
+    {
+        if (!_receive_queues[i]->enable_interrupts())
+        {
+            more = true;
+        }
+    }
+
+    if (more)
+    {
+        schedule_poll();
+    }
+}
+
+void VirtioNetwork::acknowledge_interrupt()
+{
+    if ((interrupt_status() & VIRTIO_ISR_QUEUE) && _pair_count > 0)
+    {
+        schedule_poll();
+    }
+}
+
+bool VirtioNetwork::can_read(FsHandle &handle)
+{
+    __unused(handle);
+
+    return _pair_count > 0 && !_rings->received.empty();
+}
+
+bool VirtioNetwork::can_write(FsHandle &handle)
+{
+    __unused(handle);
+
+    if (_pair_count == 0)
+    {
+        return false;
+    }
+
+    InterruptsRetainer retainer;
+
+    transmit();
+
+    return !_rings->completed.empty();
+}
+
+ResultOr<size_t> VirtioNetwork::read(FsHandle &handle, void *buffer, size_t size)
+{
+    __unused(handle);
+
+    if (_pair_count == 0)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (rings_mapped())
+    {
+        return ERR_OPERATION_NOT_SUPPORTED;
+    }
+
+    // Someone who had the rings mapped before may have left anything in
+    // them, only a receive buffer with a sane length is copied from.
+    size_t pending = ring_pending(_rings->received);
+
+    for (size_t taken = 0; taken < pending; taken++)
+    {
+        NetworkPacket packet = _rings->received.pop();
+
+        if (packet.buffer >= NETWORK_RECEIVE_BUFFERS)
+        {
+            continue;
+        }
+
+        size_t length = MIN(MIN((size_t)packet.length, (size_t)NETWORK_FRAME_SIZE), size);
+        memcpy(buffer, buffer_address(packet.buffer) + NETWORK_BUFFER_HEADROOM, length);
+
+        if (!_rings->refill.full())
+        {
+            _rings->refill.push({packet.buffer, 0});
+            replenish();
+        }
+
+        return length;
+    }
+
+    return 0;
+}
+
+ResultOr<size_t> VirtioNetwork::write(FsHandle &handle, const void *buffer, size_t size)
+{
+    __unused(handle);
+
+    if (_pair_count == 0)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    if (size > NETWORK_FRAME_SIZE)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (rings_mapped())
+    {
+        return ERR_OPERATION_NOT_SUPPORTED;
+    }
+
+    reclaim();
+
+    if (size == 0 || _rings->transmit.full())
+    {
+        return 0;
+    }
+
+    // Same as read(), only a transmit buffer is copied to.
+    size_t pending = ring_pending(_rings->completed);
+
+    for (size_t taken = 0; taken < pending; taken++)
+    {
+        NetworkPacket packet = _rings->completed.pop();
+
+        if (packet.buffer < NETWORK_RECEIVE_BUFFERS || packet.buffer >= NETWORK_BUFFER_COUNT)
+        {
+            continue;
+        }
+
+        memcpy(buffer_address(packet.buffer) + NETWORK_BUFFER_HEADROOM, buffer, size);
+
+        _rings->transmit.push({packet.buffer, (uint16_t)size});
+        transmit();
+
+        return size;
+    }
+
+    return 0;
+}
+
+Result VirtioNetwork::call(FsHandle &handle, IOCall request, void *args)
+{
+    __unused(handle);
+
+    if (_pair_count == 0)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    if (request == IOCALL_NETWORK_GET_STATE)
+    {
+        auto state = reinterpret_cast<IOCallNetworkSateAgs *>(args);
+        state->mac_address = _mac_address;
+
+        return SUCCESS;
+    }
+
+    if (request == IOCALL_NETWORK_GET_RINGS)
+    {
+        auto rings = reinterpret_cast<IOCallNetworkRingsArgs *>(args);
+        rings->memory_handle = _rings_memory->id;
+
+        return SUCCESS;
+    }
+
+    if (request == IOCALL_NETWORK_KICK)
+    {
+        InterruptsRetainer retainer;
+
+        replenish();
+        transmit();
+
+        return SUCCESS;
+    }
+
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
@@ -1,16 +1,111 @@
 #pragma once
 
+#include <abi/Network.h>
+
 #include "kernel/devices/VirtioDevice.h"
+#include "kernel/memory/MemoryObject.h"
+
+// 5.1 Network Device
+
+#define VIRTIO_NETWORK_F_MAC (1 << 5)
+#define VIRTIO_NETWORK_F_CTRL_VQ (1 << 17)
+#define VIRTIO_NETWORK_F_MQ (1 << 22)
+
+#define VIRTIO_NETWORK_CONFIG_MAC (0x00)
+#define VIRTIO_NETWORK_CONFIG_MAX_PAIRS (0x08)
+
+#define VIRTIO_NETWORK_CTRL_MQ (4)
+#define VIRTIO_NETWORK_CTRL_MQ_VQ_PAIRS_SET (0)
+#define VIRTIO_NETWORK_CTRL_OK (0)
+
+// Without VIRTIO_NET_F_MRG_RXBUF, it fits in NETWORK_BUFFER_HEADROOM.
+#define VIRTIO_NETWORK_HEADER_SIZE (10)
+
+#define VIRTIO_NETWORK_MAX_PAIRS (4)
+
+// Frames taken from the receive queues each time the bottom half runs,
+// it queues itself again when there are more.
+#define VIRTIO_NETWORK_POLL_BUDGET (64)
+
+struct __packed VirtioNetworkControl
+{
+    uint8_t klass;
+    uint8_t command;
+    uint16_t pairs;
+    uint8_t ack;
+};
 
+// Frames live in buffers shared with whoever reads the device, the queues
+// are handed those buffers and the device reads and writes them directly.
+//
+// Interrupts are coalesced: the top half turns receive interrupts off and
+// queues poll(), which drains the queues and turns them back on once they
+// are empty. Transmit queues never interrupt, their buffers are reclaimed
+// when more frames are sent or a writer waits for room.
 class VirtioNetwork : public VirtioDevice
 {
 private:
-public:
-    VirtioNetwork(DeviceAddress address) : VirtioDevice(address, DeviceClass::NETWORK)
+    MacAddress _mac_address = {};
+
+    size_t _pair_count = 0;
+    OwnPtr<VirtioQueue> _receive_queues[VIRTIO_NETWORK_MAX_PAIRS];
+    OwnPtr<VirtioQueue> _transmit_queues[VIRTIO_NETWORK_MAX_PAIRS];
+    size_t _next_receive_queue = 0;
+
+    uint16_t _control_index = 0;
+    OwnPtr<VirtioQueue> _control_queue;
+    RefPtr<MMIORange> _control_range;
+
+    MemoryObject *_rings_memory = nullptr;
+    RefPtr<MMIORange> _rings_range;
+    NetworkRings *_rings = nullptr;
+
+    volatile bool _poll_pending = false;
+
+    uintptr_t buffer_physical(uint16_t buffer)
     {
+        return _rings_range->physical_base() + NETWORK_BUFFERS_OFFSET + buffer * NETWORK_BUFFER_SIZE;
     }
 
-    ~VirtioNetwork()
+    uint8_t *buffer_address(uint16_t buffer)
     {
+        return reinterpret_cast<uint8_t *>(_rings_range->base() + NETWORK_BUFFERS_OFFSET + buffer * NETWORK_BUFFER_SIZE);
     }
+
+    // The daemon holds a reference on the rings while it has them mapped,
+    // read() and write() would race with it.
+    bool rings_mapped() { return _rings_memory->refcount > 1; }
+
+    bool set_pair_count(size_t pair_count);
+
+    bool post_receive(size_t queue, uint16_t buffer);
+
+    void replenish();
+
+    size_t receive(size_t budget);
+
+    void reclaim();
+
+    void transmit();
+
+    void schedule_poll();
+
+    void poll();
+
+public:
+    VirtioNetwork(DeviceAddress address);
+
+    ~VirtioNetwork();
+
+    void acknowledge_interrupt() override;
+
+    bool can_read(FsHandle &handle) override;
+
+    bool can_write(FsHandle &handle) override;
+
+    ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
+
+    ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
+
+    Result call(FsHandle &handle, IOCall request, void *args) override;
 };
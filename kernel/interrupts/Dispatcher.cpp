@@ -1,14 +1,34 @@
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
-#include <libutils/RingBuffer.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/Vector.h>
 
-#include "kernel/devices/Devices.h"
+#include "architectures/Architectures.h"
+#include "kernel/devices/Device.h"
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
 
-static bool _pending_interrupts[256] = {};
+// Devices listening to each interrupt, filled as drivers attach.
+static Vector<Device *> *_handlers[DISPATCHER_INTERRUPT_COUNT] = {};
+
+static uint32_t _pending[DISPATCHER_INTERRUPT_COUNT / 32] = {};
+static uint64_t _raised_at[DISPATCHER_INTERRUPT_COUNT] = {};
+static DispatcherStatistics _statistics[DISPATCHER_INTERRUPT_COUNT] = {};
+
+struct Work
+{
+    DispatcherWork function;
+    void *argument;
+    uint64_t queued_at;
+};
+
+static Work _works[DISPATCHER_WORK_QUEUE_SIZE] = {};
+static size_t _works_head = 0;
+static size_t _works_tail = 0;
+static size_t _works_dropped = 0;
+static DispatcherStatistics _works_statistics = {};
 
 void dispatcher_initialize()
 {
@@ -16,34 +36,116 @@ void dispatcher_initialize()
     task_go(interrupts_dispatcher_task);
 }
 
+void dispatcher_attach(int interrupt, Device *device)
+{
+    assert(interrupt >= 0 && interrupt < DISPATCHER_INTERRUPT_COUNT);
+
+    InterruptsRetainer retainer;
+
+    if (!_handlers[interrupt])
+    {
+        _handlers[interrupt] = new Vector<Device *>();
+    }
+
+    _handlers[interrupt]->push_back(device);
+}
+
 void dispatcher_dispatch(int interrupt)
 {
-    _pending_interrupts[interrupt] = true;
-    devices_acknowledge_interrupt(interrupt);
+    uint32_t bit = 1u << (interrupt % 32);
+
+    if (!(_pending[interrupt / 32] & bit))
+    {
+        _pending[interrupt / 32] |= bit;
+        _raised_at[interrupt] = arch_get_cycles();
+    }
+
+    if (_handlers[interrupt])
+    {
+        _handlers[interrupt]->foreach ([](Device *device) {
+            device->acknowledge_interrupt();
+            return Iteration::CONTINUE;
+        });
+    }
+}
+
+bool dispatcher_enqueue(DispatcherWork work, void *argument)
+{
+    InterruptsRetainer retainer;
+
+    if (_works_head - _works_tail == DISPATCHER_WORK_QUEUE_SIZE)
+    {
+        _works_dropped++;
+        return false;
+    }
+
+    _works[_works_head % DISPATCHER_WORK_QUEUE_SIZE] = {work, argument, arch_get_cycles()};
+    _works_head++;
+
+    return true;
 }
 
-static bool dispatcher_has_interrupt()
+static bool dispatcher_has_work()
 {
     InterruptsRetainer retainer;
 
-    int result = 0;
+    for (size_t i = 0; i < DISPATCHER_INTERRUPT_COUNT / 32; i++)
+    {
+        if (_pending[i])
+        {
+            return true;
+        }
+    }
+
+    return _works_head != _works_tail;
+}
+
+// Take the lowest pending interrupt, -1 if there is none.
+static int dispatcher_take_interrupt(uint64_t &raised_at)
+{
+    InterruptsRetainer retainer;
 
-    for (size_t i = 0; i < 256; i++)
+    for (size_t i = 0; i < DISPATCHER_INTERRUPT_COUNT / 32; i++)
     {
-        if (_pending_interrupts[i])
+        if (_pending[i])
         {
-            result++;
+            int bit = __builtin_ffs(_pending[i]) - 1;
+            int interrupt = i * 32 + bit;
+
+            _pending[i] &= ~(1u << bit);
+            raised_at = _raised_at[interrupt];
+
+            return interrupt;
         }
     }
 
-    return result > 0;
+    return -1;
 }
 
-static void dispatcher_snapshot(bool *destination)
+static bool dispatcher_take_work(Work &work)
 {
     InterruptsRetainer retainer;
-    memcpy(destination, _pending_interrupts, sizeof(_pending_interrupts));
-    memset(_pending_interrupts, 0, sizeof(_pending_interrupts));
+
+    if (_works_head == _works_tail)
+    {
+        return false;
+    }
+
+    work = _works[_works_tail % DISPATCHER_WORK_QUEUE_SIZE];
+    _works_tail++;
+
+    return true;
+}
+
+static void dispatcher_record(DispatcherStatistics &statistics, uint64_t since)
+{
+    uint64_t latency = arch_get_cycles() - since;
+
+    InterruptsRetainer retainer;
+
+    statistics.count++;
+    statistics.total_latency += latency;
+    statistics.max_latency = MAX(statistics.max_latency, latency);
 }
 
 class BlockerDispatcher : public Blocker
@@ -56,7 +158,7 @@ public:
     {
         __unused(task);
 
-        return dispatcher_has_interrupt();
+        return dispatcher_has_work();
     }
 };
 
@@ -66,18 +168,56 @@ void dispatcher_service()
     {
         task_block(scheduler_running(), new BlockerDispatcher(), -1);
 
-        while (dispatcher_has_interrupt())
-        {
-            bool snapshot[256];
-            dispatcher_snapshot(snapshot);
+        uint64_t raised_at = 0;
+        int interrupt = -1;
+        Work work;
 
-            for (size_t i = 0; i < 256; i++)
+        while (dispatcher_has_work())
+        {
+            while ((interrupt = dispatcher_take_interrupt(raised_at)) != -1)
             {
-                if (snapshot[i])
+                if (_handlers[interrupt])
                 {
-                    devices_handle_interrupt(i);
+                    _handlers[interrupt]->foreach ([](Device *device) {
+                        device->handle_interrupt();
+                        return Iteration::CONTINUE;
+                    });
                 }
+
+                dispatcher_record(_statistics[interrupt], raised_at);
+            }
+
+            while (dispatcher_take_work(work))
+            {
+                work.function(work.argument);
+                dispatcher_record(_works_statistics, work.queued_at);
             }
         }
     }
 }
+
+DispatcherStatistics dispatcher_statistics(int interrupt)
+{
+    InterruptsRetainer retainer;
+    return _statistics[interrupt];
+}
+
+DispatcherStatistics dispatcher_work_statistics()
+{
+    InterruptsRetainer retainer;
+    return _works_statistics;
+}
+
+size_t dispatcher_work_dropped()
+{
+    InterruptsRetainer retainer;
+    return _works_dropped;
+}
+
+void dispatcher_iterate_handlers(int interrupt, IterationCallback<Device *> callback)
+{
+    if (_handlers[interrupt])
+    {
+        _handlers[interrupt]->foreach (callback);
+    }
+}
@@ -1,11 +1,48 @@
 #pragma once
 
+#include <libutils/Iteration.h>
+
 #include "kernel/node/Node.h"
 
-typedef void (*DispatcherInteruptHandler)();
+#define DISPATCHER_INTERRUPT_COUNT (256)
+#define DISPATCHER_WORK_QUEUE_SIZE (256)
+
+class Device;
+
+// Run by the dispatcher task, with interrupts enabled, never from the
+// interrupt handler itself.
+typedef void (*DispatcherWork)(void *argument);
+
+struct DispatcherStatistics
+{
+    uint64_t count;
+
+    // From the interrupt, or the work being queued, to its bottom half being
+    // done, which is when the data it brought is visible to userspace.
+    uint64_t total_latency;
+    uint64_t max_latency;
+};
 
 void dispatcher_initialize();
 
+// acknowledge_interrupt() of `device` is called from the interrupt handler
+// when `interrupt` fires and handle_interrupt() later by the dispatcher
+// task.
+void dispatcher_attach(int interrupt, Device *device);
+
 void dispatcher_dispatch(int interrupt);
 
+// Safe from the interrupt handler. Works run in the order they were queued,
+// false when the queue is full.
+bool dispatcher_enqueue(DispatcherWork work, void *argument);
+
 void dispatcher_service();
+
+// Latencies are in arch_get_cycles() units.
+DispatcherStatistics dispatcher_statistics(int interrupt);
+
+DispatcherStatistics dispatcher_work_statistics();
+
+size_t dispatcher_work_dropped();
+
+void dispatcher_iterate_handlers(int interrupt, IterationCallback<Device *> callback);
@@ -15,9 +15,12 @@
 #include "kernel/graphics/Graphics.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/modules/Modules.h"
+#include "kernel/node/BlockCacheInfo.h"
 #include "kernel/node/DevicesInfo.h"
+#include "kernel/node/InterruptsInfo.h"
 #include "kernel/node/ProcessInfo.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/storage/BlockCache.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Tasking.h"
 #include "kernel/tasking/Userspace.h"
@@ -47,10 +50,13 @@ void system_main(Handover *handover)
     interrupts_initialize();
     filesystem_initialize();
     modules_initialize(handover);
+    block_cache_initialize();
     driver_initialize();
     device_initialize();
     process_info_initialize();
     device_info_initialize();
+    interrupts_info_initialize();
+    block_cache_info_initialize();
     devices_filesystem_initialize();
     graphic_initialize(handover);
     userspace_initialize();
@@ -0,0 +1,74 @@
+#include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/math/MinMax.h>
+
+#include "kernel/filesystem/Filesystem.h"
+#include "kernel/node/BlockCacheInfo.h"
+#include "kernel/node/Handle.h"
+#include "kernel/storage/BlockCache.h"
+
+FsBlockCacheInfo::FsBlockCacheInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+static int clamp_to_int(uint64_t value)
+{
+    return (int)MIN(value, (uint64_t)0x7fffffff);
+}
+
+Result FsBlockCacheInfo::open(FsHandle *handle)
+{
+    BlockCacheStatistics statistics = block_cache_statistics();
+
+    json::Object root{};
+
+    root["block_size"] = BLOCK_CACHE_BLOCK_SIZE;
+    root["blocks"] = clamp_to_int(statistics.blocks);
+    root["dirty"] = clamp_to_int(statistics.dirty);
+    root["capacity"] = clamp_to_int(statistics.capacity);
+
+    root["hits"] = clamp_to_int(statistics.hits);
+    root["misses"] = clamp_to_int(statistics.misses);
+    root["read_ahead"] = clamp_to_int(statistics.read_ahead);
+    root["evictions"] = clamp_to_int(statistics.evictions);
+    root["written_back"] = clamp_to_int(statistics.written_back);
+
+    uint64_t requests = statistics.hits + statistics.misses;
+
+    if (requests > 0)
+    {
+        root["hit_rate"] = clamp_to_int(statistics.hits * 100 / requests);
+    }
+
+    Prettifier pretty{};
+    json::prettify(pretty, root);
+
+    handle->attached = pretty.finalize().underlying_storage().give_ref();
+    handle->attached_size = reinterpret_cast<StringStorage *>(handle->attached)->length();
+
+    return SUCCESS;
+}
+
+void FsBlockCacheInfo::close(FsHandle *handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle->attached));
+}
+
+ResultOr<size_t> FsBlockCacheInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void block_cache_info_initialize()
+{
+    filesystem_link(Path::parse("/System/block-cache"), make<FsBlockCacheInfo>());
+}
@@ -69,48 +69,40 @@ ResultOr<size_t> FsDirectory::read(FsHandle &handle, void *buffer, size_t size)
 
 RefPtr<FsNode> FsDirectory::find(String name)
 {
-    RefPtr<FsNode> result;
-
-    _childs.foreach ([&](auto &entry) {
-        if (entry.name == name)
-        {
-            result = entry.node;
-
-            return Iteration::STOP;
-        }
-
-        return Iteration::CONTINUE;
-    });
+    if (!_index.has_key(name))
+    {
+        return nullptr;
+    }
 
-    return result;
+    return _index[name];
 }
 
 Result FsDirectory::link(String name, RefPtr<FsNode> child)
 {
-    if (find(name))
+    if (_index.has_key(name))
     {
         return ERR_FILE_EXISTS;
     }
 
     _childs.push_back({name, child});
+    _index[name] = child;
 
     return SUCCESS;
 }
 
 Result FsDirectory::unlink(String name)
 {
+    if (!_index.has_key(name))
+    {
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+    }
+
+    _index.remove_key(name);
 
-    bool has_removed_an_entry = _childs.remove_all_match(
+    _childs.remove_all_match(
         [&](auto &e) {
             return e.name == name;
         });
 
-    if (has_removed_an_entry)
-    {
-        return SUCCESS;
-    }
-    else
-    {
-        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
-    }
+    return SUCCESS;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <libutils/HashMap.h>
 #include <libutils/Vector.h>
 
 #include "kernel/node/Node.h"
@@ -19,7 +20,10 @@ struct FsDirectoryEntry
 class FsDirectory : public FsNode
 {
 private:
+    // _childs keeps the entries in the order they were linked for listings,
+    // _index is used for lookups by name.
     Vector<FsDirectoryEntry> _childs{};
+    HashMap<String, RefPtr<FsNode>> _index{};
 
 public:
     FsDirectory();
@@ -0,0 +1,102 @@
+#include <libsystem/Logger.h>
+#include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/math/MinMax.h>
+
+#include "kernel/devices/Device.h"
+#include "kernel/filesystem/Filesystem.h"
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/node/Handle.h"
+#include "kernel/node/InterruptsInfo.h"
+
+FsInterruptsInfo::FsInterruptsInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+static int clamp_to_int(uint64_t value)
+{
+    return (int)MIN(value, (uint64_t)0x7fffffff);
+}
+
+// Latencies are in cycles, which is enough to compare them.
+static json::Object statistics_to_json(DispatcherStatistics statistics)
+{
+    json::Object object{};
+
+    object["count"] = clamp_to_int(statistics.count);
+
+    if (statistics.count > 0)
+    {
+        object["average_latency"] = clamp_to_int(statistics.total_latency / statistics.count);
+        object["max_latency"] = clamp_to_int(statistics.max_latency);
+    }
+
+    return object;
+}
+
+Result FsInterruptsInfo::open(FsHandle *handle)
+{
+    json::Array interrupts{};
+
+    for (int interrupt = 0; interrupt < DISPATCHER_INTERRUPT_COUNT; interrupt++)
+    {
+        json::Array handlers{};
+
+        dispatcher_iterate_handlers(interrupt, [&](Device *device) {
+            handlers.push_back(device->name().cstring());
+            return Iteration::CONTINUE;
+        });
+
+        if (handlers.empty())
+        {
+            continue;
+        }
+
+        json::Object interrupt_object = statistics_to_json(dispatcher_statistics(interrupt));
+
+        interrupt_object["interrupt"] = interrupt;
+        interrupt_object["handlers"] = move(handlers);
+
+        interrupts.push_back(move(interrupt_object));
+    }
+
+    json::Object works = statistics_to_json(dispatcher_work_statistics());
+    works["dropped"] = (int)dispatcher_work_dropped();
+
+    json::Object root{};
+
+    root["interrupts"] = move(interrupts);
+    root["works"] = move(works);
+
+    Prettifier pretty{};
+    json::prettify(pretty, root);
+
+    handle->attached = pretty.finalize().underlying_storage().give_ref();
+    handle->attached_size = reinterpret_cast<StringStorage *>(handle->attached)->length();
+
+    return SUCCESS;
+}
+
+void FsInterruptsInfo::close(FsHandle *handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle->attached));
+}
+
+ResultOr<size_t> FsInterruptsInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void interrupts_info_initialize()
+{
+    filesystem_link(Path::parse("/System/interrupts"), make<FsInterruptsInfo>());
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "kernel/node/Node.h"
+
+class FsInterruptsInfo : public FsNode
+{
+private:
+public:
+    FsInterruptsInfo();
+
+    Result open(FsHandle *handle) override;
+
+    void close(FsHandle *handle) override;
+
+    ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
+};
+
+void interrupts_info_initialize();
@@ -0,0 +1,612 @@
+#include <libsystem/Assert.h>
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/thread/Lock.h>
+#include <libutils/Vector.h>
+
+#include "architectures/VirtualMemory.h"
+#include "kernel/memory/Memory.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/storage/BlockCache.h"
+#include "kernel/tasking/Task.h"
+
+struct BlockCacheEntry
+{
+    BlockStorage *storage;
+    uint64_t block;
+
+    uintptr_t address;
+    uintptr_t physical;
+
+    // Holds the content of the block, false while it is being read.
+    bool valid;
+    bool dirty;
+
+    // Used since the clock hand last went by.
+    bool referenced;
+
+    // Part of a transfer in progress, must not be evicted.
+    bool pinned;
+
+    BlockCacheEntry *next;
+};
+
+struct BlockCacheStorage
+{
+    BlockStorage *storage;
+
+    // Where the next read starts if it is sequential, and how many blocks
+    // are read ahead then.
+    uint64_t next_block;
+    size_t window;
+};
+
+// Held across transfers, which also keeps the driver from being reentered.
+static Lock _lock{};
+
+static BlockCacheEntry *_buckets[BLOCK_CACHE_BUCKET_COUNT] = {};
+static Vector<BlockCacheEntry *> *_entries = nullptr;
+static Vector<BlockCacheStorage> *_storages = nullptr;
+
+static size_t _clock_hand = 0;
+static size_t _dirty_count = 0;
+
+static BlockCacheStatistics _statistics = {};
+
+static void block_cache_flusher();
+
+void block_cache_initialize()
+{
+    lock_init(_lock);
+
+    _entries = new Vector<BlockCacheEntry *>();
+    _storages = new Vector<BlockCacheStorage>();
+
+    Task *flusher_task = task_spawn(nullptr, "BlockCacheFlusher", block_cache_flusher, nullptr, false);
+    task_go(flusher_task);
+}
+
+static BlockCacheEntry *&bucket_of(BlockStorage *storage, uint64_t block)
+{
+    size_t hash = (uintptr_t)storage / sizeof(void *) * 31 + (size_t)block;
+
+    return _buckets[hash % BLOCK_CACHE_BUCKET_COUNT];
+}
+
+static BlockCacheEntry *lookup(BlockStorage *storage, uint64_t block)
+{
+    for (BlockCacheEntry *entry = bucket_of(storage, block); entry; entry = entry->next)
+    {
+        if (entry->storage == storage && entry->block == block)
+        {
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+static void claim(BlockCacheEntry *entry, BlockStorage *storage, uint64_t block)
+{
+    BlockCacheEntry *&bucket = bucket_of(storage, block);
+
+    entry->storage = storage;
+    entry->block = block;
+    entry->valid = false;
+    entry->dirty = false;
+    entry->referenced = true;
+    entry->pinned = false;
+
+    entry->next = bucket;
+    bucket = entry;
+}
+
+static void evict(BlockCacheEntry *entry)
+{
+    assert(!entry->dirty && !entry->pinned);
+
+    if (entry->storage == nullptr)
+    {
+        return;
+    }
+
+    BlockCacheEntry **link = &bucket_of(entry->storage, entry->block);
+
+    while (*link != entry)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = entry->next;
+
+    if (entry->valid)
+    {
+        _statistics.evictions++;
+    }
+
+    entry->storage = nullptr;
+    entry->valid = false;
+    entry->next = nullptr;
+}
+
+static size_t block_length(BlockStorage *storage, uint64_t block)
+{
+    return MIN(storage->storage_size() - block * BLOCK_CACHE_BLOCK_SIZE, (uint64_t)BLOCK_CACHE_BLOCK_SIZE);
+}
+
+static BlockCacheStorage &storage_state(BlockStorage *storage)
+{
+    for (size_t i = 0; i < _storages->count(); i++)
+    {
+        if ((*_storages)[i].storage == storage)
+        {
+            return (*_storages)[i];
+        }
+    }
+
+    _storages->push_back({storage, 0, 0});
+
+    return (*_storages)[_storages->count() - 1];
+}
+
+static size_t capacity()
+{
+    return memory_get_total() / BLOCK_CACHE_MEMORY_SHARE / BLOCK_CACHE_BLOCK_SIZE;
+}
+
+static bool memory_is_low()
+{
+    return memory_get_total() - memory_get_used() < BLOCK_CACHE_MEMORY_RESERVE;
+}
+
+static void mark_dirty(BlockCacheEntry *entry)
+{
+    if (!entry->dirty)
+    {
+        entry->dirty = true;
+        _dirty_count++;
+    }
+}
+
+// Write `entry` along with the dirty blocks around it in one transfer.
+static Result write_back_run(BlockCacheEntry *entry)
+{
+    BlockStorage *storage = entry->storage;
+
+    uint64_t first = entry->block;
+
+    while (first > 0 && entry->block - first < BLOCK_CACHE_BATCH_SIZE - 1)
+    {
+        BlockCacheEntry *previous = lookup(storage, first - 1);
+
+        if (previous == nullptr || !previous->dirty)
+        {
+            break;
+        }
+
+        first--;
+    }
+
+    BlockCacheEntry *run[BLOCK_CACHE_BATCH_SIZE];
+    uintptr_t pages[BLOCK_CACHE_BATCH_SIZE];
+    size_t count = 0;
+    size_t size = 0;
+
+    for (BlockCacheEntry *current = lookup(storage, first);
+         current != nullptr && current->dirty && count < BLOCK_CACHE_BATCH_SIZE;
+         current = lookup(storage, first + count))
+    {
+        run[count] = current;
+        pages[count] = current->physical;
+        size += block_length(storage, current->block);
+
+        current->pinned = true;
+        count++;
+    }
+
+    Result result = storage->storage_transfer(true, first * BLOCK_CACHE_BLOCK_SIZE, pages, size);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        run[i]->pinned = false;
+
+        if (result == SUCCESS)
+        {
+            run[i]->dirty = false;
+        }
+    }
+
+    if (result != SUCCESS)
+    {
+        logger_error("Failed to write back %d blocks: %s", (int)count, get_result_description(result));
+        return result;
+    }
+
+    _dirty_count -= count;
+    _statistics.written_back += count;
+
+    return SUCCESS;
+}
+
+// Write back the dirty blocks of `storage`, or of every storage when null.
+static Result write_back(BlockStorage *storage)
+{
+    Result result = SUCCESS;
+
+    for (size_t i = 0; i < _entries->count() && _dirty_count > 0; i++)
+    {
+        BlockCacheEntry *entry = (*_entries)[i];
+
+        if (entry->dirty && (storage == nullptr || entry->storage == storage))
+        {
+            Result run_result = write_back_run(entry);
+
+            if (result == SUCCESS)
+            {
+                result = run_result;
+            }
+        }
+    }
+
+    return result;
+}
+
+static BlockCacheEntry *grow()
+{
+    if (_entries->count() >= capacity() || memory_is_low())
+    {
+        return nullptr;
+    }
+
+    uintptr_t address = 0;
+
+    if (memory_alloc(arch_kernel_address_space(), BLOCK_CACHE_BLOCK_SIZE, MEMORY_NONE, &address) != SUCCESS)
+    {
+        return nullptr;
+    }
+
+    auto entry = new BlockCacheEntry{};
+
+    entry->address = address;
+    entry->physical = arch_virtual_to_physical(arch_kernel_address_space(), address);
+
+    _entries->push_back(entry);
+
+    return entry;
+}
+
+// An entry free to be claimed, from fresh memory while the cache may grow,
+// then by sweeping the clock for a block not used lately. Clean blocks are
+// preferred, a dirty one is written back first.
+static BlockCacheEntry *take_entry()
+{
+    BlockCacheEntry *entry = grow();
+
+    if (entry != nullptr)
+    {
+        return entry;
+    }
+
+    BlockCacheEntry *dirty = nullptr;
+
+    for (size_t i = 0; i < _entries->count() * 2; i++)
+    {
+        BlockCacheEntry *candidate = (*_entries)[_clock_hand];
+        _clock_hand = (_clock_hand + 1) % _entries->count();
+
+        if (candidate->pinned)
+        {
+            continue;
+        }
+
+        if (candidate->referenced)
+        {
+            candidate->referenced = false;
+        }
+        else if (!candidate->dirty)
+        {
+            evict(candidate);
+            return candidate;
+        }
+        else if (dirty == nullptr)
+        {
+            dirty = candidate;
+        }
+    }
+
+    if (dirty != nullptr && write_back_run(dirty) == SUCCESS)
+    {
+        evict(dirty);
+        return dirty;
+    }
+
+    return nullptr;
+}
+
+// Read `wanted` blocks from `block` and up to `ahead` more after them, in
+// one transfer stopping short of blocks already cached.
+static Result read_blocks(BlockStorage *storage, uint64_t block, size_t wanted, size_t ahead)
+{
+    uint64_t block_count = __align_up(storage->storage_size(), BLOCK_CACHE_BLOCK_SIZE) / BLOCK_CACHE_BLOCK_SIZE;
+    size_t limit = MIN(MIN(wanted + ahead, (size_t)BLOCK_CACHE_BATCH_SIZE), block_count - block);
+
+    BlockCacheEntry *batch[BLOCK_CACHE_BATCH_SIZE];
+    uintptr_t pages[BLOCK_CACHE_BATCH_SIZE];
+    size_t count = 0;
+    size_t size = 0;
+
+    while (count < limit && (count == 0 || lookup(storage, block + count) == nullptr))
+    {
+        BlockCacheEntry *entry = take_entry();
+
+        if (entry == nullptr)
+        {
+            break;
+        }
+
+        claim(entry, storage, block + count);
+
+        // Blocks read ahead go first if they are never used.
+        entry->referenced = count < wanted;
+        entry->pinned = true;
+
+        batch[count] = entry;
+        pages[count] = entry->physical;
+        size += block_length(storage, block + count);
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    Result result = storage->storage_transfer(false, block * BLOCK_CACHE_BLOCK_SIZE, pages, size);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        batch[i]->pinned = false;
+        batch[i]->valid = result == SUCCESS;
+
+        if (result != SUCCESS)
+        {
+            evict(batch[i]);
+        }
+    }
+
+    if (result == SUCCESS)
+    {
+        _statistics.misses += MIN(count, wanted);
+        _statistics.read_ahead += count - MIN(count, wanted);
+    }
+
+    return result;
+}
+
+ResultOr<size_t> block_cache_read(BlockStorage *storage, uint64_t offset, void *buffer, size_t size)
+{
+    LockHolder holder(_lock);
+
+    uint64_t storage_size = storage->storage_size();
+
+    if (offset >= storage_size || size == 0)
+    {
+        return 0;
+    }
+
+    size = MIN(size, storage_size - offset);
+
+    uint64_t first = offset / BLOCK_CACHE_BLOCK_SIZE;
+    uint64_t last = (offset + size - 1) / BLOCK_CACHE_BLOCK_SIZE;
+
+    // Small reads may start again in the block the previous one ended in.
+    BlockCacheStorage &state = storage_state(storage);
+    bool sequential = first == state.next_block || first + 1 == state.next_block;
+
+    if (!sequential)
+    {
+        state.window = 0;
+    }
+
+    state.next_block = last + 1;
+
+    size_t done = 0;
+
+    while (done < size)
+    {
+        uint64_t block = (offset + done) / BLOCK_CACHE_BLOCK_SIZE;
+        size_t in_block = (offset + done) % BLOCK_CACHE_BLOCK_SIZE;
+        size_t length = MIN(BLOCK_CACHE_BLOCK_SIZE - in_block, size - done);
+
+        BlockCacheEntry *entry = lookup(storage, block);
+
+        if (entry != nullptr)
+        {
+            _statistics.hits++;
+        }
+        else
+        {
+            // What was read ahead got used, read further next time.
+            if (sequential)
+            {
+                state.window = MIN(MAX(state.window * 2, (size_t)BLOCK_CACHE_READ_AHEAD_MIN), (size_t)BLOCK_CACHE_READ_AHEAD_MAX);
+            }
+
+            Result result = read_blocks(storage, block, last - block + 1, state.window);
+
+            if (result != SUCCESS)
+            {
+                if (done > 0)
+                {
+                    return done;
+                }
+
+                return result;
+            }
+
+            entry = lookup(storage, block);
+        }
+
+        entry->referenced = true;
+        memcpy((uint8_t *)buffer + done, (void *)(entry->address + in_block), length);
+
+        done += length;
+    }
+
+    return done;
+}
+
+ResultOr<size_t> block_cache_write(BlockStorage *storage, uint64_t offset, const void *buffer, size_t size)
+{
+    if (storage->storage_read_only())
+    {
+        return ERR_READ_ONLY_STREAM;
+    }
+
+    LockHolder holder(_lock);
+
+    uint64_t storage_size = storage->storage_size();
+
+    if (offset >= storage_size || size == 0)
+    {
+        return 0;
+    }
+
+    size = MIN(size, storage_size - offset);
+
+    storage_state(storage);
+
+    size_t done = 0;
+    Result result = SUCCESS;
+
+    while (done < size)
+    {
+        uint64_t block = (offset + done) / BLOCK_CACHE_BLOCK_SIZE;
+        size_t in_block = (offset + done) % BLOCK_CACHE_BLOCK_SIZE;
+        size_t length = MIN(BLOCK_CACHE_BLOCK_SIZE - in_block, size - done);
+
+        BlockCacheEntry *entry = lookup(storage, block);
+
+        if (entry == nullptr && length == block_length(storage, block))
+        {
+            // Overwritten as a whole, no need to read it first.
+            entry = take_entry();
+
+            if (entry == nullptr)
+            {
+                result = ERR_OUT_OF_MEMORY;
+                break;
+            }
+
+            claim(entry, storage, block);
+            entry->valid = true;
+        }
+        else if (entry == nullptr)
+        {
+            result = read_blocks(storage, block, 1, 0);
+
+            if (result != SUCCESS)
+            {
+                break;
+            }
+
+            entry = lookup(storage, block);
+        }
+
+        memcpy((void *)(entry->address + in_block), (const uint8_t *)buffer + done, length);
+
+        entry->referenced = true;
+        mark_dirty(entry);
+
+        done += length;
+    }
+
+    // Don't let writers fill the cache faster than the flusher empties it.
+    if (_dirty_count > MAX(_entries->count() / 2, (size_t)BLOCK_CACHE_BATCH_SIZE))
+    {
+        write_back(nullptr);
+    }
+
+    if (done == 0 && result != SUCCESS)
+    {
+        return result;
+    }
+
+    return done;
+}
+
+Result block_cache_sync(BlockStorage *storage)
+{
+    LockHolder holder(_lock);
+
+    Result result = write_back(storage);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    return storage->storage_flush();
+}
+
+BlockCacheStatistics block_cache_statistics()
+{
+    LockHolder holder(_lock);
+
+    BlockCacheStatistics statistics = _statistics;
+
+    statistics.blocks = _entries->count();
+    statistics.dirty = _dirty_count;
+    statistics.capacity = capacity();
+
+    return statistics;
+}
+
+// Give clean blocks back to the physical allocator while memory is low.
+static void shrink()
+{
+    for (size_t i = _entries->count(); i > 0 && memory_is_low(); i--)
+    {
+        BlockCacheEntry *entry = (*_entries)[i - 1];
+
+        if (entry->dirty || entry->pinned)
+        {
+            continue;
+        }
+
+        evict(entry);
+        memory_free(arch_kernel_address_space(), MemoryRange{entry->address, BLOCK_CACHE_BLOCK_SIZE});
+
+        _entries->remove_index(i - 1);
+        delete entry;
+    }
+
+    if (_clock_hand >= _entries->count())
+    {
+        _clock_hand = 0;
+    }
+}
+
+static void block_cache_flusher()
+{
+    while (true)
+    {
+        task_sleep(scheduler_running(), BLOCK_CACHE_FLUSH_INTERVAL);
+
+        LockHolder holder(_lock);
+
+        for (size_t i = 0; i < _storages->count() && _dirty_count > 0; i++)
+        {
+            BlockStorage *storage = (*_storages)[i].storage;
+            size_t dirty_before = _dirty_count;
+
+            if (write_back(storage) == SUCCESS && _dirty_count != dirty_before)
+            {
+                storage->storage_flush();
+            }
+        }
+
+        shrink();
+    }
+}
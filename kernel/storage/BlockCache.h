@@ -0,0 +1,55 @@
+#pragma once
+
+#include <libutils/ResultOr.h>
+
+#include "architectures/Memory.h"
+#include "kernel/storage/BlockStorage.h"
+
+#define BLOCK_CACHE_BLOCK_SIZE (ARCH_PAGE_SIZE)
+#define BLOCK_CACHE_BUCKET_COUNT (1024)
+
+// While reads stay sequential, that many blocks after them are read along,
+// the window doubling each time from the min to the max.
+#define BLOCK_CACHE_READ_AHEAD_MIN (4)
+#define BLOCK_CACHE_READ_AHEAD_MAX (64)
+
+// Blocks moved by a single transfer to or from the disk.
+#define BLOCK_CACHE_BATCH_SIZE (128)
+
+// The cache grows up to that share of physical memory, and gives pages back
+// when less than the reserve is left to everyone else.
+#define BLOCK_CACHE_MEMORY_SHARE (4)
+#define BLOCK_CACHE_MEMORY_RESERVE (4 * 1024 * 1024)
+
+// Dirty blocks are written back by the flusher task that often, in
+// milliseconds, or right away by writers once they are half of the cache.
+#define BLOCK_CACHE_FLUSH_INTERVAL (1000)
+
+struct BlockCacheStatistics
+{
+    size_t blocks;
+    size_t dirty;
+    size_t capacity;
+
+    // Blocks asked for which were already there or had to be read.
+    uint64_t hits;
+    uint64_t misses;
+
+    // Blocks read before being asked for.
+    uint64_t read_ahead;
+
+    uint64_t evictions;
+    uint64_t written_back;
+};
+
+void block_cache_initialize();
+
+ResultOr<size_t> block_cache_read(BlockStorage *storage, uint64_t offset, void *buffer, size_t size);
+
+// Writes land in the cache and reach the disk later, from the flusher or
+// block_cache_sync().
+ResultOr<size_t> block_cache_write(BlockStorage *storage, uint64_t offset, const void *buffer, size_t size);
+
+Result block_cache_sync(BlockStorage *storage);
+
+BlockCacheStatistics block_cache_statistics();
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libsystem/Result.h>
+
+// Implemented by the drivers of disks, next to Device, so their content can
+// be kept in the block cache.
+class BlockStorage
+{
+public:
+    virtual ~BlockStorage() {}
+
+    // In bytes, a multiple of the sector size.
+    virtual uint64_t storage_size() = 0;
+
+    virtual bool storage_read_only() = 0;
+
+    // Move `size` bytes between the disk at `offset` and the physical
+    // `pages`, each holding ARCH_PAGE_SIZE bytes but the last one. Offset
+    // and size are multiples of the sector size.
+    virtual Result storage_transfer(bool write, uint64_t offset, const uintptr_t *pages, size_t size) = 0;
+
+    // Make sure what was written reached the disk.
+    virtual Result storage_flush() = 0;
+};
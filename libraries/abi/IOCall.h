@@ -45,6 +45,17 @@ struct IOCallNetworkSateAgs
     MacAddress mac_address;
 };
 
+struct IOCallNetworkRingsArgs
+{
+    int memory_handle;
+};
+
+struct IOCallDiskGeometryArgs
+{
+    size_t sector_size;
+    uint64_t sector_count;
+};
+
 enum IOCall
 {
     IOCALL_TERMINAL_GET_SIZE,
@@ -61,6 +72,11 @@ enum IOCall
     IOCALL_TEXTMODE_SET_STATE,
 
     IOCALL_NETWORK_GET_STATE,
+    IOCALL_NETWORK_GET_RINGS,
+    IOCALL_NETWORK_KICK,
+
+    IOCALL_DISK_GET_GEOMETRY,
+    IOCALL_DISK_SYNC,
 
     __IOCALL_COUNT,
 };
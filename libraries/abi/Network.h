@@ -11,3 +11,76 @@ struct MacAddress
         return bytes[index];
     }
 };
+
+// Packet rings shared by network drivers with a daemon, through the memory
+// object returned by IOCALL_NETWORK_GET_RINGS. Buffers are referred to by
+// their index, the frame is NETWORK_BUFFER_HEADROOM bytes in, the room
+// before it is for the driver.
+//
+// Each ring has a single producer advancing `head` and a single consumer
+// advancing `tail`, both free running. Buffers go around between them:
+// the daemon gives empty ones to `refill` and takes frames from `received`,
+// puts frames in `transmit` and gets their buffers back from `completed`.
+
+#define NETWORK_BUFFER_SIZE (2048)
+#define NETWORK_BUFFER_HEADROOM (16)
+#define NETWORK_FRAME_SIZE (NETWORK_BUFFER_SIZE - NETWORK_BUFFER_HEADROOM)
+
+// The receive buffers come first and start in `refill`, the transmit ones
+// start in `completed`.
+#define NETWORK_RECEIVE_BUFFERS (256)
+#define NETWORK_TRANSMIT_BUFFERS (256)
+#define NETWORK_BUFFER_COUNT (NETWORK_RECEIVE_BUFFERS + NETWORK_TRANSMIT_BUFFERS)
+
+#define NETWORK_RING_SIZE (NETWORK_BUFFER_COUNT)
+
+#define NETWORK_BUFFERS_OFFSET (16384)
+#define NETWORK_RINGS_MEMORY_SIZE (NETWORK_BUFFERS_OFFSET + NETWORK_BUFFER_COUNT * NETWORK_BUFFER_SIZE)
+
+struct NetworkPacket
+{
+    uint16_t buffer;
+    uint16_t length;
+};
+
+struct NetworkRing
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    NetworkPacket packets[NETWORK_RING_SIZE];
+
+    bool empty() const { return head == tail; }
+
+    bool full() const { return head - tail >= NETWORK_RING_SIZE; }
+
+    NetworkPacket peek() const { return packets[tail % NETWORK_RING_SIZE]; }
+
+    // Entries must be visible before the index telling about them, and read
+    // before the index giving them back.
+    void push(NetworkPacket packet)
+    {
+        packets[head % NETWORK_RING_SIZE] = packet;
+        __sync_synchronize();
+        head = head + 1;
+    }
+
+    NetworkPacket pop()
+    {
+        NetworkPacket packet = peek();
+        __sync_synchronize();
+        tail = tail + 1;
+
+        return packet;
+    }
+};
+
+struct NetworkRings
+{
+    NetworkRing received;
+    NetworkRing refill;
+    NetworkRing transmit;
+    NetworkRing completed;
+};
+
+static_assert(sizeof(NetworkRings) <= NETWORK_BUFFERS_OFFSET);
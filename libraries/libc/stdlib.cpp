@@ -5,6 +5,7 @@
 
 #include <libsystem/Logger.h>
 #include <libsystem/process/Process.h>
+#include <libutils/Sort.h>
 
 void __no_return exit(int status)
 {
@@ -36,6 +37,29 @@ int system(const char *command)
     return exit_value;
 }
 
+void qsort(void *base, size_t nmemb, size_t size, int (*compar)(const void *, const void *))
+{
+    char *bytes = (char *)base;
+
+    auto compare = [&](size_t a, size_t b) {
+        return compar(bytes + a * size, bytes + b * size);
+    };
+
+    auto swap = [&](size_t a, size_t b) {
+        char *left = bytes + a * size;
+        char *right = bytes + b * size;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            char tmp = left[i];
+            left[i] = right[i];
+            right[i] = tmp;
+        }
+    };
+
+    sort(0, nmemb, compare, swap);
+}
+
 double strtod(const char *nptr, char **endptr)
 {
     int sign = 1;
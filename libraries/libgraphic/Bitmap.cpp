@@ -93,7 +93,16 @@ ResultOr<RefPtr<Bitmap>> Bitmap::load_from(const char *path)
     if (bitmap_or_result.success())
     {
         auto bitmap = bitmap_or_result.take_value();
-        memcpy(bitmap->pixels(), decoded_data, sizeof(Color) * decoded_width * decoded_height);
+
+        Color *decoded_pixels = reinterpret_cast<Color *>(decoded_data);
+
+        for (size_t i = 0; i < decoded_width * decoded_height; i++)
+        {
+            bitmap->_pixels[i] = decoded_pixels[i].premultiplied();
+        }
+
+        bitmap->_premultiplied = true;
+
         free(decoded_data);
         return bitmap;
     }
@@ -116,20 +125,53 @@ RefPtr<Bitmap> Bitmap::load_from_or_placeholder(const char *path)
     return result.take_value();
 }
 
+void Bitmap::premultiply()
+{
+    if (_premultiplied)
+    {
+        return;
+    }
+
+    for (int i = 0; i < _width * _height; i++)
+    {
+        _pixels[i] = _pixels[i].premultiplied();
+    }
+
+    _premultiplied = true;
+}
+
 Result Bitmap::save_to(const char *path)
 {
     void *outbuffer __cleanup_malloc = nullptr;
 
     size_t outbuffer_size = 0;
 
+    // PNG files are straight alpha.
+    Color *pixels = _pixels;
+
+    if (_premultiplied)
+    {
+        pixels = (Color *)malloc(sizeof(Color) * _width * _height);
+
+        for (int i = 0; i < _width * _height; i++)
+        {
+            pixels[i] = _pixels[i].unpremultiplied();
+        }
+    }
+
     int err = lodepng_encode_memory(
         (unsigned char **)&outbuffer,
         &outbuffer_size,
-        (const unsigned char *)_pixels,
+        (const unsigned char *)pixels,
         _width,
         _height,
         LCT_RGBA, 8);
 
+    if (pixels != _pixels)
+    {
+        free(pixels);
+    }
+
     if (err != 0)
     {
         return ERR_BAD_IMAGE_FILE_FORMAT;
@@ -29,6 +29,7 @@ private:
     int _width;
     int _height;
     BitmapFiltering _filtering;
+    bool _premultiplied = false;
     Color *_pixels;
 
     __noncopyable(Bitmap);
@@ -55,8 +56,18 @@ public:
     Vec2i size() const { return Vec2i(_width, _height); }
     Recti bound() const { return Recti(_width, _height); }
 
+    BitmapFiltering filtering() const { return _filtering; }
+
     void filtering(BitmapFiltering filtering) { _filtering = filtering; }
 
+    // Images loaded from disk are only ever drawn onto something else, their
+    // pixels are premultiplied by their alpha once when loading them so
+    // blitting doesn't have to. Everything else, like window buffers and
+    // the framebuffer, keeps straight alpha.
+    bool premultiplied() const { return _premultiplied; }
+
+    void premultiply();
+
     static ResultOr<RefPtr<Bitmap>> create_shared(int width, int height);
 
     static ResultOr<RefPtr<Bitmap>> create_shared_from_handle(int handle, Vec2i width_and_height);
@@ -92,6 +103,20 @@ public:
         set_pixel_no_check(position, Color::blend(color, background));
     }
 
+    void blend_pixel_premultiplied(Vec2i position, Color color)
+    {
+        if (bound().contains(position))
+        {
+            blend_pixel_premultiplied_no_check(position, color);
+        }
+    }
+
+    void blend_pixel_premultiplied_no_check(Vec2i position, Color color)
+    {
+        Color background = get_pixel_no_check(position);
+        set_pixel_no_check(position, Color::blend_premultiplied(color, background));
+    }
+
     Color get_pixel(Vec2i position)
     {
         return _pixels[clamp(position.y(), 0, height() - 1) * width() + clamp(position.x(), 0, width() - 1)];
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <libgraphic/Color.h>
+#include <libsystem/core/CString.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+// Blend a row of `source` pixels onto `destination`, which has straight
+// alpha. Runs of opaque pixels are copied as they are, fully transparent
+// ones are skipped, and only what is left goes through the blending.
+static inline void blend_span(Color *destination, const Color *source, size_t count, bool premultiplied)
+{
+    size_t i = 0;
+
+    while (i < count)
+    {
+        size_t run = i;
+
+        while (run < count && source[run].alpha() == 255)
+        {
+            run++;
+        }
+
+        if (run > i)
+        {
+            memcpy(destination + i, source + i, (run - i) * sizeof(Color));
+            i = run;
+            continue;
+        }
+
+        Color color = source[i];
+
+        if (color.alpha() != 0)
+        {
+            destination[i] = premultiplied
+                                 ? Color::blend_premultiplied(color, destination[i])
+                                 : Color::blend(color, destination[i]);
+        }
+
+        i++;
+    }
+}
+
+// Blend the same color over a row of pixels, premultiplying it once.
+static inline void blend_span(Color *destination, Color color, size_t count)
+{
+    if (color.alpha() == 255)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            destination[i] = color;
+        }
+
+        return;
+    }
+
+    if (color.alpha() == 0)
+    {
+        return;
+    }
+
+    Color premultiplied = color.premultiplied();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        destination[i] = Color::blend_premultiplied(premultiplied, destination[i]);
+    }
+}
+
+// A premultiplied color weighted by `coverage` blended onto a straight one.
+static inline Color blend_coverage(Color premultiplied, uint32_t coverage, Color destination)
+{
+    Color source = Color::from_byte(
+        Color::div255(premultiplied.red() * coverage),
+        Color::div255(premultiplied.green() * coverage),
+        Color::div255(premultiplied.blue() * coverage),
+        Color::div255(premultiplied.alpha() * coverage));
+
+    return Color::blend_premultiplied(source, destination);
+}
+
+#ifdef __SSE2__
+
+// x / 255 rounded to the nearest on each 16 bits lane, like Color::div255().
+static inline __m128i blend_div255_epi16(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// `color` scaled by the coverage of two pixels, over two opaque pixels.
+static inline __m128i blend_coverage_epi16(__m128i color, __m128i coverage, __m128i destination)
+{
+    __m128i source = blend_div255_epi16(_mm_mullo_epi16(color, coverage));
+
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    return _mm_add_epi16(source, blend_div255_epi16(_mm_mullo_epi16(destination, inverse)));
+}
+
+#endif
+
+// Blend `color` over a row of pixels, each one weighted by its `coverage`,
+// as the rasterizer reports them. Four opaque pixels are blended at once.
+static inline void blend_span(Color *destination, Color color, const uint8_t *coverage, size_t count)
+{
+    if (color.alpha() == 0)
+    {
+        return;
+    }
+
+    Color premultiplied = color.premultiplied();
+
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+
+    uint32_t packed;
+    memcpy(&packed, &premultiplied, sizeof(Color));
+    __m128i channels = _mm_unpacklo_epi8(_mm_set1_epi32(packed), zero);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t mask;
+        memcpy(&mask, coverage + i, sizeof(mask));
+
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(destination + i));
+
+        // Blending over translucent pixels needs a division, leave them to
+        // the scalar path.
+        __m128i alpha = _mm_srli_epi32(pixels, 24);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_set1_epi32(255))) != 0xffff)
+        {
+            for (size_t j = i; j < i + 4; j++)
+            {
+                if (coverage[j] != 0)
+                {
+                    destination[j] = blend_coverage(premultiplied, coverage[j], destination[j]);
+                }
+            }
+
+            continue;
+        }
+
+        // Each coverage byte repeated over the four channels of its pixel.
+        __m128i masks = _mm_cvtsi32_si128(mask);
+        masks = _mm_unpacklo_epi8(masks, zero);
+        masks = _mm_unpacklo_epi16(masks, masks);
+
+        __m128i low_masks = _mm_unpacklo_epi32(masks, masks);
+        __m128i high_masks = _mm_unpackhi_epi32(masks, masks);
+
+        __m128i low = blend_coverage_epi16(channels, low_masks, _mm_unpacklo_epi8(pixels, zero));
+        __m128i high = blend_coverage_epi16(channels, high_masks, _mm_unpackhi_epi8(pixels, zero));
+
+        _mm_storeu_si128((__m128i *)(destination + i), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (coverage[i] == 0)
+        {
+            continue;
+        }
+
+        destination[i] = blend_coverage(premultiplied, coverage[i], destination[i]);
+    }
+}
@@ -0,0 +1,364 @@
+#include <stdlib.h>
+
+#include <libgraphic/Blur.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+// Past this radius the image is downsampled first.
+#define BLUR_DIRECT_RADIUS (4)
+
+#define BLUR_MAX_LEVELS (8)
+
+// Fixed point 1 / (radius * 2 + 1) for _mm_mulhi_epu16(), rounded up so a
+// run of the same value averages back to it. Sums of a window of at most
+// 257 pixels fit in 16 bits and the result stays below 256.
+static uint16_t box_scale(int radius)
+{
+    int size = radius * 2 + 1;
+    return (65536 + size - 1) / size;
+}
+
+static uint8_t box_average(uint32_t sum, uint16_t scale)
+{
+    return (sum * scale) >> 16;
+}
+
+#ifdef __SSE2__
+
+static __m128i load_pixel(const Color *pixel)
+{
+    int value;
+    memcpy(&value, pixel, sizeof(Color));
+    return _mm_unpacklo_epi8(_mm_cvtsi32_si128(value), _mm_setzero_si128());
+}
+
+static void store_pixel(Color *pixel, __m128i channels)
+{
+    int value = _mm_cvtsi128_si32(_mm_packus_epi16(channels, channels));
+    memcpy((void *)pixel, &value, sizeof(Color));
+}
+
+#endif
+
+// Horizontal pass, the four channels of a pixel are summed together in one
+// register. Pixels past the edges are the edge pixels repeated.
+static void box_blur_row(const Color *source, Color *destination, int width, int radius, uint16_t scale)
+{
+#ifdef __SSE2__
+    __m128i factor = _mm_set1_epi16(scale);
+    __m128i sum = _mm_mullo_epi16(load_pixel(&source[0]), _mm_set1_epi16(radius + 1));
+
+    for (int i = 1; i <= radius; i++)
+    {
+        sum = _mm_add_epi16(sum, load_pixel(&source[MIN(i, width - 1)]));
+    }
+
+    for (int x = 0; x < width; x++)
+    {
+        store_pixel(&destination[x], _mm_mulhi_epu16(sum, factor));
+
+        sum = _mm_add_epi16(sum, load_pixel(&source[MIN(x + radius + 1, width - 1)]));
+        sum = _mm_sub_epi16(sum, load_pixel(&source[MAX(x - radius, 0)]));
+    }
+#else
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(source);
+    uint8_t *output = reinterpret_cast<uint8_t *>(destination);
+
+    for (int channel = 0; channel < 4; channel++)
+    {
+        uint32_t sum = bytes[channel] * (radius + 1);
+
+        for (int i = 1; i <= radius; i++)
+        {
+            sum += bytes[MIN(i, width - 1) * 4 + channel];
+        }
+
+        for (int x = 0; x < width; x++)
+        {
+            output[x * 4 + channel] = box_average(sum, scale);
+
+            sum += bytes[MIN(x + radius + 1, width - 1) * 4 + channel];
+            sum -= bytes[MAX(x - radius, 0) * 4 + channel];
+        }
+    }
+#endif
+}
+
+// Vertical pass, running sums are kept for every channel of the row and
+// updated a whole row at a time.
+static void box_blur_columns(const Color *source, int source_stride, Color *destination, int destination_stride, int width, int height, int radius, uint16_t scale, uint16_t *sums)
+{
+    auto row = [&](int y) {
+        return reinterpret_cast<const uint8_t *>(source + MIN(MAX(y, 0), height - 1) * source_stride);
+    };
+
+    int count = width * 4;
+
+    for (int i = 0; i < count; i++)
+    {
+        sums[i] = row(0)[i] * (radius + 1);
+    }
+
+    for (int y = 1; y <= radius; y++)
+    {
+        const uint8_t *added = row(y);
+
+        for (int i = 0; i < count; i++)
+        {
+            sums[i] += added[i];
+        }
+    }
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t *added = row(y + radius + 1);
+        const uint8_t *removed = row(y - radius);
+        uint8_t *output = reinterpret_cast<uint8_t *>(destination + y * destination_stride);
+
+        int i = 0;
+
+#ifdef __SSE2__
+        __m128i zero = _mm_setzero_si128();
+        __m128i factor = _mm_set1_epi16(scale);
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i low = _mm_loadu_si128((const __m128i *)(sums + i));
+            __m128i high = _mm_loadu_si128((const __m128i *)(sums + i + 8));
+
+            _mm_storeu_si128((__m128i *)(output + i),
+                             _mm_packus_epi16(_mm_mulhi_epu16(low, factor), _mm_mulhi_epu16(high, factor)));
+
+            __m128i in = _mm_loadu_si128((const __m128i *)(added + i));
+            __m128i out = _mm_loadu_si128((const __m128i *)(removed + i));
+
+            low = _mm_sub_epi16(_mm_add_epi16(low, _mm_unpacklo_epi8(in, zero)), _mm_unpacklo_epi8(out, zero));
+            high = _mm_sub_epi16(_mm_add_epi16(high, _mm_unpackhi_epi8(in, zero)), _mm_unpackhi_epi8(out, zero));
+
+            _mm_storeu_si128((__m128i *)(sums + i), low);
+            _mm_storeu_si128((__m128i *)(sums + i + 8), high);
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            output[i] = box_average(sums[i], scale);
+            sums[i] += added[i] - removed[i];
+        }
+    }
+}
+
+void box_blur(Color *pixels, int stride, int width, int height, int radius)
+{
+    if (width <= 0 || height <= 0 || radius < 1)
+    {
+        return;
+    }
+
+    radius = MIN(radius, BLUR_BOX_MAX_RADIUS);
+    uint16_t scale = box_scale(radius);
+
+    Color *scratch = (Color *)malloc(width * height * sizeof(Color));
+    uint16_t *sums = (uint16_t *)malloc(width * 4 * sizeof(uint16_t));
+
+    for (int pass = 0; pass < 3; pass++)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            box_blur_row(pixels + y * stride, scratch + y * width, width, radius, scale);
+        }
+
+        box_blur_columns(scratch, width, pixels, stride, width, height, radius, scale, sums);
+    }
+
+    free(scratch);
+    free(sums);
+}
+
+// Average blocks of 2x2 pixels, the last row or column is repeated when the
+// size is odd.
+static void downsample(const Color *source, int stride, int width, int height, Color *destination)
+{
+    int half_width = (width + 1) / 2;
+    int half_height = (height + 1) / 2;
+
+    for (int y = 0; y < half_height; y++)
+    {
+        const Color *top = source + (y * 2) * stride;
+        const Color *bottom = source + MIN(y * 2 + 1, height - 1) * stride;
+        Color *output = destination + y * half_width;
+
+        int x = 0;
+
+#ifdef __SSE2__
+        for (; x + 2 <= width / 2; x += 2)
+        {
+            __m128i rows = _mm_avg_epu8(
+                _mm_loadu_si128((const __m128i *)(top + x * 2)),
+                _mm_loadu_si128((const __m128i *)(bottom + x * 2)));
+
+            __m128i even = _mm_shuffle_epi32(rows, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128i odd = _mm_shuffle_epi32(rows, _MM_SHUFFLE(3, 1, 3, 1));
+
+            _mm_storel_epi64((__m128i *)(output + x), _mm_avg_epu8(even, odd));
+        }
+#endif
+
+        for (; x < half_width; x++)
+        {
+            int left = x * 2;
+            int right = MIN(x * 2 + 1, width - 1);
+
+            output[x] = Color::from_byte(
+                (top[left].red() + top[right].red() + bottom[left].red() + bottom[right].red() + 2) / 4,
+                (top[left].green() + top[right].green() + bottom[left].green() + bottom[right].green() + 2) / 4,
+                (top[left].blue() + top[right].blue() + bottom[left].blue() + bottom[right].blue() + 2) / 4,
+                (top[left].alpha() + top[right].alpha() + bottom[left].alpha() + bottom[right].alpha() + 2) / 4);
+        }
+    }
+}
+
+// Rounded up average of two pixels.
+static Color average(Color a, Color b)
+{
+    return Color::from_byte(
+        (a.red() + b.red() + 1) / 2,
+        (a.green() + b.green() + 1) / 2,
+        (a.blue() + b.blue() + 1) / 2,
+        (a.alpha() + b.alpha() + 1) / 2);
+}
+
+// Pixels of an image scaled up by two sit a quarter of a pixel away from the
+// center of the source ones: each is 3/4 of the nearest source pixel and
+// 1/4 of the next one over, which is two averages in a row. `destination`
+// is `width` by `height`, at most twice the size of `source`. `row` has room
+// for the source width plus two.
+static void upsample(const Color *source, int source_width, int source_height, Color *destination, int stride, int width, int height, Color *row)
+{
+    Color *blended = row + 1;
+
+    for (int y = 0; y < height; y++)
+    {
+        int index = y / 2;
+        int neighbor = (y & 1) ? MIN(index + 1, source_height - 1) : MAX(index - 1, 0);
+
+        const Color *nearest = source + index * source_width;
+        const Color *next = source + neighbor * source_width;
+
+        int x = 0;
+
+#ifdef __SSE2__
+        for (; x + 4 <= source_width; x += 4)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *)(nearest + x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(next + x));
+
+            _mm_storeu_si128((__m128i *)(blended + x), _mm_avg_epu8(a, _mm_avg_epu8(a, b)));
+        }
+#endif
+
+        for (; x < source_width; x++)
+        {
+            blended[x] = average(nearest[x], average(nearest[x], next[x]));
+        }
+
+        blended[-1] = blended[0];
+        blended[source_width] = blended[source_width - 1];
+
+        Color *output = destination + y * stride;
+
+        // Source pixel i gives the destination pixels 2i and 2i + 1.
+        int i = 0;
+
+#ifdef __SSE2__
+        for (; (i + 4) * 2 <= width; i += 4)
+        {
+            __m128i center = _mm_loadu_si128((const __m128i *)(blended + i));
+            __m128i left = _mm_loadu_si128((const __m128i *)(blended + i - 1));
+            __m128i right = _mm_loadu_si128((const __m128i *)(blended + i + 1));
+
+            __m128i even = _mm_avg_epu8(center, _mm_avg_epu8(center, left));
+            __m128i odd = _mm_avg_epu8(center, _mm_avg_epu8(center, right));
+
+            _mm_storeu_si128((__m128i *)(output + i * 2), _mm_unpacklo_epi32(even, odd));
+            _mm_storeu_si128((__m128i *)(output + i * 2 + 4), _mm_unpackhi_epi32(even, odd));
+        }
+#endif
+
+        for (; i * 2 < width; i++)
+        {
+            output[i * 2] = average(blended[i], average(blended[i], blended[i - 1]));
+
+            if (i * 2 + 1 < width)
+            {
+                output[i * 2 + 1] = average(blended[i], average(blended[i], blended[i + 1]));
+            }
+        }
+    }
+}
+
+void blur(Color *pixels, int stride, Recti region, int radius)
+{
+    if (region.is_empty() || radius < 1)
+    {
+        return;
+    }
+
+    Color *origin = pixels + region.y() * stride + region.x();
+
+    int levels = 0;
+
+    while (levels < BLUR_MAX_LEVELS &&
+           (radius >> levels) > BLUR_DIRECT_RADIUS &&
+           (region.width() >> (levels + 1)) >= 8 &&
+           (region.height() >> (levels + 1)) >= 8)
+    {
+        levels++;
+    }
+
+    // Three boxes of half the radius spread about as far as the stack blur
+    // this replaced did with the full one.
+    int box_radius = MAX((radius >> levels) / 2, 1);
+
+    if (levels == 0)
+    {
+        box_blur(origin, stride, region.width(), region.height(), box_radius);
+        return;
+    }
+
+    // Halve the image `levels` times, blur the smallest one and double it
+    // back, every level keeps its own buffer for the way back up.
+    Color *buffers[BLUR_MAX_LEVELS + 1] = {origin};
+    int strides[BLUR_MAX_LEVELS + 1] = {stride};
+    int widths[BLUR_MAX_LEVELS + 1] = {region.width()};
+    int heights[BLUR_MAX_LEVELS + 1] = {region.height()};
+
+    for (int level = 1; level <= levels; level++)
+    {
+        widths[level] = (widths[level - 1] + 1) / 2;
+        heights[level] = (heights[level - 1] + 1) / 2;
+        strides[level] = widths[level];
+        buffers[level] = (Color *)malloc(widths[level] * heights[level] * sizeof(Color));
+
+        downsample(buffers[level - 1], strides[level - 1], widths[level - 1], heights[level - 1], buffers[level]);
+    }
+
+    box_blur(buffers[levels], strides[levels], widths[levels], heights[levels], box_radius);
+
+    Color *row = (Color *)malloc((widths[1] + 2) * sizeof(Color));
+
+    for (int level = levels; level > 0; level--)
+    {
+        upsample(buffers[level], widths[level], heights[level],
+                 buffers[level - 1], strides[level - 1], widths[level - 1], heights[level - 1],
+                 row);
+
+        free(buffers[level]);
+    }
+
+    free(row);
+}
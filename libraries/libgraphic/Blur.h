@@ -0,0 +1,15 @@
+#pragma once
+
+#include <libgraphic/Color.h>
+#include <libsystem/algebra/Rect.h>
+
+#define BLUR_BOX_MAX_RADIUS (128)
+
+// Three box blurs of `radius` applied to a `width` by `height` image, which
+// is close enough to a gaussian. Rows are `stride` pixels apart.
+void box_blur(Color *pixels, int stride, int width, int height, int radius);
+
+// Blur `region` of an image `stride` pixels wide in place. Large radii are
+// blurred on a copy downsampled by two as many times as the radius allows,
+// then scaled back up, so the cost barely depends on the radius.
+void blur(Color *pixels, int stride, Recti region, int radius);
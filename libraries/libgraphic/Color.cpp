@@ -2,8 +2,8 @@
 #include <libgraphic/Color.h>
 #include <libsystem/core/CString.h>
 #include <libsystem/utils/NumberParser.h>
-#include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
+#include <libutils/SpanScanner.h>
 
 struct ColorName
 {
@@ -18,12 +18,12 @@ static constexpr ColorName _color_names[] = {
 #undef __ENTRY
 };
 
-static void whitespace(Scanner &scan)
+static void whitespace(SpanScanner &scan)
 {
-    scan.eat(Strings::WHITESPACE);
+    scan.eat_whitespace();
 }
 
-static double number(Scanner &scan)
+static double number(SpanScanner &scan)
 {
     return scan_float(scan);
 }
@@ -35,9 +35,9 @@ Color Color::parse(const char *name)
 
 Color Color::parse(const char *name, size_t size)
 {
-    StringScanner scan{name, size};
+    SpanScanner scan{name, size};
 
-    auto parse_component = [&](StringScanner &scan) {
+    auto parse_component = [&](SpanScanner &scan) {
         whitespace(scan);
 
         auto value = number(scan);
@@ -141,14 +141,96 @@ public:
     static Color parse(const char *name);
     static Color parse(const char *name, size_t size);
 
-    static constexpr Color blend(Color fg, Color gb)
+    // x / 255 rounded to the nearest, for x up to 255 * 255, using a
+    // multiply and shifts instead of a division.
+    static constexpr uint8_t div255(uint32_t x)
     {
-        float a = (1 - fg.alphaf()) * gb.alphaf() + fg.alphaf();
-        float r = ((1 - fg.alphaf()) * gb.alphaf() * gb.redf() + fg.alphaf() * fg.redf()) / a;
-        float g = ((1 - fg.alphaf()) * gb.alphaf() * gb.greenf() + fg.alphaf() * fg.greenf()) / a;
-        float b = ((1 - fg.alphaf()) * gb.alphaf() * gb.bluef() + fg.alphaf() * fg.bluef()) / a;
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    constexpr Color premultiplied() const
+    {
+        return {
+            div255(_red * _alpha),
+            div255(_green * _alpha),
+            div255(_blue * _alpha),
+            _alpha,
+        };
+    }
+
+    constexpr Color unpremultiplied() const
+    {
+        if (_alpha == 0 || _alpha == 255)
+        {
+            return *this;
+        }
+
+        return {
+            static_cast<uint8_t>((_red * 255 + _alpha / 2) / _alpha),
+            static_cast<uint8_t>((_green * 255 + _alpha / 2) / _alpha),
+            static_cast<uint8_t>((_blue * 255 + _alpha / 2) / _alpha),
+            _alpha,
+        };
+    }
+
+    // Source over, both colors and the result premultiplied.
+    static constexpr Color over_premultiplied(Color fg, Color bg)
+    {
+        uint32_t inverse = 255 - fg._alpha;
+
+        return {
+            static_cast<uint8_t>(fg._red + div255(bg._red * inverse)),
+            static_cast<uint8_t>(fg._green + div255(bg._green * inverse)),
+            static_cast<uint8_t>(fg._blue + div255(bg._blue * inverse)),
+            static_cast<uint8_t>(fg._alpha + div255(bg._alpha * inverse)),
+        };
+    }
+
+    // Blend a premultiplied color onto a straight one, most destinations
+    // are opaque and the result is then straight `fg + bg * (255 - a) / 255`.
+    static constexpr Color blend_premultiplied(Color fg, Color bg)
+    {
+        if (fg._alpha == 255 || bg._alpha == 0)
+        {
+            return fg.unpremultiplied();
+        }
+
+        if (bg._alpha == 255)
+        {
+            return over_premultiplied(fg, bg);
+        }
+
+        return over_premultiplied(fg, bg.premultiplied()).unpremultiplied();
+    }
+
+    // Blend two straight colors.
+    static constexpr Color blend(Color fg, Color bg)
+    {
+        if (fg._alpha == 255 || bg._alpha == 0)
+        {
+            return fg;
+        }
+
+        if (fg._alpha == 0)
+        {
+            return bg;
+        }
+
+        if (bg._alpha == 255)
+        {
+            uint32_t alpha = fg._alpha;
+            uint32_t inverse = 255 - alpha;
+
+            return {
+                div255(fg._red * alpha + bg._red * inverse),
+                div255(fg._green * alpha + bg._green * inverse),
+                div255(fg._blue * alpha + bg._blue * inverse),
+                255,
+            };
+        }
 
-        return from_rgba(r, g, b, a);
+        return blend_premultiplied(fg.premultiplied(), bg);
     }
 
     static constexpr Color lerp(Color from, Color to, float transition)
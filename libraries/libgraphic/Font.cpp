@@ -1,4 +1,7 @@
+#include <abi/Handle.h>
+
 #include <libgraphic/Font.h>
+#include <libgraphic/font/GlyphCache.h>
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
@@ -9,6 +12,21 @@
 
 static HashMap<String, RefPtr<Font>> _fonts;
 
+// Every size of a scalable font shares the same outlines.
+static HashMap<String, RefPtr<graphic::TrueType>> _faces;
+
+static graphic::GlyphCache *_glyph_cache = nullptr;
+
+graphic::GlyphCache &Font::glyph_cache()
+{
+    if (!_glyph_cache)
+    {
+        _glyph_cache = new graphic::GlyphCache(GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT);
+    }
+
+    return *_glyph_cache;
+}
+
 static ResultOr<Vector<Glyph>> font_load_glyph(String name)
 {
     char glyph_path[PATH_LENGTH];
@@ -60,8 +78,51 @@ ResultOr<RefPtr<Font>> Font::create(String name)
     return _fonts[name];
 }
 
+ResultOr<RefPtr<Font>> Font::create(String name, int size)
+{
+    char key[PATH_LENGTH];
+    snprintf(key, PATH_LENGTH, "%s@%d", name.cstring(), size);
+
+    if (!_fonts.has_key(key))
+    {
+        if (!_faces.has_key(name))
+        {
+            char path[PATH_LENGTH];
+            snprintf(path, PATH_LENGTH, "/Files/Fonts/%s.ttf", name.cstring());
+
+            auto face_or_error = graphic::TrueType::load(path);
+
+            if (!face_or_error.success())
+            {
+                logger_error("Failed to load font %s: %s", name.cstring(), handle_error_string(face_or_error.result()));
+                return face_or_error.result();
+            }
+
+            _faces[name] = face_or_error.take_value();
+        }
+
+        _fonts[key] = make<Font>(_faces[name], size);
+    }
+
+    return _fonts[key];
+}
+
+// Rounded the same way as the glyphs of the cache.
+int Font::advance(int index)
+{
+    float scale = _size / (float)_face->units_per_em();
+    return (int)(_face->advance(index) * scale + 0.5f);
+}
+
 Glyph &Font::glyph(Codepoint codepoint)
 {
+    if (_face)
+    {
+        Glyph &glyph = glyph_cache().lookup(*_face, _size, _face->glyph_index(codepoint));
+        glyph.codepoint = codepoint;
+        return glyph;
+    }
+
     for (int i = 0; _glyphs[i].codepoint != 0; i++)
     {
         if (_glyphs[i].codepoint == codepoint)
@@ -75,6 +136,11 @@ Glyph &Font::glyph(Codepoint codepoint)
 
 bool Font::has_glyph(Codepoint codepoint)
 {
+    if (_face)
+    {
+        return _face->glyph_index(codepoint) != 0;
+    }
+
     for (int i = 0; _glyphs[i].codepoint != 0; i++)
     {
         if (_glyphs[i].codepoint == codepoint)
@@ -90,6 +156,19 @@ Recti Font::mesure_string(const char *string)
 {
     int width = 0;
 
+    // Measuring only needs the advances, nothing is rasterized.
+    if (_face)
+    {
+        codepoint_foreach(reinterpret_cast<const uint8_t *>(string), [&](auto codepoint) {
+            width += advance(_face->glyph_index(codepoint));
+        });
+
+        float scale = _size / (float)_face->units_per_em();
+        int height = (_face->ascent() - _face->descent()) * scale + 0.5f;
+
+        return Recti(width, height);
+    }
+
     codepoint_foreach(reinterpret_cast<const uint8_t *>(string), [&](auto codepoint) {
         Glyph &g = glyph(codepoint);
         width += g.advance;
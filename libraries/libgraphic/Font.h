@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libgraphic/Bitmap.h>
+#include <libgraphic/font/TrueType.h>
 #include <libsystem/unicode/Codepoint.h>
 #include <libutils/String.h>
 #include <libutils/Vector.h>
@@ -13,6 +14,11 @@ struct Glyph
     int advance;
 };
 
+namespace graphic
+{
+class GlyphCache;
+} // namespace graphic
+
 class Font : public RefCounted<Font>
 {
 private:
@@ -20,11 +26,27 @@ private:
     Glyph _default;
     Vector<Glyph> _glyphs;
 
+    // Scalable fonts have no bitmap, their glyphs are rasterized when
+    // first used into the glyph cache.
+    RefPtr<graphic::TrueType> _face;
+    int _size = 0;
+
+    int advance(int index);
+
 public:
     Bitmap &bitmap() { return *_bitmap; }
 
+    bool scalable() { return _face; }
+
+    // Shared by every scalable font of the process.
+    static graphic::GlyphCache &glyph_cache();
+
+    // Prerendered font, /Files/Fonts/<name>.png and its .glyph table.
     static ResultOr<RefPtr<Font>> create(String name);
 
+    // TrueType font from /Files/Fonts/<name>.ttf at `size` pixels per em.
+    static ResultOr<RefPtr<Font>> create(String name, int size);
+
     Font(RefPtr<Bitmap> bitmap, Vector<Glyph> glyphs)
         : _bitmap(bitmap),
           _glyphs(move(glyphs))
@@ -32,6 +54,14 @@ public:
         _default = glyph(U'?');
     }
 
+    Font(RefPtr<graphic::TrueType> face, int size)
+        : _face(face),
+          _size(size)
+    {
+    }
+
+    // For scalable fonts the glyph is only valid until the next one is
+    // asked for.
     Glyph &glyph(Codepoint codepoint);
 
     bool has_glyph(Codepoint codepoint);
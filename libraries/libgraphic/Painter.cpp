@@ -1,7 +1,10 @@
 #include <stdlib.h>
 
+#include <libgraphic/Blending.h>
+#include <libgraphic/Blur.h>
 #include <libgraphic/Font.h>
-#include <libgraphic/StackBlur.h>
+#include <libgraphic/Scaling.h>
+#include <libgraphic/font/GlyphCache.h>
 #include <libsystem/Assert.h>
 #include <libsystem/math/Math.h>
 
@@ -75,6 +78,16 @@ void Painter::plot_pixel(Vec2i position, Color color)
     }
 }
 
+void Painter::plot_pixel_premultiplied(Vec2i position, Color color)
+{
+    Vec2i transformed = position + _state_stack[_state_stack_top].origine;
+
+    if (clip().contains(transformed))
+    {
+        _bitmap->blend_pixel_premultiplied(transformed, color);
+    }
+}
+
 void Painter::blit_bitmap_fast(Bitmap &bitmap, Recti source, Recti destination)
 {
     Recti clipped_destination = apply_transform(destination);
@@ -86,35 +99,51 @@ void Painter::blit_bitmap_fast(Bitmap &bitmap, Recti source, Recti destination)
     if (clipped_destination.is_empty())
         return;
 
-    for (int x = 0; x < clipped_destination.width(); x++)
+    if (bitmap.bound().contains(clipped_source))
     {
         for (int y = 0; y < clipped_destination.height(); y++)
+        {
+            Color *source_row = bitmap.pixels() + (clipped_source.y() + y) * bitmap.width() + clipped_source.x();
+            Color *destination_row = _bitmap->pixels() + (clipped_destination.y() + y) * _bitmap->width() + clipped_destination.x();
+
+            blend_span(destination_row, source_row, clipped_destination.width(), bitmap.premultiplied());
+        }
+
+        return;
+    }
+
+    for (int y = 0; y < clipped_destination.height(); y++)
+    {
+        for (int x = 0; x < clipped_destination.width(); x++)
         {
             Vec2i position(x, y);
 
             Color sample = bitmap.get_pixel(clipped_source.position() + position);
 
-            _bitmap->blend_pixel(clipped_destination.position() + position, sample);
+            if (bitmap.premultiplied())
+            {
+                _bitmap->blend_pixel_premultiplied(clipped_destination.position() + position, sample);
+            }
+            else
+            {
+                _bitmap->blend_pixel(clipped_destination.position() + position, sample);
+            }
         }
     }
 }
 
 void Painter::blit_bitmap_scaled(Bitmap &bitmap, Recti source, Recti destination)
 {
-    if (destination.is_empty())
-        return;
+    source = source.clipped_with(bitmap.bound());
+    destination = apply_transform(destination);
 
-    for (int x = 0; x < destination.width(); x++)
-    {
-        for (int y = 0; y < destination.height(); y++)
-        {
-            float xx = x / (float)destination.width();
-            float yy = y / (float)destination.height();
+    if (source.is_empty() || destination.is_empty())
+        return;
 
-            Color sample = bitmap.sample(source, Vec2f(xx, yy));
-            plot_pixel(destination.position() + Vec2i(x, y), sample);
-        }
-    }
+    scale(bitmap.pixels(), bitmap.width(), source, destination, apply_clip(destination), bitmap.filtering(),
+          [&](int y, int x, const Color *pixels, int count) {
+              blend_span(_bitmap->pixels() + y * _bitmap->width() + x, pixels, count, bitmap.premultiplied());
+          });
 }
 
 __flatten void Painter::blit_bitmap(Bitmap &bitmap, Recti source, Recti destination)
@@ -133,6 +162,14 @@ __flatten void Painter::blit_bitmap(Bitmap &bitmap, Recti source, Recti destinat
     }
 }
 
+static void copy_span_no_alpha(Color *destination, const Color *source, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        destination[i] = Color::from_byte(source[i].red(), source[i].green(), source[i].blue(), 255);
+    }
+}
+
 void Painter::blit_bitmap_fast_no_alpha(Bitmap &bitmap, Recti source, Recti destination)
 {
     Recti clipped_destination = apply_transform(destination);
@@ -144,9 +181,22 @@ void Painter::blit_bitmap_fast_no_alpha(Bitmap &bitmap, Recti source, Recti dest
     if (clipped_destination.is_empty())
         return;
 
-    for (int x = 0; x < clipped_destination.width(); x++)
+    if (bitmap.bound().contains(clipped_source))
     {
         for (int y = 0; y < clipped_destination.height(); y++)
+        {
+            Color *source_row = bitmap.pixels() + (clipped_source.y() + y) * bitmap.width() + clipped_source.x();
+            Color *destination_row = _bitmap->pixels() + (clipped_destination.y() + y) * _bitmap->width() + clipped_destination.x();
+
+            copy_span_no_alpha(destination_row, source_row, clipped_destination.width());
+        }
+
+        return;
+    }
+
+    for (int y = 0; y < clipped_destination.height(); y++)
+    {
+        for (int x = 0; x < clipped_destination.width(); x++)
         {
             Vec2i position(x, y);
 
@@ -158,17 +208,16 @@ void Painter::blit_bitmap_fast_no_alpha(Bitmap &bitmap, Recti source, Recti dest
 
 void Painter::blit_bitmap_scaled_no_alpha(Bitmap &bitmap, Recti source, Recti destination)
 {
-    for (int x = 0; x < destination.width(); x++)
-    {
-        for (int y = 0; y < destination.height(); y++)
-        {
-            float xx = x / (float)destination.width();
-            float yy = y / (float)destination.height();
+    source = source.clipped_with(bitmap.bound());
+    destination = apply_transform(destination);
 
-            Color sample = bitmap.sample(source, Vec2f(xx, yy));
-            plot_pixel(destination.position() + Vec2i(x, y), sample);
-        }
-    }
+    if (source.is_empty() || destination.is_empty())
+        return;
+
+    scale(bitmap.pixels(), bitmap.width(), source, destination, apply_clip(destination), bitmap.filtering(),
+          [&](int y, int x, const Color *pixels, int count) {
+              copy_span_no_alpha(_bitmap->pixels() + y * _bitmap->width() + x, pixels, count);
+          });
 }
 
 __flatten void Painter::blit_bitmap_no_alpha(Bitmap &bitmap, Recti source, Recti destination)
@@ -218,12 +267,10 @@ __flatten void Painter::fill_rectangle(Recti rectangle, Color color)
         return;
     }
 
-    for (int x = 0; x < rectangle.width(); x++)
+    for (int y = 0; y < rectangle.height(); y++)
     {
-        for (int y = 0; y < rectangle.height(); y++)
-        {
-            _bitmap->blend_pixel_no_check(Vec2i(rectangle.x() + x, rectangle.y() + y), color);
-        }
+        Color *row = _bitmap->pixels() + (rectangle.y() + y) * _bitmap->width() + rectangle.x();
+        blend_span(row, color, rectangle.width());
     }
 }
 
@@ -550,26 +597,16 @@ __flatten void Painter::draw_triangle(Vec2i p0, Vec2i p1, Vec2i p2, Color color)
     draw_line(p2, p0, color);
 }
 
-void Painter::draw_path(const graphic::Path &path, Vec2f pos, Trans2f transform, Color color)
+void Painter::fill_path(const graphic::Path &path, Vec2f pos, Trans2f transform, Color color, graphic::FillRule rule)
 {
-    for (size_t i = 0; i < path.subpath_count(); i++)
-    {
-        auto &subpath = path.subpath(i);
-
-        for (size_t i = 0; i < subpath.length(); i++)
-        {
-            auto curve = subpath.curves(i);
-
-            curve.start = transform.apply(curve.start) + pos;
-            curve.first_control_point = transform.apply(curve.first_control_point) + pos;
-            curve.second_contol_point = transform.apply(curve.second_contol_point) + pos;
-            curve.end = transform.apply(curve.end) + pos;
+    _rasterizer.fill(path, pos + Vec2f(origine()), transform, clip(), rule, [&](int y, int x, const uint8_t *coverage, int count) {
+        blend_span(_bitmap->pixels() + y * _bitmap->width() + x, color, coverage, count);
+    });
+}
 
-            draw_line(curve.start, curve.first_control_point, color);
-            draw_line(curve.first_control_point, curve.second_contol_point, color);
-            draw_line(curve.second_contol_point, curve.end, color);
-        }
-    }
+void Painter::draw_path(const graphic::Path &path, Vec2f pos, Trans2f transform, Color color)
+{
+    _rasterizer.stroke(*this, path, pos, transform, color);
 }
 
 static double sample_draw_circle(Vec2i center, double radius, double thickness, Vec2i position)
@@ -641,12 +678,7 @@ __flatten void Painter::blur_rectangle(Recti rectangle, int radius)
     rectangle = apply_transform(rectangle);
     rectangle = apply_clip(rectangle);
 
-    stackblur((unsigned char *)_bitmap->pixels(),
-              _bitmap->width(),
-              _bitmap->height(),
-              radius,
-              rectangle.x(), rectangle.x() + rectangle.width(),
-              rectangle.y(), rectangle.y() + rectangle.height());
+    blur(_bitmap->pixels(), _bitmap->width(), rectangle, radius);
 }
 
 __flatten void Painter::blit_bitmap_colored(Bitmap &bitmap, Recti source, Recti destination, Color color)
@@ -667,10 +699,41 @@ __flatten void Painter::blit_bitmap_colored(Bitmap &bitmap, Recti source, Recti
     }
 }
 
+void Painter::blit_coverage(const uint8_t *coverage, int stride, Recti source, Vec2i position, Color color)
+{
+    Recti unclipped = apply_transform(Recti(position, source.size()));
+    Recti destination = apply_clip(unclipped);
+
+    if (destination.is_empty())
+    {
+        return;
+    }
+
+    Vec2i offset = source.position() + destination.position() - unclipped.position();
+
+    for (int y = 0; y < destination.height(); y++)
+    {
+        blend_span(
+            _bitmap->pixels() + (destination.y() + y) * _bitmap->width() + destination.x(),
+            color,
+            coverage + (offset.y() + y) * stride + offset.x(),
+            destination.width());
+    }
+}
+
 void Painter::draw_glyph(Font &font, Glyph &glyph, Vec2i position, Color color)
 {
     Recti dest(position - glyph.origin, glyph.bound.size());
-    blit_bitmap_colored(font.bitmap(), glyph.bound, dest, color);
+
+    if (font.scalable())
+    {
+        auto &cache = Font::glyph_cache();
+        blit_coverage(cache.coverage(), cache.width(), glyph.bound, dest.position(), color);
+    }
+    else
+    {
+        blit_bitmap_colored(font.bitmap(), glyph.bound, dest, color);
+    }
 }
 
 __flatten void Painter::draw_string(Font &font, const char *str, Vec2i position, Color color)
@@ -4,6 +4,7 @@
 #include <libgraphic/Font.h>
 #include <libgraphic/Icon.h>
 #include <libgraphic/vector/Path.h>
+#include <libgraphic/vector/Rasterizer.h>
 #include <libsystem/algebra/Trans2.h>
 
 #define STATESTACK_SIZE 32
@@ -20,6 +21,7 @@ private:
     RefPtr<Bitmap> _bitmap;
     int _state_stack_top = 0;
     PainterState _state_stack[STATESTACK_SIZE];
+    graphic::Rasterizer _rasterizer;
 
 public:
     Painter(RefPtr<Bitmap> bitmap);
@@ -62,6 +64,8 @@ public:
 
     void draw_triangle(Vec2i p0, Vec2i p1, Vec2i p2, Color color);
 
+    void fill_path(const graphic::Path &path, Vec2f pos, Trans2f transform, Color color, graphic::FillRule rule = graphic::FillRule::NONZERO);
+
     void draw_path(const graphic::Path &path, Vec2f pos, Trans2f transform, Color color);
 
     void draw_rounded_rectangle(Recti bound, int radius, int thickness, Color color);
@@ -83,6 +87,8 @@ private:
 
     Recti apply_transform(Recti rectangle);
 
+    void plot_pixel_premultiplied(Vec2i position, Color color);
+
     void blit_bitmap_fast(Bitmap &bitmap, Recti source, Recti destination);
 
     void blit_bitmap_scaled(Bitmap &bitmap, Recti source, Recti destination);
@@ -99,5 +105,7 @@ private:
 
     void blit_bitmap_colored(Bitmap &src, Recti src_rect, Recti dst_rect, Color color);
 
+    void blit_coverage(const uint8_t *coverage, int stride, Recti source, Vec2i position, Color color);
+
     void draw_circle_helper(Recti bound, Vec2i center, int radius, int thickness, Color color);
 };
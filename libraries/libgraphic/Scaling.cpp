@@ -0,0 +1,329 @@
+#include <stdlib.h>
+
+#include <libgraphic/Scaling.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+// Positions are 16.16 fixed point, weights are out of 256.
+struct Sample
+{
+    int first;
+    int second;
+
+    // How much of `second` goes in the result.
+    int weight;
+};
+
+// Where pixels are sampled, their centers land on the centers of the
+// destination pixels.
+static Sample sample_at(int index, int source_size, int destination_size, BitmapFiltering filtering)
+{
+    int step = ((int64_t)source_size << 16) / destination_size;
+    int position = index * step + step / 2;
+
+    if (filtering == BITMAP_FILTERING_NEAREST)
+    {
+        int nearest = MIN(position >> 16, source_size - 1);
+        return {nearest, nearest, 0};
+    }
+
+    position = MAX(position - 0x8000, 0);
+
+    int first = position >> 16;
+
+    if (first >= source_size - 1)
+    {
+        return {source_size - 1, source_size - 1, 0};
+    }
+
+    return {first, first + 1, (position >> 8) & 0xff};
+}
+
+struct Range
+{
+    int start;
+    int end;
+};
+
+// The source pixels under destination pixel `index` when shrinking.
+static Range range_at(int index, int source_size, int destination_size)
+{
+    int start = (int64_t)index * source_size / destination_size;
+    int end = (int64_t)(index + 1) * source_size / destination_size;
+
+    return {start, MAX(end, start + 1)};
+}
+
+#ifdef __SSE2__
+
+static __m128i load_two_pixels(Color first, Color second)
+{
+    uint32_t values[2];
+    memcpy(&values[0], &first, sizeof(Color));
+    memcpy(&values[1], &second, sizeof(Color));
+
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)values), _mm_setzero_si128());
+}
+
+// a + (b - a) * weight / 256 on 16 bits lanes, weights already spread on
+// the lanes of their pixel.
+static __m128i lerp_epi16(__m128i a, __m128i b, __m128i weight)
+{
+    __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(256), weight);
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a, inverse), _mm_mullo_epi16(b, weight));
+
+    return _mm_srli_epi16(sum, 8);
+}
+
+#endif
+
+static Color lerp_color(Color a, Color b, int weight)
+{
+    int inverse = 256 - weight;
+
+    return Color::from_byte(
+        (a.red() * inverse + b.red() * weight) >> 8,
+        (a.green() * inverse + b.green() * weight) >> 8,
+        (a.blue() * inverse + b.blue() * weight) >> 8,
+        (a.alpha() * inverse + b.alpha() * weight) >> 8);
+}
+
+static void scale_row(const Color *line, const Sample *columns, Color *output, int count)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    for (; x + 2 <= count; x += 2)
+    {
+        const Sample &left = columns[x];
+        const Sample &right = columns[x + 1];
+
+        __m128i a = load_two_pixels(line[left.first], line[right.first]);
+        __m128i b = load_two_pixels(line[left.second], line[right.second]);
+
+        __m128i weight = _mm_unpacklo_epi64(_mm_set1_epi16(left.weight), _mm_set1_epi16(right.weight));
+        __m128i result = lerp_epi16(a, b, weight);
+
+        _mm_storel_epi64((__m128i *)(output + x), _mm_packus_epi16(result, result));
+    }
+#endif
+
+    for (; x < count; x++)
+    {
+        output[x] = lerp_color(line[columns[x].first], line[columns[x].second], columns[x].weight);
+    }
+}
+
+static void lerp_rows(const Color *first, const Color *second, int weight, Color *output, int count)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i weights = _mm_set1_epi16(weight);
+
+    for (; x + 4 <= count; x += 4)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(first + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(second + x));
+
+        __m128i low = lerp_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), weights);
+        __m128i high = lerp_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), weights);
+
+        _mm_storeu_si128((__m128i *)(output + x), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; x < count; x++)
+    {
+        output[x] = lerp_color(first[x], second[x], weight);
+    }
+}
+
+static void scale_bilinear(const Color *pixels, int stride, Recti source, Recti destination, Recti clip, BitmapFiltering filtering, ScaledSpan &span)
+{
+    int count = clip.width();
+
+    Sample *columns = (Sample *)malloc(sizeof(Sample) * count);
+
+    for (int x = 0; x < count; x++)
+    {
+        columns[x] = sample_at(clip.x() - destination.x() + x, source.width(), destination.width(), filtering);
+    }
+
+    // Source rows already scaled along x, consecutive destination rows
+    // mostly sample the same two.
+    Color *buffer = (Color *)malloc(sizeof(Color) * count * 3);
+    Color *scaled[2] = {buffer, buffer + count};
+    int scaled_row[2] = {-1, -1};
+    Color *output = buffer + count * 2;
+
+    auto scaled_line = [&](int row, int keep) {
+        for (int i = 0; i < 2; i++)
+        {
+            if (scaled_row[i] == row)
+            {
+                return i;
+            }
+        }
+
+        int slot = keep == 0 ? 1 : 0;
+
+        scale_row(pixels + (source.y() + row) * stride + source.x(), columns, scaled[slot], count);
+        scaled_row[slot] = row;
+
+        return slot;
+    };
+
+    for (int y = clip.top(); y < clip.bottom(); y++)
+    {
+        Sample row = sample_at(y - destination.y(), source.height(), destination.height(), filtering);
+
+        int first = scaled_line(row.first, -1);
+
+        if (row.weight == 0)
+        {
+            span(y, clip.x(), scaled[first], count);
+            continue;
+        }
+
+        int second = scaled_line(row.second, first);
+
+        lerp_rows(scaled[first], scaled[second], row.weight, output, count);
+        span(y, clip.x(), output, count);
+    }
+
+    free(buffer);
+    free(columns);
+}
+
+static void scale_box(const Color *pixels, int stride, Recti source, Recti destination, Recti clip, ScaledSpan &span)
+{
+    int count = clip.width();
+
+    Range *columns = (Range *)malloc(sizeof(Range) * count);
+
+    for (int x = 0; x < count; x++)
+    {
+        columns[x] = range_at(clip.x() - destination.x() + x, source.width(), destination.width());
+    }
+
+    // Only the source columns under the clip are summed.
+    int first_column = columns[0].start;
+    int column_count = columns[count - 1].end - first_column;
+
+    uint32_t *sums = (uint32_t *)malloc(sizeof(uint32_t) * 4 * column_count);
+    Color *output = (Color *)malloc(sizeof(Color) * count);
+
+    for (int y = clip.top(); y < clip.bottom(); y++)
+    {
+        Range rows = range_at(y - destination.y(), source.height(), destination.height());
+
+        memset(sums, 0, sizeof(uint32_t) * 4 * column_count);
+
+        for (int row = rows.start; row < rows.end; row++)
+        {
+            const Color *line = pixels + (source.y() + row) * stride + source.x() + first_column;
+
+            int i = 0;
+
+#ifdef __SSE2__
+            __m128i zero = _mm_setzero_si128();
+
+            for (; i + 4 <= column_count; i += 4)
+            {
+                __m128i colors = _mm_loadu_si128((const __m128i *)(line + i));
+                __m128i low = _mm_unpacklo_epi8(colors, zero);
+                __m128i high = _mm_unpackhi_epi8(colors, zero);
+
+                __m128i *sum = (__m128i *)(sums + i * 4);
+
+                _mm_storeu_si128(sum + 0, _mm_add_epi32(_mm_loadu_si128(sum + 0), _mm_unpacklo_epi16(low, zero)));
+                _mm_storeu_si128(sum + 1, _mm_add_epi32(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi16(low, zero)));
+                _mm_storeu_si128(sum + 2, _mm_add_epi32(_mm_loadu_si128(sum + 2), _mm_unpacklo_epi16(high, zero)));
+                _mm_storeu_si128(sum + 3, _mm_add_epi32(_mm_loadu_si128(sum + 3), _mm_unpackhi_epi16(high, zero)));
+            }
+#endif
+
+            for (; i < column_count; i++)
+            {
+                sums[i * 4 + 0] += line[i].red();
+                sums[i * 4 + 1] += line[i].green();
+                sums[i * 4 + 2] += line[i].blue();
+                sums[i * 4 + 3] += line[i].alpha();
+            }
+        }
+
+        float height_inverse = 1.0f / (rows.end - rows.start);
+
+        for (int x = 0; x < count; x++)
+        {
+            float inverse = height_inverse / (columns[x].end - columns[x].start);
+
+#ifdef __SSE2__
+            __m128i total = _mm_setzero_si128();
+
+            for (int column = columns[x].start; column < columns[x].end; column++)
+            {
+                total = _mm_add_epi32(total, _mm_loadu_si128((const __m128i *)(sums + (column - first_column) * 4)));
+            }
+
+            __m128i average = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(total), _mm_set1_ps(inverse)));
+            average = _mm_packs_epi32(average, average);
+            average = _mm_packus_epi16(average, average);
+
+            uint32_t value = _mm_cvtsi128_si32(average);
+            memcpy((void *)&output[x], &value, sizeof(Color));
+#else
+            uint32_t total[4] = {};
+
+            for (int column = columns[x].start; column < columns[x].end; column++)
+            {
+                uint32_t *sum = sums + (column - first_column) * 4;
+
+                total[0] += sum[0];
+                total[1] += sum[1];
+                total[2] += sum[2];
+                total[3] += sum[3];
+            }
+
+            output[x] = Color::from_byte(
+                total[0] * inverse + 0.5f,
+                total[1] * inverse + 0.5f,
+                total[2] * inverse + 0.5f,
+                total[3] * inverse + 0.5f);
+#endif
+        }
+
+        span(y, clip.x(), output, count);
+    }
+
+    free(output);
+    free(sums);
+    free(columns);
+}
+
+void scale(const Color *pixels, int stride, Recti source, Recti destination, Recti clip, BitmapFiltering filtering, ScaledSpan span)
+{
+    clip = clip.clipped_with(destination);
+
+    if (clip.is_empty() || source.is_empty())
+    {
+        return;
+    }
+
+    if (filtering == BITMAP_FILTERING_LINEAR &&
+        source.width() >= destination.width() * 2 &&
+        source.height() >= destination.height() * 2)
+    {
+        scale_box(pixels, stride, source, destination, clip, span);
+    }
+    else
+    {
+        scale_bilinear(pixels, stride, source, destination, clip, filtering, span);
+    }
+}
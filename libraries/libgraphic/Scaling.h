@@ -0,0 +1,17 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+#include <libsystem/algebra/Rect.h>
+#include <libutils/Callback.h>
+
+// `count` scaled pixels of row `y` starting at column `x`.
+using ScaledSpan = Callback<void(int y, int x, const Color *pixels, int count)>;
+
+// Scale `source`, of an image `stride` pixels wide, so it covers
+// `destination` and report the rows of the part of it inside `clip`.
+//
+// Positions and weights along x are computed once for the whole blit and
+// rows are produced in order. Shrinking by two or more averages every
+// source pixel under a destination one, anything else is a bilinear
+// interpolation, or the nearest pixel when asked for.
+void scale(const Color *pixels, int stride, Recti source, Recti destination, Recti clip, BitmapFiltering filtering, ScaledSpan span);
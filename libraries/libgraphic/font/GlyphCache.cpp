@@ -0,0 +1,215 @@
+#include <stdlib.h>
+
+#include <libgraphic/font/GlyphCache.h>
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/Math.h>
+
+namespace graphic
+{
+
+// Heights of shelves are rounded up so glyphs of close sizes share them.
+#define SHELF_HEIGHT_ALIGN (4)
+
+GlyphCache::GlyphCache(int width, int height)
+    : _width(width),
+      _height(height)
+{
+    _coverage = (uint8_t *)calloc(width * height, sizeof(uint8_t));
+}
+
+GlyphCache::~GlyphCache()
+{
+    free(_coverage);
+}
+
+int GlyphCache::allocate(int width, int height, Vec2i &position)
+{
+    height = __align_up(height, SHELF_HEIGHT_ALIGN);
+
+    int found = -1;
+
+    for (size_t i = 0; i < _shelves.count(); i++)
+    {
+        if (_shelves[i].height == height && _shelves[i].used + width <= _width)
+        {
+            found = i;
+            break;
+        }
+    }
+
+    if (found < 0 && _bottom + height <= _height)
+    {
+        _shelves.push_back({_bottom, height, 0, 0});
+        _bottom += height;
+        found = _shelves.count() - 1;
+    }
+
+    if (found < 0)
+    {
+        for (size_t i = 0; i < _shelves.count(); i++)
+        {
+            if (_shelves[i].height >= height &&
+                (found < 0 || _shelves[i].last_used < _shelves[found].last_used))
+            {
+                found = i;
+            }
+        }
+
+        if (found >= 0)
+        {
+            evict(found);
+        }
+    }
+
+    // Only shelves too short for this glyph are left, start over.
+    if (found < 0)
+    {
+        flush();
+
+        _shelves.push_back({0, height, 0, 0});
+        _bottom = height;
+        found = 0;
+    }
+
+    Shelf &shelf = _shelves[found];
+
+    position = Vec2i(shelf.used, shelf.y);
+    shelf.used += width;
+    shelf.last_used = ++_clock;
+
+    return found;
+}
+
+void GlyphCache::evict(int shelf)
+{
+    Vector<GlyphKey> evicted;
+
+    _entries.foreach([&](auto &key, auto &entry) {
+        if (entry.shelf == shelf)
+        {
+            evicted.push_back(key);
+        }
+
+        return Iteration::CONTINUE;
+    });
+
+    for (size_t i = 0; i < evicted.count(); i++)
+    {
+        _entries.remove_key(evicted[i]);
+    }
+
+    _evictions += evicted.count();
+    _shelves[shelf].used = 0;
+}
+
+void GlyphCache::flush()
+{
+    Vector<GlyphKey> evicted;
+
+    _entries.foreach([&](auto &key, auto &entry) {
+        if (entry.shelf >= 0)
+        {
+            evicted.push_back(key);
+        }
+
+        return Iteration::CONTINUE;
+    });
+
+    for (size_t i = 0; i < evicted.count(); i++)
+    {
+        _entries.remove_key(evicted[i]);
+    }
+
+    _evictions += evicted.count();
+    _shelves.clear();
+    _bottom = 0;
+}
+
+GlyphCache::Entry GlyphCache::rasterize(const TrueType &face, int size, int index)
+{
+    float scale = size / (float)face.units_per_em();
+
+    Entry entry{};
+    entry.glyph.advance = (int)(face.advance(index) * scale + 0.5f);
+    entry.shelf = -1;
+
+    // In font units, y going up.
+    Recti outline = face.glyph_bound(index);
+
+    if (outline.is_empty())
+    {
+        return entry;
+    }
+
+    int left = floorf(outline.left() * scale);
+    int right = ceilf(outline.right() * scale);
+    int top = ceilf(outline.bottom() * scale);
+    int bottom = floorf(outline.top() * scale);
+
+    int width = right - left;
+    int height = top - bottom;
+
+    if (width > _width || height > _height)
+    {
+        logger_warn("Glyph %d at size %d doesn't fit in the cache", index, size);
+        return entry;
+    }
+
+    Vec2i position;
+    entry.shelf = allocate(width, height, position);
+
+    // The room may have been used by an evicted glyph.
+    for (int y = 0; y < height; y++)
+    {
+        memset(_coverage + (position.y() + y) * _width + position.x(), 0, width);
+    }
+
+    Recti bound{position, {width, height}};
+
+    _rasterizer.fill(
+        face.glyph_path(index),
+        Vec2f(position.x() - left, position.y() + top),
+        Trans2f::scale(Vec2f(scale, -scale)),
+        bound,
+        FillRule::NONZERO,
+        [&](int y, int x, const uint8_t *coverage, int count) {
+            memcpy(_coverage + y * _width + x, coverage, count);
+        });
+
+    entry.glyph.bound = bound;
+    entry.glyph.origin = Vec2i(-left, top);
+
+    return entry;
+}
+
+Glyph &GlyphCache::lookup(const TrueType &face, int size, int index)
+{
+    GlyphKey key{&face, size, index};
+
+    Entry *entry = _entries.find(key);
+
+    if (entry)
+    {
+        _hits++;
+
+        if (entry->shelf >= 0)
+        {
+            _shelves[entry->shelf].last_used = ++_clock;
+        }
+
+        return entry->glyph;
+    }
+
+    _misses++;
+
+    // Rasterizing may evict entries, insert afterward.
+    Entry rasterized = rasterize(face, size, index);
+
+    Entry &slot = _entries[key];
+    slot = rasterized;
+
+    return slot.glyph;
+}
+
+} // namespace graphic
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <libgraphic/Font.h>
+#include <libgraphic/font/TrueType.h>
+#include <libgraphic/vector/Rasterizer.h>
+#include <libutils/HashMap.h>
+
+#define GLYPH_CACHE_WIDTH (512)
+#define GLYPH_CACHE_HEIGHT (512)
+
+namespace graphic
+{
+
+struct GlyphKey
+{
+    const TrueType *face;
+    int size;
+    int index;
+
+    bool operator==(const GlyphKey &other) const
+    {
+        return face == other.face && size == other.size && index == other.index;
+    }
+};
+
+// Glyphs of TrueType fonts rasterized on demand, whatever their size, into
+// one coverage atlas shared by every font of the process.
+//
+// The atlas is split in shelves, rows of glyphs of about the same height.
+// Using a glyph marks its shelf as recently used, once the atlas is full
+// the least recently used shelf tall enough is emptied for the new glyph.
+class GlyphCache
+{
+private:
+    struct Shelf
+    {
+        int y;
+        int height;
+        int used;
+        uint32_t last_used;
+    };
+
+    struct Entry
+    {
+        Glyph glyph;
+
+        // -1 for glyphs without outline, they take no room.
+        int shelf;
+    };
+
+    int _width;
+    int _height;
+    uint8_t *_coverage;
+
+    Vector<Shelf> _shelves{};
+    int _bottom = 0;
+
+    HashMap<GlyphKey, Entry> _entries{};
+    uint32_t _clock = 0;
+
+    Rasterizer _rasterizer{};
+
+    size_t _hits = 0;
+    size_t _misses = 0;
+    size_t _evictions = 0;
+
+    int allocate(int width, int height, Vec2i &position);
+
+    void evict(int shelf);
+
+    void flush();
+
+    Entry rasterize(const TrueType &face, int size, int index);
+
+public:
+    __noncopyable(GlyphCache);
+
+    GlyphCache(int width, int height);
+
+    ~GlyphCache();
+
+    int width() const { return _width; }
+
+    int height() const { return _height; }
+
+    // One byte of coverage per pixel, rows are width() bytes apart.
+    const uint8_t *coverage() const { return _coverage; }
+
+    size_t count() const { return _entries.count(); }
+
+    size_t hits() const { return _hits; }
+
+    size_t misses() const { return _misses; }
+
+    size_t evictions() const { return _evictions; }
+
+    // Glyph `index` of `face` at `size` pixels per em, its bound is where
+    // it is in the atlas. The reference and the atlas content only stay
+    // valid until the next lookup.
+    Glyph &lookup(const TrueType &face, int size, int index);
+};
+
+} // namespace graphic
+
+template <>
+inline uint32_t hash<graphic::GlyphKey>(const graphic::GlyphKey &key)
+{
+    return hash(&key, sizeof(key));
+}
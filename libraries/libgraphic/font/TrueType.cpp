@@ -0,0 +1,639 @@
+#include <abi/Handle.h>
+
+#include <libgraphic/font/TrueType.h>
+#include <libsystem/Logger.h>
+#include <libsystem/io/File.h>
+
+namespace graphic
+{
+
+// Flags of the points of a simple glyph.
+#define POINT_ON_CURVE (1 << 0)
+#define POINT_X_SHORT (1 << 1)
+#define POINT_Y_SHORT (1 << 2)
+#define POINT_REPEAT (1 << 3)
+#define POINT_X_SAME_OR_POSITIVE (1 << 4)
+#define POINT_Y_SAME_OR_POSITIVE (1 << 5)
+
+// Flags of the components of a composite glyph.
+#define COMPONENT_ARGS_ARE_WORDS (1 << 0)
+#define COMPONENT_ARGS_ARE_XY (1 << 1)
+#define COMPONENT_HAVE_SCALE (1 << 3)
+#define COMPONENT_MORE (1 << 5)
+#define COMPONENT_HAVE_XY_SCALE (1 << 6)
+#define COMPONENT_HAVE_2X2 (1 << 7)
+
+// Composite glyphs are made of other glyphs, which may be composite too.
+#define MAX_COMPOSITE_DEPTH (8)
+
+static constexpr uint32_t tag(const char *name)
+{
+    return (name[0] << 24) | (name[1] << 16) | (name[2] << 8) | name[3];
+}
+
+// Out of bounds reads give 0, a truncated table yields garbage glyphs
+// instead of reading past the file.
+uint8_t TrueType::read_u8(uint32_t offset) const
+{
+    if (offset >= _data.count())
+    {
+        return 0;
+    }
+
+    return _data.raw_storage()[offset];
+}
+
+uint16_t TrueType::read_u16(uint32_t offset) const
+{
+    return (read_u8(offset) << 8) | read_u8(offset + 1);
+}
+
+int16_t TrueType::read_i16(uint32_t offset) const
+{
+    return (int16_t)read_u16(offset);
+}
+
+uint32_t TrueType::read_u32(uint32_t offset) const
+{
+    return ((uint32_t)read_u16(offset) << 16) | read_u16(offset + 2);
+}
+
+ResultOr<RefPtr<TrueType>> TrueType::load(const char *path)
+{
+    uint8_t *buffer = nullptr;
+    size_t size = 0;
+
+    Result result = file_read_all(path, (void **)&buffer, &size);
+
+    if (result != SUCCESS)
+    {
+        logger_error("Failed to load font from %s: %s", path, handle_error_string(result));
+        return result;
+    }
+
+    return parse(Vector(ADOPT, buffer, size));
+}
+
+ResultOr<RefPtr<TrueType>> TrueType::parse(Vector<uint8_t> data)
+{
+    auto font = make<TrueType>(move(data));
+
+    uint32_t version = font->read_u32(0);
+
+    if (version != 0x00010000 && version != tag("true"))
+    {
+        return ERR_BAD_FONT_FILE_FORMAT;
+    }
+
+    uint32_t head = 0;
+    uint32_t hhea = 0;
+    uint32_t maxp = 0;
+    uint32_t cmap = 0;
+
+    int table_count = font->read_u16(4);
+
+    for (int i = 0; i < table_count; i++)
+    {
+        uint32_t record = 12 + i * 16;
+
+        uint32_t offset = font->read_u32(record + 8);
+        uint32_t length = font->read_u32(record + 12);
+
+        if (offset > font->_data.count() || length > font->_data.count() - offset)
+        {
+            return ERR_BAD_FONT_FILE_FORMAT;
+        }
+
+        switch (font->read_u32(record))
+        {
+        case tag("head"):
+            head = offset;
+            break;
+
+        case tag("hhea"):
+            hhea = offset;
+            break;
+
+        case tag("maxp"):
+            maxp = offset;
+            break;
+
+        case tag("cmap"):
+            cmap = offset;
+            break;
+
+        case tag("hmtx"):
+            font->_hmtx = offset;
+            break;
+
+        case tag("loca"):
+            font->_loca = offset;
+            break;
+
+        case tag("glyf"):
+            font->_glyf = offset;
+            font->_glyf_size = length;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (!head || !hhea || !maxp || !cmap || !font->_hmtx || !font->_loca || !font->_glyf)
+    {
+        logger_error("Missing tables, only fonts with TrueType outlines are supported");
+        return ERR_BAD_FONT_FILE_FORMAT;
+    }
+
+    font->_units_per_em = font->read_u16(head + 18);
+    font->_long_loca = font->read_i16(head + 50) != 0;
+
+    font->_ascent = font->read_i16(hhea + 4);
+    font->_descent = font->read_i16(hhea + 6);
+    font->_line_gap = font->read_i16(hhea + 8);
+    font->_metrics_count = font->read_u16(hhea + 34);
+
+    font->_glyph_count = font->read_u16(maxp + 4);
+
+    if (font->_units_per_em == 0 || font->_metrics_count == 0)
+    {
+        return ERR_BAD_FONT_FILE_FORMAT;
+    }
+
+    // Prefer the full unicode mapping, then the basic multilingual plane.
+    int subtable_count = font->read_u16(cmap + 2);
+
+    for (int i = 0; i < subtable_count; i++)
+    {
+        uint32_t record = cmap + 4 + i * 8;
+
+        uint16_t platform = font->read_u16(record);
+        uint16_t encoding = font->read_u16(record + 2);
+        uint32_t subtable = cmap + font->read_u32(record + 4);
+
+        bool is_unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+
+        if (!is_unicode)
+        {
+            continue;
+        }
+
+        uint16_t format = font->read_u16(subtable);
+
+        if (format == 12 || (format == 4 && font->_cmap_format != 12))
+        {
+            font->_cmap = subtable;
+            font->_cmap_format = format;
+        }
+    }
+
+    if (font->_cmap_format == 0)
+    {
+        logger_error("No unicode character map");
+        return ERR_BAD_FONT_FILE_FORMAT;
+    }
+
+    return font;
+}
+
+int TrueType::glyph_index_format4(uint32_t subtable, Codepoint codepoint) const
+{
+    if (codepoint > 0xffff)
+    {
+        return 0;
+    }
+
+    int segment_count = read_u16(subtable + 6) / 2;
+
+    uint32_t ends = subtable + 14;
+    uint32_t starts = ends + segment_count * 2 + 2;
+    uint32_t deltas = starts + segment_count * 2;
+    uint32_t ranges = deltas + segment_count * 2;
+
+    // First segment ending after the codepoint.
+    int low = 0;
+    int high = segment_count;
+
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+
+        if (read_u16(ends + middle * 2) < codepoint)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low == segment_count)
+    {
+        return 0;
+    }
+
+    uint16_t start = read_u16(starts + low * 2);
+
+    if (codepoint < start)
+    {
+        return 0;
+    }
+
+    uint16_t delta = read_u16(deltas + low * 2);
+    uint16_t range = read_u16(ranges + low * 2);
+
+    if (range == 0)
+    {
+        return (codepoint + delta) & 0xffff;
+    }
+
+    // The offset is relative to where it's stored.
+    uint16_t glyph = read_u16(ranges + low * 2 + range + (codepoint - start) * 2);
+
+    if (glyph == 0)
+    {
+        return 0;
+    }
+
+    return (glyph + delta) & 0xffff;
+}
+
+int TrueType::glyph_index_format12(uint32_t subtable, Codepoint codepoint) const
+{
+    uint32_t group_count = read_u32(subtable + 12);
+    uint32_t groups = subtable + 16;
+
+    uint32_t low = 0;
+    uint32_t high = group_count;
+
+    while (low < high)
+    {
+        uint32_t middle = (low + high) / 2;
+        uint32_t group = groups + middle * 12;
+
+        if (codepoint < read_u32(group))
+        {
+            high = middle;
+        }
+        else if (codepoint > read_u32(group + 4))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            return read_u32(group + 8) + (codepoint - read_u32(group));
+        }
+    }
+
+    return 0;
+}
+
+int TrueType::glyph_index(Codepoint codepoint) const
+{
+    int glyph;
+
+    if (_cmap_format == 12)
+    {
+        glyph = glyph_index_format12(_cmap, codepoint);
+    }
+    else
+    {
+        glyph = glyph_index_format4(_cmap, codepoint);
+    }
+
+    if (glyph < 0 || glyph >= _glyph_count)
+    {
+        return 0;
+    }
+
+    return glyph;
+}
+
+int TrueType::advance(int glyph) const
+{
+    // Monospaced fonts only store the advance of the first glyphs, the
+    // last one is repeated for the others.
+    if (glyph >= _metrics_count)
+    {
+        glyph = _metrics_count - 1;
+    }
+
+    return read_u16(_hmtx + glyph * 4);
+}
+
+bool TrueType::glyph_location(int glyph, uint32_t &offset, uint32_t &size) const
+{
+    if (glyph < 0 || glyph >= _glyph_count)
+    {
+        return false;
+    }
+
+    uint32_t start;
+    uint32_t end;
+
+    if (_long_loca)
+    {
+        start = read_u32(_loca + glyph * 4);
+        end = read_u32(_loca + glyph * 4 + 4);
+    }
+    else
+    {
+        start = read_u16(_loca + glyph * 2) * 2;
+        end = read_u16(_loca + glyph * 2 + 2) * 2;
+    }
+
+    // Glyphs without outline have no data.
+    if (start >= end || end > _glyf_size)
+    {
+        return false;
+    }
+
+    offset = _glyf + start;
+    size = end - start;
+
+    return true;
+}
+
+Recti TrueType::glyph_bound(int glyph) const
+{
+    uint32_t offset;
+    uint32_t size;
+
+    if (!glyph_location(glyph, offset, size))
+    {
+        return {};
+    }
+
+    int x_min = read_i16(offset + 2);
+    int y_min = read_i16(offset + 4);
+    int x_max = read_i16(offset + 6);
+    int y_max = read_i16(offset + 8);
+
+    return {x_min, y_min, x_max - x_min, y_max - y_min};
+}
+
+void TrueType::append_simple_glyph(Path &path, uint32_t offset, uint32_t end, int contours, Trans2f transform) const
+{
+    uint32_t end_points = offset + 10;
+    int point_count = read_u16(end_points + (contours - 1) * 2) + 1;
+
+    uint32_t instructions = end_points + contours * 2;
+    uint32_t cursor = instructions + 2 + read_u16(instructions);
+
+    Vector<uint8_t> flags(point_count);
+
+    while ((int)flags.count() < point_count && cursor < end)
+    {
+        uint8_t flag = read_u8(cursor++);
+        flags.push_back(flag);
+
+        if (flag & POINT_REPEAT)
+        {
+            int repeat = read_u8(cursor++);
+
+            for (int i = 0; i < repeat && (int)flags.count() < point_count; i++)
+            {
+                flags.push_back(flag);
+            }
+        }
+    }
+
+    if ((int)flags.count() < point_count)
+    {
+        return;
+    }
+
+    // Coordinates are deltas from the previous point, all the x then all
+    // the y.
+    Vector<Vec2f> points(point_count);
+
+    int x = 0;
+
+    for (int i = 0; i < point_count; i++)
+    {
+        if (flags[i] & POINT_X_SHORT)
+        {
+            int delta = read_u8(cursor++);
+            x += (flags[i] & POINT_X_SAME_OR_POSITIVE) ? delta : -delta;
+        }
+        else if (!(flags[i] & POINT_X_SAME_OR_POSITIVE))
+        {
+            x += read_i16(cursor);
+            cursor += 2;
+        }
+
+        points.push_back(Vec2f(x, 0));
+    }
+
+    int y = 0;
+
+    for (int i = 0; i < point_count; i++)
+    {
+        if (flags[i] & POINT_Y_SHORT)
+        {
+            int delta = read_u8(cursor++);
+            y += (flags[i] & POINT_Y_SAME_OR_POSITIVE) ? delta : -delta;
+        }
+        else if (!(flags[i] & POINT_Y_SAME_OR_POSITIVE))
+        {
+            y += read_i16(cursor);
+            cursor += 2;
+        }
+
+        points[i] = transform.apply(Vec2f(points[i].x(), y));
+    }
+
+    if (cursor > end)
+    {
+        return;
+    }
+
+    int start = 0;
+
+    for (int contour = 0; contour < contours; contour++)
+    {
+        int last = read_u16(end_points + contour * 2);
+
+        if (last < start || last >= point_count)
+        {
+            return;
+        }
+
+        int count = last - start + 1;
+
+        auto on_curve = [&](int index) { return flags[start + index] & POINT_ON_CURVE; };
+        auto point = [&](int index) { return points[start + index]; };
+
+        // Two off curve points in a row have an implied on curve point
+        // between them, which also gives a place to start from when the
+        // contour has no point on the curve at its ends.
+        Vec2f first;
+        int begin = 0;
+        int stop = count;
+
+        if (on_curve(0))
+        {
+            first = point(0);
+            begin = 1;
+        }
+        else if (on_curve(count - 1))
+        {
+            first = point(count - 1);
+            stop = count - 1;
+        }
+        else
+        {
+            first = (point(0) + point(count - 1)) / 2;
+        }
+
+        path.move_to(first);
+
+        bool has_control = false;
+        Vec2f control;
+
+        for (int i = begin; i < stop; i++)
+        {
+            if (on_curve(i))
+            {
+                if (has_control)
+                {
+                    path.quad_bezier_to(control, point(i));
+                    has_control = false;
+                }
+                else
+                {
+                    path.line_to(point(i));
+                }
+            }
+            else
+            {
+                if (has_control)
+                {
+                    path.quad_bezier_to(control, (control + point(i)) / 2);
+                }
+
+                control = point(i);
+                has_control = true;
+            }
+        }
+
+        if (has_control)
+        {
+            path.quad_bezier_to(control, first);
+        }
+        else
+        {
+            path.line_to(first);
+        }
+
+        path.close_subpath();
+
+        start = last + 1;
+    }
+}
+
+static float read_f2dot14(int16_t value)
+{
+    return value / 16384.0f;
+}
+
+void TrueType::append_composite_glyph(Path &path, uint32_t offset, uint32_t end, Trans2f transform, int depth) const
+{
+    uint32_t cursor = offset + 10;
+
+    while (cursor + 4 <= end)
+    {
+        uint16_t flags = read_u16(cursor);
+        uint16_t glyph = read_u16(cursor + 2);
+        cursor += 4;
+
+        float dx = 0;
+        float dy = 0;
+
+        if (flags & COMPONENT_ARGS_ARE_WORDS)
+        {
+            dx = read_i16(cursor);
+            dy = read_i16(cursor + 2);
+            cursor += 4;
+        }
+        else
+        {
+            dx = (int8_t)read_u8(cursor);
+            dy = (int8_t)read_u8(cursor + 1);
+            cursor += 2;
+        }
+
+        // Components placed by matching points are rare, they are drawn
+        // without offset.
+        if (!(flags & COMPONENT_ARGS_ARE_XY))
+        {
+            dx = 0;
+            dy = 0;
+        }
+
+        float a = 1;
+        float b = 0;
+        float c = 0;
+        float d = 1;
+
+        if (flags & COMPONENT_HAVE_SCALE)
+        {
+            a = d = read_f2dot14(read_i16(cursor));
+            cursor += 2;
+        }
+        else if (flags & COMPONENT_HAVE_XY_SCALE)
+        {
+            a = read_f2dot14(read_i16(cursor));
+            d = read_f2dot14(read_i16(cursor + 2));
+            cursor += 4;
+        }
+        else if (flags & COMPONENT_HAVE_2X2)
+        {
+            a = read_f2dot14(read_i16(cursor));
+            b = read_f2dot14(read_i16(cursor + 2));
+            c = read_f2dot14(read_i16(cursor + 4));
+            d = read_f2dot14(read_i16(cursor + 6));
+            cursor += 8;
+        }
+
+        append_glyph(path, glyph, Trans2f{a, b, c, d, dx, dy} * transform, depth + 1);
+
+        if (!(flags & COMPONENT_MORE))
+        {
+            break;
+        }
+    }
+}
+
+void TrueType::append_glyph(Path &path, int glyph, Trans2f transform, int depth) const
+{
+    uint32_t offset;
+    uint32_t size;
+
+    if (depth > MAX_COMPOSITE_DEPTH || !glyph_location(glyph, offset, size))
+    {
+        return;
+    }
+
+    int contours = read_i16(offset);
+
+    if (contours > 0)
+    {
+        append_simple_glyph(path, offset, offset + size, contours, transform);
+    }
+    else if (contours < 0)
+    {
+        append_composite_glyph(path, offset, offset + size, transform, depth);
+    }
+}
+
+Path TrueType::glyph_path(int glyph) const
+{
+    Path path;
+    append_glyph(path, glyph, Trans2f::identity(), 0);
+    return path;
+}
+
+} // namespace graphic
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <libgraphic/vector/Path.h>
+#include <libsystem/algebra/Trans2.h>
+#include <libsystem/unicode/Codepoint.h>
+#include <libutils/RefCounted.h>
+#include <libutils/ResultOr.h>
+#include <libutils/Vector.h>
+
+namespace graphic
+{
+
+// The outlines and metrics of a TrueType font, read straight from the
+// tables of the file kept in memory: cmap maps codepoints to glyphs, loca
+// and glyf hold their outlines and hmtx their advances. Everything is in
+// font units, up is positive y.
+class TrueType : public RefCounted<TrueType>
+{
+private:
+    Vector<uint8_t> _data;
+
+    // The cmap subtable in use, format 4 or 12.
+    uint32_t _cmap = 0;
+    uint16_t _cmap_format = 0;
+
+    uint32_t _glyf = 0;
+    uint32_t _glyf_size = 0;
+    uint32_t _loca = 0;
+    uint32_t _hmtx = 0;
+
+    bool _long_loca = false;
+    int _glyph_count = 0;
+    int _metrics_count = 0;
+
+    int _units_per_em = 0;
+    int _ascent = 0;
+    int _descent = 0;
+    int _line_gap = 0;
+
+    uint8_t read_u8(uint32_t offset) const;
+    uint16_t read_u16(uint32_t offset) const;
+    int16_t read_i16(uint32_t offset) const;
+    uint32_t read_u32(uint32_t offset) const;
+
+    bool glyph_location(int glyph, uint32_t &offset, uint32_t &size) const;
+
+    int glyph_index_format4(uint32_t subtable, Codepoint codepoint) const;
+    int glyph_index_format12(uint32_t subtable, Codepoint codepoint) const;
+
+    void append_simple_glyph(Path &path, uint32_t offset, uint32_t end, int contours, Trans2f transform) const;
+    void append_composite_glyph(Path &path, uint32_t offset, uint32_t end, Trans2f transform, int depth) const;
+    void append_glyph(Path &path, int glyph, Trans2f transform, int depth) const;
+
+public:
+    static ResultOr<RefPtr<TrueType>> load(const char *path);
+
+    static ResultOr<RefPtr<TrueType>> parse(Vector<uint8_t> data);
+
+    TrueType(Vector<uint8_t> data) : _data(move(data)) {}
+
+    int units_per_em() const { return _units_per_em; }
+
+    int ascent() const { return _ascent; }
+
+    // Below the baseline, so usually negative.
+    int descent() const { return _descent; }
+
+    int line_gap() const { return _line_gap; }
+
+    int glyph_count() const { return _glyph_count; }
+
+    // 0 is the "missing glyph" of the font.
+    int glyph_index(Codepoint codepoint) const;
+
+    int advance(int glyph) const;
+
+    // Bounding box of the outline, empty for glyphs without one like the
+    // space.
+    Recti glyph_bound(int glyph) const;
+
+    Path glyph_path(int glyph) const;
+};
+
+} // namespace graphic
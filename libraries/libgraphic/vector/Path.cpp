@@ -3,15 +3,14 @@
 
 namespace graphic
 {
-static constexpr auto WHITESPACE = "\n\r\t ";
 static constexpr auto OPERATIONS = "MmZzLlHhVvCcSsQqTtAa";
 
-static void whitespace(Scanner &scan)
+static void whitespace(SpanScanner &scan)
 {
-    scan.eat(WHITESPACE);
+    scan.eat_whitespace();
 }
 
-static void whitespace_or_comma(Scanner &scan)
+static void whitespace_or_comma(SpanScanner &scan)
 {
     whitespace(scan);
 
@@ -21,7 +20,7 @@ static void whitespace_or_comma(Scanner &scan)
     }
 }
 
-static Vec2f coordinate(Scanner &scan)
+static Vec2f coordinate(SpanScanner &scan)
 {
     auto x = scan_float(scan);
     whitespace_or_comma(scan);
@@ -31,7 +30,7 @@ static Vec2f coordinate(Scanner &scan)
     return Vec2f{(float)x, (float)y};
 }
 
-static int arcflags(Scanner &scan)
+static int arcflags(SpanScanner &scan)
 {
     int flags = 0;
 
@@ -55,7 +54,7 @@ static int arcflags(Scanner &scan)
     return flags;
 }
 
-static void operation(Scanner &scan, Path &path, char operation)
+static void operation(SpanScanner &scan, Path &path, char operation)
 {
     switch (operation)
     {
@@ -229,7 +228,7 @@ static void operation(Scanner &scan, Path &path, char operation)
     }
 }
 
-Path Path::parse(Scanner &scan)
+Path Path::parse(SpanScanner &scan)
 {
     Path path;
 
@@ -3,7 +3,7 @@
 #include <libgraphic/vector/Arc.h>
 #include <libgraphic/vector/SubPath.h>
 #include <libsystem/algebra/Rect.h>
-#include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
 #include <libutils/Vector.h>
 
 namespace graphic
@@ -38,11 +38,11 @@ private:
 public:
     static Path parse(const char *str)
     {
-        StringScanner scan{str, strlen(str)};
+        SpanScanner scan{str, strlen(str)};
         return parse(scan);
     }
 
-    static Path parse(Scanner &scan);
+    static Path parse(SpanScanner &scan);
 
     const SubPath &subpath(size_t index) const
     {
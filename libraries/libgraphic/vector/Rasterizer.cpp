@@ -1,27 +1,46 @@
 #include <libgraphic/Painter.h>
 #include <libgraphic/vector/Rasterizer.h>
+#include <libsystem/math/MinMax.h>
 
 namespace graphic
 {
 
 void Rasterizer::tessellate_cubic_bezier(BezierCurve &curve, int depth)
 {
-    if (depth > MAX_DEPTH)
-    {
-        return;
-    }
-
     auto a = curve.start;
     auto b = curve.first_control_point;
     auto c = curve.second_contol_point;
     auto d = curve.end;
 
+    if (depth > MAX_DEPTH)
+    {
+        _points.push_back(d);
+        return;
+    }
+
     auto delta1 = d - a;
-    float delta2 = abs((b.x() - d.x()) * delta1.y() - (b.y() - d.y()) * delta1.x());
-    float delta3 = abs((c.x() - d.x()) * delta1.y() - (c.y() - d.y()) * delta1.x());
+    float length = delta1.x() * delta1.x() + delta1.y() * delta1.y();
+
+    bool flat;
+
+    if (length == 0)
+    {
+        // Both ends at the same place, like the segment closing a subpath
+        // which already ends where it started, only the control points
+        // tell whether there is a loop.
+        auto ab = b - a;
+        auto ac = c - a;
+        flat = ab.x() * ab.x() + ab.y() * ab.y() + ac.x() * ac.x() + ac.y() * ac.y() < TOLERANCE;
+    }
+    else
+    {
+        float delta2 = abs((b.x() - d.x()) * delta1.y() - (b.y() - d.y()) * delta1.x());
+        float delta3 = abs((c.x() - d.x()) * delta1.y() - (c.y() - d.y()) * delta1.x());
+
+        flat = (delta2 + delta3) * (delta2 + delta3) < TOLERANCE * length;
+    }
 
-    if ((delta2 + delta3) * (delta2 + delta3) <
-        TOLERANCE * (delta1.x() * delta1.x() + delta1.y() * delta1.y()))
+    if (flat)
     {
         _points.push_back(d);
         return;
@@ -43,39 +62,288 @@ void Rasterizer::tessellate_cubic_bezier(BezierCurve &curve, int depth)
     tessellate_cubic_bezier(curve_b, depth + 1);
 }
 
-// void Rasterizer::fill(Path &path, Vec2f position, Trans2f transform, Color color)
-// {
-// }
+void Rasterizer::flatten(const SubPath &subpath, Vec2f position, Trans2f transform)
+{
+    _points.clear();
+    _points.push_back(transform.apply(subpath.first_point()) + position);
+
+    for (size_t i = 0; i < subpath.length(); i++)
+    {
+        auto curve = subpath.curves(i);
+
+        curve.start = transform.apply(curve.start) + position;
+        curve.first_control_point = transform.apply(curve.first_control_point) + position;
+        curve.second_contol_point = transform.apply(curve.second_contol_point) + position;
+        curve.end = transform.apply(curve.end) + position;
+
+        flatten(curve);
+    }
+}
+
+// Edges between the flattened points, filling always closes the subpath.
+void Rasterizer::add_edges()
+{
+    for (size_t i = 0; i < _points.count(); i++)
+    {
+        Vec2f from = _points[i];
+        Vec2f to = _points[(i + 1) % _points.count()];
+
+        if (from.y() == to.y())
+        {
+            continue;
+        }
+
+        Edge edge;
+
+        if (from.y() < to.y())
+        {
+            edge = {from.x(), from.y(), to.x(), to.y(), 0, 1};
+        }
+        else
+        {
+            edge = {to.x(), to.y(), from.x(), from.y(), 0, -1};
+        }
+
+        edge.dxdy = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+
+        _edges.push_back(edge);
+    }
+}
+
+static int floor_to_int(float value)
+{
+    int result = (int)value;
+    return result - (value < result);
+}
+
+static int ceil_to_int(float value)
+{
+    int result = (int)value;
+    return result + (value > result);
+}
+
+// Add the area the part of `edge` within row `y` leaves to the right of it
+// to the cells of the row. Cells are relative to `origin`, whatever is
+// past the left or right of the row is pushed to its border, which doesn't
+// change the coverage of the pixels inside.
+void Rasterizer::accumulate(const Edge &edge, int y, int origin, int width, int &min_x, int &max_x)
+{
+    float top = MAX((float)y, edge.y0);
+    float bottom = MIN((float)(y + 1), edge.y1);
+
+    if (bottom <= top)
+    {
+        return;
+    }
+
+    float dy = bottom - top;
+    float d = dy * edge.winding;
+
+    float start = edge.x0 + (top - edge.y0) * edge.dxdy - origin;
+    float end = start + dy * edge.dxdy;
+
+    start = clamp(start, 0.0f, (float)width);
+    end = clamp(end, 0.0f, (float)width);
+
+    float x0 = MIN(start, end);
+    float x1 = MAX(start, end);
+
+    int x0i = floor_to_int(x0);
+    int x1i = ceil_to_int(x1);
+
+    float *cells = _cells.raw_storage();
+
+    if (x1i <= x0i + 1)
+    {
+        // Within a single cell, what is left of the middle of the segment
+        // stays in it, the rest goes to the next one.
+        float middle = 0.5f * (start + end) - x0i;
+
+        cells[x0i] += d - d * middle;
+        cells[x0i + 1] += d * middle;
+
+        min_x = MIN(min_x, x0i);
+        max_x = MAX(max_x, x0i + 1);
+    }
+    else
+    {
+        float slope = 1 / (x1 - x0);
+
+        float x0f = x0 - x0i;
+        float first = 0.5f * slope * (1 - x0f) * (1 - x0f);
+
+        float x1f = x1 - x1i + 1;
+        float last = 0.5f * slope * x1f * x1f;
+
+        cells[x0i] += d * first;
+
+        if (x1i == x0i + 2)
+        {
+            cells[x0i + 1] += d * (1 - first - last);
+        }
+        else
+        {
+            float second = slope * (1.5f - x0f);
+            cells[x0i + 1] += d * (second - first);
+
+            for (int x = x0i + 2; x < x1i - 1; x++)
+            {
+                cells[x] += d * slope;
+            }
+
+            float before_last = second + (x1i - x0i - 3) * slope;
+            cells[x1i - 1] += d * (1 - before_last - last);
+        }
+
+        cells[x1i] += d * last;
+
+        min_x = MIN(min_x, x0i);
+        max_x = MAX(max_x, x1i);
+    }
+}
 
-void Rasterizer::stroke(Painter &painter, Path &path, Vec2f position, Trans2f transform, Color color)
+void Rasterizer::fill(const Path &path, Vec2f position, Trans2f transform, Recti clip, FillRule rule, CoverageSpan span)
 {
+    if (clip.is_empty())
+    {
+        return;
+    }
+
+    _edges.clear();
+
     for (size_t i = 0; i < path.subpath_count(); i++)
     {
-        _points.clear();
+        flatten(path.subpath(i), position, transform);
+        add_edges();
+    }
+
+    if (_edges.empty())
+    {
+        return;
+    }
+
+    _edges.sort([](const Edge &left, const Edge &right) {
+        return (left.y0 > right.y0) - (left.y0 < right.y0);
+    });
 
-        auto &subpath = path.subpath(i);
+    float lowest = _edges[0].y1;
 
-        _points.push_back(transform.apply(subpath.first_point()));
+    for (size_t i = 0; i < _edges.count(); i++)
+    {
+        lowest = MAX(lowest, _edges[i].y1);
+    }
+
+    int first_row = MAX(clip.top(), floor_to_int(_edges[0].y0));
+    int last_row = MIN(clip.bottom(), ceil_to_int(lowest));
+
+    int width = clip.width();
+
+    // Two more cells for what lands on the right border.
+    if (_cells.count() < (size_t)width + 2)
+    {
+        _cells.clear();
+        _coverage.clear();
 
-        for (size_t j = 0; j < subpath.length(); j++)
+        for (int i = 0; i < width + 2; i++)
         {
-            auto curve = subpath.curves(j);
+            _cells.push_back(0);
+            _coverage.push_back(0);
+        }
+    }
+
+    float *cells = _cells.raw_storage();
+    uint8_t *coverage = _coverage.raw_storage();
 
-            curve.start = transform.apply(curve.start) + position;
-            curve.first_control_point = transform.apply(curve.first_control_point) + position;
-            curve.second_contol_point = transform.apply(curve.second_contol_point) + position;
-            curve.end = transform.apply(curve.end) + position;
+    _active.clear();
+    size_t next = 0;
 
-            flatten(curve);
+    for (int y = first_row; y < last_row; y++)
+    {
+        while (next < _edges.count() && _edges[next].y0 < y + 1)
+        {
+            _active.push_back(next);
+            next++;
         }
 
-        if (_points.count() > 0)
+        for (size_t i = 0; i < _active.count();)
         {
-            for (size_t i = 0; i < _points.count() - 1; i += 1)
+            if (_edges[_active[i]].y1 <= y)
             {
-                painter.draw_line(_points[i], _points[i + 1], color);
+                _active[i] = _active[_active.count() - 1];
+                _active.pop_back();
+            }
+            else
+            {
+                i++;
             }
         }
+
+        if (_active.empty())
+        {
+            continue;
+        }
+
+        int min_x = width + 2;
+        int max_x = -1;
+
+        for (size_t i = 0; i < _active.count(); i++)
+        {
+            accumulate(_edges[_active[i]], y, clip.x(), width, min_x, max_x);
+        }
+
+        if (max_x < min_x)
+        {
+            continue;
+        }
+
+        // Past the last cell touched the edges of a closed path add up to
+        // nothing, only the pixels in between are reported.
+        int end = MIN(max_x + 1, width);
+        float accumulated = 0;
+
+        for (int x = min_x; x < end; x++)
+        {
+            accumulated += cells[x];
+            cells[x] = 0;
+
+            float value = accumulated < 0 ? -accumulated : accumulated;
+
+            if (rule == FillRule::EVENODD)
+            {
+                value -= 2 * floor_to_int(value / 2);
+                value = value > 1 ? 2 - value : value;
+            }
+            else
+            {
+                value = MIN(value, 1.0f);
+            }
+
+            coverage[x - min_x] = (uint8_t)(value * 255 + 0.5f);
+        }
+
+        for (int x = end; x <= max_x; x++)
+        {
+            cells[x] = 0;
+        }
+
+        if (end > min_x)
+        {
+            span(y, clip.x() + min_x, coverage, end - min_x);
+        }
     }
 }
+
+void Rasterizer::stroke(Painter &painter, const Path &path, Vec2f position, Trans2f transform, Color color)
+{
+    for (size_t i = 0; i < path.subpath_count(); i++)
+    {
+        flatten(path.subpath(i), position, transform);
+
+        for (size_t j = 0; j + 1 < _points.count(); j++)
+        {
+            painter.draw_line(_points[j], _points[j + 1], color);
+        }
+    }
+}
+
 } // namespace graphic
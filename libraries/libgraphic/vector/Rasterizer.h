@@ -1,19 +1,61 @@
 #pragma once
 
-#include <libgraphic/Bitmap.h>
+#include <libgraphic/Color.h>
 #include <libgraphic/vector/Path.h>
+#include <libsystem/algebra/Rect.h>
 #include <libsystem/algebra/Trans2.h>
+#include <libutils/Callback.h>
 
 class Painter;
 
 namespace graphic
 {
 
+enum class FillRule
+{
+    NONZERO,
+    EVENODD,
+};
+
+// Coverage of `count` pixels of row `y` starting at column `x`, from 0 for
+// outside of the shape to 255 for fully inside.
+using CoverageSpan = Callback<void(int y, int x, const uint8_t *coverage, int count)>;
+
 class Rasterizer
 {
 private:
+    struct Edge
+    {
+        // Always going down, y0 < y1.
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+
+        float dxdy;
+
+        // +1 if the path goes down along this edge, -1 if it goes up.
+        float winding;
+    };
+
     Vector<Vec2f> _points;
 
+    // Every edge of the path sorted by their top, the active ones are
+    // the indexes of those crossing the current scanline.
+    Vector<Edge> _edges;
+    Vector<size_t> _active;
+
+    // Signed area left by the edges in each cell of the scanline, the
+    // running sum of it is the coverage. Kept around between fills.
+    Vector<float> _cells;
+    Vector<uint8_t> _coverage;
+
+    void flatten(const SubPath &subpath, Vec2f position, Trans2f transform);
+
+    void add_edges();
+
+    void accumulate(const Edge &edge, int y, int origin, int width, int &min_x, int &max_x);
+
 public:
     static constexpr auto TOLERANCE = 0.25f;
     static constexpr auto MAX_DEPTH = 8;
@@ -26,11 +68,13 @@ public:
 
     void flatten(BezierCurve &curve) { tessellate_cubic_bezier(curve, 0); }
 
-    void rasterize();
-
-    void fill(Path &path, Vec2f position, Trans2f transform, Color color);
+    // Scanline conversion of the path with antialiasing: edges become
+    // active when the scanline reaches them and each one adds the exact
+    // area it covers to the cells it crosses, like stb_truetype and
+    // font-rs do. Only what is inside `clip` is reported to `span`.
+    void fill(const Path &path, Vec2f position, Trans2f transform, Recti clip, FillRule rule, CoverageSpan span);
 
-    void stroke(Painter &painter, Path &path, Vec2f position, Trans2f transform, Color color);
+    void stroke(Painter &painter, const Path &path, Vec2f position, Trans2f transform, Color color);
 };
 
 } // namespace graphic
@@ -1,78 +1,131 @@
 #pragma once
 
+#include <libutils/Arena.h>
+#include <libutils/Atom.h>
 #include <libutils/Enum.h>
-#include <libutils/HashMap.h>
 #include <libutils/Prettifier.h>
 #include <libutils/Scanner.h>
 #include <libutils/String.h>
-#include <libutils/Vector.h>
+#include <libutils/StringView.h>
 
 namespace markup
 {
 
-using Attributes = HashMap<String, String>;
+struct Attribute
+{
+    Atom name;
+    StringView value;
+    Attribute *next;
+};
 
+// Node of a Document, nodes, attributes and their strings all live in the
+// document arena. Childs and attributes are kept in insertion order as
+// singly linked lists, a node rarely has more than a handful of either.
 class Node
 {
 private:
-    String _type;
+    StringView _type;
     int _flags;
-    Vector<Node> _childs;
-    HashMap<String, String> _attributes;
+
+    Node *_first_child = nullptr;
+    Node *_last_child = nullptr;
+    Node *_next_sibling = nullptr;
+    size_t _child_count = 0;
+
+    Attribute *_first_attribute = nullptr;
+    Attribute *_last_attribute = nullptr;
+
+    Attribute *find_attribute(Atom name) const
+    {
+        for (auto attribute = _first_attribute; attribute; attribute = attribute->next)
+        {
+            if (attribute->name == name)
+            {
+                return attribute;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Looking an attribute up doesn't intern its name, only setting it does.
+    Attribute *find_attribute(StringView name) const
+    {
+        Atom atom;
+
+        if (!Atom::lookup(name, &atom))
+        {
+            return nullptr;
+        }
+
+        return find_attribute(atom);
+    }
 
 public:
     static constexpr auto NONE = 0;
     static constexpr auto SELF_CLOSING = 1 << 0;
 
-    auto type() const { return _type; }
+    StringView type() const { return _type; }
 
-    auto is(String type) const { return _type == type; }
+    bool is(StringView type) const { return _type == type; }
 
-    auto flags() { return _flags; }
+    int flags() const { return _flags; }
 
-    auto count_child() { return _childs.count(); }
+    void flags(int flags) { _flags = flags; }
 
-    Node(String type, int flags = NONE)
+    size_t count_child() const { return _child_count; }
+
+    // `type` must outlive the node, usually it was copied to the arena.
+    Node(StringView type, int flags = NONE)
         : _type(type),
           _flags(flags)
     {
     }
 
-    Node(String type, int flags, Attributes &&attributes)
-        : _type(type),
-          _flags(flags),
-          _attributes(attributes)
+    bool has_attribute(StringView attribute) const
     {
+        return find_attribute(attribute) != nullptr;
     }
 
-    bool has_attribute(String attribute)
+    // `value` must outlive the node.
+    void set_attribute(Arena &arena, Atom name, StringView value)
     {
-        return _attributes.has_key(attribute);
-    }
+        auto existing = find_attribute(name);
 
-    void set_attribute(String attribute, String value)
-    {
-        _attributes[attribute] = value;
-    }
+        if (existing)
+        {
+            existing->value = value;
+            return;
+        }
 
-    String get_attribute(String attribute)
-    {
-        if (_attributes.has_key(attribute))
+        auto attribute = arena.make<Attribute>(name, value, nullptr);
+
+        if (_last_attribute)
         {
-            return _attributes[attribute];
+            _last_attribute->next = attribute;
         }
         else
         {
-            return "";
+            _first_attribute = attribute;
         }
+
+        _last_attribute = attribute;
+    }
+
+    String get_attribute(StringView attribute) const
+    {
+        return get_attribute_or_default(attribute, "");
     }
 
     template <typename TCallback>
-    bool with_attribute(String attribute, TCallback callback)
+    bool with_attribute(StringView attribute, TCallback callback) const
     {
-        if (_attributes.has_key(attribute))
+        auto found = find_attribute(attribute);
+
+        if (found)
         {
-            callback(_attributes[attribute]);
+            String value{found->value};
+            callback(value);
             return true;
         }
         else
@@ -81,11 +134,13 @@ public:
         }
     }
 
-    String get_attribute_or_default(String attribute, String fallback)
+    String get_attribute_or_default(StringView attribute, String fallback) const
     {
-        if (_attributes.has_key(attribute))
+        auto found = find_attribute(attribute);
+
+        if (found)
         {
-            return _attributes[attribute];
+            return String{found->value};
         }
         else
         {
@@ -94,31 +149,91 @@ public:
     }
 
     template <typename TCallback>
-    Iteration foreach_attributes(TCallback callback)
+    Iteration foreach_attributes(TCallback callback) const
     {
-        return _attributes.foreach (callback);
-    }
+        for (auto attribute = _first_attribute; attribute; attribute = attribute->next)
+        {
+            if (callback(attribute->name, attribute->value) == Iteration::STOP)
+            {
+                return Iteration::STOP;
+            }
+        }
 
-    void add_child(const Node &child)
-    {
-        _childs.push_back(child);
+        return Iteration::CONTINUE;
     }
 
-    void add_child(Node &&child)
+    void add_child(Node *child)
     {
-        _childs.push_back(move(child));
+        if (_last_child)
+        {
+            _last_child->_next_sibling = child;
+        }
+        else
+        {
+            _first_child = child;
+        }
+
+        _last_child = child;
+        _child_count++;
     }
 
     template <typename TCallback>
     Iteration foreach_child(TCallback callback)
     {
-        return _childs.foreach (callback);
+        for (auto child = _first_child; child; child = child->_next_sibling)
+        {
+            if (callback(*child) == Iteration::STOP)
+            {
+                return Iteration::STOP;
+            }
+        }
+
+        return Iteration::CONTINUE;
+    }
+};
+
+// Parsed markup, the whole tree goes away with the document in a few free()
+// no matter how many nodes it has.
+class Document
+{
+private:
+    Arena _arena{};
+    Node *_root = nullptr;
+
+public:
+    Arena &arena() { return _arena; }
+
+    Node &root() { return *_root; }
+
+    void root(Node *node) { _root = node; }
+
+    Document() {}
+
+    Document(Document &&other)
+    {
+        swap(_arena, other._arena);
+        swap(_root, other._root);
     }
+
+    Document &operator=(Document &&other)
+    {
+        if (this != &other)
+        {
+            swap(_arena, other._arena);
+            swap(_root, other._root);
+        }
+
+        return *this;
+    }
+
+    __noncopyable(Document);
 };
 
-Node parse(Scanner &scan);
+Document parse(const char *buffer, size_t size);
+
+Document parse(Scanner &scan);
 
-Node parse_file(const char *path);
+Document parse_file(const char *path);
 
 void prettify(Prettifier &pretty, Node &node);
 
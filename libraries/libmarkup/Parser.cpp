@@ -1,11 +1,12 @@
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
 #include <libsystem/unicode/Codepoint.h>
 #include <libsystem/utils/NumberParser.h>
 #include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
-#include <libutils/StringBuilder.h>
+#include <libutils/SpanScanner.h>
 #include <libutils/Strings.h>
 
 #include <libmarkup/Markup.h>
@@ -13,31 +14,31 @@
 namespace markup
 {
 
-static void whitespace(Scanner &scan)
+static void whitespace(SpanScanner &scan)
 {
-    scan.eat(Strings::WHITESPACE);
+    scan.eat_whitespace();
 }
 
-static String identifier(Scanner &scan)
+static StringView identifier(SpanScanner &scan)
 {
-    StringBuilder builder{};
-
-    while (scan.current_is(Strings::ALL_ALPHA) &&
-           scan.do_continue())
-    {
-        builder.append(scan.current());
-        scan.foreward();
-    }
-
-    return builder.finalize();
+    return scan.eat(Strings::ALL_ALPHA);
 }
 
-static String string(Scanner &scan)
+static StringView string(SpanScanner &scan, Arena &arena)
 {
-    StringBuilder builder{};
-
     scan.skip('"');
 
+    auto run = scan.take_until('"', '\\');
+
+    // Most attributes have no escape sequences and are copied in one go.
+    if (scan.skip('"') || scan.ended())
+    {
+        return arena.copy(run);
+    }
+
+    ArenaString builder{arena, run.length() * 2};
+    builder.append(run);
+
     while (scan.do_continue() &&
            scan.current() != '"')
     {
@@ -45,11 +46,8 @@ static String string(Scanner &scan)
         {
             builder.append(scan_json_escape_sequence(scan));
         }
-        else
-        {
-            builder.append(scan.current());
-            scan.foreward();
-        }
+
+        builder.append(scan.take_until('"', '\\'));
     }
 
     scan.skip('"');
@@ -57,60 +55,56 @@ static String string(Scanner &scan)
     return builder.finalize();
 }
 
-static void attribute(Scanner &scan, Attributes &attr)
+static void attribute(SpanScanner &scan, Arena &arena, Node &node)
 {
-    auto ident = identifier(scan);
+    Atom ident{identifier(scan)};
 
     whitespace(scan);
 
     if (scan.skip('='))
     {
         whitespace(scan);
-        attr[ident] = string(scan);
+        node.set_attribute(arena, ident, string(scan, arena));
     }
     else
     {
-        attr[ident] = "";
+        node.set_attribute(arena, ident, "");
     }
 }
 
-static Node opening_tag(Scanner &scan)
+static Node *opening_tag(SpanScanner &scan, Arena &arena)
 {
     if (!scan.skip('<'))
     {
-        return {"error"};
+        return arena.make<Node>("error");
     }
 
     whitespace(scan);
 
-    auto type = identifier(scan);
+    auto node = arena.make<Node>(arena.copy(identifier(scan)));
 
     whitespace(scan);
 
-    Attributes attr{};
-
     while (scan.current_is(Strings::ALL_ALPHA) &&
            scan.do_continue())
     {
-        attribute(scan, attr);
+        attribute(scan, arena, *node);
         whitespace(scan);
     }
 
-    auto flags = Node::NONE;
-
     if (scan.skip('/'))
     {
         scan.skip('>');
 
-        flags = Node::SELF_CLOSING;
+        node->flags(Node::SELF_CLOSING);
     }
 
     scan.skip('>');
 
-    return {type, flags, move(attr)};
+    return node;
 }
 
-static void closing_tag(Scanner &scan, const Node &node)
+static void closing_tag(SpanScanner &scan, const Node &node)
 {
     scan.skip('<');
     scan.skip('/');
@@ -119,12 +113,12 @@ static void closing_tag(Scanner &scan, const Node &node)
 
     auto type = identifier(scan);
 
-    if (!node.is(type))
+    if (node.type() != type)
     {
         logger_warn(
             "Opening tag <%s> doesn't match closing tag </%s>",
-            node.type().cstring(),
-            type.cstring());
+            node.type().buffer(),
+            String{type}.cstring());
     }
 
     whitespace(scan);
@@ -132,13 +126,13 @@ static void closing_tag(Scanner &scan, const Node &node)
     scan.skip('>');
 }
 
-static Node node(Scanner &scan)
+static Node *node(SpanScanner &scan, Arena &arena)
 {
     whitespace(scan);
 
-    auto n = opening_tag(scan);
+    auto n = opening_tag(scan, arena);
 
-    if (n.flags() & Node::SELF_CLOSING)
+    if (n->flags() & Node::SELF_CLOSING)
     {
         return n;
     }
@@ -149,35 +143,49 @@ static Node node(Scanner &scan)
            scan.peek(1) != '/' &&
            scan.do_continue())
     {
-        n.add_child(node(scan));
+        n->add_child(node(scan, arena));
         whitespace(scan);
     }
 
     whitespace(scan);
 
-    closing_tag(scan, n);
+    closing_tag(scan, *n);
 
     return n;
 }
 
-Node parse(Scanner &scan)
+Document parse(const char *buffer, size_t size)
 {
+    Document document{};
+
+    SpanScanner scan{buffer, size};
     scan_skip_utf8bom(scan);
-    return node(scan);
+    document.root(node(scan, document.arena()));
+
+    return document;
 }
 
-Node parse_file(const char *path)
+Document parse(Scanner &scan)
 {
-    __cleanup(stream_cleanup) Stream *json_file = stream_open(path, OPEN_READ);
+    auto content = scan_read_all(scan);
+    return parse(content.cstring(), content.length());
+}
+
+Document parse_file(const char *path)
+{
+    void *buffer = nullptr;
+    size_t size = 0;
 
-    if (handle_has_error(json_file))
+    if (file_read_all(path, &buffer, &size) != SUCCESS)
     {
-        return {"error"};
+        return parse("", 0);
     }
 
-    StreamScanner scan{json_file};
-    scan_skip_utf8bom(scan);
-    return node(scan);
+    auto document = parse((const char *)buffer, size);
+
+    free(buffer);
+
+    return document;
 }
 
 } // namespace markup
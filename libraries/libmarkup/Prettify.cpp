@@ -14,9 +14,9 @@ void prettify(Prettifier &pretty, Node &node)
 
     node.foreach_attributes([&](auto &key, auto &value) {
         pretty.append(' ');
-        pretty.append(key);
+        pretty.append(key.cstring());
 
-        if (value != "")
+        if (value.length() > 0)
         {
             pretty.append('=');
             pretty.append('"');
@@ -3,25 +3,30 @@
 #define RESULT_ENUM(__ENTRY, __ENTRY_WITH_VALUE)                                  \
     __ENTRY_WITH_VALUE(SUCCESS, 0, "Success")                                     \
     __ENTRY(TIMEOUT, "Timed out")                                                 \
+    __ENTRY(ERR_ADDRESS_IN_USE, "Address already in use")                         \
     __ENTRY(ERR_BAD_ADDRESS, "Bad address")                                       \
     __ENTRY(ERR_BAD_FILE_DESCRIPTOR, "Bad file descriptor")                       \
     __ENTRY(ERR_BAD_FONT_FILE_FORMAT, "Bad font file format")                     \
     __ENTRY(ERR_BAD_IMAGE_FILE_FORMAT, "Bad image file format")                   \
     __ENTRY(ERR_CANNOT_ALLOCATE_MEMORY, "Cannot allocate memory")                 \
     __ENTRY(ERR_CONNECTION_REFUSED, "Connection refused")                         \
+    __ENTRY(ERR_CONNECTION_RESET, "Connection reset by peer")                     \
     __ENTRY(ERR_EXEC_FORMAT_ERROR, "Exec format error")                           \
     __ENTRY(ERR_FILE_EXISTS, "File exists")                                       \
     __ENTRY(ERR_FUNCTION_NOT_IMPLEMENTED, "Function not implemented")             \
     __ENTRY(ERR_INAPPROPRIATE_CALL_FOR_DEVICE, "Inappropriate call for device")   \
+    __ENTRY(ERR_INPUT_OUTPUT, "Input/output error")                               \
     __ENTRY(ERR_INVALID_ARGUMENT, "Invalid argument")                             \
     __ENTRY(ERR_IS_A_DIRECTORY, "File is a directory")                            \
     __ENTRY(ERR_MEMORY_NOT_ALIGNED, "Memory not aligned")                         \
+    __ENTRY(ERR_NETWORK_UNREACHABLE, "Network is unreachable")                    \
     __ENTRY(ERR_NO_SUCH_DEVICE, "No such device")                                 \
     __ENTRY(ERR_NO_SUCH_FILE_OR_DIRECTORY, "No such file or directory")           \
     __ENTRY(ERR_NO_SUCH_TASK, "No such task")                                     \
     __ENTRY(ERR_NOT_A_DIRECTORY, "File is not a directory")                       \
     __ENTRY(ERR_NOT_A_SOCKET, "Not a socket")                                     \
     __ENTRY(ERR_NOT_A_STREAM, "Not a stream")                                     \
+    __ENTRY(ERR_NOT_CONNECTED, "Not connected")                                   \
     __ENTRY(ERR_NOT_READABLE, "Not readable")                                     \
     __ENTRY(ERR_NOT_WRITABLE, "Not writable")                                     \
     __ENTRY(ERR_OPERATION_NOT_SUPPORTED, "Unsupported operation")                 \
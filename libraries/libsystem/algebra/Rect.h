@@ -396,7 +396,7 @@ public:
     bool contains(Rect other) const
     {
         return (_x <= other._x && (_x + _width) >= (other._x + other._width)) &&
-               (_y <= other._y && (_y + _height) >= (other._y + other._width));
+               (_y <= other._y && (_y + _height) >= (other._y + other._height));
     }
 
     Border contains(Insets<Scalar> spacing, Vec2<Scalar> position) const
@@ -107,6 +107,17 @@ static Timeout eventloop_get_timeout()
         return Iteration::CONTINUE;
     });
 
+    // An invoker asking to run again from its own callback would otherwise
+    // wait for the next event.
+    _eventloop_invoker.foreach ([&](Invoker *invoker) {
+        if (invoker->should_be_invoke_later())
+        {
+            timeout = 0;
+        }
+
+        return Iteration::CONTINUE;
+    });
+
     return timeout;
 }
 
@@ -18,14 +18,40 @@ Result file_read_all(const char *path, void **buffer, size_t *size)
         return handle_get_error(stream);
     }
 
-    *buffer = malloc(state.size);
-    *size = state.size;
+    if (state.size == 0)
+    {
+        // Devices like /System/processes don't know their size up front.
+        size_t capacity = 4096;
+        size_t used = 0;
+        char *data = (char *)malloc(capacity);
+
+        size_t read = 0;
+
+        while ((read = stream_read(stream, data + used, capacity - used)) > 0)
+        {
+            used += read;
+
+            if (used == capacity)
+            {
+                capacity *= 2;
+                data = (char *)realloc(data, capacity);
+            }
+        }
 
-    stream_read(stream, *buffer, state.size);
+        *buffer = data;
+        *size = used;
+    }
+    else
+    {
+        *buffer = malloc(state.size);
+        *size = state.size;
+
+        stream_read(stream, *buffer, state.size);
+    }
 
     if (handle_has_error(stream))
     {
-        free(buffer);
+        free(*buffer);
         return handle_get_error(stream);
     }
 
@@ -0,0 +1,317 @@
+#include <libsystem/Assert.h>
+#include <libsystem/io/File.h>
+#include <libsystem/json/Document.h>
+
+namespace json
+{
+
+static constexpr Node _nil{};
+
+size_t Node::length() const
+{
+    if (_type == ARRAY || _type == OBJECT)
+    {
+        return _length;
+    }
+
+    return 0;
+}
+
+StringView Node::as_string() const
+{
+    switch (_type)
+    {
+    case STRING:
+        return {_string, _length};
+
+    case TRUE:
+        return "true";
+
+    case FALSE:
+        return "false";
+
+    case NIL:
+        return "null";
+
+    default:
+        return {};
+    }
+}
+
+int Node::as_integer() const
+{
+    switch (_type)
+    {
+    case INTEGER:
+        return _integer;
+
+#ifndef __KERNEL__
+    case DOUBLE:
+        return _double;
+#endif
+
+    case TRUE:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+#ifndef __KERNEL__
+
+double Node::as_double() const
+{
+    switch (_type)
+    {
+    case INTEGER:
+        return _integer;
+
+    case DOUBLE:
+        return _double;
+
+    case TRUE:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+#endif
+
+const Node &Node::get(size_t index) const
+{
+    if (_type != ARRAY || index >= _length)
+    {
+        return _nil;
+    }
+
+    return _items[index];
+}
+
+bool Node::has(StringView key) const
+{
+    return &get(key) != &_nil;
+}
+
+// Objects are small in practice, a linear scan comparing the length first
+// beats hashing every key while building the tree.
+const Node &Node::get(StringView key) const
+{
+    if (_type != OBJECT)
+    {
+        return _nil;
+    }
+
+    for (size_t i = 0; i < _length; i++)
+    {
+        if (_members[i].key == key)
+        {
+            return _members[i].value;
+        }
+    }
+
+    return _nil;
+}
+
+const Member &Node::member(size_t index) const
+{
+    assert(_type == OBJECT && index < _length);
+
+    return _members[index];
+}
+
+Document::Document(const char *buffer, size_t size)
+{
+    Reader reader{buffer, size};
+
+    Vector<Node> items{};
+    Vector<Member> members{};
+
+    if (!build(reader, reader.next(), _root, items, members))
+    {
+        _root = {};
+    }
+}
+
+Document::Document(Document &&other)
+{
+    swap(_arena, other._arena);
+    swap(_buffer, other._buffer);
+    swap(_root, other._root);
+}
+
+Document &Document::operator=(Document &&other)
+{
+    if (this != &other)
+    {
+        swap(_arena, other._arena);
+        swap(_buffer, other._buffer);
+        swap(_root, other._root);
+    }
+
+    return *this;
+}
+
+Document::~Document()
+{
+    free(_buffer);
+}
+
+bool Document::build(Reader &reader, Token token, Node &node, Vector<Node> &items, Vector<Member> &members)
+{
+    switch (token)
+    {
+    case Token::STRING:
+        node._type = STRING;
+
+        if (reader.escaped())
+        {
+            char *buffer = (char *)_arena.allocate(reader.raw_string().length() * 2, 1);
+            node._length = reader.unescape(buffer);
+            node._string = buffer;
+        }
+        else
+        {
+            node._length = reader.raw_string().length();
+            node._string = reader.raw_string().buffer();
+        }
+
+        return true;
+
+    case Token::INTEGER:
+        node._type = INTEGER;
+        node._integer = reader.integer();
+        return true;
+
+#ifndef __KERNEL__
+    case Token::DOUBLE:
+        node._type = DOUBLE;
+        node._double = reader.as_double();
+        return true;
+#endif
+
+    case Token::TRUE:
+        node._type = TRUE;
+        return true;
+
+    case Token::FALSE:
+        node._type = FALSE;
+        return true;
+
+    case Token::NIL:
+        node._type = NIL;
+        return true;
+
+    case Token::BEGIN_ARRAY:
+    {
+        // Items are collected on a shared stack and copied in place once
+        // the array is complete, nested arrays stack on top of it.
+        size_t base = items.count();
+
+        for (Token child = reader.next(); child != Token::END_ARRAY; child = reader.next())
+        {
+            Node item{};
+
+            if (!build(reader, child, item, items, members))
+            {
+                return false;
+            }
+
+            items.push_back(item);
+        }
+
+        size_t count = items.count() - base;
+        Node *array = _arena.make_array<Node>(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            array[i] = items[base + i];
+        }
+
+        while (items.count() > base)
+        {
+            items.pop_back();
+        }
+
+        node._type = ARRAY;
+        node._length = count;
+        node._items = array;
+
+        return true;
+    }
+
+    case Token::BEGIN_OBJECT:
+    {
+        size_t base = members.count();
+
+        for (Token child = reader.next(); child != Token::END_OBJECT; child = reader.next())
+        {
+            if (child != Token::KEY)
+            {
+                return false;
+            }
+
+            Member member{};
+
+            if (reader.escaped())
+            {
+                char *buffer = (char *)_arena.allocate(reader.raw_string().length() * 2, 1);
+                member.key = {buffer, reader.unescape(buffer)};
+            }
+            else
+            {
+                member.key = reader.raw_string();
+            }
+
+            if (!build(reader, reader.next(), member.value, items, members))
+            {
+                return false;
+            }
+
+            members.push_back(member);
+        }
+
+        size_t count = members.count() - base;
+        Member *object = _arena.make_array<Member>(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            object[i] = members[base + i];
+        }
+
+        while (members.count() > base)
+        {
+            members.pop_back();
+        }
+
+        node._type = OBJECT;
+        node._length = count;
+        node._members = object;
+
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+Document Document::load_file(const char *path)
+{
+    void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_read_all(path, &buffer, &size) != SUCCESS)
+    {
+        return {};
+    }
+
+    Document document{(const char *)buffer, size};
+    document._buffer = (char *)buffer;
+
+    return document;
+}
+
+} // namespace json
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <libsystem/json/Reader.h>
+#include <libsystem/json/Value.h>
+#include <libutils/Arena.h>
+#include <libutils/StringView.h>
+#include <libutils/Vector.h>
+
+namespace json
+{
+
+struct Member;
+
+// Read only node of a Document, strings without escape sequences point
+// straight into the parsed buffer.
+class Node
+{
+private:
+    friend class Document;
+
+    Type _type;
+    size_t _length;
+
+    union
+    {
+        const char *_string;
+        int _integer;
+#ifndef __KERNEL__
+        double _double;
+#endif
+        const Node *_items;
+        const Member *_members;
+    };
+
+public:
+    constexpr Node() : _type(NIL), _length(0), _integer(0) {}
+
+    Type type() const { return _type; }
+
+    bool is(Type type) const { return _type == type; }
+
+    // Number of items or members, 0 for anything else.
+    size_t length() const;
+
+    StringView as_string() const;
+
+    int as_integer() const;
+
+#ifndef __KERNEL__
+    double as_double() const;
+#endif
+
+    // Missing items and members are returned as null.
+    const Node &get(size_t index) const;
+
+    bool has(StringView key) const;
+
+    const Node &get(StringView key) const;
+
+    const Member &member(size_t index) const;
+};
+
+struct Member
+{
+    StringView key;
+    Node value;
+};
+
+// Whole tree parsed in one go with all its nodes in an arena, freeing it
+// is a handful of free() no matter how large it is.
+class Document
+{
+private:
+    Arena _arena{};
+    char *_buffer = nullptr;
+    Node _root{};
+
+    bool build(Reader &reader, Token token, Node &node, Vector<Node> &items, Vector<Member> &members);
+
+public:
+    const Node &root() const { return _root; }
+
+    Document() {}
+
+    // The buffer must outlive the document.
+    Document(const char *buffer, size_t size);
+
+    Document(Document &&other);
+
+    Document &operator=(Document &&other);
+
+    ~Document();
+
+    __noncopyable(Document);
+
+    static Document load_file(const char *path);
+};
+
+} // namespace json
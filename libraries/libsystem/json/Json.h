@@ -4,7 +4,9 @@
 #include <libutils/String.h>
 
 #include <libsystem/json/Array.h>
+#include <libsystem/json/Document.h>
 #include <libsystem/json/Object.h>
+#include <libsystem/json/Reader.h>
 #include <libsystem/json/Value.h>
 #include <libutils/Prettifier.h>
 
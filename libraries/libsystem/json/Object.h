@@ -1,13 +1,14 @@
 #pragma once
 
 #include <libsystem/json/Value.h>
+#include <libutils/Atom.h>
 #include <libutils/HashMap.h>
 #include <libutils/String.h>
 
 namespace json
 {
 
-struct Object : public HashMap<String, Value>
+struct Object : public HashMap<Atom, Value>
 {
 };
 
@@ -1,200 +1,96 @@
 #include <libsystem/Assert.h>
-#include <libsystem/core/CString.h>
-#include <libsystem/io/Stream.h>
+#include <libsystem/io/File.h>
 #include <libsystem/json/Json.h>
-#include <libsystem/unicode/Codepoint.h>
-#include <libsystem/utils/NumberParser.h>
+#include <libsystem/json/Reader.h>
 #include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
-#include <libutils/StringBuilder.h>
-#include <libutils/Strings.h>
 
 namespace json
 {
 
-static Value value(Scanner &scan);
-
-static void whitespace(Scanner &scan)
+static Value build(Reader &reader, Token token)
 {
-    scan.eat(Strings::WHITESPACE);
-}
+    switch (token)
+    {
+    case Token::STRING:
+        return reader.string();
 
-static Value number(Scanner &scan)
-{
-#ifdef __KERNEL__
-    return Value{scan_int(scan, 10)};
-#else
-    return {scan_float(scan)};
+    case Token::INTEGER:
+        return reader.integer();
+
+#ifndef __KERNEL__
+    case Token::DOUBLE:
+        return reader.as_double();
 #endif
-}
 
-static String string(Scanner &scan)
-{
-    StringBuilder builder{};
+    case Token::TRUE:
+        return true;
 
-    scan.skip('"');
+    case Token::FALSE:
+        return false;
 
-    while (scan.current() != '"' && scan.do_continue())
+    case Token::BEGIN_ARRAY:
     {
-        if (scan.current() == '\\')
-        {
-            builder.append(scan_json_escape_sequence(scan));
-        }
-        else
-        {
-            builder.append(scan.current());
-            scan.foreward();
-        }
-    }
-
-    scan.skip('"');
+        Array array{};
 
-    return builder.finalize();
-}
-
-static Value array(Scanner &scan)
-{
-    scan.skip('[');
-
-    Array array{};
+        for (Token child = reader.next(); child != Token::END_ARRAY; child = reader.next())
+        {
+            if (child == Token::END || child == Token::ERROR)
+            {
+                break;
+            }
 
-    whitespace(scan);
+            array.push_back(build(reader, child));
+        }
 
-    if (scan.skip(']'))
-    {
         return move(array);
     }
 
-    int index = 0;
-
-    do
+    case Token::BEGIN_OBJECT:
     {
-        scan.skip(',');
-        array.push_back(value(scan));
-        index++;
-    } while (scan.current() == ',');
-
-    scan.skip(']');
-
-    return move(array);
-}
-
-static Value object(Scanner &scan)
-{
-    scan.skip('{');
+        Object object{};
 
-    Object object{};
-
-    whitespace(scan);
+        for (Token child = reader.next(); child == Token::KEY; child = reader.next())
+        {
+            Atom key = reader.escaped() ? Atom{reader.string()} : Atom{reader.raw_string()};
+            object[key] = build(reader, reader.next());
+        }
 
-    if (scan.skip('}'))
-    {
         return move(object);
     }
 
-    while (scan.current() != '}')
-    {
-        auto k = string(scan);
-        whitespace(scan);
-
-        scan.skip(':');
-
-        object[k] = value(scan);
-
-        scan.skip(',');
-
-        whitespace(scan);
-    }
-
-    scan.skip('}');
-
-    return object;
-}
-
-static Value keyword(Scanner &scan)
-{
-    StringBuilder builder{};
-
-    while (scan.current_is(Strings::LOWERCASE_ALPHA) &&
-           scan.do_continue())
-    {
-        builder.append(scan.current());
-        scan.foreward();
-    }
-
-    auto keyword = builder.finalize();
-
-    if (keyword == "true")
-    {
-        return true;
-    }
-    else if (keyword == "false")
-    {
-        return false;
-    }
-    else
-    {
+    default:
         return nullptr;
     }
 }
 
-static Value value(Scanner &scan)
+Value parse(const char *str, size_t size)
 {
-    whitespace(scan);
-
-    Value value{};
-
-    if (scan.current() == '"')
-    {
-        value = string(scan);
-    }
-    else if (scan.current_is("-") ||
-             scan.current_is("0123456789"))
-    {
-        value = number(scan);
-    }
-    else if (scan.current() == '{')
-    {
-        value = object(scan);
-    }
-    else if (scan.current() == '[')
-    {
-        value = array(scan);
-    }
-    else
-    {
-        value = keyword(scan);
-    }
-
-    whitespace(scan);
-
-    return value;
+    Reader reader{str, size};
+    return build(reader, reader.next());
 }
 
 Value parse(Scanner &scan)
 {
-    scan_skip_utf8bom(scan);
-    return value(scan);
+    auto content = scan_read_all(scan);
+    return parse(content.cstring(), content.length());
 }
 
-Value parse(const char *str, size_t size)
-{
-    StringScanner scan{str, size};
-    return parse(scan);
-};
-
 Value parse_file(const char *path)
 {
-    __cleanup(stream_cleanup) Stream *json_file = stream_open(path, OPEN_READ);
+    void *buffer = nullptr;
+    size_t size = 0;
 
-    if (handle_has_error(json_file))
+    if (file_read_all(path, &buffer, &size) != SUCCESS)
     {
         return nullptr;
     }
 
-    StreamScanner scan{json_file};
-    scan_skip_utf8bom(scan);
-    return value(scan);
+    auto value = parse((const char *)buffer, size);
+
+    free(buffer);
+
+    return value;
 }
 
 } // namespace json
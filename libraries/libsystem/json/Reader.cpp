@@ -0,0 +1,310 @@
+#include <libsystem/core/CString.h>
+#include <libsystem/json/Reader.h>
+#include <libutils/ScannerUtils.h>
+#include <libutils/StringBuilder.h>
+
+namespace json
+{
+
+static inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+Reader::Reader(const char *buffer, size_t size)
+    : _scan(buffer, size)
+{
+    scan_skip_utf8bom(_scan);
+}
+
+Token Reader::error()
+{
+    _error = true;
+    return Token::ERROR;
+}
+
+void Reader::value_done()
+{
+    _expect_key = _depth > 0 && _in_object[_depth - 1];
+}
+
+Token Reader::scan_string()
+{
+    _scan.foreward();
+
+    const char *start = _scan.rest().buffer();
+    _escaped = false;
+
+    while (true)
+    {
+        _scan.take_until('"', '\\');
+
+        if (_scan.ended())
+        {
+            return error();
+        }
+
+        if (_scan.current() == '"')
+        {
+            break;
+        }
+
+        _escaped = true;
+        _scan.foreward(2);
+    }
+
+    _string = {start, (size_t)(_scan.rest().buffer() - start)};
+    _scan.foreward();
+
+    if (_expect_key)
+    {
+        _expect_key = false;
+        return Token::KEY;
+    }
+
+    value_done();
+    return Token::STRING;
+}
+
+static int digits_value(StringView digits)
+{
+    int value = 0;
+
+    for (size_t i = 0; i < digits.length(); i++)
+    {
+        value = value * 10 + (digits[i] - '0');
+    }
+
+    return value;
+}
+
+Token Reader::scan_number()
+{
+    bool negative = _scan.skip('-');
+
+    int integer = digits_value(_scan.eat_while(is_digit));
+
+    _integer = negative ? -integer : integer;
+
+    value_done();
+
+#ifdef __KERNEL__
+    // No floating point in the kernel, the fraction and exponent are dropped.
+    _scan.eat_while([](char c) {
+        return is_digit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+    });
+
+    return Token::INTEGER;
+#else
+    bool has_fraction = false;
+    bool has_exponent = false;
+
+    double fraction = 0;
+
+    if (_scan.skip('.'))
+    {
+        has_fraction = true;
+
+        double multiplier = 0.1;
+        auto digits = _scan.eat_while(is_digit);
+
+        for (size_t i = 0; i < digits.length(); i++)
+        {
+            fraction += multiplier * (digits[i] - '0');
+            multiplier *= 0.1;
+        }
+    }
+
+    int exponent = 0;
+
+    if (_scan.skip('e') || _scan.skip('E'))
+    {
+        has_exponent = true;
+
+        bool negative_exponent = _scan.skip('-');
+
+        if (!negative_exponent)
+        {
+            _scan.skip('+');
+        }
+
+        exponent = digits_value(_scan.eat_while(is_digit));
+
+        if (negative_exponent)
+        {
+            exponent = -exponent;
+        }
+    }
+
+    if (!has_fraction && !has_exponent)
+    {
+        return Token::INTEGER;
+    }
+
+    _double = (integer + fraction) * pow(10, exponent);
+
+    if (negative)
+    {
+        _double = -_double;
+    }
+
+    return Token::DOUBLE;
+#endif
+}
+
+Token Reader::scan_keyword(const char *keyword, Token token)
+{
+    if (!_scan.skip_word(keyword))
+    {
+        return error();
+    }
+
+    value_done();
+
+    return token;
+}
+
+Token Reader::next()
+{
+    if (_error)
+    {
+        return Token::ERROR;
+    }
+
+    while (true)
+    {
+        _scan.eat_whitespace();
+
+        if (_scan.ended())
+        {
+            return _depth == 0 ? Token::END : error();
+        }
+
+        char c = _scan.current();
+
+        switch (c)
+        {
+        case ',':
+        case ':':
+            _scan.foreward();
+            break;
+
+        case '{':
+        case '[':
+            if (_depth == MAX_DEPTH)
+            {
+                return error();
+            }
+
+            _in_object[_depth++] = c == '{';
+            _expect_key = c == '{';
+            _scan.foreward();
+
+            return c == '{' ? Token::BEGIN_OBJECT : Token::BEGIN_ARRAY;
+
+        case '}':
+        case ']':
+            if (_depth == 0 || _in_object[_depth - 1] != (c == '}'))
+            {
+                return error();
+            }
+
+            _depth--;
+            _scan.foreward();
+            value_done();
+
+            return c == '}' ? Token::END_OBJECT : Token::END_ARRAY;
+
+        case '"':
+            return scan_string();
+
+        case 't':
+            return scan_keyword("true", Token::TRUE);
+
+        case 'f':
+            return scan_keyword("false", Token::FALSE);
+
+        case 'n':
+            return scan_keyword("null", Token::NIL);
+
+        default:
+            if (c == '-' || is_digit(c))
+            {
+                return scan_number();
+            }
+
+            return error();
+        }
+    }
+}
+
+void Reader::skip()
+{
+    int depth = _depth - 1;
+
+    while (_depth > depth)
+    {
+        Token token = next();
+
+        if (token == Token::END || token == Token::ERROR)
+        {
+            return;
+        }
+    }
+}
+
+String Reader::string() const
+{
+    if (!_escaped)
+    {
+        return String{_string};
+    }
+
+    StringBuilder builder{_string.length()};
+    SpanScanner scan{_string};
+
+    while (scan.do_continue())
+    {
+        auto run = scan.take_until('\\');
+        builder.append(run);
+
+        if (scan.current() == '\\')
+        {
+            builder.append(scan_json_escape_sequence(scan));
+        }
+    }
+
+    return builder.finalize();
+}
+
+size_t Reader::unescape(char *buffer) const
+{
+    if (!_escaped)
+    {
+        memcpy(buffer, _string.buffer(), _string.length());
+        return _string.length();
+    }
+
+    size_t length = 0;
+    SpanScanner scan{_string};
+
+    while (scan.do_continue())
+    {
+        auto run = scan.take_until('\\');
+        memcpy(buffer + length, run.buffer(), run.length());
+        length += run.length();
+
+        if (scan.current() == '\\')
+        {
+            const char *sequence = scan_json_escape_sequence(scan);
+            size_t sequence_length = strlen(sequence);
+
+            memcpy(buffer + length, sequence, sequence_length);
+            length += sequence_length;
+        }
+    }
+
+    return length;
+}
+
+} // namespace json
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <libutils/SpanScanner.h>
+#include <libutils/String.h>
+#include <libutils/StringView.h>
+
+namespace json
+{
+
+enum class Token
+{
+    BEGIN_OBJECT,
+    END_OBJECT,
+    BEGIN_ARRAY,
+    END_ARRAY,
+    KEY,
+    STRING,
+    INTEGER,
+
+#ifndef __KERNEL__
+    DOUBLE,
+#endif
+
+    TRUE,
+    FALSE,
+    NIL,
+
+    END,
+    ERROR,
+};
+
+// Pull parser over a contiguous buffer, next() returns one token at a time.
+// Keys and strings are handed out as views into the buffer with their
+// escape sequences left as is, nothing is allocated unless they are asked
+// for as a String.
+class Reader
+{
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    SpanScanner _scan;
+
+    int _depth = 0;
+    bool _in_object[MAX_DEPTH];
+    bool _expect_key = false;
+    bool _error = false;
+
+    StringView _string{};
+    bool _escaped = false;
+    int _integer = 0;
+
+#ifndef __KERNEL__
+    double _double = 0;
+#endif
+
+    Token error();
+
+    void value_done();
+
+    Token scan_string();
+
+    Token scan_number();
+
+    Token scan_keyword(const char *keyword, Token token);
+
+public:
+    int depth() const { return _depth; }
+
+    // The content of the last KEY or STRING token, escape sequences aren't
+    // resolved.
+    StringView raw_string() const { return _string; }
+
+    bool escaped() const { return _escaped; }
+
+    int integer() const { return _integer; }
+
+#ifndef __KERNEL__
+    double as_double() const { return _double; }
+#endif
+
+    Reader(const char *buffer, size_t size);
+
+    Token next();
+
+    // Skip the rest of the object or array the last token opened.
+    void skip();
+
+    // The content of the last KEY or STRING token with its escape sequences
+    // resolved.
+    String string() const;
+
+    // Same as string() but written to `buffer` which must have room for
+    // twice raw_string().length() chars (an invalid \u escape expands to a
+    // replacement character). Returns the length of the unescaped string.
+    size_t unescape(char *buffer) const;
+};
+
+} // namespace json
@@ -2,15 +2,33 @@
 #include <libsystem/json/Object.h>
 #include <libsystem/json/Value.h>
 #include <libutils/Move.h>
+#include <libutils/New.h>
 
 namespace json
 {
 
+// Missing keys read as null, like they did when looking them up inserted
+// them. Built in place and never destroyed, the kernel links this file and
+// doesn't run static destructors.
+static const Value &nil()
+{
+    alignas(Value) static char storage[sizeof(Value)];
+    static bool constructed = false;
+
+    if (!constructed)
+    {
+        new (storage) Value{};
+        constructed = true;
+    }
+
+    return *reinterpret_cast<const Value *>(storage);
+}
+
 String Value::as_string() const
 {
     if (_type == STRING)
     {
-        return String(RefPtr<StringStorage>{*_string});
+        return _string;
     }
     else if (_type == TRUE)
     {
@@ -108,28 +126,22 @@ const Array &Value::as_array() const
     return *_array;
 }
 
-Value::Value()
-{
-    _type = NIL;
-    _all = 0;
-}
-
 Value::Value(String &value)
 {
     _type = STRING;
-    _string = ref_if_not_null(value.underlying_storage().naked());
+    new (&_string) String(value);
 }
 
 Value::Value(String &&value)
 {
     _type = STRING;
-    _string = ref_if_not_null(value.underlying_storage().naked());
+    new (&_string) String(move(value));
 }
 
 Value::Value(const char *cstring)
 {
     _type = STRING;
-    _string = new StringStorage(cstring);
+    new (&_string) String(cstring);
 }
 
 Value::Value(int value)
@@ -199,7 +211,7 @@ Value::Value(const Value &other)
     switch (_type)
     {
     case STRING:
-        _string = ref_if_not_null(other._string);
+        new (&_string) String(other._string);
         break;
 
     case INTEGER:
@@ -229,8 +241,18 @@ Value::Value(const Value &other)
 
 Value::Value(Value &&other)
 {
-    _type = exchange_and_return_initial_value(other._type, NIL);
-    _all = exchange_and_return_initial_value(other._all, 0);
+    _type = other._type;
+
+    if (_type == STRING)
+    {
+        new (&_string) String(move(other._string));
+        other.clear();
+    }
+    else
+    {
+        _all = exchange_and_return_initial_value(other._all, 0);
+        other._type = NIL;
+    }
 }
 
 Value::~Value()
@@ -238,35 +260,48 @@ Value::~Value()
     clear();
 }
 
-bool Value::has(String key) const
+const Value *Value::find(StringView key) const
 {
-    if (is(OBJECT))
-    {
-        return _object->has_key(key);
-    }
-    else
+    Atom atom;
+
+    if (!is(OBJECT) || !Atom::lookup(key, &atom))
     {
-        return false;
+        return nullptr;
     }
+
+    return _object->find(atom);
 }
 
-const Value &Value::get(String key) const
+bool Value::has(StringView key) const
+{
+    return find(key) != nullptr;
+}
+
+const Value &Value::get(StringView key) const
 {
     assert(is(OBJECT));
 
-    return _object->operator[](key);
+    auto value = find(key);
+
+    return value ? *value : nil();
 }
 
-void Value::put(String key, const Value &value) const
+void Value::put(Atom key, const Value &value) const
 {
     assert(is(OBJECT));
     _object->operator[](key) = value;
 }
 
-void Value::remove(String key)
+void Value::remove(StringView key)
 {
     assert(is(OBJECT));
-    _object->remove_key(key);
+
+    Atom atom;
+
+    if (Atom::lookup(key, &atom))
+    {
+        _object->remove_key(atom);
+    }
 }
 
 size_t Value::length() const
@@ -315,6 +350,11 @@ void Value::append(const Value &value)
 
 Value &Value::operator=(const Value &other)
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
     clear();
 
     _type = other._type;
@@ -322,7 +362,7 @@ Value &Value::operator=(const Value &other)
     switch (_type)
     {
     case STRING:
-        _string = ref_if_not_null(other._string);
+        new (&_string) String(other._string);
         break;
 
     case INTEGER:
@@ -354,8 +394,23 @@ Value &Value::operator=(const Value &other)
 
 Value &Value::operator=(Value &&other)
 {
-    swap(_type, other._type);
-    swap(_all, other._all);
+    if (this != &other)
+    {
+        clear();
+
+        _type = other._type;
+
+        if (_type == STRING)
+        {
+            new (&_string) String(move(other._string));
+            other.clear();
+        }
+        else
+        {
+            _all = exchange_and_return_initial_value(other._all, 0);
+            other._type = NIL;
+        }
+    }
 
     return *this;
 }
@@ -364,7 +419,7 @@ void Value::clear()
 {
     if (_type == STRING)
     {
-        deref_if_not_null(_string);
+        _string.~String();
     }
     else if (_type == OBJECT)
     {
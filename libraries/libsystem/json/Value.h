@@ -1,5 +1,6 @@
 #pragma once
 
+#include <libutils/Atom.h>
 #include <libutils/String.h>
 
 namespace json
@@ -35,7 +36,7 @@ private:
 
     union
     {
-        StringStorage *_string;
+        String _string;
         int _integer;
 #ifndef __KERNEL__
         double _double;
@@ -64,7 +65,7 @@ public:
 
     const Array &as_array() const;
 
-    Value();
+    constexpr Value() : _type(NIL), _all(0) {}
 
     Value(String &);
 
@@ -96,22 +97,27 @@ public:
 
     ~Value();
 
-    bool has(String key) const;
+    // Looking a key up doesn't intern it, only put() does.
+    const Value *find(StringView key) const;
 
-    const Value &get(String key) const;
+    bool has(StringView key) const;
+
+    const Value &get(StringView key) const;
 
     template <typename TCallback>
-    void with(String key, TCallback callback) const
+    void with(StringView key, TCallback callback) const
     {
-        if (has(key))
+        auto value = find(key);
+
+        if (value)
         {
-            callback(get(key));
+            callback(*value);
         }
     }
 
-    void put(String key, const Value &value) const;
+    void put(Atom key, const Value &value) const;
 
-    void remove(String key);
+    void remove(StringView key);
 
     size_t length() const;
 
@@ -1,7 +1,27 @@
 #pragma once
 
 #include <libsystem/Common.h>
+#include <libsystem/network/Ethernet.h>
+#include <libsystem/network/IPv4.h>
 
-struct ARPPacket
+#define ARP_HARDWARE_ETHERNET (1)
+
+#define ARP_OPERATION_REQUEST (1)
+#define ARP_OPERATION_REPLY (2)
+
+// Only the Ethernet and IPv4 flavour of RFC 826.
+struct __packed ARPPacket
 {
+    be_uint16_t hardware_type;
+    be_uint16_t protocol_type;
+    uint8_t hardware_size;
+    uint8_t protocol_size;
+    be_uint16_t operation;
+
+    MacAddress sender_hardware;
+    IPv4Address sender_protocol;
+    MacAddress target_hardware;
+    IPv4Address target_protocol;
 };
+
+static_assert(sizeof(ARPPacket) == 28);
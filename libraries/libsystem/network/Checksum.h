@@ -0,0 +1,49 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// The internet checksum (RFC 1071): the one's complement of the one's
+// complement sum of the data taken as big endian 16 bits words.
+//
+// Sums are kept unfolded so a pseudo header and the pieces of a packet
+// can be added up before folding, the pieces but the last one must have
+// an even size. 32 bits don't overflow for anything smaller than 128KiB.
+
+static inline uint32_t checksum_add(uint32_t sum, const void *data, size_t size)
+{
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+
+    while (size > 1)
+    {
+        sum += (bytes[0] << 8) | bytes[1];
+        bytes += 2;
+        size -= 2;
+    }
+
+    if (size)
+    {
+        sum += bytes[0] << 8;
+    }
+
+    return sum;
+}
+
+static inline uint32_t checksum_add_word(uint32_t sum, uint16_t word)
+{
+    return sum + word;
+}
+
+static inline uint16_t checksum_finalize(uint32_t sum)
+{
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+    return ~sum & 0xffff;
+}
+
+static inline uint16_t checksum(const void *data, size_t size)
+{
+    return checksum_finalize(checksum_add(0, data, size));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <libsystem/network/IPv4.h>
+
+#define DHCP_SERVER_PORT (67)
+#define DHCP_CLIENT_PORT (68)
+
+#define DHCP_BOOT_REQUEST (1)
+#define DHCP_BOOT_REPLY (2)
+
+#define DHCP_FLAG_BROADCAST (0x8000)
+
+#define DHCP_MAGIC_COOKIE (0x63825363)
+
+#define DHCP_OPTION_PAD (0)
+#define DHCP_OPTION_SUBNET_MASK (1)
+#define DHCP_OPTION_ROUTER (3)
+#define DHCP_OPTION_DNS (6)
+#define DHCP_OPTION_REQUESTED_ADDRESS (50)
+#define DHCP_OPTION_LEASE_TIME (51)
+#define DHCP_OPTION_MESSAGE_TYPE (53)
+#define DHCP_OPTION_SERVER_IDENTIFIER (54)
+#define DHCP_OPTION_PARAMETER_LIST (55)
+#define DHCP_OPTION_END (255)
+
+#define DHCP_DISCOVER (1)
+#define DHCP_OFFER (2)
+#define DHCP_REQUEST (3)
+#define DHCP_DECLINE (4)
+#define DHCP_ACK (5)
+#define DHCP_NAK (6)
+#define DHCP_RELEASE (7)
+
+#define DHCP_OPTIONS_SIZE (308)
+
+struct __packed DHCPPacket
+{
+    uint8_t operation;
+    uint8_t hardware_type;
+    uint8_t hardware_size;
+    uint8_t hops;
+    be_uint32_t transaction;
+    be_uint16_t seconds;
+    be_uint16_t flags;
+    IPv4Address client_address;
+    IPv4Address your_address;
+    IPv4Address server_address;
+    IPv4Address relay_address;
+    uint8_t client_hardware[16];
+    char server_name[64];
+    char boot_file[128];
+    be_uint32_t magic;
+    uint8_t options[DHCP_OPTIONS_SIZE];
+};
+
+static_assert(sizeof(DHCPPacket) == 548);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <libutils/Endian.h>
+
+#define DNS_PORT (53)
+
+#define DNS_FLAG_RESPONSE (0x8000)
+#define DNS_FLAG_RECURSION_DESIRED (0x0100)
+#define DNS_RESPONSE_CODE (0x000f)
+
+#define DNS_TYPE_A (1)
+#define DNS_CLASS_INTERNET (1)
+
+// Names are compressed by pointing back into the message, RFC 1035 4.1.4.
+#define DNS_POINTER (0xc0)
+
+#define DNS_MESSAGE_SIZE (512)
+
+struct __packed DNSHeader
+{
+    be_uint16_t identifier;
+    be_uint16_t flags;
+    be_uint16_t questions;
+    be_uint16_t answers;
+    be_uint16_t authorities;
+    be_uint16_t additionals;
+};
+
+static_assert(sizeof(DNSHeader) == 12);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <abi/Network.h>
+
+#include <libutils/Endian.h>
+
+#define ETHERNET_TYPE_IPV4 (0x0800)
+#define ETHERNET_TYPE_ARP (0x0806)
+
+#define ETHERNET_MTU (1500)
+
+struct __packed EthernetHeader
+{
+    MacAddress destination;
+    MacAddress source;
+    be_uint16_t type;
+};
+
+static_assert(sizeof(EthernetHeader) == 14);
+
+static constexpr MacAddress ETHERNET_BROADCAST = {{0xff, 0xff, 0xff, 0xff, 0xff, 0xff}};
+
+static inline bool mac_address_equals(const MacAddress &left, const MacAddress &right)
+{
+    for (size_t i = 0; i < 6; i++)
+    {
+        if (left[i] != right[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <libutils/Endian.h>
+
+#define ICMP_ECHO_REPLY (0)
+#define ICMP_DESTINATION_UNREACHABLE (3)
+#define ICMP_ECHO_REQUEST (8)
+
+#define ICMP_PORT_UNREACHABLE (3)
+
+struct __packed ICMPHeader
+{
+    uint8_t type;
+    uint8_t code;
+    be_uint16_t checksum;
+    be_uint16_t identifier;
+    be_uint16_t sequence;
+};
+
+static_assert(sizeof(ICMPHeader) == 8);
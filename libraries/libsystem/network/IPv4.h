@@ -0,0 +1,123 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libsystem/network/Checksum.h>
+#include <libutils/Endian.h>
+
+struct IPv4Address
+{
+    uint8_t bytes[4];
+
+    uint8_t operator[](int index) const
+    {
+        return bytes[index];
+    }
+
+    // In host order, for masking and comparing.
+    uint32_t value() const
+    {
+        return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+    }
+
+    static IPv4Address from_value(uint32_t value)
+    {
+        return {{
+            (uint8_t)(value >> 24),
+            (uint8_t)(value >> 16),
+            (uint8_t)(value >> 8),
+            (uint8_t)(value),
+        }};
+    }
+
+    bool empty() const { return value() == 0; }
+
+    bool operator==(const IPv4Address &other) const { return value() == other.value(); }
+
+    bool operator!=(const IPv4Address &other) const { return value() != other.value(); }
+};
+
+static constexpr IPv4Address IPV4_ANY = {{0, 0, 0, 0}};
+static constexpr IPv4Address IPV4_BROADCAST = {{255, 255, 255, 255}};
+
+// Parses a dotted quad, "10.0.2.15".
+static inline bool ipv4_address_parse(const char *string, IPv4Address &address)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (*string < '0' || *string > '9')
+        {
+            return false;
+        }
+
+        int byte = 0;
+
+        while (*string >= '0' && *string <= '9')
+        {
+            byte = byte * 10 + (*string - '0');
+            string++;
+
+            if (byte > 255)
+            {
+                return false;
+            }
+        }
+
+        if (*string != (i == 3 ? '\0' : '.'))
+        {
+            return false;
+        }
+
+        if (i < 3)
+        {
+            string++;
+        }
+
+        address.bytes[i] = byte;
+    }
+
+    return true;
+}
+
+#define IPV4_VERSION (4)
+#define IPV4_DEFAULT_TTL (64)
+
+#define IPV4_PROTOCOL_ICMP (1)
+#define IPV4_PROTOCOL_TCP (6)
+#define IPV4_PROTOCOL_UDP (17)
+
+#define IPV4_FLAG_DONT_FRAGMENT (0x4000)
+#define IPV4_FLAG_MORE_FRAGMENTS (0x2000)
+#define IPV4_FRAGMENT_OFFSET (0x1fff)
+
+struct __packed IPv4Header
+{
+    uint8_t version_and_length;
+    uint8_t service;
+    be_uint16_t total_length;
+    be_uint16_t identification;
+    be_uint16_t fragment;
+    uint8_t ttl;
+    uint8_t protocol;
+    be_uint16_t checksum;
+    IPv4Address source;
+    IPv4Address destination;
+
+    uint8_t version() const { return version_and_length >> 4; }
+
+    size_t header_size() const { return (version_and_length & 0xf) * 4; }
+};
+
+static_assert(sizeof(IPv4Header) == 20);
+
+// Sum of the pseudo header covered by the UDP and TCP checksums.
+static inline uint32_t ipv4_pseudo_header_sum(IPv4Address source, IPv4Address destination, uint8_t protocol, uint16_t length)
+{
+    uint32_t sum = 0;
+
+    sum = checksum_add(sum, source.bytes, 4);
+    sum = checksum_add(sum, destination.bytes, 4);
+    sum = checksum_add_word(sum, protocol);
+    sum = checksum_add_word(sum, length);
+
+    return sum;
+}
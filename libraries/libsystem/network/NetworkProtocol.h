@@ -0,0 +1,86 @@
+#pragma once
+
+#include <abi/Network.h>
+
+#include <libsystem/Result.h>
+#include <libsystem/network/IPv4.h>
+
+// Protocol spoken between applications and the network service.
+//
+// Each socket is a connection to the service. A request is a message
+// followed by `size` bytes of payload and gets exactly one reply, a request
+// that can't complete yet (connect, accept, receive, or send with a full
+// buffer) is answered once it does. Replies never go beyond the buffer of
+// a connection so the service never blocks on a client.
+
+#define NETWORK_SERVICE_PATH "/Session/network.ipc"
+
+enum NetworkSocketType
+{
+    NETWORK_SOCKET_UDP,
+    NETWORK_SOCKET_TCP,
+};
+
+enum NetworkMessageType
+{
+    NETWORK_MESSAGE_INVALID,
+    NETWORK_MESSAGE_ACK,
+    NETWORK_MESSAGE_DATA,
+    NETWORK_MESSAGE_CONFIGURATION,
+
+    NETWORK_MESSAGE_GET_CONFIGURATION,
+    NETWORK_MESSAGE_OPEN,
+    NETWORK_MESSAGE_ATTACH,
+    NETWORK_MESSAGE_BIND,
+    NETWORK_MESSAGE_CONNECT,
+    NETWORK_MESSAGE_LISTEN,
+    NETWORK_MESSAGE_ACCEPT,
+    NETWORK_MESSAGE_SEND,
+    NETWORK_MESSAGE_RECEIVE,
+    NETWORK_MESSAGE_SHUTDOWN,
+};
+
+struct NetworkEndpoint
+{
+    IPv4Address address;
+    uint16_t port;
+};
+
+// OPEN: `value` is a NetworkSocketType.
+// ATTACH: `value` is the identifier of a connection given by ACCEPT,
+//         it makes the connection this socket.
+// BIND, CONNECT: `endpoint` is the local or the remote end.
+// LISTEN: `value` is the backlog.
+// ACCEPT: replies with the identifier in `value` and the peer in `endpoint`.
+// SEND: replies with what was taken in `value`. UDP sends to `endpoint`,
+//       or to the connected end when it is empty.
+// RECEIVE: `value` is the most wanted, replies with DATA from `endpoint`,
+//          an empty one once a TCP peer is done sending.
+struct NetworkMessage
+{
+    NetworkMessageType type;
+    Result result;
+    NetworkEndpoint endpoint;
+    uint32_t value;
+    uint32_t size;
+};
+
+#define NETWORK_MESSAGE_PAYLOAD_SIZE (4096 - sizeof(NetworkMessage))
+
+struct NetworkConfiguration
+{
+    bool configured;
+    bool shared_rings;
+
+    MacAddress mac_address;
+    IPv4Address address;
+    IPv4Address netmask;
+    IPv4Address gateway;
+    IPv4Address dns;
+    uint32_t lease;
+
+    uint32_t received;
+    uint32_t transmitted;
+    uint32_t dropped;
+    uint32_t batches;
+};
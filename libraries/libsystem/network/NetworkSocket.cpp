@@ -0,0 +1,277 @@
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Connection.h>
+#include <libsystem/io/Socket.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/network/NetworkSocket.h>
+
+struct NetworkSocket
+{
+    Connection *connection;
+};
+
+static Result receive_exactly(Connection *connection, void *buffer, size_t size)
+{
+    size_t received = 0;
+
+    while (received < size)
+    {
+        size_t result = connection_receive(connection, (char *)buffer + received, size - received);
+
+        if (handle_has_error(connection))
+        {
+            return handle_get_error(connection);
+        }
+
+        if (result == 0)
+        {
+            return ERR_STREAM_CLOSED;
+        }
+
+        received += result;
+    }
+
+    return SUCCESS;
+}
+
+// Sends a request and waits for its reply, the payload of the reply is
+// copied to `reply_payload` up to `reply_capacity`.
+static Result request(
+    Connection *connection,
+    NetworkMessage &message,
+    const void *payload,
+    void *reply_payload,
+    size_t reply_capacity)
+{
+    assert(message.size <= NETWORK_MESSAGE_PAYLOAD_SIZE);
+
+    // In one write, a request is one message for the service.
+    char buffer[sizeof(NetworkMessage) + NETWORK_MESSAGE_PAYLOAD_SIZE];
+    memcpy(buffer, &message, sizeof(NetworkMessage));
+    memcpy(buffer + sizeof(NetworkMessage), payload, message.size);
+
+    connection_send(connection, buffer, sizeof(NetworkMessage) + message.size);
+
+    if (handle_has_error(connection))
+    {
+        return handle_get_error(connection);
+    }
+
+    Result result = receive_exactly(connection, &message, sizeof(NetworkMessage));
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (message.size > NETWORK_MESSAGE_PAYLOAD_SIZE)
+    {
+        return ERR_INPUT_OUTPUT;
+    }
+
+    result = receive_exactly(connection, buffer, message.size);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (reply_payload)
+    {
+        message.size = MIN(message.size, reply_capacity);
+        memcpy(reply_payload, buffer, message.size);
+    }
+
+    return message.result;
+}
+
+static Result request(Connection *connection, NetworkMessage &message)
+{
+    return request(connection, message, nullptr, nullptr, 0);
+}
+
+static ResultOr<NetworkSocket *> connect_to_service(NetworkMessage &message)
+{
+    Connection *connection = socket_connect(NETWORK_SERVICE_PATH);
+
+    if (handle_has_error(connection))
+    {
+        Result result = handle_get_error(connection);
+        connection_close(connection);
+        return result;
+    }
+
+    Result result = request(connection, message);
+
+    if (result != SUCCESS)
+    {
+        connection_close(connection);
+        return result;
+    }
+
+    auto socket = new NetworkSocket;
+    socket->connection = connection;
+
+    return socket;
+}
+
+ResultOr<NetworkSocket *> network_socket_open(NetworkSocketType type)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_OPEN;
+    message.value = type;
+
+    return connect_to_service(message);
+}
+
+void network_socket_close(NetworkSocket *socket)
+{
+    connection_close(socket->connection);
+    delete socket;
+}
+
+Result network_socket_bind(NetworkSocket *socket, NetworkEndpoint local)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_BIND;
+    message.endpoint = local;
+
+    return request(socket->connection, message);
+}
+
+Result network_socket_connect(NetworkSocket *socket, NetworkEndpoint remote)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_CONNECT;
+    message.endpoint = remote;
+
+    return request(socket->connection, message);
+}
+
+Result network_socket_listen(NetworkSocket *socket, int backlog)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_LISTEN;
+    message.value = backlog;
+
+    return request(socket->connection, message);
+}
+
+ResultOr<NetworkSocket *> network_socket_accept(NetworkSocket *socket, NetworkEndpoint *peer)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_ACCEPT;
+
+    Result result = request(socket->connection, message);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (peer)
+    {
+        *peer = message.endpoint;
+    }
+
+    NetworkMessage attach = {};
+    attach.type = NETWORK_MESSAGE_ATTACH;
+    attach.value = message.value;
+
+    return connect_to_service(attach);
+}
+
+ResultOr<size_t> network_socket_send(NetworkSocket *socket, const void *buffer, size_t size)
+{
+    size_t sent = 0;
+
+    do
+    {
+        NetworkMessage message = {};
+        message.type = NETWORK_MESSAGE_SEND;
+        message.size = MIN(size - sent, NETWORK_MESSAGE_PAYLOAD_SIZE);
+
+        Result result = request(socket->connection, message, (const char *)buffer + sent, nullptr, 0);
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+
+        sent += message.value;
+    } while (sent < size);
+
+    return sent;
+}
+
+ResultOr<size_t> network_socket_send_to(NetworkSocket *socket, NetworkEndpoint remote, const void *buffer, size_t size)
+{
+    if (size > NETWORK_MESSAGE_PAYLOAD_SIZE)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_SEND;
+    message.endpoint = remote;
+    message.size = size;
+
+    Result result = request(socket->connection, message, buffer, nullptr, 0);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    return (size_t)message.value;
+}
+
+ResultOr<size_t> network_socket_receive(NetworkSocket *socket, void *buffer, size_t size, NetworkEndpoint *from)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_RECEIVE;
+    message.value = MIN(size, NETWORK_MESSAGE_PAYLOAD_SIZE);
+
+    Result result = request(socket->connection, message, nullptr, buffer, size);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (from)
+    {
+        *from = message.endpoint;
+    }
+
+    return (size_t)message.size;
+}
+
+Result network_socket_shutdown(NetworkSocket *socket)
+{
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_SHUTDOWN;
+
+    return request(socket->connection, message);
+}
+
+Result network_get_configuration(NetworkConfiguration *configuration)
+{
+    Connection *connection = socket_connect(NETWORK_SERVICE_PATH);
+
+    if (handle_has_error(connection))
+    {
+        Result result = handle_get_error(connection);
+        connection_close(connection);
+        return result;
+    }
+
+    NetworkMessage message = {};
+    message.type = NETWORK_MESSAGE_GET_CONFIGURATION;
+
+    Result result = request(connection, message, nullptr, configuration, sizeof(NetworkConfiguration));
+
+    connection_close(connection);
+
+    return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <libsystem/network/NetworkProtocol.h>
+#include <libutils/ResultOr.h>
+
+struct NetworkSocket;
+
+ResultOr<NetworkSocket *> network_socket_open(NetworkSocketType type);
+
+void network_socket_close(NetworkSocket *socket);
+
+Result network_socket_bind(NetworkSocket *socket, NetworkEndpoint local);
+
+Result network_socket_connect(NetworkSocket *socket, NetworkEndpoint remote);
+
+Result network_socket_listen(NetworkSocket *socket, int backlog);
+
+ResultOr<NetworkSocket *> network_socket_accept(NetworkSocket *socket, NetworkEndpoint *peer);
+
+// Returns once everything was taken by the service.
+ResultOr<size_t> network_socket_send(NetworkSocket *socket, const void *buffer, size_t size);
+
+// Sends one datagram, at most NETWORK_MESSAGE_PAYLOAD_SIZE bytes.
+ResultOr<size_t> network_socket_send_to(NetworkSocket *socket, NetworkEndpoint remote, const void *buffer, size_t size);
+
+// Zero once a TCP peer is done sending.
+ResultOr<size_t> network_socket_receive(NetworkSocket *socket, void *buffer, size_t size, NetworkEndpoint *from = nullptr);
+
+Result network_socket_shutdown(NetworkSocket *socket);
+
+Result network_get_configuration(NetworkConfiguration *configuration);
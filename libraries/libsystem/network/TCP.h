@@ -0,0 +1,53 @@
+#pragma once
+
+#include <libutils/Endian.h>
+
+#define TCP_FIN (1 << 0)
+#define TCP_SYN (1 << 1)
+#define TCP_RST (1 << 2)
+#define TCP_PSH (1 << 3)
+#define TCP_ACK (1 << 4)
+#define TCP_URG (1 << 5)
+
+#define TCP_OPTION_END (0)
+#define TCP_OPTION_NOP (1)
+#define TCP_OPTION_MSS (2)
+#define TCP_OPTION_WINDOW_SCALE (3)
+#define TCP_OPTION_SACK_PERMITTED (4)
+#define TCP_OPTION_SACK (5)
+
+// RFC 7323 caps the shift so the window stays under 1GiB.
+#define TCP_MAX_WINDOW_SCALE (14)
+
+// Options are 40 bytes at most, 4 SACK blocks with their kind, length
+// and two NOPs to align them.
+#define TCP_MAX_OPTIONS_SIZE (40)
+#define TCP_MAX_SACK_BLOCKS (4)
+
+struct __packed TCPHeader
+{
+    be_uint16_t source_port;
+    be_uint16_t destination_port;
+    be_uint32_t sequence;
+    be_uint32_t acknowledgment;
+    uint8_t data_offset;
+    uint8_t flags;
+    be_uint16_t window;
+    be_uint16_t checksum;
+    be_uint16_t urgent;
+
+    size_t header_size() const { return (data_offset >> 4) * 4; }
+};
+
+static_assert(sizeof(TCPHeader) == 20);
+
+// Sequence numbers wrap around, they are compared by their distance.
+static inline bool tcp_sequence_before(uint32_t left, uint32_t right)
+{
+    return (int32_t)(left - right) < 0;
+}
+
+static inline bool tcp_sequence_before_or_equal(uint32_t left, uint32_t right)
+{
+    return (int32_t)(left - right) <= 0;
+}
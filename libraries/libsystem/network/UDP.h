@@ -0,0 +1,13 @@
+#pragma once
+
+#include <libutils/Endian.h>
+
+struct __packed UDPHeader
+{
+    be_uint16_t source_port;
+    be_uint16_t destination_port;
+    be_uint16_t length;
+    be_uint16_t checksum;
+};
+
+static_assert(sizeof(UDPHeader) == 8);
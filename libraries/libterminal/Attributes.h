@@ -64,6 +64,26 @@ struct Attributes
         return attr;
     }
 
+    uint16_t pack() const
+    {
+        return foreground |
+               (background << 5) |
+               (bold << 10) |
+               (invert << 11) |
+               (underline << 12);
+    }
+
+    static Attributes unpack(uint16_t packed)
+    {
+        return {
+            (Color)(packed & 0x1f),
+            (Color)((packed >> 5) & 0x1f),
+            (bool)((packed >> 10) & 1),
+            (bool)((packed >> 11) & 1),
+            (bool)((packed >> 12) & 1),
+        };
+    }
+
     bool operator==(const Attributes &other) const
     {
         return foreground == other.foreground &&
@@ -9,7 +9,17 @@ struct Cell
 {
     Codepoint codepoint;
     Attributes attributes;
-    bool dirty;
+
+    bool operator==(const Cell &other) const
+    {
+        return codepoint == other.codepoint &&
+               attributes == other.attributes;
+    }
+
+    bool operator!=(const Cell &other) const
+    {
+        return !(*this == other);
+    }
 };
 
 } // namespace terminal
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <libsystem/math/MinMax.h>
+
+namespace terminal
+{
+
+// Span of columns [from, to) of a line which changed since the last time
+// it was repainted.
+struct Damage
+{
+    int from;
+    int to;
+
+    static Damage none() { return {0, 0}; }
+
+    bool any() const { return from < to; }
+
+    Damage merged_with(int from_x, int to_x) const
+    {
+        if (!any())
+        {
+            return {from_x, to_x};
+        }
+
+        return {MIN(from, from_x), MAX(to, to_x)};
+    }
+};
+
+} // namespace terminal
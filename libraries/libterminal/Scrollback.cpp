@@ -0,0 +1,192 @@
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/unicode/Codepoint.h>
+#include <libterminal/Scrollback.h>
+
+namespace terminal
+{
+
+static constexpr Cell BLANK_CELL = {U' ', {FOREGROUND, BACKGROUND, false, false, false}};
+
+// A run is encoded as: packed attributes (2 bytes), codepoint count
+// (2 bytes), followed by the utf8 encoded codepoints.
+static constexpr size_t RUN_HEADER_SIZE = 4;
+
+static constexpr size_t MAX_UTF8_SIZE = 4;
+
+// Stored in place of what utf8 can't encode, every codepoint counted in a
+// run has to take at least one byte.
+static constexpr Codepoint REPLACEMENT_CHARACTER = 0xFFFD;
+
+Scrollback::Scrollback(int capacity)
+{
+    resize(capacity);
+}
+
+Scrollback::~Scrollback()
+{
+    for (int i = 0; i < _capacity; i++)
+    {
+        free(_lines[i].data);
+    }
+
+    free(_lines);
+    free(_scratch);
+}
+
+void Scrollback::clear()
+{
+    _head = 0;
+    _count = 0;
+}
+
+void Scrollback::resize(int capacity)
+{
+    capacity = MAX(capacity, 0);
+
+    ScrollbackLine *new_lines = (ScrollbackLine *)calloc(MAX(capacity, 1), sizeof(ScrollbackLine));
+
+    // Keep the most recent lines.
+    int kept = MIN(_count, capacity);
+
+    for (int i = 0; i < _count; i++)
+    {
+        ScrollbackLine &old_line = _lines[(_head + i) % _capacity];
+
+        if (i >= _count - kept)
+        {
+            new_lines[i - (_count - kept)] = old_line;
+        }
+        else
+        {
+            free(old_line.data);
+        }
+    }
+
+    for (int i = _count; i < _capacity; i++)
+    {
+        free(_lines[(_head + i) % _capacity].data);
+    }
+
+    free(_lines);
+
+    _lines = new_lines;
+    _capacity = capacity;
+    _head = 0;
+    _count = kept;
+}
+
+void Scrollback::push(const Cell *cells, int width)
+{
+    if (_capacity == 0)
+    {
+        return;
+    }
+
+    int used = width;
+
+    while (used > 0 && cells[used - 1] == BLANK_CELL)
+    {
+        used--;
+    }
+
+    size_t worst_size = used * (RUN_HEADER_SIZE + MAX_UTF8_SIZE) + 1;
+
+    if (_scratch_size < worst_size)
+    {
+        _scratch = (uint8_t *)realloc(_scratch, worst_size);
+        _scratch_size = worst_size;
+    }
+
+    size_t size = 0;
+    int x = 0;
+
+    while (x < used)
+    {
+        uint16_t attributes = cells[x].attributes.pack();
+        size_t header = size;
+        size += RUN_HEADER_SIZE;
+
+        uint16_t length = 0;
+
+        while (x < used && cells[x].attributes.pack() == attributes)
+        {
+            int encoded = codepoint_to_utf8(cells[x].codepoint, _scratch + size);
+
+            if (encoded == 0)
+            {
+                encoded = codepoint_to_utf8(REPLACEMENT_CHARACTER, _scratch + size);
+            }
+
+            size += encoded;
+            length++;
+            x++;
+        }
+
+        _scratch[header + 0] = attributes & 0xff;
+        _scratch[header + 1] = attributes >> 8;
+        _scratch[header + 2] = length & 0xff;
+        _scratch[header + 3] = length >> 8;
+    }
+
+    int index;
+
+    if (_count < _capacity)
+    {
+        index = (_head + _count) % _capacity;
+        _count++;
+    }
+    else
+    {
+        index = _head;
+        _head = (_head + 1) % _capacity;
+    }
+
+    ScrollbackLine &line = _lines[index];
+
+    if (line.capacity < size)
+    {
+        line.data = (uint8_t *)realloc(line.data, size);
+        line.capacity = size;
+    }
+
+    memcpy(line.data, _scratch, size);
+    line.size = size;
+}
+
+void Scrollback::line(int index, Cell *cells, int width) const
+{
+    assert(index >= 0 && index < _count);
+
+    const ScrollbackLine &line = _lines[(_head + index) % _capacity];
+
+    int x = 0;
+    size_t offset = 0;
+
+    while (offset < line.size)
+    {
+        Attributes attributes = Attributes::unpack(line.data[offset] | (line.data[offset + 1] << 8));
+        uint16_t length = line.data[offset + 2] | (line.data[offset + 3] << 8);
+        offset += RUN_HEADER_SIZE;
+
+        for (uint16_t i = 0; i < length && offset < line.size; i++)
+        {
+            Codepoint codepoint = 0;
+            offset += utf8_to_codepoint(line.data + offset, &codepoint);
+
+            if (x < width)
+            {
+                cells[x] = {codepoint, attributes};
+                x++;
+            }
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        cells[x] = BLANK_CELL;
+    }
+}
+
+} // namespace terminal
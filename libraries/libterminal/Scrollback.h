@@ -0,0 +1,52 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libterminal/Cell.h>
+
+namespace terminal
+{
+
+// Lines that scrolled off the screen are kept as runs of
+// (attributes, utf8 text) with the trailing blank cells dropped,
+// most of them end up being a few bytes instead of width * sizeof(Cell).
+struct ScrollbackLine
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+};
+
+class Scrollback
+{
+private:
+    ScrollbackLine *_lines = nullptr;
+    int _capacity = 0;
+    int _head = 0;
+    int _count = 0;
+
+    uint8_t *_scratch = nullptr;
+    size_t _scratch_size = 0;
+
+public:
+    int count() const { return _count; }
+
+    int capacity() const { return _capacity; }
+
+    Scrollback(int capacity);
+
+    ~Scrollback();
+
+    __noncopyable(Scrollback);
+    __nonmovable(Scrollback);
+
+    void clear();
+
+    void resize(int capacity);
+
+    void push(const Cell *cells, int width);
+
+    // Index 0 is the oldest line, count() - 1 the most recent one.
+    void line(int index, Cell *cells, int width) const;
+};
+
+} // namespace terminal
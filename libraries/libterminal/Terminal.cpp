@@ -1,19 +1,95 @@
 
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
 #include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
 #include <libsystem/math/MinMax.h>
 #include <libterminal/Terminal.h>
 
 namespace terminal
 {
 
-Terminal::Terminal(int width, int height)
+static bool is_printable(uint8_t c)
+{
+    return c >= 0x20 && c < 0x7f;
+}
+
+// Length of the run of printable ascii at the start of the buffer, this is
+// what most of the terminal output looks like and it doesn't need to go
+// through the utf8 decoder nor the escape sequence state machine.
+static size_t printable_run(const char *buffer, size_t size)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(buffer);
+    size_t offset = 0;
+
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i del = _mm_set1_epi8(0x7f);
+
+    while (offset + 16 <= size)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + offset));
+
+        // Bytes >= 0x80 are negative when compared as signed, so this catch
+        // both control characters and utf8 sequences.
+        __m128i special = _mm_or_si128(
+            _mm_cmplt_epi8(chunk, space),
+            _mm_cmpeq_epi8(chunk, del));
+
+        int mask = _mm_movemask_epi8(special);
+
+        if (mask != 0)
+        {
+            return offset + __builtin_ctz(mask);
+        }
+
+        offset += 16;
+    }
+#else
+    constexpr uintptr_t ONES = ~(uintptr_t)0 / 255;
+    constexpr uintptr_t HIGHS = ONES * 0x80;
+
+    while (offset + sizeof(uintptr_t) <= size)
+    {
+        uintptr_t word;
+        memcpy(&word, bytes + offset, sizeof(uintptr_t));
+
+        uintptr_t below_space = (word - ONES * 0x20) & ~word & HIGHS;
+        uintptr_t is_del = ((word ^ (ONES * 0x7f)) - ONES) & ~(word ^ (ONES * 0x7f)) & HIGHS;
+        uintptr_t non_ascii = word & HIGHS;
+
+        if (below_space | is_del | non_ascii)
+        {
+            break;
+        }
+
+        offset += sizeof(uintptr_t);
+    }
+#endif
+
+    while (offset < size && is_printable(bytes[offset]))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+Terminal::Terminal(int width, int height, int scrollback)
+    : _scrollback(scrollback)
 {
     _width = width;
     _height = height;
     _buffer = (Cell *)calloc(_width * _height, sizeof(Cell));
+    _damages = (Damage *)calloc(_height, sizeof(Damage));
+    _top = 0;
 
     _decoder.callback([this](auto codepoint) { write(codepoint); });
 
+    _state = State::WAIT_ESC;
+
     _cursor = {0, 0, true};
     _saved_cursor = {0, 0, true};
 
@@ -33,13 +109,22 @@ Terminal::Terminal(int width, int height)
 Terminal::~Terminal()
 {
     free(_buffer);
+    free(_damages);
+}
+
+void Terminal::invalidate()
+{
+    for (int y = 0; y < _height; y++)
+    {
+        _damages[y] = {0, _width};
+    }
 }
 
 void Terminal::clear(int fromx, int fromy, int tox, int toy)
 {
     for (int i = fromx + fromy * _width; i < tox + toy * _width; i++)
     {
-        set_cell(i % _width, i / _width, (Cell){U' ', _attributes, true});
+        set_cell(i % _width, i / _width, {U' ', _attributes});
     }
 }
 
@@ -48,14 +133,18 @@ void Terminal::clear_all()
     Terminal::clear(0, 0, _width, _height);
 }
 
-void Terminal::clear_line(int line)
+void Terminal::clear_line(int y)
 {
-    if (line >= 0 && line < _height)
+    if (y >= 0 && y < _height)
     {
-        for (int i = 0; i < _width; i++)
+        Cell *cells = line(y);
+
+        for (int x = 0; x < _width; x++)
         {
-            set_cell(i, line, (Cell){U' ', _attributes, true});
+            cells[x] = {U' ', _attributes};
         }
+
+        _damages[y] = {0, _width};
     }
 }
 
@@ -65,42 +154,75 @@ void Terminal::resize(int width, int height)
 
     for (int i = 0; i < width * height; i++)
     {
-        new_buffer[i] = {U' ', _attributes, true};
+        new_buffer[i] = {U' ', _attributes};
     }
 
-    for (int x = 0; x < MIN(width, _width); x++)
+    for (int y = 0; y < MIN(height, _height); y++)
     {
-        for (int y = 0; y < MIN(height, _height); y++)
+        Cell *cells = line(y);
+
+        for (int x = 0; x < MIN(width, _width); x++)
         {
-            new_buffer[y * width + x] = cell_at(x, y);
+            new_buffer[y * width + x] = cells[x];
         }
     }
 
     free(_buffer);
     _buffer = new_buffer;
+    _top = 0;
+
+    free(_damages);
+    _damages = (Damage *)calloc(height, sizeof(Damage));
 
     _width = width;
     _height = height;
 
+    invalidate();
+
     _cursor.x = clamp(_cursor.x, 0, width - 1);
     _cursor.y = clamp(_cursor.y, 0, height - 1);
+
+    _saved_cursor.x = clamp(_saved_cursor.x, 0, width - 1);
+    _saved_cursor.y = clamp(_saved_cursor.y, 0, height - 1);
 }
 
 Cell Terminal::cell_at(int x, int y)
 {
     if (x >= 0 && x < _width && y >= 0 && y < _height)
     {
-        return _buffer[y * _width + x];
+        return line(y)[x];
     }
 
-    return {U' ', _attributes, true};
+    return {U' ', _attributes};
 }
 
-void Terminal::cell_undirty(int x, int y)
+const Cell *Terminal::cells(int y)
 {
-    if (x >= 0 && x < _width && y >= 0 && y < _height)
+    assert(y >= 0 && y < _height);
+
+    return line(y);
+}
+
+Damage Terminal::line_damage(int y)
+{
+    if (y >= 0 && y < _height)
     {
-        _buffer[y * _width + x].dirty = false;
+        return _damages[y];
+    }
+
+    return Damage::none();
+}
+
+bool Terminal::line_dirty(int y)
+{
+    return line_damage(y).any();
+}
+
+void Terminal::line_undirty(int y)
+{
+    if (y >= 0 && y < _height)
+    {
+        _damages[y] = Damage::none();
     }
 }
 
@@ -109,13 +231,12 @@ void Terminal::set_cell(int x, int y, Cell cell)
     if (x >= 0 && x < _width &&
         y >= 0 && y < _height)
     {
-        Cell old_cell = _buffer[y * _width + x];
+        Cell &old_cell = line(y)[x];
 
-        if (old_cell.codepoint != cell.codepoint ||
-            old_cell.attributes != cell.attributes)
+        if (old_cell != cell)
         {
-            _buffer[y * _width + x] = cell;
-            _buffer[y * _width + x].dirty = true;
+            old_cell = cell;
+            _damages[y] = _damages[y].merged_with(x, x + 1);
         }
     }
 }
@@ -160,42 +281,31 @@ void Terminal::cursor_move(int offx, int offy)
 
 void Terminal::cursor_set(int x, int y)
 {
-    _cursor.x = clamp(x, 0, _width);
-    _cursor.y = clamp(y, 0, _height);
+    _cursor.x = clamp(x, 0, _width - 1);
+    _cursor.y = clamp(y, 0, _height - 1);
 }
 
 void Terminal::scroll(int how_many_line)
 {
     if (how_many_line < 0)
     {
-        for (int line = 0; line < how_many_line; line++)
+        for (int i = 0; i < -how_many_line; i++)
         {
-            for (int i = (_width * _height) - 1; i >= _height; i++)
-            {
-                int x = i % _width;
-                int y = i / _width;
-
-                set_cell(x, y, cell_at(x, y - 1));
-            }
-
+            _top = (_top + _height - 1) % _height;
             clear_line(0);
         }
     }
     else if (how_many_line > 0)
     {
-        for (int line = 0; line < how_many_line; line++)
+        for (int i = 0; i < how_many_line; i++)
         {
-            for (int i = 0; i < _width * (_height - 1); i++)
-            {
-                int x = i % _width;
-                int y = i / _width;
-
-                set_cell(x, y, cell_at(x, y + 1));
-            }
-
+            _scrollback.push(line(0), _width);
+            _top = (_top + 1) % _height;
             clear_line(_height - 1);
         }
     }
+
+    invalidate();
 }
 
 void Terminal::new_line()
@@ -228,11 +338,32 @@ void Terminal::append(Codepoint codepoint)
     }
     else
     {
-        set_cell(_cursor.x, _cursor.y, {codepoint, _attributes, true});
+        set_cell(_cursor.x, _cursor.y, {codepoint, _attributes});
         cursor_move(1, 0);
     }
 }
 
+void Terminal::append(const char *text, size_t size)
+{
+    while (size > 0)
+    {
+        size_t count = MIN(size, (size_t)(_width - _cursor.x));
+        Cell *cells = line(_cursor.y);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            cells[_cursor.x + i] = {(Codepoint)text[i], _attributes};
+        }
+
+        _damages[_cursor.y] = _damages[_cursor.y].merged_with(_cursor.x, _cursor.x + count);
+
+        cursor_move(count, 0);
+
+        text += count;
+        size -= count;
+    }
+}
+
 void Terminal::do_ansi(Codepoint codepoint)
 {
     switch (codepoint)
@@ -375,22 +506,22 @@ void Terminal::do_ansi(Codepoint codepoint)
     case U'S':
         if (_parameters[0].empty)
         {
-            scroll(-1);
+            scroll(1);
         }
         else
         {
-            scroll(-_parameters[0].value);
+            scroll(_parameters[0].value);
         }
         break;
 
     case U'T':
         if (_parameters[0].empty)
         {
-            scroll(1);
+            scroll(-1);
         }
         else
         {
-            scroll(_parameters[0].value);
+            scroll(-_parameters[0].value);
         }
         break;
 
@@ -528,9 +659,25 @@ void Terminal::write(char c)
 
 void Terminal::write(const char *buffer, size_t size)
 {
-    for (size_t i = 0; i < size; i++)
+    size_t offset = 0;
+
+    while (offset < size)
     {
-        write(buffer[i]);
+        if (_state == State::WAIT_ESC && !_decoder.decoding())
+        {
+            size_t run = printable_run(buffer + offset, size - offset);
+
+            if (run > 0)
+            {
+                append(buffer + offset, run);
+                offset += run;
+
+                continue;
+            }
+        }
+
+        write(buffer[offset]);
+        offset++;
     }
 }
 
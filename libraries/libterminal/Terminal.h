@@ -4,6 +4,8 @@
 #include <libterminal/Attributes.h>
 #include <libterminal/Cell.h>
 #include <libterminal/Cursor.h>
+#include <libterminal/Damage.h>
+#include <libterminal/Scrollback.h>
 
 namespace terminal
 {
@@ -26,7 +28,14 @@ struct Terminal
 private:
     int _height;
     int _width;
+
+    // The screen is a ring of rows, scrolling only moves _top around.
     Cell *_buffer;
+    Damage *_damages;
+    int _top;
+
+    Scrollback _scrollback;
+
     UTF8Decoder _decoder;
 
     State _state;
@@ -39,14 +48,25 @@ private:
     int _parameters_top;
     Parameter _parameters[MAX_PARAMETERS];
 
+    Cell *line(int y)
+    {
+        return &_buffer[((_top + y) % _height) * _width];
+    }
+
+    void invalidate();
+
 public:
+    static constexpr int DEFAULT_SCROLLBACK = 1000;
+
     int width() { return _width; }
 
     int height() { return _height; }
 
     const Cursor &cursor() { return _cursor; }
 
-    Terminal(int width, int height);
+    Scrollback &scrollback() { return _scrollback; }
+
+    Terminal(int width, int height, int scrollback = DEFAULT_SCROLLBACK);
 
     ~Terminal();
 
@@ -60,7 +80,13 @@ public:
 
     Cell cell_at(int x, int y);
 
-    void cell_undirty(int x, int y);
+    const Cell *cells(int y);
+
+    Damage line_damage(int y);
+
+    bool line_dirty(int y);
+
+    void line_undirty(int y);
 
     void set_cell(int x, int y, Cell cell);
 
@@ -76,6 +102,8 @@ public:
 
     void append(Codepoint codepoint);
 
+    void append(const char *text, size_t size);
+
     void do_ansi(Codepoint codepoint);
 
     void write(Codepoint codepoint);
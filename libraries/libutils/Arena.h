@@ -0,0 +1,436 @@
+#pragma once
+
+#include <type_traits>
+
+#include <libsystem/Assert.h>
+#include <libsystem/Common.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/Iteration.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
+#include <libutils/StringView.h>
+
+// Bump allocator over a list of large chunks. Allocating is a pointer
+// increment, nothing is freed on its own: the whole arena is released at
+// once, or rolled back to a marker taken earlier. Meant for trees built in
+// one go and dropped together, like a parsed document or a shell command.
+//
+// Destructors are never run, only trivially destructible types can live
+// in an arena.
+class Arena
+{
+private:
+    struct Chunk
+    {
+        Chunk *next; // The previous, older, chunk.
+        size_t used;
+        size_t size;
+        alignas(16) char data[];
+    };
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    Chunk *_current = nullptr;
+
+    // The last standard sized chunk given back by a reset, kept around so a
+    // scope that grows past its chunk doesn't hit malloc every time.
+    Chunk *_spare = nullptr;
+
+    size_t _chunk_size = DEFAULT_CHUNK_SIZE;
+
+    static size_t align_up(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    void push_chunk(size_t needed)
+    {
+        Chunk *chunk = nullptr;
+
+        if (needed <= _chunk_size && _spare)
+        {
+            chunk = _spare;
+            _spare = nullptr;
+        }
+        else
+        {
+            size_t size = MAX(needed, _chunk_size);
+            chunk = (Chunk *)malloc(sizeof(Chunk) + size);
+            chunk->size = size;
+        }
+
+        chunk->next = _current;
+        chunk->used = 0;
+
+        _current = chunk;
+    }
+
+    void release_chunk(Chunk *chunk)
+    {
+        if (!_spare && chunk->size == _chunk_size)
+        {
+            _spare = chunk;
+        }
+        else
+        {
+            free(chunk);
+        }
+    }
+
+public:
+    struct Marker
+    {
+        void *chunk;
+        size_t used;
+    };
+
+    Arena() {}
+
+    Arena(size_t chunk_size) : _chunk_size(chunk_size) {}
+
+    Arena(Arena &&other)
+    {
+        swap(_current, other._current);
+        swap(_spare, other._spare);
+        swap(_chunk_size, other._chunk_size);
+    }
+
+    Arena &operator=(Arena &&other)
+    {
+        if (this != &other)
+        {
+            swap(_current, other._current);
+            swap(_spare, other._spare);
+            swap(_chunk_size, other._chunk_size);
+        }
+
+        return *this;
+    }
+
+    ~Arena()
+    {
+        while (_current)
+        {
+            Chunk *next = _current->next;
+            free(_current);
+            _current = next;
+        }
+
+        free(_spare);
+    }
+
+    __noncopyable(Arena);
+
+    void *allocate(size_t size, size_t align = 8)
+    {
+        assert(align <= 16 && (align & (align - 1)) == 0);
+
+        if (_current)
+        {
+            size_t offset = align_up(_current->used, align);
+
+            if (offset + size <= _current->size)
+            {
+                _current->used = offset + size;
+                return &_current->data[offset];
+            }
+        }
+
+        push_chunk(size);
+        _current->used = size;
+
+        return &_current->data[0];
+    }
+
+    // Grow or shrink `pointer` which must come from this arena. If it was
+    // the last allocation and there is room behind it, it is resized in
+    // place, otherwise the content is copied to a new allocation.
+    void *reallocate(void *pointer, size_t old_size, size_t new_size, size_t align = 8)
+    {
+        if (pointer && _current &&
+            (char *)pointer + old_size == &_current->data[_current->used] &&
+            (size_t)((char *)pointer - _current->data) + new_size <= _current->size)
+        {
+            _current->used = (char *)pointer - _current->data + new_size;
+            return pointer;
+        }
+
+        void *result = allocate(new_size, align);
+
+        if (pointer)
+        {
+            memcpy(result, pointer, MIN(old_size, new_size));
+        }
+
+        return result;
+    }
+
+    template <typename T, typename... TArgs>
+    T *make(TArgs &&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never run destructors");
+
+        return new (allocate(sizeof(T), alignof(T))) T(forward<TArgs>(args)...);
+    }
+
+    template <typename T>
+    T *make_array(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never run destructors");
+
+        T *array = (T *)allocate(sizeof(T) * count, alignof(T));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&array[i]) T();
+        }
+
+        return array;
+    }
+
+    // Copy of `view` followed by a null terminator.
+    StringView copy(StringView view)
+    {
+        char *buffer = (char *)allocate(view.length() + 1, 1);
+
+        memcpy(buffer, view.buffer(), view.length());
+        buffer[view.length()] = '\0';
+
+        return {buffer, view.length()};
+    }
+
+    char *copy_cstring(StringView view)
+    {
+        return const_cast<char *>(copy(view).buffer());
+    }
+
+    Marker mark() const
+    {
+        return {_current, _current ? _current->used : 0};
+    }
+
+    // Free everything allocated after `marker` was taken.
+    void reset(Marker marker)
+    {
+        while (_current && _current != marker.chunk)
+        {
+            Chunk *next = _current->next;
+            release_chunk(_current);
+            _current = next;
+        }
+
+        if (_current)
+        {
+            _current->used = marker.used;
+        }
+    }
+
+    // Free everything, the first chunk is kept for what comes next.
+    void reset()
+    {
+        while (_current && _current->next)
+        {
+            Chunk *next = _current->next;
+            release_chunk(_current);
+            _current = next;
+        }
+
+        if (_current)
+        {
+            _current->used = 0;
+        }
+    }
+
+    // Bytes handed out, alignment padding and the spare chunk excluded.
+    size_t used() const
+    {
+        size_t total = 0;
+
+        for (Chunk *chunk = _current; chunk; chunk = chunk->next)
+        {
+            total += chunk->used;
+        }
+
+        return total;
+    }
+
+    size_t reserved() const
+    {
+        size_t total = 0;
+
+        for (Chunk *chunk = _current; chunk; chunk = chunk->next)
+        {
+            total += chunk->size;
+        }
+
+        return total;
+    }
+};
+
+// Roll the arena back to where it was when the scope was entered.
+class ArenaScope
+{
+private:
+    Arena &_arena;
+    Arena::Marker _marker;
+
+public:
+    ArenaScope(Arena &arena)
+        : _arena(arena),
+          _marker(arena.mark())
+    {
+    }
+
+    ~ArenaScope()
+    {
+        _arena.reset(_marker);
+    }
+
+    __noncopyable(ArenaScope);
+    __nonmovable(ArenaScope);
+};
+
+// Growable array living in an arena. Growing in place is free as long as
+// nothing else was allocated from the arena in between, otherwise the
+// items are copied and the old storage is left until the arena is reset.
+template <typename T>
+class ArenaVector
+{
+private:
+    Arena *_arena = nullptr;
+    T *_storage = nullptr;
+    size_t _count = 0;
+    size_t _capacity = 0;
+
+public:
+    size_t count() const { return _count; }
+
+    bool empty() const { return _count == 0; }
+
+    bool any() const { return _count > 0; }
+
+    T *raw_storage() { return _storage; }
+
+    const T *raw_storage() const { return _storage; }
+
+    ArenaVector() {}
+
+    ArenaVector(Arena &arena, size_t capacity = 0)
+        : _arena(&arena)
+    {
+        reserve(capacity);
+    }
+
+    void reserve(size_t capacity)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "ArenaVector moves items with memcpy");
+
+        if (capacity <= _capacity)
+        {
+            return;
+        }
+
+        size_t new_capacity = MAX(MAX(_capacity * 2, capacity), 4);
+
+        _storage = (T *)_arena->reallocate(_storage, sizeof(T) * _capacity, sizeof(T) * new_capacity, alignof(T));
+        _capacity = new_capacity;
+    }
+
+    T &operator[](size_t index)
+    {
+        assert(index < _count);
+        return _storage[index];
+    }
+
+    const T &operator[](size_t index) const
+    {
+        assert(index < _count);
+        return _storage[index];
+    }
+
+    T &push_back(const T &value)
+    {
+        reserve(_count + 1);
+
+        new (&_storage[_count]) T(value);
+
+        return _storage[_count++];
+    }
+
+    T pop_back()
+    {
+        assert(_count > 0);
+        return _storage[--_count];
+    }
+
+    void clear()
+    {
+        _count = 0;
+    }
+
+    template <typename TCallback>
+    Iteration foreach (TCallback callback)
+    {
+        for (size_t i = 0; i < _count; i++)
+        {
+            if (callback(_storage[i]) == Iteration::STOP)
+            {
+                return Iteration::STOP;
+            }
+        }
+
+        return Iteration::CONTINUE;
+    }
+
+    T *begin() { return _storage; }
+
+    T *end() { return _storage + _count; }
+
+    const T *begin() const { return _storage; }
+
+    const T *end() const { return _storage + _count; }
+};
+
+// StringBuilder counterpart writing straight into an arena, the result
+// stays valid until the arena is reset.
+class ArenaString
+{
+private:
+    ArenaVector<char> _chars;
+
+public:
+    size_t length() const { return _chars.count(); }
+
+    ArenaString(Arena &arena, size_t capacity = 16)
+        : _chars(arena, capacity + 1)
+    {
+    }
+
+    void append(char chr)
+    {
+        _chars.push_back(chr);
+    }
+
+    void append(StringView view)
+    {
+        _chars.reserve(_chars.count() + view.length());
+
+        for (size_t i = 0; i < view.length(); i++)
+        {
+            _chars.push_back(view[i]);
+        }
+    }
+
+    // Null terminated, appending more afterward is not allowed.
+    StringView finalize()
+    {
+        _chars.push_back('\0');
+        return {_chars.raw_storage(), _chars.count() - 1};
+    }
+
+    char *finalize_cstring()
+    {
+        return const_cast<char *>(finalize().buffer());
+    }
+};
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <libsystem/io/Stream.h>
 #include <libsystem/process/Process.h>
 
 #include <libutils/Callback.h>
-#include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
 #include <libutils/String.h>
 #include <libutils/Traits.h>
 #include <libutils/Vector.h>
@@ -248,7 +249,7 @@ public:
         while (context.any())
         {
             auto current = context.pop();
-            StringScanner scan{current.cstring(), current.length()};
+            SpanScanner scan{current.cstring(), current.length()};
 
             if (scan.skip_word("--"))
             {
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <libsystem/thread/Lock.h>
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+#include <libutils/StringView.h>
+
+// Interned string, atoms with the same content share the same storage so
+// comparing and hashing them doesn't look at the chars. Meant for
+// identifiers which are repeated a lot like json keys, markup attributes
+// or widget ids, atoms are never freed.
+class Atom
+{
+private:
+    struct Storage
+    {
+        uint32_t hash;
+        size_t length;
+        char cstring[];
+    };
+
+    // The empty atom has no storage, default constructing one or looking up
+    // an empty key doesn't have to take the lock.
+    const Storage *_storage = nullptr;
+
+    static inline Lock _lock{};
+    static inline HashMap<StringView, const Storage *> *_atoms = nullptr;
+
+    static const Storage *find(StringView view)
+    {
+        if (!_atoms)
+        {
+            return nullptr;
+        }
+
+        auto storage = _atoms->find(view);
+
+        return storage ? *storage : nullptr;
+    }
+
+    static const Storage *intern(const char *cstring, size_t length)
+    {
+        if (length == 0)
+        {
+            return nullptr;
+        }
+
+        LockHolder holder(_lock);
+
+        auto existing = find({cstring, length});
+
+        if (existing)
+        {
+            return existing;
+        }
+
+        if (!_atoms)
+        {
+            _atoms = new HashMap<StringView, const Storage *>();
+        }
+
+        auto storage = (Storage *)malloc(sizeof(Storage) + length + 1);
+
+        storage->hash = ::hash(cstring, length);
+        storage->length = length;
+        memcpy(storage->cstring, cstring, length);
+        storage->cstring[length] = '\0';
+
+        (*_atoms)[{storage->cstring, length}] = storage;
+
+        return storage;
+    }
+
+    explicit Atom(const Storage *storage) : _storage(storage) {}
+
+public:
+    // The atom with the content of `view` if it was interned already. Lookups
+    // go through this: a key nobody inserted can't be in a map of atoms, and
+    // interning every missed key would grow the table forever.
+    static bool lookup(StringView view, Atom *atom)
+    {
+        if (view.length() == 0)
+        {
+            *atom = Atom{};
+            return true;
+        }
+
+        LockHolder holder(_lock);
+
+        auto storage = find(view);
+
+        if (storage)
+        {
+            *atom = Atom{storage};
+        }
+
+        return storage != nullptr;
+    }
+
+    const char *cstring() const { return _storage ? _storage->cstring : ""; }
+
+    size_t length() const { return _storage ? _storage->length : 0; }
+
+    uint32_t hash() const { return _storage ? _storage->hash : ::hash("", 0); }
+
+    StringView view() const { return {cstring(), length()}; }
+
+    String string() const { return {cstring(), length()}; }
+
+    Atom() {}
+
+    Atom(const char *cstring) : Atom(cstring, strlen(cstring)) {}
+
+    Atom(const char *cstring, size_t length) : _storage(intern(cstring, length)) {}
+
+    Atom(const String &string) : Atom(string.cstring(), string.length()) {}
+
+    Atom(StringView view) : Atom(view.buffer(), view.length()) {}
+
+    bool operator==(const Atom &other) const
+    {
+        return _storage == other._storage;
+    }
+
+    bool operator!=(const Atom &other) const
+    {
+        return _storage != other._storage;
+    }
+
+    bool operator==(const char *cstring) const
+    {
+        return view() == cstring;
+    }
+
+    bool operator!=(const char *cstring) const
+    {
+        return view() != cstring;
+    }
+};
+
+template <>
+inline uint32_t hash<Atom>(const Atom &value)
+{
+    return value.hash();
+}
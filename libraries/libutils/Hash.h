@@ -1,17 +1,63 @@
 #pragma once
 
 #include <libsystem/Common.h>
+#include <libsystem/core/CString.h>
+
+// Based on wyhash32, it only needs 32x32->64 multiplications which are
+// cheap on i686 and hash 8 bytes per round instead of one.
+
+static inline void __hash_mix(uint32_t &a, uint32_t &b)
+{
+    uint64_t c = (uint64_t)(a ^ 0x53c5ca59u) * (uint64_t)(b ^ 0x74743c1bu);
+
+    a = (uint32_t)c;
+    b = (uint32_t)(c >> 32);
+}
+
+static inline uint32_t __hash_read32(const uint8_t *bytes)
+{
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline uint32_t __hash_read24(const uint8_t *bytes, size_t size)
+{
+    return ((uint32_t)bytes[0] << 16) |
+           ((uint32_t)bytes[size >> 1] << 8) |
+           (uint32_t)bytes[size - 1];
+}
 
 static inline uint32_t hash(const void *object, size_t size)
 {
-    uint32_t hash = 5381;
+    const uint8_t *bytes = (const uint8_t *)object;
+
+    uint32_t seed = 0;
+    uint32_t see1 = (uint32_t)size;
 
-    for (size_t i = 0; i < size; i++)
+    __hash_mix(seed, see1);
+
+    for (; size > 8; size -= 8, bytes += 8)
+    {
+        seed ^= __hash_read32(bytes);
+        see1 ^= __hash_read32(bytes + 4);
+        __hash_mix(seed, see1);
+    }
+
+    if (size >= 4)
+    {
+        seed ^= __hash_read32(bytes);
+        see1 ^= __hash_read32(bytes + size - 4);
+    }
+    else if (size > 0)
     {
-        hash = ((hash << 5) + hash) + ((const uint8_t *)object)[i];
+        seed ^= __hash_read24(bytes, size);
     }
 
-    return hash;
+    __hash_mix(seed, see1);
+    __hash_mix(seed, see1);
+
+    return seed ^ see1;
 }
 
 template <typename TObject>
@@ -32,3 +78,9 @@ inline uint32_t hash<uint32_t>(const uint32_t &value)
 {
     return hash(&value, sizeof(value));
 }
+
+template <>
+inline uint32_t hash<const char *>(const char *const &value)
+{
+    return hash(value, strlen(value));
+}
@@ -1,9 +1,17 @@
 #pragma once
 
-#include <libsystem/Logger.h>
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
 #include <libutils/Hash.h>
-#include <libutils/Vector.h>
+#include <libutils/Iteration.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
 
+class String;
+
+// Open addressing hash map using robin hood hashing: on collision the
+// item which is the furthest from its ideal slot keeps the slot, which
+// keeps probe sequences short and lets lookups of missing keys stop early.
 template <typename TKey, typename TValue>
 class HashMap
 {
@@ -15,102 +23,245 @@ private:
         TValue value;
     };
 
-    static constexpr int BUCKET_COUNT = 256;
+    struct Slot
+    {
+        // Distance from the ideal slot plus one, 0 means the slot is free.
+        uint32_t distance;
+        alignas(Item) char storage[sizeof(Item)];
 
-    Vector<Vector<Item>> _buckets{};
+        Item &item() { return *reinterpret_cast<Item *>(storage); }
+    };
 
-    Vector<Item> &bucket(uint32_t hash)
-    {
-        return _buckets[hash % BUCKET_COUNT];
-    }
+    static constexpr size_t MIN_CAPACITY = 8;
+
+    Slot *_slots = nullptr;
+    size_t _capacity = 0;
+    size_t _count = 0;
+
+    size_t mask() const { return _capacity - 1; }
 
-    Item *item_by_key(const TKey &key)
+    // Grow when more than 80% of the slots are used.
+    bool should_grow() const { return (_count + 1) * 5 > _capacity * 4; }
+
+    template <typename TLookup>
+    Slot *slot_by_key(const TLookup &key, uint32_t hash) const
     {
-        return item_by_key(key, hash<TKey>(key));
+        if (_count == 0)
+        {
+            return nullptr;
+        }
+
+        size_t index = hash & mask();
+
+        for (uint32_t distance = 1;; distance++)
+        {
+            Slot &slot = _slots[index];
+
+            if (slot.distance < distance)
+            {
+                return nullptr;
+            }
+
+            if (slot.item().hash == hash && slot.item().key == key)
+            {
+                return &slot;
+            }
+
+            index = (index + 1) & mask();
+        }
     }
 
-    Item *item_by_key(const TKey &key, uint32_t hash)
+    Item &insert_new(Item &&item)
     {
-        Item *result = nullptr;
-        auto &b = bucket(hash);
+        if (should_grow())
+        {
+            rehash(_capacity ? _capacity * 2 : MIN_CAPACITY);
+        }
+
+        _count++;
+
+        Slot *inserted = nullptr;
+        size_t index = item.hash & mask();
+        uint32_t distance = 1;
 
-        b.foreach ([&](Item &item) {
-            if (item.hash == hash && item.key == key)
+        while (true)
+        {
+            Slot &slot = _slots[index];
+
+            if (slot.distance == 0)
             {
-                result = &item;
-                return Iteration::STOP;
+                new (&slot.item()) Item(move(item));
+                slot.distance = distance;
+
+                return inserted ? inserted->item() : slot.item();
             }
-            else
+
+            if (slot.distance < distance)
             {
-                return Iteration::CONTINUE;
+                swap(slot.item(), item);
+                swap(slot.distance, distance);
+
+                if (!inserted)
+                {
+                    inserted = &slot;
+                }
             }
-        });
 
-        return result;
+            index = (index + 1) & mask();
+            distance++;
+        }
     }
 
-public:
-    size_t count()
+    void remove_slot(Slot *slot)
     {
-        size_t result = 0;
+        slot->item().~Item();
+        slot->distance = 0;
+        _count--;
 
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        // Backward shift deletion, no tombstones needed.
+        size_t index = slot - _slots;
+        size_t next = (index + 1) & mask();
+
+        while (_slots[next].distance > 1)
         {
-            result += _buckets[i].count();
+            new (&_slots[index].item()) Item(move(_slots[next].item()));
+            _slots[index].distance = _slots[next].distance - 1;
+
+            _slots[next].item().~Item();
+            _slots[next].distance = 0;
+
+            index = next;
+            next = (next + 1) & mask();
         }
+    }
 
-        return result;
+    void rehash(size_t capacity)
+    {
+        Slot *old_slots = _slots;
+        size_t old_capacity = _capacity;
+
+        _slots = (Slot *)calloc(capacity, sizeof(Slot));
+        _capacity = capacity;
+        _count = 0;
+
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (old_slots[i].distance)
+            {
+                insert_new(move(old_slots[i].item()));
+                old_slots[i].item().~Item();
+            }
+        }
+
+        free(old_slots);
     }
 
-    HashMap()
+    void destroy_items()
     {
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        for (size_t i = 0; i < _capacity; i++)
         {
-            _buckets.push_back({});
+            if (_slots[i].distance)
+            {
+                _slots[i].item().~Item();
+                _slots[i].distance = 0;
+            }
         }
+
+        _count = 0;
     }
 
+    template <typename TLookup>
+    TValue &get_or_insert(const TLookup &key, uint32_t hash)
+    {
+        Slot *slot = slot_by_key(key, hash);
+
+        if (slot)
+        {
+            return slot->item().value;
+        }
+
+        return insert_new({hash, TKey(key), {}}).value;
+    }
+
+public:
+    size_t count() const { return _count; }
+
+    bool empty() const { return _count == 0; }
+
+    HashMap() {}
+
     HashMap(const HashMap &other)
-        : _buckets(other._buckets)
     {
+        *this = other;
     }
 
     HashMap(HashMap &&other)
-        : _buckets(move(other._buckets))
     {
+        swap(_slots, other._slots);
+        swap(_capacity, other._capacity);
+        swap(_count, other._count);
+    }
+
+    ~HashMap()
+    {
+        destroy_items();
+        free(_slots);
     }
 
     void clear()
     {
-        _buckets.clear();
+        destroy_items();
     }
 
-    void remove_key(TKey &key)
+    void remove_key(const TKey &key)
     {
-        uint32_t h = hash<TKey>(key);
+        Slot *slot = slot_by_key(key, hash<TKey>(key));
 
-        bucket(h).remove_all_match([&](auto &item) {
-            return item.hash == h && item.key == key;
-        });
+        if (slot)
+        {
+            remove_slot(slot);
+        }
     }
 
-    void remove_value(TValue &value)
+    void remove_key(const char *key) requires IsSame<TKey, String>::value
     {
-        _buckets.foreach ([&](auto &bucket) {
-            bucket.remove_all_match([&](auto &item) {
-                return item.value == value;
-            });
+        Slot *slot = slot_by_key(key, hash<const char *>(key));
 
-            return Iteration::CONTINUE;
-        });
+        if (slot)
+        {
+            remove_slot(slot);
+        }
+    }
+
+    void remove_value(const TValue &value)
+    {
+        size_t i = 0;
+
+        while (i < _capacity)
+        {
+            if (_slots[i].distance && _slots[i].item().value == value)
+            {
+                // The next item might have been shifted in this slot.
+                remove_slot(&_slots[i]);
+            }
+            else
+            {
+                i++;
+            }
+        }
     }
 
-    bool has_key(const TKey &key)
+    bool has_key(const TKey &key) const
     {
-        return item_by_key(key) != nullptr;
+        return slot_by_key(key, hash<TKey>(key)) != nullptr;
     }
 
-    bool has_value(const TValue &value)
+    bool has_key(const char *key) const requires IsSame<TKey, String>::value
+    {
+        return slot_by_key(key, hash<const char *>(key)) != nullptr;
+    }
+
+    bool has_value(const TValue &value) const
     {
         bool result = false;
 
@@ -132,38 +283,70 @@ public:
     template <typename TCallback>
     Iteration foreach (TCallback callback) const
     {
-        return _buckets.foreach ([&](auto &bucket) {
-            return bucket.foreach ([&](auto &item) {
-                return callback(item.key, item.value);
-            });
-        });
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            if (_slots[i].distance)
+            {
+                Item &item = _slots[i].item();
+
+                if (callback(item.key, item.value) == Iteration::STOP)
+                {
+                    return Iteration::STOP;
+                }
+            }
+        }
+
+        return Iteration::CONTINUE;
     }
 
     HashMap &operator=(const HashMap &other)
     {
-        _buckets = other._buckets;
+        if (this != &other)
+        {
+            destroy_items();
+            free(_slots);
+
+            _slots = (Slot *)calloc(other._capacity, sizeof(Slot));
+            _capacity = other._capacity;
+            _count = other._count;
+
+            for (size_t i = 0; i < _capacity; i++)
+            {
+                if (other._slots[i].distance)
+                {
+                    new (&_slots[i].item()) Item(other._slots[i].item());
+                    _slots[i].distance = other._slots[i].distance;
+                }
+            }
+        }
+
         return *this;
     }
 
     HashMap &operator=(HashMap &&other)
     {
-        swap(_buckets, other._buckets);
+        swap(_slots, other._slots);
+        swap(_capacity, other._capacity);
+        swap(_count, other._count);
+
         return *this;
     }
 
+    // The value of `key`, or nullptr without looking twice like has_key()
+    // then operator[] would.
+    TValue *find(const TKey &key)
+    {
+        Slot *slot = slot_by_key(key, hash<TKey>(key));
+        return slot ? &slot->item().value : nullptr;
+    }
+
     TValue &operator[](const TKey &key)
     {
-        auto h = hash<TKey>(key);
-        auto *i = item_by_key(key, h);
+        return get_or_insert(key, hash<TKey>(key));
+    }
 
-        if (i)
-        {
-            return i->value;
-        }
-        else
-        {
-            auto &b = bucket(h);
-            return b.push_back({h, key, {}}).value;
-        }
+    TValue &operator[](const char *key) requires IsSame<TKey, String>::value
+    {
+        return get_or_insert(key, hash<const char *>(key));
     }
 };
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <libsystem/Assert.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/Iteration.h>
+#include <libutils/Sort.h>
+#include <libutils/Vector.h>
+
+// Half open intervals [start, end) with a value, answering "which
+// intervals contain this point" in O(log n + matches).
+//
+// Intervals are kept sorted by start in a flat array viewed as an implicit
+// balanced tree: the middle of a range is the root of its subtree and
+// every node knows the largest end below it. Meant for data added in bulk
+// then queried a lot, like syntax highlighting: adding only marks the tree
+// dirty and the next query sorts and rebuilds it.
+template <typename TKey, typename TValue>
+class IntervalTree
+{
+private:
+    struct Interval
+    {
+        TKey start;
+        TKey end;
+        TValue value;
+    };
+
+    Vector<Interval> _intervals{};
+    Vector<TKey> _max_end{};
+    bool _dirty = false;
+
+    TKey build(size_t low, size_t high)
+    {
+        size_t middle = low + (high - low) / 2;
+        TKey max_end = _intervals[middle].end;
+
+        // MAX() is a macro, don't hand it the recursive calls.
+        if (low < middle)
+        {
+            TKey left = build(low, middle);
+            max_end = MAX(max_end, left);
+        }
+
+        if (middle + 1 < high)
+        {
+            TKey right = build(middle + 1, high);
+            max_end = MAX(max_end, right);
+        }
+
+        _max_end[middle] = max_end;
+
+        return max_end;
+    }
+
+    void rebuild()
+    {
+        _intervals.stable_sort([](auto &left, auto &right) {
+            return (left.start > right.start) - (left.start < right.start);
+        });
+
+        _max_end.clear();
+
+        for (size_t i = 0; i < _intervals.count(); i++)
+        {
+            _max_end.push_back(_intervals[i].end);
+        }
+
+        if (_intervals.any())
+        {
+            build(0, _intervals.count());
+        }
+
+        _dirty = false;
+    }
+
+    template <typename TCallback>
+    Iteration query(size_t low, size_t high, TKey point, TCallback &callback) const
+    {
+        if (low >= high)
+        {
+            return Iteration::CONTINUE;
+        }
+
+        size_t middle = low + (high - low) / 2;
+
+        // Nothing in this subtree ends after the point.
+        if (_max_end[middle] <= point)
+        {
+            return Iteration::CONTINUE;
+        }
+
+        if (query(low, middle, point, callback) == Iteration::STOP)
+        {
+            return Iteration::STOP;
+        }
+
+        // Everything on the right starts after the point.
+        if (point < _intervals[middle].start)
+        {
+            return Iteration::CONTINUE;
+        }
+
+        if (point < _intervals[middle].end &&
+            callback(_intervals[middle].start, _intervals[middle].end, _intervals[middle].value) == Iteration::STOP)
+        {
+            return Iteration::STOP;
+        }
+
+        return query(middle + 1, high, point, callback);
+    }
+
+public:
+    size_t count() const { return _intervals.count(); }
+
+    void add(TKey start, TKey end, TValue value)
+    {
+        assert(start <= end);
+
+        _intervals.push_back({start, end, value});
+        _dirty = true;
+    }
+
+    void clear()
+    {
+        _intervals.clear();
+        _max_end.clear();
+        _dirty = false;
+    }
+
+    // Call `callback(start, end, value)` for every interval containing
+    // `point`, in order of their start.
+    template <typename TCallback>
+    Iteration containing(TKey point, TCallback callback)
+    {
+        if (_dirty)
+        {
+            rebuild();
+        }
+
+        return query(0, _intervals.count(), point, callback);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libsystem/Assert.h>
+#include <libutils/Move.h>
 
 template <typename T>
 class OwnPtr
@@ -140,6 +141,11 @@ public:
     }
 };
 
+template <typename T>
+struct IsTriviallyRelocatable<OwnPtr<T>> : TrueType
+{
+};
+
 template <typename Type, typename... Args>
 inline OwnPtr<Type> own(Args &&...args)
 {
@@ -2,7 +2,7 @@
 
 #include <abi/Filesystem.h>
 
-#include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
 #include <libutils/String.h>
 #include <libutils/StringBuilder.h>
 #include <libutils/Vector.h>
@@ -34,7 +34,7 @@ public:
 
     static Path parse(const char *path, size_t size, int flags)
     {
-        StringScanner scan{path, size};
+        SpanScanner scan{path, size};
 
         bool absolute = false;
 
@@ -43,17 +43,13 @@ public:
             absolute = true;
         }
 
+        // Elements are copied in one go instead of char by char, this is
+        // on the path of every filesystem syscall.
         auto parse_element = [](auto &scan) {
-            StringBuilder builder{};
+            auto element = scan.take_until(PATH_SEPARATOR);
+            scan.skip(PATH_SEPARATOR);
 
-            while (!scan.skip(PATH_SEPARATOR) &&
-                   scan.do_continue())
-            {
-                builder.append(scan.current());
-                scan.foreward();
-            }
-
-            return builder.finalize();
+            return String{element};
         };
 
         auto parse_shorthand = [](auto &scan) {
@@ -120,7 +116,7 @@ public:
     {
     }
 
-    Path(bool absolute, Vector<String> &&elements) : _absolute(absolute), _elements(elements)
+    Path(bool absolute, Vector<String> &&elements) : _absolute(absolute), _elements(move(elements))
     {
     }
 
@@ -152,7 +148,7 @@ public:
         return *this;
     }
 
-    String operator[](size_t index) const
+    const String &operator[](size_t index) const
     {
         return _elements[index];
     }
@@ -225,24 +221,15 @@ public:
 
     String basename_without_extension() const
     {
-        StringBuilder builder{basename().length()};
+        auto filename = basename();
 
-        StringScanner scan{basename().cstring(), basename().length()};
+        SpanScanner scan{filename.view()};
 
         // It's not a file extention it's an hidden file.
-        if (scan.current_is("."))
-        {
-            builder.append(scan.current());
-            scan.foreward();
-        }
+        scan.skip('.');
+        scan.take_until('.');
 
-        while (!scan.current_is(".") && scan.do_continue())
-        {
-            builder.append(scan.current());
-            scan.foreward();
-        }
-
-        return builder.finalize();
+        return String{filename.view().substring(0, scan.position())};
     }
 
     String dirname() const
@@ -293,29 +280,13 @@ public:
     {
         auto filename = basename();
 
-        StringBuilder builder{filename.length()};
-
-        StringScanner scan{filename.cstring(), filename.length()};
+        SpanScanner scan{filename.view()};
 
         // It's not a file extention it's an hidden file.
-        if (scan.current_is("."))
-        {
-            scan.foreward();
-        }
-
-        while (!scan.current_is(".") &&
-               scan.do_continue())
-        {
-            scan.foreward();
-        }
+        scan.skip('.');
+        scan.take_until('.');
 
-        while (scan.do_continue())
-        {
-            builder.append(scan.current());
-            scan.foreward();
-        }
-
-        return builder.finalize();
+        return String{scan.rest()};
     }
 
     Path parent(size_t index) const
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <libsystem/Assert.h>
+#include <libsystem/Common.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/StringView.h>
+#include <libutils/Vector.h>
+
+// Editable sequence of bytes stored as pieces of two buffers: the original
+// content, which is never modified, and an append only buffer receiving
+// everything inserted afterward. Editing only touches the list of pieces,
+// loading a file doesn't copy it and typing at the same place keeps
+// growing the same piece.
+class PieceTable
+{
+private:
+    struct Piece
+    {
+        bool added;
+        size_t start;
+        size_t length;
+    };
+
+    char *_original = nullptr;
+    size_t _original_size = 0;
+
+    char *_added = nullptr;
+    size_t _added_size = 0;
+    size_t _added_capacity = 0;
+
+    Vector<Piece> _pieces{};
+    size_t _length = 0;
+
+    // Edits and reads tend to happen close to each other, lookups walk the
+    // pieces from the last one found instead of from the start.
+    mutable size_t _cache_index = 0;
+    mutable size_t _cache_start = 0;
+
+    const char *data(const Piece &piece) const
+    {
+        return (piece.added ? _added : _original) + piece.start;
+    }
+
+    // Index of the piece containing `offset` and the offset within it,
+    // offset == length() is past the last piece.
+    void locate(size_t offset, size_t &index, size_t &within) const
+    {
+        assert(offset <= _length);
+
+        if (_cache_index > _pieces.count())
+        {
+            _cache_index = 0;
+            _cache_start = 0;
+        }
+
+        while (_cache_index > 0 && offset < _cache_start)
+        {
+            _cache_index--;
+            _cache_start -= _pieces[_cache_index].length;
+        }
+
+        while (_cache_index < _pieces.count() &&
+               offset >= _cache_start + _pieces[_cache_index].length)
+        {
+            _cache_start += _pieces[_cache_index].length;
+            _cache_index++;
+        }
+
+        index = _cache_index;
+        within = offset - _cache_start;
+    }
+
+    size_t append_to_added(StringView text)
+    {
+        if (_added_size + text.length() > _added_capacity)
+        {
+            _added_capacity = MAX(_added_size + text.length(), MAX(_added_capacity * 2, 4096));
+            _added = (char *)realloc(_added, _added_capacity);
+        }
+
+        size_t start = _added_size;
+
+        memcpy(_added + start, text.buffer(), text.length());
+        _added_size += text.length();
+
+        return start;
+    }
+
+public:
+    size_t length() const { return _length; }
+
+    size_t piece_count() const { return _pieces.count(); }
+
+    PieceTable() {}
+
+    // Take ownership of `buffer` which must come from malloc().
+    PieceTable(char *buffer, size_t size)
+        : _original(buffer),
+          _original_size(size),
+          _length(size)
+    {
+        if (size > 0)
+        {
+            _pieces.push_back({false, 0, size});
+        }
+    }
+
+    PieceTable(PieceTable &&other)
+    {
+        *this = move(other);
+    }
+
+    PieceTable &operator=(PieceTable &&other)
+    {
+        if (this != &other)
+        {
+            swap(_original, other._original);
+            swap(_original_size, other._original_size);
+            swap(_added, other._added);
+            swap(_added_size, other._added_size);
+            swap(_added_capacity, other._added_capacity);
+            swap(_pieces, other._pieces);
+            swap(_length, other._length);
+
+            _cache_index = other._cache_index = 0;
+            _cache_start = other._cache_start = 0;
+        }
+
+        return *this;
+    }
+
+    ~PieceTable()
+    {
+        free(_original);
+        free(_added);
+    }
+
+    __noncopyable(PieceTable);
+
+    char at(size_t offset) const
+    {
+        assert(offset < _length);
+
+        size_t index;
+        size_t within;
+        locate(offset, index, within);
+
+        return data(_pieces[index])[within];
+    }
+
+    // Call `callback` with the contiguous runs making up the range.
+    template <typename TCallback>
+    void read(size_t offset, size_t size, TCallback callback) const
+    {
+        assert(offset + size <= _length);
+
+        size_t index;
+        size_t within;
+        locate(offset, index, within);
+
+        while (size > 0)
+        {
+            auto &piece = _pieces[index];
+            size_t run = MIN(piece.length - within, size);
+
+            callback(StringView{data(piece) + within, run});
+
+            size -= run;
+            index++;
+            within = 0;
+        }
+    }
+
+    void copy(size_t offset, size_t size, char *destination) const
+    {
+        read(offset, size, [&](StringView run) {
+            memcpy(destination, run.buffer(), run.length());
+            destination += run.length();
+        });
+    }
+
+    void insert(size_t offset, StringView text)
+    {
+        if (text.length() == 0)
+        {
+            return;
+        }
+
+        size_t index;
+        size_t within;
+        locate(offset, index, within);
+
+        size_t start = append_to_added(text);
+
+        if (within == 0 && index > 0)
+        {
+            auto &previous = _pieces[index - 1];
+
+            // Typing right after the last insertion, grow the same piece.
+            if (previous.added && previous.start + previous.length == start)
+            {
+                previous.length += text.length();
+                _length += text.length();
+
+                _cache_index = index - 1;
+                _cache_start = offset - (previous.length - text.length());
+
+                return;
+            }
+        }
+
+        if (within == 0)
+        {
+            _pieces.insert(index, {true, start, text.length()});
+        }
+        else
+        {
+            Piece left = _pieces[index];
+            Piece right = {left.added, left.start + within, left.length - within};
+            left.length = within;
+
+            _pieces[index] = left;
+            _pieces.insert(index + 1, {true, start, text.length()});
+            _pieces.insert(index + 2, right);
+
+            index++;
+        }
+
+        _length += text.length();
+
+        _cache_index = index;
+        _cache_start = offset;
+    }
+
+    void remove(size_t offset, size_t size)
+    {
+        assert(offset + size <= _length);
+
+        if (size == 0)
+        {
+            return;
+        }
+
+        size_t first_index;
+        size_t first_within;
+        locate(offset, first_index, first_within);
+
+        size_t index = first_index;
+        size_t within = first_within;
+
+        _length -= size;
+
+        while (size > 0)
+        {
+            auto &piece = _pieces[index];
+
+            if (within == 0 && size >= piece.length)
+            {
+                size -= piece.length;
+                _pieces.remove_index(index);
+            }
+            else if (within == 0)
+            {
+                piece.start += size;
+                piece.length -= size;
+                size = 0;
+            }
+            else if (within + size >= piece.length)
+            {
+                size -= piece.length - within;
+                piece.length = within;
+
+                index++;
+                within = 0;
+            }
+            else
+            {
+                Piece right = {piece.added, piece.start + within + size, piece.length - within - size};
+                piece.length = within;
+                _pieces.insert(index + 1, right);
+
+                size = 0;
+            }
+        }
+
+        _cache_index = first_index;
+        _cache_start = offset - first_within;
+    }
+};
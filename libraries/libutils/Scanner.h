@@ -235,12 +235,19 @@ private:
     size_t _offset = 0;
 
 public:
+    using Scanner::foreward;
+
     StringScanner(const char *string, size_t size)
     {
         _string = string;
         _size = size;
     }
 
+    size_t position()
+    {
+        return _offset;
+    }
+
     bool ended() override
     {
         return _offset >= _size;
@@ -5,9 +5,14 @@
 #endif
 
 #include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
+#include <libutils/StringBuilder.h>
 #include <libutils/Strings.h>
 
-static inline const char *scan_json_escape_sequence(Scanner &scan)
+// These work on both a Scanner and a SpanScanner.
+
+template <typename TScanner>
+static inline const char *scan_json_escape_sequence(TScanner &scan)
 {
     scan.skip('\\');
 
@@ -108,7 +113,8 @@ static inline const char *scan_json_escape_sequence(Scanner &scan)
     return buffer;
 }
 
-static inline unsigned int scan_uint(Scanner &scan, int base)
+template <typename TScanner>
+static inline unsigned int scan_uint(TScanner &scan, int base)
 {
     assert(base >= 2 && base <= 16);
 
@@ -123,7 +129,8 @@ static inline unsigned int scan_uint(Scanner &scan, int base)
     return v;
 }
 
-static inline int scan_int(Scanner &scan, int base)
+template <typename TScanner>
+static inline int scan_int(TScanner &scan, int base)
 {
     assert(base >= 2 && base <= 16);
 
@@ -150,7 +157,8 @@ static inline int scan_int(Scanner &scan, int base)
 
 #ifndef __KERNEL__
 
-static inline double scan_float(Scanner &scan)
+template <typename TScanner>
+static inline double scan_float(TScanner &scan)
 {
     int ipart = scan_int(scan, 10);
 
@@ -181,7 +189,23 @@ static inline double scan_float(Scanner &scan)
 
 #endif
 
-static inline void scan_skip_utf8bom(Scanner &scan)
+template <typename TScanner>
+static inline void scan_skip_utf8bom(TScanner &scan)
 {
     scan.skip_word("\xEF\xBB\xBF");
 }
+
+// Drain a scanner into a string so a stream can be handed to the parsers
+// working on contiguous buffers.
+static inline String scan_read_all(Scanner &scan)
+{
+    StringBuilder builder{};
+
+    while (scan.do_continue())
+    {
+        builder.append(scan.current());
+        scan.foreward();
+    }
+
+    return builder.finalize();
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
+
+// The sorting engine only works on indices through a compare(a, b) callback
+// returning <0, 0 or >0 like strcmp and a swap(a, b) callback. This way it
+// can be shared between typed containers and qsort() which only knows the
+// size of the elements.
+
+static constexpr size_t SORT_INSERTION_THRESHOLD = 16;
+
+template <typename TCompare, typename TSwap>
+void insertion_sort(size_t start, size_t end, TCompare &compare, TSwap &swap)
+{
+    for (size_t i = start + 1; i < end; i++)
+    {
+        for (size_t j = i; j > start && compare(j - 1, j) > 0; j--)
+        {
+            swap(j - 1, j);
+        }
+    }
+}
+
+template <typename TCompare, typename TSwap>
+void heap_sift_down(size_t start, size_t root, size_t count, TCompare &compare, TSwap &swap)
+{
+    while (true)
+    {
+        size_t largest = root;
+        size_t left = 2 * root + 1;
+        size_t right = 2 * root + 2;
+
+        if (left < count && compare(start + left, start + largest) > 0)
+        {
+            largest = left;
+        }
+
+        if (right < count && compare(start + right, start + largest) > 0)
+        {
+            largest = right;
+        }
+
+        if (largest == root)
+        {
+            return;
+        }
+
+        swap(start + root, start + largest);
+        root = largest;
+    }
+}
+
+template <typename TCompare, typename TSwap>
+void heap_make(size_t start, size_t end, TCompare &compare, TSwap &swap)
+{
+    size_t count = end - start;
+
+    for (size_t i = count / 2; i > 0; i--)
+    {
+        heap_sift_down(start, i - 1, count, compare, swap);
+    }
+}
+
+template <typename TCompare, typename TSwap>
+void heap_sort(size_t start, size_t end, TCompare &compare, TSwap &swap)
+{
+    heap_make(start, end, compare, swap);
+
+    for (size_t count = end - start; count > 1; count--)
+    {
+        swap(start, start + count - 1);
+        heap_sift_down(start, 0, count - 1, compare, swap);
+    }
+}
+
+// Move the median of the first, middle and last element at start and
+// partition the range around it, returns the final index of the pivot.
+template <typename TCompare, typename TSwap>
+size_t quick_partition(size_t start, size_t end, TCompare &compare, TSwap &swap)
+{
+    size_t middle = start + (end - start) / 2;
+    size_t last = end - 1;
+
+    if (compare(middle, start) < 0)
+    {
+        swap(middle, start);
+    }
+
+    if (compare(last, start) < 0)
+    {
+        swap(last, start);
+    }
+
+    if (compare(last, middle) < 0)
+    {
+        swap(last, middle);
+    }
+
+    swap(start, middle);
+
+    size_t i = start + 1;
+    size_t j = last;
+
+    while (true)
+    {
+        while (i <= j && compare(i, start) < 0)
+        {
+            i++;
+        }
+
+        while (i <= j && compare(j, start) > 0)
+        {
+            j--;
+        }
+
+        if (i >= j)
+        {
+            break;
+        }
+
+        swap(i, j);
+        i++;
+        j--;
+    }
+
+    swap(start, j);
+
+    return j;
+}
+
+template <typename TCompare, typename TSwap>
+void intro_sort(size_t start, size_t end, size_t depth, TCompare &compare, TSwap &swap)
+{
+    while (end - start > SORT_INSERTION_THRESHOLD)
+    {
+        if (depth == 0)
+        {
+            heap_sort(start, end, compare, swap);
+            return;
+        }
+
+        depth--;
+
+        size_t pivot = quick_partition(start, end, compare, swap);
+
+        // Recurse on the smaller side to keep the stack depth logarithmic.
+        if (pivot - start < end - pivot)
+        {
+            intro_sort(start, pivot, depth, compare, swap);
+            start = pivot + 1;
+        }
+        else
+        {
+            intro_sort(pivot + 1, end, depth, compare, swap);
+            end = pivot;
+        }
+    }
+
+    insertion_sort(start, end, compare, swap);
+}
+
+template <typename TCompare, typename TSwap>
+void sort(size_t start, size_t end, TCompare compare, TSwap swap)
+{
+    if (end - start < 2)
+    {
+        return;
+    }
+
+    size_t depth = 0;
+
+    for (size_t count = end - start; count > 1; count >>= 1)
+    {
+        depth += 2;
+    }
+
+    intro_sort(start, end, depth, compare, swap);
+}
+
+// Sort the `count` smallest elements of the range at its start, the order of
+// the remaining ones is unspecified.
+template <typename TCompare, typename TSwap>
+void partial_sort(size_t start, size_t end, size_t count, TCompare compare, TSwap swap)
+{
+    if (count == 0 || end - start < 2)
+    {
+        return;
+    }
+
+    size_t middle = start + count < end ? start + count : end;
+
+    heap_make(start, middle, compare, swap);
+
+    for (size_t i = middle; i < end; i++)
+    {
+        if (compare(i, start) < 0)
+        {
+            swap(i, start);
+            heap_sift_down(start, 0, middle - start, compare, swap);
+        }
+    }
+
+    for (size_t size = middle - start; size > 1; size--)
+    {
+        swap(start, start + size - 1);
+        heap_sift_down(start, 0, size - 1, compare, swap);
+    }
+}
+
+// Stable merge sort, `buffer` must have room for half of the elements and is
+// used as raw storage.
+template <typename T, typename TCompare>
+void merge_sort(T *data, T *buffer, size_t count, TCompare &compare)
+{
+    if (count <= SORT_INSERTION_THRESHOLD)
+    {
+        for (size_t i = 1; i < count; i++)
+        {
+            for (size_t j = i; j > 0 && compare(data[j - 1], data[j]) > 0; j--)
+            {
+                ::swap(data[j - 1], data[j]);
+            }
+        }
+
+        return;
+    }
+
+    size_t middle = count / 2;
+
+    merge_sort(data, buffer, middle, compare);
+    merge_sort(data + middle, buffer, count - middle, compare);
+
+    if (compare(data[middle - 1], data[middle]) <= 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < middle; i++)
+    {
+        new (&buffer[i]) T(move(data[i]));
+        data[i].~T();
+    }
+
+    size_t left = 0;
+    size_t right = middle;
+    size_t output = 0;
+
+    while (left < middle && right < count)
+    {
+        // Take from the left side on equality to keep the sort stable.
+        if (compare(data[right], buffer[left]) < 0)
+        {
+            new (&data[output++]) T(move(data[right]));
+            data[right++].~T();
+        }
+        else
+        {
+            new (&data[output++]) T(move(buffer[left]));
+            buffer[left++].~T();
+        }
+    }
+
+    while (left < middle)
+    {
+        new (&data[output++]) T(move(buffer[left]));
+        buffer[left++].~T();
+    }
+}
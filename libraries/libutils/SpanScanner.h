@@ -0,0 +1,327 @@
+#pragma once
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+#include <libsystem/core/CString.h>
+#include <libsystem/unicode/Codepoint.h>
+#include <libutils/StringView.h>
+
+// Scanner over a contiguous buffer. Same interface as Scanner but nothing
+// is virtual so every call inlines down to a pointer compare, and runs of
+// chars can be consumed at once and handed out as views into the buffer.
+class SpanScanner
+{
+private:
+    const char *_begin;
+    const char *_cursor;
+    const char *_end;
+
+    StringView span_from(const char *start) const
+    {
+        return {start, (size_t)(_cursor - start)};
+    }
+
+    static bool is_whitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Compare 4 chars at once against a repeated byte using the
+    // "has zero byte" bit trick.
+    static bool has_byte(uint32_t chunk, uint32_t repeated)
+    {
+        uint32_t value = chunk ^ repeated;
+        return (value - 0x01010101u) & ~value & 0x80808080u;
+    }
+
+    const char *find(char a, char b) const
+    {
+        const char *cursor = _cursor;
+
+#ifdef __SSE2__
+        const __m128i first = _mm_set1_epi8(a);
+        const __m128i second = _mm_set1_epi8(b);
+
+        while (_end - cursor >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+
+            int mask = _mm_movemask_epi8(_mm_or_si128(
+                _mm_cmpeq_epi8(chunk, first),
+                _mm_cmpeq_epi8(chunk, second)));
+
+            if (mask)
+            {
+                return cursor + __builtin_ctz(mask);
+            }
+
+            cursor += 16;
+        }
+#else
+        uint32_t first = (uint8_t)a * 0x01010101u;
+        uint32_t second = (uint8_t)b * 0x01010101u;
+
+        while (_end - cursor >= 4)
+        {
+            uint32_t chunk;
+            memcpy(&chunk, cursor, sizeof(chunk));
+
+            if (has_byte(chunk, first) || has_byte(chunk, second))
+            {
+                break;
+            }
+
+            cursor += 4;
+        }
+#endif
+
+        while (cursor < _end && *cursor != a && *cursor != b)
+        {
+            cursor++;
+        }
+
+        return cursor;
+    }
+
+public:
+    size_t position() const { return _cursor - _begin; }
+
+    size_t remaining() const { return _end - _cursor; }
+
+    // Everything that hasn't been consumed yet.
+    StringView rest() const { return {_cursor, remaining()}; }
+
+    SpanScanner(const char *buffer, size_t size)
+        : _begin(buffer),
+          _cursor(buffer),
+          _end(buffer + size)
+    {
+    }
+
+    SpanScanner(StringView view)
+        : SpanScanner(view.buffer(), view.length())
+    {
+    }
+
+    bool ended() const { return _cursor >= _end; }
+
+    bool do_continue() const { return _cursor < _end; }
+
+    void foreward()
+    {
+        if (_cursor < _end)
+        {
+            _cursor++;
+        }
+    }
+
+    void foreward(size_t n)
+    {
+        _cursor += n < remaining() ? n : remaining();
+    }
+
+    void foreward_codepoint()
+    {
+        if ((current() & 0xf8) == 0xf0)
+        {
+            foreward(4);
+        }
+        else if ((current() & 0xf0) == 0xe0)
+        {
+            foreward(3);
+        }
+        else if ((current() & 0xe0) == 0xc0)
+        {
+            foreward(2);
+        }
+        else
+        {
+            foreward(1);
+        }
+    }
+
+    char peek(size_t peek) const
+    {
+        return peek < remaining() ? _cursor[peek] : '\0';
+    }
+
+    char current() const
+    {
+        return _cursor < _end ? *_cursor : '\0';
+    }
+
+    Codepoint current_codepoint() const
+    {
+        size_t size = 0;
+        Codepoint codepoint = peek(0);
+
+        if ((current() & 0xf8) == 0xf0)
+        {
+            size = 4;
+            codepoint = (0x07 & codepoint) << 18;
+        }
+        else if ((current() & 0xf0) == 0xe0)
+        {
+            size = 3;
+            codepoint = (0x0f & codepoint) << 12;
+        }
+        else if ((current() & 0xe0) == 0xc0)
+        {
+            codepoint = (0x1f & codepoint) << 6;
+            size = 2;
+        }
+
+        for (size_t i = 1; i < size; i++)
+        {
+            codepoint |= (0x3f & peek(i)) << (6 * (size - i - 1));
+        }
+
+        return codepoint;
+    }
+
+    bool current_is(const char *what) const
+    {
+        return current_is(what, strlen(what));
+    }
+
+    bool current_is(const char *what, size_t size) const
+    {
+        return _cursor < _end && memchr(what, *_cursor, size) != nullptr;
+    }
+
+    bool current_is_word(const char *word) const
+    {
+        size_t length = strlen(word);
+        return length <= remaining() && memcmp(_cursor, word, length) == 0;
+    }
+
+    // Consume chars as long as they match the predicate.
+    template <typename TPredicate>
+    StringView eat_while(TPredicate predicate)
+    {
+        const char *start = _cursor;
+
+        while (_cursor < _end && predicate(*_cursor))
+        {
+            _cursor++;
+        }
+
+        return span_from(start);
+    }
+
+    StringView eat(const char *what)
+    {
+        size_t size = strlen(what);
+
+        return eat_while([&](char c) {
+            return memchr(what, c, size) != nullptr;
+        });
+    }
+
+    // Same as eat(Strings::WHITESPACE) but 16 chars at a time when there
+    // is indentation to get through.
+    StringView eat_whitespace()
+    {
+        const char *start = _cursor;
+
+        if (_cursor == _end || !is_whitespace(*_cursor))
+        {
+            return {};
+        }
+
+#ifdef __SSE2__
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriage = _mm_set1_epi8('\r');
+        const __m128i tab = _mm_set1_epi8('\t');
+
+        while (_end - _cursor >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i *)_cursor);
+
+            __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage), _mm_cmpeq_epi8(chunk, tab)));
+
+            int mask = ~_mm_movemask_epi8(whitespace) & 0xffff;
+
+            if (mask)
+            {
+                _cursor += __builtin_ctz(mask);
+                return span_from(start);
+            }
+
+            _cursor += 16;
+        }
+#endif
+
+        while (_cursor < _end && is_whitespace(*_cursor))
+        {
+            _cursor++;
+        }
+
+        return span_from(start);
+    }
+
+    // Consume everything up to, but not including, the first `c` or the
+    // end of the buffer.
+    StringView take_until(char c)
+    {
+        const char *start = _cursor;
+        _cursor = find(c, c);
+
+        return span_from(start);
+    }
+
+    // Consume everything up to the first `a` or `b`.
+    StringView take_until(char a, char b)
+    {
+        const char *start = _cursor;
+        _cursor = find(a, b);
+
+        return span_from(start);
+    }
+
+    StringView take(size_t n)
+    {
+        const char *start = _cursor;
+        foreward(n);
+
+        return span_from(start);
+    }
+
+    bool skip(char chr)
+    {
+        if (current() == chr && _cursor < _end)
+        {
+            _cursor++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skip(const char *chr)
+    {
+        if (current_is(chr))
+        {
+            _cursor++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skip_word(const char *word)
+    {
+        if (current_is_word(word))
+        {
+            _cursor += strlen(word);
+            return true;
+        }
+
+        return false;
+    }
+};
@@ -4,70 +4,145 @@
 #include <libutils/Move.h>
 #include <libutils/RefPtr.h>
 #include <libutils/StringStorage.h>
+#include <libutils/StringView.h>
 
 class String
 {
+public:
+    // Strings up to INLINE_CAPACITY bytes are stored in place, longer ones
+    // share a refcounted StringStorage between copies.
+    static constexpr size_t INLINE_CAPACITY = 23;
+
 private:
-    RefPtr<StringStorage> _buffer;
+    size_t _length = 0;
 
-public:
-    size_t length() const { return _buffer->length(); }
+    union
+    {
+        char _inline[INLINE_CAPACITY + 1];
+        StringStorage *_storage;
+    };
 
-    const char *cstring() const { return _buffer->cstring(); }
-    char at(int index) const { return _buffer->cstring()[index]; }
+    bool is_inline() const { return _length <= INLINE_CAPACITY; }
 
-    bool null_or_empty() const { return _buffer == nullptr || _buffer->length() == 0; }
-    
-    String substr(size_t start, size_t length)
+    void assign(const char *cstring, size_t length)
+    {
+        _length = length;
+
+        if (is_inline())
+        {
+            memcpy(_inline, cstring, length);
+            _inline[length] = '\0';
+        }
+        else
+        {
+            _storage = new StringStorage(cstring, length);
+        }
+    }
+
+    void assign(const String &other)
+    {
+        _length = other._length;
+
+        if (is_inline())
+        {
+            memcpy(_inline, other._inline, _length + 1);
+        }
+        else
+        {
+            _storage = other._storage;
+            _storage->ref();
+        }
+    }
+
+    void release()
     {
-        char str[length + 1];
-        
-        for (size_t i = 0; i <= length; i++)
+        if (!is_inline())
         {
-            str[i] = at(start + i);
+            _storage->deref();
         }
-        
-        str[length] = '\0';
-        return str;
+
+        _length = 0;
+        _inline[0] = '\0';
+    }
+
+public:
+    size_t length() const { return _length; }
+
+    const char *cstring() const { return is_inline() ? _inline : _storage->cstring(); }
+
+    char at(int index) const { return cstring()[index]; }
+
+    bool null_or_empty() const { return _length == 0; }
+
+    StringView view() const { return {cstring(), _length}; }
+
+    String substr(size_t start, size_t length)
+    {
+        return String(cstring() + start, length);
     }
 
     String(const char *cstring = "")
     {
-        _buffer = make<StringStorage>(cstring);
+        assign(cstring, strlen(cstring));
     }
 
     String(const char *cstring, size_t length)
     {
-        _buffer = make<StringStorage>(cstring, length);
+        assign(cstring, strnlen(cstring, length));
+    }
+
+    String(StringView view)
+        : String(view.buffer(), view.length())
+    {
     }
 
     String(char c)
     {
-        char cstr[2];
-        cstr[0] = c;
-        _buffer = make<StringStorage>(cstr, 1);
+        assign(&c, 1);
     }
 
     String(RefPtr<StringStorage> storage)
-        : _buffer(storage)
     {
+        if (storage == nullptr)
+        {
+            assign("", 0);
+        }
+        else if (storage->length() <= INLINE_CAPACITY)
+        {
+            assign(storage->cstring(), storage->length());
+        }
+        else
+        {
+            _length = storage->length();
+            _storage = storage.give_ref();
+        }
     }
 
     String(const String &other)
-        : _buffer(const_cast<String &>(other)._buffer)
     {
+        assign(other);
     }
 
     String(String &&other)
-        : _buffer(move(other._buffer))
     {
+        _length = other._length;
+        memcpy(_inline, other._inline, sizeof(_inline));
+
+        other._length = 0;
+        other._inline[0] = '\0';
+    }
+
+    ~String()
+    {
+        release();
     }
 
     String &operator=(const String &other)
     {
         if (this != &other)
         {
-            _buffer = const_cast<String &>(other)._buffer;
+            release();
+            assign(other);
         }
 
         return *this;
@@ -77,7 +152,12 @@ public:
     {
         if (this != &other)
         {
-            swap(_buffer, other._buffer);
+            swap(_length, other._length);
+
+            char temp[sizeof(_inline)];
+            memcpy(temp, _inline, sizeof(_inline));
+            memcpy(_inline, other._inline, sizeof(_inline));
+            memcpy(other._inline, temp, sizeof(_inline));
         }
 
         return *this;
@@ -85,7 +165,14 @@ public:
 
     String &operator+=(String &other)
     {
-        _buffer = make<StringStorage>(*_buffer, *other._buffer);
+        size_t length = _length + other._length;
+        char *buffer = new char[length + 1];
+
+        memcpy(buffer, cstring(), _length);
+        memcpy(buffer + _length, other.cstring(), other._length);
+        buffer[length] = '\0';
+
+        *this = String(make<StringStorage>(AdoptTag::ADOPT, buffer, length));
 
         return *this;
     }
@@ -97,43 +184,27 @@ public:
 
     bool operator==(const String &other) const
     {
-        if (_buffer == other._buffer)
-        {
-            return true;
-        }
-
-        if (length() != other.length())
+        if (_length != other._length)
         {
             return false;
         }
 
-        for (size_t i = 0; i < length(); i++)
+        if (!is_inline() && _storage == other._storage)
         {
-            if (cstring()[i] != other.cstring()[i])
-            {
-                return false;
-            }
+            return true;
         }
 
-        return true;
+        return memcmp(cstring(), other.cstring(), _length) == 0;
     }
 
     bool operator==(const char *str) const
     {
-        if (length() != strlen(str))
+        if (_length != strlen(str))
         {
             return false;
         }
 
-        for (size_t i = 0; i < length(); i++)
-        {
-            if (cstring()[i] != str[i])
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return memcmp(cstring(), str, _length) == 0;
     }
 
     char operator[](int index) const
@@ -143,10 +214,21 @@ public:
 
     RefPtr<StringStorage> underlying_storage()
     {
-        return _buffer;
+        if (is_inline())
+        {
+            return make<StringStorage>(_inline, _length);
+        }
+
+        return RefPtr<StringStorage>{*_storage};
     }
 };
 
+// The inline storage holds chars, never a pointer to itself.
+template <>
+struct IsTriviallyRelocatable<String> : TrueType
+{
+};
+
 template <>
 inline uint32_t hash<String>(const String &value)
 {
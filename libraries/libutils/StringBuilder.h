@@ -4,6 +4,7 @@
 #include <libsystem/Common.h>
 #include <libsystem/math/MinMax.h>
 #include <libutils/String.h>
+#include <libutils/StringView.h>
 #include <libutils/Vector.h>
 
 class StringBuilder
@@ -13,52 +14,101 @@ private:
     size_t _size = 0;
     char *_buffer = nullptr;
 
+    // Short strings are built in place and finalized without touching the
+    // heap since they fit in String inline storage.
+    char _inline[String::INLINE_CAPACITY + 1];
+
     __noncopyable(StringBuilder);
     __nonmovable(StringBuilder);
 
+    void reset()
+    {
+        _buffer = _inline;
+        _size = sizeof(_inline);
+        _used = 0;
+        _buffer[0] = '\0';
+    }
+
+    void grow(size_t needed)
+    {
+        auto new_size = _size + _size / 4;
+
+        if (new_size < needed)
+        {
+            new_size = needed;
+        }
+
+        auto new_buffer = new char[new_size];
+        memcpy(new_buffer, _buffer, _used + 1);
+
+        if (_buffer != _inline)
+        {
+            delete[] _buffer;
+        }
+
+        _size = new_size;
+        _buffer = new_buffer;
+    }
+
 public:
     size_t length() const
     {
         return _used;
     }
 
-    StringBuilder() : StringBuilder(16)
+    StringBuilder()
     {
+        reset();
     }
 
     StringBuilder(size_t preallocated)
     {
-        preallocated = MAX(preallocated, 16);
+        reset();
 
-        _buffer = new char[preallocated];
-        _size = preallocated;
-        _used = 0;
+        if (preallocated > _size)
+        {
+            _buffer = new char[preallocated];
+            _buffer[0] = '\0';
+            _size = preallocated;
+        }
     }
 
     ~StringBuilder()
     {
-        if (_buffer)
+        if (_buffer != _inline)
             delete[] _buffer;
     }
 
     String finalize()
     {
+        if (_used <= String::INLINE_CAPACITY)
+        {
+            String result{_buffer, _used};
+
+            if (_buffer != _inline)
+            {
+                delete[] _buffer;
+            }
+
+            reset();
+
+            return result;
+        }
+
         char *result = _buffer;
         size_t size = _used;
 
-        _buffer = nullptr;
-        _used = 0;
-        _size = 0;
+        reset();
 
         return String(make<StringStorage>(AdoptTag::ADOPT, result, size));
     }
 
     String intermediate()
     {
-        return String(make<StringStorage>(_buffer, _used));
+        return String(_buffer, _used);
     }
 
-    StringBuilder &append(String string)
+    StringBuilder &append(const String &string)
     {
         for (size_t i = 0; i < string.length(); i++)
         {
@@ -89,37 +139,31 @@ public:
     {
         if (!str)
         {
-            append("<null>");
+            return append("<null>");
         }
-        else
+
+        return append(StringView{str, size});
+    }
+
+    StringBuilder &append(StringView view)
+    {
+        if (_used + view.length() + 1 > _size)
         {
-            for (size_t i = 0; i < size; i++)
-            {
-                append(str[i]);
-            }
+            grow(_used + view.length() + 1);
         }
 
+        memcpy(_buffer + _used, view.buffer(), view.length());
+        _used += view.length();
+        _buffer[_used] = '\0';
+
         return *this;
     }
 
     StringBuilder &append(char chr)
     {
-        if (_size == 0)
-        {
-            _buffer = new char[16];
-            _size = 16;
-            _used = 0;
-        }
-
         if (_used + 1 == _size)
         {
-            auto new_size = _size + _size / 4;
-            auto new_buffer = new char[new_size];
-            memcpy(new_buffer, _buffer, _size);
-            delete[] _buffer;
-
-            _size = new_size;
-            _buffer = new_buffer;
+            grow(_used + 2);
         }
 
         _buffer[_used] = chr;
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <libsystem/core/CString.h>
+#include <libutils/Hash.h>
+
+// Non-owning reference to a run of chars, it is not null terminated and
+// must not outlive the buffer it points into.
+class StringView
+{
+private:
+    const char *_buffer = "";
+    size_t _length = 0;
+
+public:
+    const char *buffer() const { return _buffer; }
+
+    size_t length() const { return _length; }
+
+    bool empty() const { return _length == 0; }
+
+    StringView() {}
+
+    StringView(const char *cstring)
+        : _buffer(cstring),
+          _length(strlen(cstring))
+    {
+    }
+
+    StringView(const char *buffer, size_t length)
+        : _buffer(buffer),
+          _length(length)
+    {
+    }
+
+    char operator[](size_t index) const
+    {
+        return _buffer[index];
+    }
+
+    StringView substring(size_t start, size_t length) const
+    {
+        if (start >= _length)
+        {
+            return {};
+        }
+
+        if (length > _length - start)
+        {
+            length = _length - start;
+        }
+
+        return {_buffer + start, length};
+    }
+
+    bool operator==(const StringView &other) const
+    {
+        return _length == other._length &&
+               memcmp(_buffer, other._buffer, _length) == 0;
+    }
+
+    bool operator!=(const StringView &other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator==(const char *cstring) const
+    {
+        return *this == StringView{cstring};
+    }
+
+    bool operator!=(const char *cstring) const
+    {
+        return !(*this == cstring);
+    }
+};
+
+template <>
+inline uint32_t hash<StringView>(const StringView &value)
+{
+    return hash(value.buffer(), value.length());
+}
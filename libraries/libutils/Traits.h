@@ -502,3 +502,12 @@ using IsFloatingPoint = __IsFloatingPoint<typename RemoveConstVolatile<T>::Type>
 template <typename ReferenceType, typename T>
 using CopyConst =
     typename Conditional<IsConst<ReferenceType>::value, typename AddConst<T>::Type, typename RemoveConst<T>::Type>::Type;
+
+// Types which can be moved to another address with a memcpy, without
+// running the move constructor at the new place or the destructor at the
+// old one. Anything trivially copyable is, classes which only hold
+// pointers to things outside of themselves opt in with a specialization.
+template <typename T>
+struct IsTriviallyRelocatable : IntegralConstant<bool, __is_trivially_copyable(T)>
+{
+};
@@ -9,6 +9,8 @@
 #include <libutils/Iteration.h>
 #include <libutils/New.h>
 #include <libutils/RefPtr.h>
+#include <libutils/Sort.h>
+#include <libutils/Traits.h>
 
 template <typename T>
 void typed_copy(T *destination, T *source, size_t count)
@@ -46,10 +48,80 @@ template <typename T>
 class Vector
 {
 private:
+    static constexpr size_t MIN_CAPACITY = 16;
+
     T *_storage = nullptr;
     size_t _count = 0;
     size_t _capacity = 0;
 
+    // Move the items to a block of `capacity` items. Relocatable items go
+    // through realloc() which can often extend the block where it is.
+    void relocate(size_t capacity)
+    {
+        if constexpr (IsTriviallyRelocatable<T>::value)
+        {
+            _storage = reinterpret_cast<T *>(realloc((void *)_storage, sizeof(T) * capacity));
+        }
+        else
+        {
+            T *new_storage = reinterpret_cast<T *>(malloc(sizeof(T) * capacity));
+
+            for (size_t i = 0; i < _count; i++)
+            {
+                new (&new_storage[i]) T(move(_storage[i]));
+                _storage[i].~T();
+            }
+
+            free(_storage);
+            _storage = new_storage;
+        }
+
+        _capacity = capacity;
+    }
+
+    // Growing by half of the capacity keeps a push_back() loop to a
+    // logarithmic number of reallocations.
+    void grow(size_t needed)
+    {
+        relocate(MAX(MAX(needed, _capacity + _capacity / 2), MIN_CAPACITY));
+    }
+
+    // Give memory back once the vector is mostly empty, the gap between
+    // the grow and shrink thresholds avoids reallocating back and forth
+    // when items come and go around the limit.
+    void shrink_if_sparse()
+    {
+        if (_capacity > MIN_CAPACITY && _count < _capacity / 4)
+        {
+            relocate(MAX(_capacity / 2, MIN_CAPACITY));
+        }
+    }
+
+    // Shift the items starting at `index` one slot to the right and leave
+    // the slot uninitialized.
+    void open_slot(size_t index)
+    {
+        if (_count == _capacity)
+        {
+            grow(_count + 1);
+        }
+
+        if constexpr (IsTriviallyRelocatable<T>::value)
+        {
+            memmove((void *)&_storage[index + 1], (const void *)&_storage[index], sizeof(T) * (_count - index));
+        }
+        else
+        {
+            for (size_t j = _count; j > index; j--)
+            {
+                new (&_storage[j]) T(move(_storage[j - 1]));
+                _storage[j - 1].~T();
+            }
+        }
+
+        _count++;
+    }
+
 public:
     size_t count() const { return _count; }
 
@@ -59,6 +131,8 @@ public:
 
     T *raw_storage() { return _storage; }
 
+    const T *raw_storage() const { return _storage; }
+
     T &at(size_t index)
     {
         assert(index < _count);
@@ -71,20 +145,22 @@ public:
         return _storage[index];
     }
 
-    Vector() : Vector(16) {}
+    size_t capacity() const { return _capacity; }
+
+    Vector() {}
 
     Vector(size_t capacity)
     {
-        ensure_capacity(capacity);
+        reserve(capacity);
     }
-    
+
     Vector(std::initializer_list<T> data)
     {
-        ensure_capacity(data.size());
-        
-        for (size_t i = 0; i < data.size(); i++)
+        reserve(data.size());
+
+        for (auto &value : data)
         {
-            push_back(data[i]);
+            push_back(value);
         }
     }
 
@@ -97,10 +173,13 @@ public:
 
     Vector(const Vector &other)
     {
-        ensure_capacity(other.count());
+        reserve(other.count());
 
-        _count = other.count();
-        typed_copy(_storage, other._storage, _count);
+        if (other.count())
+        {
+            _count = other.count();
+            typed_copy(_storage, other._storage, _count);
+        }
     }
 
     Vector(Vector &&other)
@@ -124,9 +203,13 @@ public:
         {
             clear();
 
-            ensure_capacity(other.count());
-            _count = other.count();
-            typed_copy(_storage, other._storage, _count);
+            reserve(other.count());
+
+            if (other.count())
+            {
+                _count = other.count();
+                typed_copy(_storage, other._storage, _count);
+            }
         }
 
         return *this;
@@ -221,98 +304,54 @@ public:
     template <typename Comparator>
     void sort(Comparator comparator)
     {
-        for (size_t i = 0; i < _count - 1; i++)
-        {
-            for (size_t j = i + 1; j < _count; j++)
-            {
-                if (comparator(_storage[i], _storage[j]) > 0)
-                {
-                    swap(_storage[i], _storage[j]);
-                }
-            }
-        }
+        ::sort(
+            0, _count,
+            [&](size_t a, size_t b) { return comparator(_storage[a], _storage[b]); },
+            [&](size_t a, size_t b) { swap(_storage[a], _storage[b]); });
     }
 
-    void ensure_capacity(size_t capacity)
+    template <typename Comparator>
+    void stable_sort(Comparator comparator)
     {
-        capacity = MAX(capacity, 16);
-
-        if (!_storage)
+        if (_count < 2)
         {
-            _storage = reinterpret_cast<T *>(calloc(capacity, sizeof(T)));
-            _capacity = capacity;
-            _count = 0;
-
             return;
         }
 
-        capacity = MAX(_count, capacity);
-
-        if (capacity <= _capacity)
-        {
-            return;
-        }
-
-        size_t new_capacity = _capacity;
-
-        while (new_capacity <= capacity)
-        {
-            new_capacity += new_capacity / 4;
-        }
-
-        T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-        for (size_t i = 0; i < _count; i++)
-        {
-            new (&new_storage[i]) T(move(_storage[i]));
-        }
-
-        free(_storage);
-        _storage = new_storage;
-        _capacity = new_capacity;
+        T *buffer = reinterpret_cast<T *>(malloc(sizeof(T) * (_count / 2 + 1)));
+        merge_sort(_storage, buffer, _count, comparator);
+        free(buffer);
+    }
 
-        _count++;
+    // Only the first `count` elements end up sorted, useful for "top N" views.
+    template <typename Comparator>
+    void partial_sort(size_t count, Comparator comparator)
+    {
+        ::partial_sort(
+            0, _count, count,
+            [&](size_t a, size_t b) { return comparator(_storage[a], _storage[b]); },
+            [&](size_t a, size_t b) { swap(_storage[a], _storage[b]); });
     }
 
-    void grow()
+    void reserve(size_t capacity)
     {
-        if (_count + 1 >= _capacity)
+        if (capacity > _capacity)
         {
-            size_t new_capacity = _capacity + _capacity / 4;
-            T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-            for (size_t i = 0; i < _count; i++)
-            {
-                new (&new_storage[i]) T(move(_storage[i]));
-            }
-
-            free(_storage);
-            _storage = new_storage;
-            _capacity = new_capacity;
+            relocate(capacity);
         }
-
-        _count++;
     }
 
-    void shrink()
+    void shrink_to_fit()
     {
-        _count--;
-
-        size_t new_capacity = _capacity - _capacity / 4;
-
-        if (MAX(_count, 16) < new_capacity)
+        if (_count == 0)
         {
-            T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
-
-            for (size_t i = 0; i < _count; i++)
-            {
-                new (&new_storage[i]) T(move(_storage[i]));
-                _storage[i].~T();
-            }
-
             free(_storage);
-            _storage = new_storage;
-            _capacity = new_capacity;
+            _storage = nullptr;
+            _capacity = 0;
+        }
+        else if (_count < _capacity)
+        {
+            relocate(_count);
         }
     }
 
@@ -325,15 +364,27 @@ public:
     {
         assert(index <= _count);
 
-        grow();
+        open_slot(index);
+        new (&_storage[index]) T(move(value));
 
-        for (size_t j = _count - 1; j > index; j--)
+        return _storage[index];
+    }
+
+    // Construct the item in place. The arguments may refer to an item of
+    // this vector, they are turned into a temporary first if the items
+    // are about to move.
+    template <typename... Args>
+    T &emplace_at(size_t index, Args &&... args)
+    {
+        assert(index <= _count);
+
+        if (index < _count || _count == _capacity)
         {
-            new (&_storage[j]) T(move(_storage[j - 1]));
-            at(j - 1).~T();
+            return insert(index, T(forward<Args>(args)...));
         }
 
-        new (&_storage[index]) T(move(value));
+        new (&_storage[_count]) T(forward<Args>(args)...);
+        _count++;
 
         return _storage[index];
     }
@@ -383,13 +434,22 @@ public:
 
         _storage[index].~T();
 
-        for (size_t i = index; i < _count - 1; ++i)
+        if constexpr (IsTriviallyRelocatable<T>::value)
         {
-            new (&_storage[i]) T(move(_storage[i + 1]));
-            _storage[i + 1].~T();
+            memmove((void *)&_storage[index], (const void *)&_storage[index + 1], sizeof(T) * (_count - index - 1));
         }
+        else
+        {
+            for (size_t i = index; i < _count - 1; ++i)
+            {
+                new (&_storage[i]) T(move(_storage[i + 1]));
+                _storage[i + 1].~T();
+            }
+        }
+
+        _count--;
 
-        shrink();
+        shrink_if_sparse();
     }
 
     void remove_value(const T &value)
@@ -454,39 +514,29 @@ public:
     template <typename... Args>
     T &emplace(Args &&... args)
     {
-        grow();
-
-        for (size_t j = _count - 1; j > 0; j--)
-        {
-            new (&_storage[j]) T(move(_storage[j - 1]));
-            at(j - 1).~T();
-        }
-
-        new (&_storage[0]) T(forward<Args>(args)...);
-        return _storage[0];
+        return emplace_at(0, forward<Args>(args)...);
     }
 
     T &push_back(const T &value)
     {
-        return push_back(T(value));
+        return emplace_at(_count, value);
     }
 
     T &push_back(T &&value)
     {
-        return insert(_count, move(value));
+        return emplace_at(_count, move(value));
     }
 
     template <typename... Args>
     T &emplace_back(Args &&... args)
     {
-        grow();
-
-        new (&_storage[_count - 1]) T(forward<Args>(args)...);
-        return _storage[_count - 1];
+        return emplace_at(_count, forward<Args>(args)...);
     }
 
     void push_back_many(const Vector<T> &values)
     {
+        reserve(_count + values.count());
+
         for (size_t i = 0; i < values.count(); i++)
         {
             push_back(values[i]);
@@ -538,3 +588,8 @@ public:
         return false;
     }
 };
+
+template <typename T>
+struct IsTriviallyRelocatable<Vector<T>> : TrueType
+{
+};
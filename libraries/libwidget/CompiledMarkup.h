@@ -0,0 +1,178 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libsystem/core/CString.h>
+#include <libutils/StringView.h>
+
+// Binary form of a .markup file produced at build time by
+// toolbox/markup-compiler.py. Widget types, layouts, insets and flags are
+// resolved ahead of time, only the strings remain and live in a table at
+// the end of the file. Nodes are stored in pre-order, each followed by its
+// childs. Keep both sides in sync when changing the layout.
+
+#define COMPILED_MARKUP_MAGIC "MKUP"
+#define COMPILED_MARKUP_VERSION 1
+
+enum CompiledWidgetType : uint16_t
+{
+    COMPILED_WIDGET_PLACEHOLDER,
+    COMPILED_WIDGET_WINDOW,
+    COMPILED_WIDGET_CONTAINER,
+    COMPILED_WIDGET_PANEL,
+    COMPILED_WIDGET_BUTTON,
+    COMPILED_WIDGET_LABEL,
+    COMPILED_WIDGET_IMAGE,
+    COMPILED_WIDGET_SLIDER,
+};
+
+#define COMPILED_MARKUP_HAS_LAYOUT (1 << 0)
+#define COMPILED_MARKUP_HAS_INSETS (1 << 1)
+#define COMPILED_MARKUP_FILL (1 << 2)
+#define COMPILED_MARKUP_ROUNDED (1 << 3)
+#define COMPILED_MARKUP_FILLED (1 << 4)
+#define COMPILED_MARKUP_OUTLINED (1 << 5)
+#define COMPILED_MARKUP_BORDERLESS (1 << 6)
+#define COMPILED_MARKUP_RESIZABLE (1 << 7)
+#define COMPILED_MARKUP_ALWAYS_FOCUSED (1 << 8)
+#define COMPILED_MARKUP_SWALLOW (1 << 9)
+#define COMPILED_MARKUP_TRANSPARENT (1 << 10)
+
+#define COMPILED_MARKUP_NO_STRING (0xffffffff)
+
+struct __packed CompiledMarkupHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t node_count;
+    uint32_t strings_offset;
+    uint32_t strings_size;
+};
+
+struct __packed CompiledMarkupString
+{
+    uint32_t offset; // COMPILED_MARKUP_NO_STRING when the attribute is missing.
+    uint32_t length;
+};
+
+struct __packed CompiledMarkupNode
+{
+    uint16_t type;
+    uint16_t flags;
+    uint32_t childs;
+
+    uint8_t layout; // LayoutType
+    uint8_t anchor; // Anchor
+    uint16_t reserved;
+
+    int16_t layout_cells[2];
+    int16_t layout_spacing[2];
+
+    int16_t insets[4]; // top, bottom, left, right
+
+    int16_t width;
+    int16_t height;
+
+    CompiledMarkupString name;
+    CompiledMarkupString id;
+    CompiledMarkupString text; // "text" or the window "title"
+    CompiledMarkupString icon;
+    CompiledMarkupString path;
+};
+
+// Read only view over a compiled markup file held in memory.
+class CompiledMarkup
+{
+private:
+    const uint8_t *_buffer = nullptr;
+    size_t _size = 0;
+
+    const CompiledMarkupHeader &header() const
+    {
+        return *reinterpret_cast<const CompiledMarkupHeader *>(_buffer);
+    }
+
+    bool string_valid(const CompiledMarkupString &string) const
+    {
+        return string.offset == COMPILED_MARKUP_NO_STRING ||
+               (string.offset <= header().strings_size &&
+                string.length <= header().strings_size - string.offset);
+    }
+
+public:
+    static bool is_compiled(const void *buffer, size_t size)
+    {
+        return size >= sizeof(CompiledMarkupHeader) &&
+               memcmp(buffer, COMPILED_MARKUP_MAGIC, 4) == 0;
+    }
+
+    CompiledMarkup(const void *buffer, size_t size)
+        : _buffer(reinterpret_cast<const uint8_t *>(buffer)),
+          _size(size)
+    {
+    }
+
+    // Check the header, every child count and every string reference once
+    // so building widgets afterward doesn't have to.
+    bool valid() const
+    {
+        if (!is_compiled(_buffer, _size) ||
+            header().version != COMPILED_MARKUP_VERSION ||
+            header().node_count == 0)
+        {
+            return false;
+        }
+
+        size_t nodes_end = sizeof(CompiledMarkupHeader) + header().node_count * sizeof(CompiledMarkupNode);
+
+        if (header().node_count > _size / sizeof(CompiledMarkupNode) ||
+            nodes_end > header().strings_offset ||
+            header().strings_offset > _size ||
+            header().strings_size > _size - header().strings_offset)
+        {
+            return false;
+        }
+
+        // Each node consumes one slot, its childs must fit in what is left.
+        size_t pending = 1;
+
+        for (size_t i = 0; i < header().node_count; i++)
+        {
+            auto &n = node(i);
+
+            if (pending == 0 ||
+                n.childs > header().node_count ||
+                !string_valid(n.name) || !string_valid(n.id) ||
+                !string_valid(n.text) || !string_valid(n.icon) ||
+                !string_valid(n.path))
+            {
+                return false;
+            }
+
+            pending = pending - 1 + n.childs;
+        }
+
+        return pending == 0;
+    }
+
+    size_t node_count() const { return header().node_count; }
+
+    const CompiledMarkupNode &node(size_t index) const
+    {
+        return reinterpret_cast<const CompiledMarkupNode *>(_buffer + sizeof(CompiledMarkupHeader))[index];
+    }
+
+    bool has(const CompiledMarkupString &string) const
+    {
+        return string.offset != COMPILED_MARKUP_NO_STRING;
+    }
+
+    StringView string(const CompiledMarkupString &string) const
+    {
+        if (!has(string))
+        {
+            return {};
+        }
+
+        return {reinterpret_cast<const char *>(_buffer + header().strings_offset + string.offset), string.length};
+    }
+};
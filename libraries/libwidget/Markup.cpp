@@ -1,18 +1,21 @@
 #include <libmarkup/Markup.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
+#include <libsystem/system/System.h>
 #include <libsystem/utils/NumberParser.h>
-#include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
 
+#include <libwidget/CompiledMarkup.h>
 #include <libwidget/Markup.h>
 #include <libwidget/Widgets.h>
 
-static void whitespace(Scanner &scan)
+static void whitespace(SpanScanner &scan)
 {
     scan.eat(" ");
 }
 
-static int number(Scanner &scan)
+static int number(SpanScanner &scan)
 {
     int number = 0;
 
@@ -35,7 +38,7 @@ static Layout layout_parse(const char *string)
 
     Layout result = STACK();
 
-    StringScanner scan(string, strlen(string));
+    SpanScanner scan{string, strlen(string)};
 
     if (scan.skip_word("stack"))
     {
@@ -121,7 +124,7 @@ Insetsi insets_parse(const char *string)
         return Insetsi(0);
     }
 
-    StringScanner scan{string, strlen(string)};
+    SpanScanner scan{string, strlen(string)};
 
     if (!scan.skip_word("insets"))
     {
@@ -317,7 +320,7 @@ Widget *widget_create_from_markup(Widget *parent, markup::Node &node)
 
     if (widget == nullptr)
     {
-        widget = new Placeholder(parent, node.type());
+        widget = new Placeholder(parent, String{node.type()});
     }
 
     widget_apply_attribute_from_markup(widget, node);
@@ -388,14 +391,235 @@ Window *window_create_from_markup(markup::Node &node)
     return window;
 }
 
+static String compiled_string_or_default(CompiledMarkup &markup, const CompiledMarkupString &string, const char *fallback)
+{
+    if (markup.has(string))
+    {
+        return String{markup.string(string)};
+    }
+
+    return fallback;
+}
+
+static void widget_apply_attribute_from_compiled(Widget *widget, CompiledMarkup &markup, const CompiledMarkupNode &node)
+{
+    if (markup.has(node.id))
+    {
+        widget->id(String{markup.string(node.id)});
+    }
+
+    if (node.flags & COMPILED_MARKUP_HAS_LAYOUT)
+    {
+        widget->layout((Layout){
+            (LayoutType)node.layout,
+            node.layout_cells[0],
+            node.layout_cells[1],
+            Vec2i(node.layout_spacing[0], node.layout_spacing[1]),
+        });
+    }
+
+    if (node.flags & COMPILED_MARKUP_HAS_INSETS)
+    {
+        widget->insets(Insetsi(node.insets[0], node.insets[1], node.insets[2], node.insets[3]));
+    }
+
+    if (node.flags & COMPILED_MARKUP_FILL)
+    {
+        widget->attributes(LAYOUT_FILL);
+    }
+}
+
+static Widget *widget_create_from_compiled(Widget *parent, CompiledMarkup &markup, const CompiledMarkupNode &node)
+{
+    Widget *widget = nullptr;
+
+    switch (node.type)
+    {
+    case COMPILED_WIDGET_CONTAINER:
+        widget = new Container(parent);
+        break;
+
+    case COMPILED_WIDGET_PANEL:
+    {
+        auto panel = new Panel(parent);
+
+        if (node.flags & COMPILED_MARKUP_ROUNDED)
+        {
+            panel->border_radius(6);
+        }
+
+        widget = panel;
+        break;
+    }
+
+    case COMPILED_WIDGET_BUTTON:
+    {
+        ButtonStyle button_style = BUTTON_TEXT;
+
+        if (node.flags & COMPILED_MARKUP_FILLED)
+        {
+            button_style = BUTTON_FILLED;
+        }
+
+        if (node.flags & COMPILED_MARKUP_OUTLINED)
+        {
+            button_style = BUTTON_OUTLINE;
+        }
+
+        bool has_text = markup.has(node.text);
+        bool has_icon = markup.has(node.icon);
+
+        if (has_text && has_icon)
+        {
+            widget = new Button(parent, button_style, Icon::get(String{markup.string(node.icon)}), String{markup.string(node.text)});
+        }
+        else if (has_text)
+        {
+            widget = new Button(parent, button_style, String{markup.string(node.text)});
+        }
+        else if (has_icon)
+        {
+            widget = new Button(parent, button_style, Icon::get(String{markup.string(node.icon)}));
+        }
+        else
+        {
+            widget = new Button(parent, button_style);
+        }
+
+        break;
+    }
+
+    case COMPILED_WIDGET_LABEL:
+        widget = new Label(
+            parent,
+            compiled_string_or_default(markup, node.text, "Label"),
+            (Anchor)node.anchor);
+        break;
+
+    case COMPILED_WIDGET_IMAGE:
+        widget = new Image(
+            parent,
+            Bitmap::load_from_or_placeholder(compiled_string_or_default(markup, node.path, "null").cstring()));
+        break;
+
+    case COMPILED_WIDGET_SLIDER:
+        widget = new Slider(parent);
+        break;
+
+    default:
+        widget = new Placeholder(parent, String{markup.string(node.name)});
+        break;
+    }
+
+    widget_apply_attribute_from_compiled(widget, markup, node);
+
+    return widget;
+}
+
+// Nodes are in pre-order so the whole tree is built walking the array
+// once, `index` is left on the node following the last descendant.
+static void widget_create_childs_from_compiled(Widget *parent, CompiledMarkup &markup, size_t &index, size_t childs)
+{
+    for (size_t i = 0; i < childs; i++)
+    {
+        auto &node = markup.node(index++);
+
+        auto widget = widget_create_from_compiled(parent, markup, node);
+        widget_create_childs_from_compiled(widget, markup, index, node.childs);
+    }
+}
+
+static Window *window_create_from_compiled(CompiledMarkup &markup)
+{
+    auto &root = markup.node(0);
+
+    WindowFlag flags = 0;
+
+    if (root.flags & COMPILED_MARKUP_BORDERLESS)
+    {
+        flags |= WINDOW_BORDERLESS;
+    }
+
+    if (root.flags & COMPILED_MARKUP_RESIZABLE)
+    {
+        flags |= WINDOW_RESIZABLE;
+    }
+
+    if (root.flags & COMPILED_MARKUP_ALWAYS_FOCUSED)
+    {
+        flags |= WINDOW_ALWAYS_FOCUSED;
+    }
+
+    if (root.flags & COMPILED_MARKUP_SWALLOW)
+    {
+        flags |= WINDOW_SWALLOW;
+    }
+
+    if (root.flags & COMPILED_MARKUP_TRANSPARENT)
+    {
+        flags |= WINDOW_TRANSPARENT;
+    }
+
+    auto window = new Window(flags);
+
+    window->size(Vec2i(root.width, root.height));
+
+    if (markup.has(root.icon))
+    {
+        window->icon(Icon::get(String{markup.string(root.icon)}));
+    }
+
+    if (markup.has(root.text))
+    {
+        window->title(String{markup.string(root.text)});
+    }
+
+    widget_apply_attribute_from_compiled(window->root(), markup, root);
+
+    size_t index = 1;
+    widget_create_childs_from_compiled(window->root(), markup, index, root.childs);
+
+    return window;
+}
+
+// Markup files shipped with applications are compiled at build time by
+// toolbox/markup-compiler.py, plain text markup is still accepted for the
+// layout viewer and files edited by hand.
 Window *window_create_from_file(const char *path)
 {
-    auto root = markup::parse_file(path);
+    uint start = system_get_ticks();
+
+    void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_read_all(path, &buffer, &size) != SUCCESS)
+    {
+        logger_error("Failed to load markup from '%s'", path);
+        size = 0;
+    }
+
+    Window *window = nullptr;
+
+    CompiledMarkup compiled{buffer, size};
+
+    if (compiled.valid())
+    {
+        window = window_create_from_compiled(compiled);
+    }
+    else
+    {
+        auto document = markup::parse((const char *)buffer, size);
+        auto &root = document.root();
+
+        window = window_create_from_markup(root);
+
+        widget_apply_attribute_from_markup(window->root(), root);
+        widget_create_childs_from_markup(window->root(), root);
+    }
 
-    auto window = window_create_from_markup(root);
+    free(buffer);
 
-    widget_apply_attribute_from_markup(window->root(), root);
-    widget_create_childs_from_markup(window->root(), root);
+    logger_info("Window created from '%s' in %dms", path, (int)(system_get_ticks() - start));
 
     return window;
 }
@@ -669,7 +669,7 @@ void Window::widget_removed(Widget *widget)
     widget_by_id.remove_value(widget);
 }
 
-void Window::register_widget_by_id(String id, Widget *widget)
+void Window::register_widget_by_id(Atom id, Widget *widget)
 {
     widget_by_id[id] = widget;
 }
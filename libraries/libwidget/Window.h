@@ -3,6 +3,7 @@
 #include <libgraphic/Bitmap.h>
 #include <libgraphic/Painter.h>
 #include <libsystem/eventloop/Invoker.h>
+#include <libutils/Atom.h>
 #include <libutils/HashMap.h>
 #include <libutils/Vector.h>
 #include <libwidget/Cursor.h>
@@ -56,7 +57,7 @@ struct Window
     Widget *focused_widget = nullptr;
     Widget *mouse_focused_widget = nullptr;
     Widget *mouse_over_widget = nullptr;
-    HashMap<String, Widget *> widget_by_id{};
+    HashMap<Atom, Widget *> widget_by_id{};
 
     OwnPtr<Invoker> _repaint_invoker;
 
@@ -144,7 +145,7 @@ public:
     void should_relayout();
 
     template <typename WidgetType, typename CallbackType>
-    void with_widget(String name, CallbackType callback)
+    void with_widget(Atom name, CallbackType callback)
     {
         if (widget_by_id.has_key(name))
         {
@@ -163,5 +164,5 @@ public:
 
     void widget_removed(Widget *widget);
 
-    void register_widget_by_id(String id, Widget *widget);
+    void register_widget_by_id(Atom id, Widget *widget);
 };
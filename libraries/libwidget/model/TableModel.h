@@ -2,18 +2,138 @@
 
 #include <libgraphic/Color.h>
 #include <libutils/Observable.h>
+#include <libutils/Vector.h>
 
 #include <libwidget/utils/Variant.h>
 
+struct TableModelChange
+{
+    enum Type
+    {
+        INSERTED,
+        REMOVED,
+        CHANGED,
+    };
+
+    Type type;
+    int row;
+    int count;
+};
+
 class TableModel :
     public RefCounted<TableModel>,
     public Observable<TableModel>
 {
+private:
+    Vector<TableModelChange> _changes{};
+    bool _reset = true;
+
+    void record(TableModelChange::Type type, int row, int count)
+    {
+        if (_changes.any())
+        {
+            auto &last = _changes[_changes.count() - 1];
+
+            if (last.type == type && type == TableModelChange::REMOVED && last.row == row)
+            {
+                last.count += count;
+                return;
+            }
+
+            if (last.type == type && type != TableModelChange::REMOVED && last.row + last.count == row)
+            {
+                last.count += count;
+                return;
+            }
+        }
+
+        _changes.push_back({type, row, count});
+    }
+
+protected:
+    // Changes are replayed in order by observers, row numbers are the ones
+    // the table has after the previous changes were applied.
+    void did_insert_rows(int row, int count)
+    {
+        _reset = false;
+        record(TableModelChange::INSERTED, row, count);
+    }
+
+    void did_remove_rows(int row, int count)
+    {
+        _reset = false;
+        record(TableModelChange::REMOVED, row, count);
+    }
+
+    void did_change_rows(int row, int count)
+    {
+        _reset = false;
+        record(TableModelChange::CHANGED, row, count);
+    }
+
+    // Record the changes between two versions of the rows sorted the same
+    // way: `compare(old_row, new_row)` orders rows by their key like a sort
+    // comparator, `equals(old_row, new_row)` tells if a row keeping its key
+    // also kept its content. Rows out of order are still reported right,
+    // only as more removals and insertions than necessary.
+    template <typename TCompare, typename TEquals>
+    void did_diff_rows(int old_count, int new_count, TCompare compare, TEquals equals)
+    {
+        _reset = false;
+
+        int old_row = 0;
+        int new_row = 0;
+
+        while (old_row < old_count || new_row < new_count)
+        {
+            int order = old_row == old_count   ? 1
+                        : new_row == new_count ? -1
+                                               : compare(old_row, new_row);
+
+            if (order < 0)
+            {
+                record(TableModelChange::REMOVED, new_row, 1);
+                old_row++;
+            }
+            else if (order > 0)
+            {
+                record(TableModelChange::INSERTED, new_row, 1);
+                new_row++;
+            }
+            else
+            {
+                if (!equals(old_row, new_row))
+                {
+                    record(TableModelChange::CHANGED, new_row, 1);
+                }
+
+                old_row++;
+                new_row++;
+            }
+        }
+    }
+
 public:
     TableModel() {}
 
     virtual ~TableModel() {}
 
+    // True when the model didn't say what changed, everything has to be
+    // fetched again.
+    bool everything_changed() { return _reset; }
+
+    const Vector<TableModelChange> &changes() { return _changes; }
+
+    // Notify the observers of the changes recorded since the last update,
+    // a model recording none is considered reset.
+    void did_update()
+    {
+        Observable<TableModel>::did_update();
+
+        _changes.clear();
+        _reset = true;
+    }
+
     virtual int rows()
     {
         return 0;
@@ -1,135 +1,584 @@
-#include <libutils/Scanner.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
 
 #include <libwidget/model/TextModel.h>
 
-RefPtr<TextModel> TextModel::empty()
+static bool is_continuation(char byte)
 {
-    auto model = make<TextModel>();
-    model->append_line(own<TextModelLine>());
-    return model;
+    return (byte & 0xc0) == 0x80;
 }
 
-RefPtr<TextModel> TextModel::from_file(const char *path)
+static size_t count_codepoints(StringView text)
 {
-    auto model = make<TextModel>();
+    size_t count = 0;
 
-    Stream *stream = stream_open(path, OPEN_READ | OPEN_BUFFERED);
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        count += !is_continuation(text[i]);
+    }
 
-    StreamScanner scan{stream};
+    return count;
+}
 
-    // Skip the utf8 bom header if present.
-    scan.skip_word("\xEF\xBB\xBF");
+static size_t count_codepoints(const PieceTable &text, size_t offset, size_t size)
+{
+    size_t count = 0;
+
+    text.read(offset, size, [&](StringView run) {
+        count += count_codepoints(run);
+    });
+
+    return count;
+}
+
+/* --- TextModelLine -------------------------------------------------------- */
+
+size_t TextModelLine::offset_of(size_t column) const
+{
+    if (column >= _length)
+    {
+        return _size;
+    }
+
+    // Plain ASCII, one byte per codepoint.
+    if (_length == _size)
+    {
+        return column;
+    }
+
+    while (_hint_column > column)
+    {
+        do
+        {
+            _hint_offset--;
+        } while (_hint_offset > 0 && is_continuation(_hint_offset));
+
+        _hint_column--;
+    }
+
+    while (_hint_column < column)
+    {
+        do
+        {
+            _hint_offset++;
+        } while (_hint_offset < _size && is_continuation(_hint_offset));
+
+        _hint_column++;
+    }
+
+    return _hint_offset;
+}
+
+Codepoint TextModelLine::operator[](size_t column) const
+{
+    assert(column < _length);
+
+    size_t start = offset_of(column);
+    size_t end = offset_of(column + 1);
+
+    uint8_t buffer[5] = {};
+    _text->copy(_start + start, MIN(end - start, 4u), (char *)buffer);
+
+    Codepoint codepoint = 0;
+    utf8_to_codepoint(buffer, &codepoint);
+
+    return codepoint;
+}
+
+/* --- TextModelLineIndex --------------------------------------------------- */
+
+void TextModelLineIndex::update_blocks() const
+{
+    _block_lines.clear();
+    _block_starts.clear();
+
+    size_t line = 0;
+    size_t start = 0;
+
+    for (size_t i = 0; i < _blocks.count(); i++)
+    {
+        _block_lines.push_back(line);
+        _block_starts.push_back(start);
+
+        line += _blocks[i].lines.count();
+        start += _blocks[i].size;
+    }
+
+    _dirty = false;
+}
+
+void TextModelLineIndex::locate(size_t line, size_t &block, size_t &index) const
+{
+    assert(line < _count);
+
+    if (_dirty)
+    {
+        update_blocks();
+    }
+
+    size_t low = 0;
+    size_t high = _blocks.count();
+
+    while (high - low > 1)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (_block_lines[middle] <= line)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    block = low;
+    index = line - _block_lines[low];
+}
+
+void TextModelLineIndex::clear()
+{
+    _blocks.clear();
+    _count = 0;
+    _dirty = true;
+}
+
+void TextModelLineIndex::append(Line line)
+{
+    if (_blocks.empty() || _blocks[_blocks.count() - 1].lines.count() >= BLOCK_SIZE)
+    {
+        _blocks.push_back({});
+    }
+
+    auto &block = _blocks[_blocks.count() - 1];
+
+    block.lines.push_back(line);
+    block.size += line.size;
+
+    _count++;
+    _dirty = true;
+}
+
+TextModelLineIndex::Line TextModelLineIndex::line(size_t index) const
+{
+    size_t block;
+    size_t within;
+    locate(index, block, within);
+
+    return _blocks[block].lines[within];
+}
+
+size_t TextModelLineIndex::start(size_t line) const
+{
+    size_t block;
+    size_t within;
+    locate(line, block, within);
+
+    size_t start = _block_starts[block];
+
+    for (size_t i = 0; i < within; i++)
+    {
+        start += _blocks[block].lines[i].size;
+    }
+
+    return start;
+}
+
+size_t TextModelLineIndex::line_at(size_t offset) const
+{
+    if (_dirty)
+    {
+        update_blocks();
+    }
+
+    size_t low = 0;
+    size_t high = _blocks.count();
 
-    while (scan.do_continue())
+    while (high - low > 1)
     {
-        auto line = own<TextModelLine>();
+        size_t middle = low + (high - low) / 2;
 
-        while (scan.do_continue() &&
-               scan.current_codepoint() != '\n')
+        if (_block_starts[middle] <= offset)
         {
-            line->append(scan.current_codepoint());
-            scan.foreward_codepoint();
+            low = middle;
         }
-        scan.skip('\n'); // skip the \n
+        else
+        {
+            high = middle;
+        }
+    }
+
+    auto &lines = _blocks[low].lines;
+    size_t start = _block_starts[low];
+    size_t index = 0;
+
+    while (index + 1 < lines.count() && start + lines[index].size <= offset)
+    {
+        start += lines[index].size;
+        index++;
+    }
+
+    return _block_lines[low] + index;
+}
+
+void TextModelLineIndex::update(size_t line, Line removed, Line inserted)
+{
+    size_t block;
+    size_t within;
+    locate(line, block, within);
 
-        model->append_line(line);
+    auto &current = _blocks[block].lines[within];
+
+    current.size = current.size - removed.size + inserted.size;
+    current.length = current.length - removed.length + inserted.length;
+
+    _blocks[block].size = _blocks[block].size - removed.size + inserted.size;
+
+    // Unsigned arithmetic wraps around, adding the difference works even
+    // when the line shrinks.
+    size_t delta = inserted.size - removed.size;
+
+    for (size_t i = block + 1; i < _block_starts.count(); i++)
+    {
+        _block_starts[i] += delta;
     }
+}
 
-    stream_close(stream);
+void TextModelLineIndex::splice(size_t line, size_t count, const Vector<Line> &lines)
+{
+    size_t block;
+    size_t index;
+    locate(line, block, index);
 
-    if (model->line_count() == 0)
+    for (size_t i = 0; i < count; i++)
     {
-        model->append_line(own<TextModelLine>());
+        while (index == _blocks[block].lines.count())
+        {
+            if (_blocks[block].lines.empty())
+            {
+                _blocks.remove_index(block);
+            }
+            else
+            {
+                block++;
+            }
+
+            index = 0;
+        }
+
+        _blocks[block].size -= _blocks[block].lines[index].size;
+        _blocks[block].lines.remove_index(index);
     }
 
+    _count = _count - count + lines.count();
+    _dirty = true;
+
+    if (lines.empty())
+    {
+        if (_blocks[block].lines.empty())
+        {
+            _blocks.remove_index(block);
+        }
+
+        return;
+    }
+
+    auto &old_lines = _blocks[block].lines;
+    Vector<Line> merged(old_lines.count() + lines.count());
+
+    for (size_t i = 0; i < index; i++)
+    {
+        merged.push_back(old_lines[i]);
+    }
+
+    for (size_t i = 0; i < lines.count(); i++)
+    {
+        merged.push_back(lines[i]);
+    }
+
+    for (size_t i = index; i < old_lines.count(); i++)
+    {
+        merged.push_back(old_lines[i]);
+    }
+
+    _blocks.remove_index(block);
+
+    // Keep blocks small enough for the walk inside them to stay cheap.
+    size_t chunk = merged.count() <= BLOCK_SIZE * 2 ? merged.count() : BLOCK_SIZE;
+
+    for (size_t first = 0; first < merged.count(); first += chunk)
+    {
+        Block new_block{};
+
+        for (size_t i = first; i < MIN(first + chunk, merged.count()); i++)
+        {
+            new_block.lines.push_back(merged[i]);
+            new_block.size += merged[i].size;
+        }
+
+        _blocks.insert(block++, move(new_block));
+    }
+}
+
+/* --- TextModel ------------------------------------------------------------ */
+
+RefPtr<TextModel> TextModel::empty()
+{
+    return make<TextModel>();
+}
+
+RefPtr<TextModel> TextModel::from_file(const char *path)
+{
+    void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_read_all(path, &buffer, &size) != SUCCESS)
+    {
+        return empty();
+    }
+
+    auto model = from_buffer((char *)buffer, size);
+
     model->span_add(TextModelSpan(0, 0, 10, THEME_ANSI_RED, THEME_ANSI_BLUE));
 
-    if (model->line_count() == 0)
+    return model;
+}
+
+RefPtr<TextModel> TextModel::from_buffer(char *buffer, size_t size)
+{
+    auto model = make<TextModel>();
+
+    model->_text = PieceTable{buffer, size};
+
+    // Skip the utf8 bom header if present.
+    if (size >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0)
+    {
+        model->_text.remove(0, 3);
+        buffer += 3;
+        size -= 3;
+    }
+
+    model->_lines.clear();
+
+    StringView text{buffer, size};
+    size_t start = 0;
+
+    while (const char *newline = (const char *)memchr(text.buffer() + start, '\n', size - start))
     {
-        model->append_line(own<TextModelLine>());
+        StringView line{text.buffer() + start, (size_t)(newline - text.buffer()) + 1 - start};
+        model->_lines.append({line.length(), count_codepoints(line)});
+        start += line.length();
     }
 
+    StringView last_line{text.buffer() + start, size - start};
+    model->_lines.append({last_line.length(), count_codepoints(last_line)});
+
     return model;
 }
 
+TextModel::TextModel()
+{
+    _lines.append({0, 0});
+}
+
+TextModelLine TextModel::line(size_t index) const
+{
+    auto info = _lines.line(index);
+
+    // Every line but the last one ends with a newline.
+    if (index + 1 < _lines.count())
+    {
+        info.size--;
+        info.length--;
+    }
+
+    return {_text, _lines.start(index), info.size, info.length};
+}
+
+String TextModel::string() const
+{
+    char *buffer = new char[_text.length() + 1];
+
+    _text.copy(0, _text.length(), buffer);
+    buffer[_text.length()] = '\0';
+
+    return String{make<StringStorage>(AdoptTag::ADOPT, buffer, _text.length())};
+}
+
+size_t TextModel::offset_at(TextCursor &cursor)
+{
+    auto current = line(cursor.line());
+
+    if (_hint_line == cursor.line())
+    {
+        current.hint(_hint_column, _hint_offset);
+    }
+
+    _hint_line = cursor.line();
+    _hint_column = cursor.column();
+    _hint_offset = current.offset_of(cursor.column());
+
+    return current.start() + _hint_offset;
+}
+
+void TextModel::replace(size_t offset, size_t size, StringView text)
+{
+    _hint_line = -1;
+
+    size_t first = _lines.line_at(offset);
+    size_t last = _lines.line_at(offset + size);
+
+    bool has_newline = memchr(text.buffer(), '\n', text.length()) != nullptr;
+
+    if (first == last && !has_newline)
+    {
+        _lines.update(
+            first,
+            {size, count_codepoints(_text, offset, size)},
+            {text.length(), count_codepoints(text)});
+    }
+    else
+    {
+        size_t first_start = _lines.start(first);
+        size_t last_end = _lines.start(last) + _lines.line(last).size;
+
+        size_t head = offset - first_start;
+        size_t tail = last_end - (offset + size);
+
+        Vector<TextModelLineIndex::Line> lines{};
+        TextModelLineIndex::Line current{head, count_codepoints(_text, first_start, head)};
+
+        for (size_t i = 0; i < text.length(); i++)
+        {
+            current.size++;
+            current.length += !is_continuation(text[i]);
+
+            if (text[i] == '\n')
+            {
+                lines.push_back(current);
+                current = {0, 0};
+            }
+        }
+
+        current.size += tail;
+        current.length += count_codepoints(_text, offset + size, tail);
+        lines.push_back(current);
+
+        _lines.splice(first, last - first + 1, lines);
+    }
+
+    _text.remove(offset, size);
+    _text.insert(offset, text);
+}
+
 void TextModel::append_at(TextCursor &cursor, Codepoint codepoint)
 {
-    line(cursor.line()).append_at(cursor.column(), codepoint);
+    uint8_t buffer[5] = {};
+    int size = codepoint_to_utf8(codepoint, buffer);
+
+    size_t offset = offset_at(cursor);
+    size_t hint_offset = _hint_offset;
+
+    replace(offset, 0, {(const char *)buffer, (size_t)size});
+
+    _hint_line = cursor.line();
+    _hint_column = cursor.column() + 1;
+    _hint_offset = hint_offset + size;
+
     cursor.move_right_within(*this);
 }
 
 void TextModel::backspace_at(TextCursor &cursor)
 {
+    auto current = line(cursor.line());
+
     if (cursor.line() > 0 &&
         cursor.column() == 0)
     {
-        int line_length = line(cursor.line() - 1).length();
-        line(cursor.line() - 1).append(line(cursor.line()));
+        size_t line_length = line(cursor.line() - 1).length();
 
-        _lines.remove_index(cursor.line());
+        replace(current.start() - 1, 1, "");
 
         cursor.move_up_within(*this);
         cursor.move_to_within(line(cursor.line()), line_length);
     }
-    else if (cursor.column() > 0 && line(cursor.line()).length() > 0)
+    else if (cursor.column() > 0 && current.length() > 0)
     {
-        line(cursor.line()).backspace_at(cursor.column());
+        size_t start = current.offset_of(cursor.column() - 1);
+        size_t end = current.offset_of(cursor.column());
+
+        replace(current.start() + start, end - start, "");
         cursor.move_left_within(*this);
     }
 }
 
 void TextModel::delete_at(TextCursor &cursor)
 {
-    if (cursor.line() < line_count() - 1 && cursor.column() == line(cursor.line()).length())
-    {
-        line(cursor.line()).append(line(cursor.line() + 1));
+    auto current = line(cursor.line());
 
-        _lines.remove_index(cursor.line() + 1);
+    if (cursor.line() < line_count() - 1 && cursor.column() == current.length())
+    {
+        replace(current.start() + current.size(), 1, "");
     }
-    else if (cursor.column() < line(cursor.line()).length() && line(cursor.line()).length() > 0)
+    else if (cursor.column() < current.length())
     {
-        line(cursor.line()).delete_at(cursor.column());
+        size_t start = current.offset_of(cursor.column());
+        size_t end = current.offset_of(cursor.column() + 1);
+
+        replace(current.start() + start, end - start, "");
     }
 }
 
 void TextModel::newline_at(TextCursor &cursor)
 {
-    auto left_side_line = own<TextModelLine>();
-    auto right_side_line = own<TextModelLine>();
-
-    for (size_t i = 0; i < cursor.column(); i++)
-    {
-        left_side_line->append(line(cursor.line())[i]);
-    }
-
-    for (size_t i = cursor.column(); i < line(cursor.line()).length(); i++)
-    {
-        right_side_line->append(line(cursor.line())[i]);
-    }
-
-    _lines.remove_index(cursor.line());
-
-    _lines.insert(cursor.line(), left_side_line);
-    _lines.insert(cursor.line() + 1, right_side_line);
+    replace(offset_at(cursor), 0, "\n");
 
     cursor.move_down_within(*this);
     cursor.move_to_beginning_of_the_line();
 }
 
+static void swap_lines(PieceTable &text, const TextModelLine &top, const TextModelLine &bottom, char *buffer)
+{
+    text.copy(bottom.start(), bottom.size(), buffer);
+    buffer[bottom.size()] = '\n';
+    text.copy(top.start(), top.size(), buffer + bottom.size() + 1);
+}
+
 void TextModel::move_line_up_at(TextCursor &cursor)
 {
     if (cursor.line() > 0)
     {
-        _lines.insert(cursor.line() - 1, _lines.take_at(cursor.line()));
+        auto top = line(cursor.line() - 1);
+        auto bottom = line(cursor.line());
+
+        size_t size = bottom.start() + bottom.size() - top.start();
+        char *buffer = (char *)malloc(size);
+
+        swap_lines(_text, top, bottom, buffer);
+        replace(top.start(), size, {buffer, size});
+
+        free(buffer);
+
         cursor.move_up_within(*this);
     }
 }
 
 void TextModel::move_line_down_at(TextCursor &cursor)
 {
-    if (cursor.line() < line_count())
+    if (cursor.line() + 1 < line_count())
     {
-        _lines.insert(cursor.line() + 1, _lines.take_at(cursor.line()));
+        auto top = line(cursor.line());
+        auto bottom = line(cursor.line() + 1);
+
+        size_t size = bottom.start() + bottom.size() - top.start();
+        char *buffer = (char *)malloc(size);
+
+        swap_lines(_text, top, bottom, buffer);
+        replace(top.start(), size, {buffer, size});
+
+        free(buffer);
+
         cursor.move_down_within(*this);
     }
 }
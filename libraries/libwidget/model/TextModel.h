@@ -1,64 +1,119 @@
 #pragma once
 
 #include <libsystem/unicode/Codepoint.h>
-#include <libutils/OwnPtr.h>
+#include <libutils/IntervalTree.h>
+#include <libutils/PieceTable.h>
 #include <libutils/RefCounted.h>
+#include <libutils/String.h>
 #include <libutils/Vector.h>
 
 #include <libwidget/Theme.h>
 
 struct TextCursor;
 
+// View of one line of a TextModel, columns are counted in codepoints while
+// the text is stored as UTF-8. Any edit of the model invalidates it.
 class TextModelLine
 {
 private:
-    Vector<Codepoint> _codepoints{};
+    const PieceTable *_text;
+    size_t _start;
+    size_t _size;
+    size_t _length;
 
-public:
-    TextModelLine()
-    {
-    }
+    // Byte offset of the codepoint at _hint_column. Lookups walk from there
+    // so reading a line from left to right stays linear.
+    mutable size_t _hint_column = 0;
+    mutable size_t _hint_offset = 0;
 
-    ~TextModelLine()
+    bool is_continuation(size_t offset) const
     {
+        return (_text->at(_start + offset) & 0xc0) == 0x80;
     }
 
-    Codepoint operator[](size_t index)
-    {
-        assert(index < length());
+public:
+    // Byte offset of the line in the text.
+    size_t start() const { return _start; }
 
-        return _codepoints[index];
-    }
+    // Size in bytes, without the newline.
+    size_t size() const { return _size; }
 
-    size_t length()
-    {
-        return _codepoints.count();
-    }
+    // Length in codepoints.
+    size_t length() const { return _length; }
 
-    void append(Codepoint codepoint)
+    TextModelLine(const PieceTable &text, size_t start, size_t size, size_t length)
+        : _text(&text),
+          _start(start),
+          _size(size),
+          _length(length)
     {
-        _codepoints.push_back(codepoint);
     }
 
-    void append(TextModelLine &line)
-    {
-        _codepoints.push_back_many(line._codepoints);
-    }
+    // Byte offset of `column` from the start of the line.
+    size_t offset_of(size_t column) const;
 
-    void append_at(size_t index, Codepoint codepoint)
+    // Start walking from a column whose offset is already known.
+    void hint(size_t column, size_t offset) const
     {
-        _codepoints.insert(index, codepoint);
+        _hint_column = column;
+        _hint_offset = offset;
     }
 
-    void backspace_at(size_t index)
+    Codepoint operator[](size_t column) const;
+};
+
+// Size and length of every line, kept in blocks of about a hundred lines
+// with the first line and byte of each block cached. Finding where a line
+// starts, or which line an offset is on, is a binary search over the
+// blocks then a short walk inside one. Adding or removing lines only
+// touches one block instead of shifting every line after it.
+class TextModelLineIndex
+{
+public:
+    struct Line
     {
-        _codepoints.remove_index(index - 1);
-    }
+        size_t size;   // Bytes, newline included.
+        size_t length; // Codepoints, newline included.
+    };
 
-    void delete_at(size_t index)
+private:
+    static constexpr size_t BLOCK_SIZE = 128;
+
+    struct Block
     {
-        _codepoints.remove_index(index);
-    }
+        Vector<Line> lines{};
+        size_t size = 0;
+    };
+
+    Vector<Block> _blocks{};
+    size_t _count = 0;
+
+    mutable Vector<size_t> _block_lines{};
+    mutable Vector<size_t> _block_starts{};
+    mutable bool _dirty = true;
+
+    void update_blocks() const;
+
+    void locate(size_t line, size_t &block, size_t &index) const;
+
+public:
+    size_t count() const { return _count; }
+
+    void clear();
+
+    void append(Line line);
+
+    Line line(size_t index) const;
+
+    size_t start(size_t line) const;
+
+    size_t line_at(size_t offset) const;
+
+    // Grow or shrink a line without adding or removing any.
+    void update(size_t line, Line removed, Line inserted);
+
+    // Replace `count` lines starting at `line` by `lines`.
+    void splice(size_t line, size_t count, const Vector<Line> &lines);
 };
 
 class TextModelSpan
@@ -103,25 +158,50 @@ public:
 class TextModel : public RefCounted<TextModel>
 {
 private:
-    Vector<OwnPtr<TextModelLine>> _lines{1024};
-    Vector<TextModelSpan> _spans{1024};
+    PieceTable _text{};
+    TextModelLineIndex _lines{};
+    IntervalTree<uint64_t, TextModelSpan> _spans{};
+
+    // Where the last edit happened, typing at the same place doesn't have
+    // to walk the line from its start to find the offset of the cursor.
+    size_t _hint_line = -1;
+    size_t _hint_column = 0;
+    size_t _hint_offset = 0;
+
+    static uint64_t span_position(size_t line, size_t column)
+    {
+        return ((uint64_t)line << 32) | column;
+    }
+
+    size_t offset_at(TextCursor &cursor);
+
+    // Replace `size` bytes at `offset` by `text` and keep the line index up
+    // to date.
+    void replace(size_t offset, size_t size, StringView text);
 
 public:
     static RefPtr<TextModel> empty();
 
     static RefPtr<TextModel> from_file(const char *path);
 
-    TextModel() {}
+    // Take ownership of `buffer` which must come from malloc(), the text
+    // isn't copied.
+    static RefPtr<TextModel> from_buffer(char *buffer, size_t size);
+
+    TextModel();
 
     ~TextModel() {}
 
     /* --- Editing ---------------------------------------------------------- */
 
-    TextModelLine &line(int index) { return *_lines[index]; }
+    TextModelLine line(size_t index) const;
 
     size_t line_count() const { return _lines.count(); }
 
-    void append_line(OwnPtr<TextModelLine> line) { _lines.push_back(line); }
+    // Size of the text in bytes.
+    size_t size() const { return _text.length(); }
+
+    String string() const;
 
     void append_at(TextCursor &cursor, Codepoint codepoint);
 
@@ -139,25 +219,23 @@ public:
 
     void span_add(TextModelSpan span)
     {
-        _spans.insert_sorted(span, [](auto &left, auto &right) {
-            return left.line() < right.line() &&
-                   left.start() < right.start();
-        });
+        _spans.add(
+            span_position(span.line(), span.start()),
+            span_position(span.line(), span.end()),
+            span);
     }
 
+    // When spans overlap the one starting last wins.
     TextModelSpan span_at(size_t line, size_t column)
     {
-        for (size_t i = 0; i < _spans.count(); i++)
-        {
-            auto &span = _spans[i];
+        TextModelSpan result{line, column, column + 1};
 
-            if (span.line() == line && column >= span.start() && column < span.end())
-            {
-                return span;
-            }
-        }
+        _spans.containing(span_position(line, column), [&](auto, auto, auto &span) {
+            result = span;
+            return Iteration::CONTINUE;
+        });
 
-        return TextModelSpan(line, column, column + 1);
+        return result;
     }
 
     void span_clear()
@@ -186,7 +264,7 @@ public:
         }
     }
 
-    void move_to_within(TextModelLine &line, size_t column)
+    void move_to_within(const TextModelLine &line, size_t column)
     {
         _column = clamp(column, 0, line.length());
         _prefered_column = _column;
@@ -269,7 +347,7 @@ public:
         _prefered_column = _column;
     }
 
-    void move_home_within(TextModelLine &line)
+    void move_home_within(const TextModelLine &line)
     {
         __unused(line);
 
@@ -277,7 +355,7 @@ public:
         _prefered_column = _column;
     }
 
-    void move_end_within(TextModelLine &line)
+    void move_end_within(const TextModelLine &line)
     {
         _column = line.length();
         _prefered_column = _column;
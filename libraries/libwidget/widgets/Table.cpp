@@ -73,25 +73,172 @@ int Table::row_at(Vec2i position) const
     return row;
 }
 
-void Table::paint_cell(Painter &painter, int row, int column)
+void Table::visible_rows(int &first, int &last) const
+{
+    first = MAX(0, _scroll_offset / TABLE_ROW_HEIGHT - 1);
+    last = MIN(_model->rows(), ((_scroll_offset + list_bound().height()) / TABLE_ROW_HEIGHT) + 1);
+    last = MAX(first, last);
+}
+
+void Table::cache_range(int first, int last)
+{
+    if (first == _cache_first && last - first == (int)_cache.count())
+    {
+        return;
+    }
+
+    Vector<CachedRow> cache(last - first);
+
+    for (int row = first; row < last; row++)
+    {
+        int index = row - _cache_first;
+
+        if (index >= 0 && index < (int)_cache.count())
+        {
+            cache.push_back(move(_cache[index]));
+        }
+        else
+        {
+            cache.push_back({});
+        }
+    }
+
+    _cache = move(cache);
+    _cache_first = first;
+}
+
+void Table::cache_invalidate(int from, int to)
+{
+    for (size_t i = 0; i < _cache.count(); i++)
+    {
+        int cached = _cache_first + i;
+
+        if (cached >= from && cached < to)
+        {
+            _cache[i].valid = false;
+        }
+    }
+}
+
+Table::CachedRow &Table::cached_row(int row)
+{
+    auto &cached = _cache[row - _cache_first];
+
+    if (!cached.valid)
+    {
+        cached.cells.clear();
+
+        for (int column = 0; column < _model->columns(); column++)
+        {
+            Variant data = _model->data(row, column);
+            cached.cells.push_back({data.as_string(), data.icon()});
+        }
+
+        cached.valid = true;
+    }
+
+    return cached;
+}
+
+void Table::model_updated()
+{
+    if (_model->everything_changed())
+    {
+        _cache.clear();
+
+        if (_selected >= _model->rows())
+        {
+            _selected = -1;
+        }
+
+        should_repaint();
+        should_relayout();
+        return;
+    }
+
+    int first;
+    int last;
+    visible_rows(first, last);
+
+    bool rows_moved = false;
+    bool visible_changed = false;
+
+    for (size_t i = 0; i < _model->changes().count(); i++)
+    {
+        auto &change = _model->changes()[i];
+
+        switch (change.type)
+        {
+        case TableModelChange::INSERTED:
+            if (_selected >= change.row)
+            {
+                _selected += change.count;
+            }
+
+            cache_invalidate(change.row, INT32_MAX);
+            rows_moved = true;
+            visible_changed |= change.row < last;
+            break;
+
+        case TableModelChange::REMOVED:
+            if (_selected >= change.row + change.count)
+            {
+                _selected -= change.count;
+            }
+            else if (_selected >= change.row)
+            {
+                _selected = -1;
+            }
+
+            cache_invalidate(change.row, INT32_MAX);
+            rows_moved = true;
+            visible_changed |= change.row < last;
+            break;
+
+        case TableModelChange::CHANGED:
+            cache_invalidate(change.row, change.row + change.count);
+
+            if (change.row < last && change.row + change.count > first)
+            {
+                visible_changed = true;
+            }
+            break;
+
+        default:
+            ASSERT_NOT_REACHED();
+        }
+    }
+
+    // Rows added or removed after the ones in view only move the scrollbar.
+    if (rows_moved)
+    {
+        should_relayout();
+    }
+
+    if (visible_changed)
+    {
+        should_repaint();
+    }
+}
+
+void Table::paint_cell(Painter &painter, int row, int column, CachedCell &cell)
 {
     Recti bound = cell_bound(row, column);
-    Variant data = _model->data(row, column);
 
     painter.push();
     painter.clip(bound);
 
-    if (data.has_icon())
+    if (cell.icon)
     {
         painter.blit_icon(
-            *data.icon(),
+            *cell.icon,
             ICON_18PX,
             Recti(bound.x() + 7, bound.y() + 7, 18, 18),
             color(THEME_FOREGROUND));
 
         painter.draw_string(
             *font(),
-            data.as_string(),
+            cell.text.cstring(),
             Vec2i(bound.x() + 7 + 18 + 7, bound.y() + 20),
             color(THEME_FOREGROUND));
     }
@@ -99,7 +246,7 @@ void Table::paint_cell(Painter &painter, int row, int column)
     {
         painter.draw_string(
             *font(),
-            data.as_string(),
+            cell.text.cstring(),
             Vec2i(bound.x() + 7, bound.y() + 20),
             color(THEME_FOREGROUND));
     }
@@ -145,11 +292,13 @@ void Table::paint(Painter &painter, Recti rectangle)
     }
     else
     {
-        for (int row = MAX(0, _scroll_offset / TABLE_ROW_HEIGHT - 1);
-             row < MIN(_model->rows(), ((_scroll_offset + list_bound().height()) / TABLE_ROW_HEIGHT) + 1);
-             row++)
-        {
+        int first;
+        int last;
+        visible_rows(first, last);
+        cache_range(first, last);
 
+        for (int row = first; row < last; row++)
+        {
             if (_selected == row)
             {
                 painter.fill_rectangle(row_bound(row), color(THEME_SELECTION));
@@ -160,12 +309,15 @@ void Table::paint(Painter &painter, Recti rectangle)
                 painter.fill_rectangle(row_bound(row), color(THEME_FOREGROUND).with_alpha(0.05));
             }
 
-            for (int column = 0; column < column_count; column++)
+            auto &cached = cached_row(row);
+
+            for (int column = 0; column < (int)cached.cells.count(); column++)
             {
-                paint_cell(painter, row, column);
+                paint_cell(painter, row, column, cached.cells[column]);
             }
         }
     }
+
     painter.blur_rectangle(header_bound(), 8);
     painter.fill_rectangle(header_bound(), color(THEME_BACKGROUND).with_alpha(0.9));
 
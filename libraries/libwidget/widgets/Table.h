@@ -19,6 +19,29 @@ private:
 
     String _empty_message{"No data to display"};
 
+    // Cells of the rows in view, fetched from the model once and kept until
+    // the model says they changed or they scroll out of view.
+    struct CachedCell
+    {
+        String text;
+        RefPtr<Icon> icon;
+    };
+
+    struct CachedRow
+    {
+        bool valid = false;
+        Vector<CachedCell> cells{};
+    };
+
+    int _cache_first = 0;
+    Vector<CachedRow> _cache{};
+
+    void visible_rows(int &first, int &last) const;
+    void cache_range(int first, int last);
+    void cache_invalidate(int from, int to);
+    CachedRow &cached_row(int row);
+    void model_updated();
+
     Recti body_bound() const;
     Recti scrollbar_bound() const;
     Recti header_bound() const;
@@ -27,16 +50,17 @@ private:
     Recti column_bound(int column) const;
     Recti cell_bound(int row, int column) const;
     int row_at(Vec2i position) const;
-    void paint_cell(Painter &painter, int row, int column);
+    void paint_cell(Painter &painter, int row, int column, CachedCell &cell);
 
 public:
     void model(RefPtr<TableModel> model)
     {
         _model = model;
         _model_observer = model->observe([this](auto &) {
-            should_repaint();
-            should_relayout();
+            model_updated();
         });
+
+        _cache.clear();
     }
 
     void empty_message(String message)
@@ -81,7 +81,7 @@ void TextField::paint(Painter &painter, Recti rectangle)
         }
 
         // Line content
-        auto &line = _model->line(i);
+        auto line = _model->line(i);
 
         Vec2i current_position = line_bound.cutoff_left_and_right((_linenumbers ? 32 : 0) + 4, 0).position() + Vec2i(0, LINE_HEIGHT / 2 + 4);
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdio.h>
+#include <time.h>
+
+// libsystem/io/Stream.h redirects printf() to its own streams, benchmarks
+// report through the host one.
+#undef printf
+
+static inline double bench_now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Run the body __iterations times and report the time per iteration,
+// __bytes is the amount of data processed by one iteration (0 if it
+// doesn't make sense for this benchmark).
+#define BENCHMARK(__name, __iterations, __bytes, ...)                                   \
+    do                                                                                  \
+    {                                                                                   \
+        double __start = bench_now();                                                   \
+        for (size_t __i = 0; __i < (size_t)(__iterations); __i++)                       \
+        {                                                                               \
+            __VA_ARGS__;                                                                \
+        }                                                                               \
+        double __elapsed = bench_now() - __start;                                       \
+        double __per_iteration = __elapsed / (__iterations);                            \
+        if ((__bytes) > 0)                                                              \
+        {                                                                               \
+            printf("%-40s %12.3f us %10.1f MB/s\n", __name, __per_iteration * 1000000,     \
+                   ((double)(__bytes) / (1024 * 1024)) / __per_iteration);              \
+        }                                                                               \
+        else                                                                            \
+        {                                                                               \
+            printf("%-40s %12.3f us\n", __name, __per_iteration * 1000000);                \
+        }                                                                               \
+    } while (0)
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libutils/Arena.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr size_t COUNT = 10000;
+
+struct TreeNode
+{
+    TreeNode *left;
+    TreeNode *right;
+    int value;
+};
+
+static TreeNode *tree_malloc(int depth)
+{
+    auto node = (TreeNode *)malloc(sizeof(TreeNode));
+
+    node->value = depth;
+    node->left = depth > 0 ? tree_malloc(depth - 1) : nullptr;
+    node->right = depth > 0 ? tree_malloc(depth - 1) : nullptr;
+
+    return node;
+}
+
+static void tree_free(TreeNode *node)
+{
+    if (node)
+    {
+        tree_free(node->left);
+        tree_free(node->right);
+        free(node);
+    }
+}
+
+static TreeNode *tree_arena(Arena &arena, int depth)
+{
+    auto node = arena.make<TreeNode>();
+
+    node->value = depth;
+    node->left = depth > 0 ? tree_arena(arena, depth - 1) : nullptr;
+    node->right = depth > 0 ? tree_arena(arena, depth - 1) : nullptr;
+
+    return node;
+}
+
+static size_t tree_sum(TreeNode *node)
+{
+    return node ? node->value + tree_sum(node->left) + tree_sum(node->right) : 0;
+}
+
+int main(int, char const *[])
+{
+    static void *pointers[COUNT];
+
+    BENCHMARK("malloc 10000 x 32 bytes", 1000, 0, {
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            pointers[i] = malloc(32);
+            *(volatile char *)pointers[i] = i;
+        }
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            free(pointers[i]);
+        }
+    });
+
+    Arena arena{};
+
+    BENCHMARK("arena 10000 x 32 bytes", 1000, 0, {
+        ArenaScope scope{arena};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            pointers[i] = arena.allocate(32);
+            *(volatile char *)pointers[i] = i;
+        }
+    });
+
+    BENCHMARK("malloc tree 2^14 nodes", 200, 0, {
+        auto root = tree_malloc(13);
+        _sink = _sink + tree_sum(root);
+        tree_free(root);
+    });
+
+    BENCHMARK("arena tree 2^14 nodes", 200, 0, {
+        ArenaScope scope{arena};
+
+        auto root = tree_arena(arena, 13);
+        _sink = _sink + tree_sum(root);
+    });
+
+    BENCHMARK("malloc 1000 strings", 1000, 0, {
+        for (size_t i = 0; i < 1000; i++)
+        {
+            char *copy = (char *)malloc(12);
+            memcpy(copy, "hello world", 12);
+            pointers[i] = copy;
+        }
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            free(pointers[i]);
+        }
+    });
+
+    BENCHMARK("arena 1000 strings", 1000, 0, {
+        ArenaScope scope{arena};
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            pointers[i] = (void *)arena.copy("hello world").buffer();
+        }
+    });
+
+    return 0;
+}
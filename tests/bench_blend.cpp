@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libgraphic/Blending.h>
+#include <libgraphic/Color.h>
+#include <libsystem/math/MinMax.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr int WIDTH = 512;
+static constexpr int HEIGHT = 512;
+static constexpr size_t PIXELS = WIDTH * HEIGHT;
+
+// What Color::blend used to be.
+static Color float_blend(Color fg, Color gb)
+{
+    float a = (1 - fg.alphaf()) * gb.alphaf() + fg.alphaf();
+    float r = ((1 - fg.alphaf()) * gb.alphaf() * gb.redf() + fg.alphaf() * fg.redf()) / a;
+    float g = ((1 - fg.alphaf()) * gb.alphaf() * gb.greenf() + fg.alphaf() * fg.greenf()) / a;
+    float b = ((1 - fg.alphaf()) * gb.alphaf() * gb.bluef() + fg.alphaf() * fg.bluef()) / a;
+
+    return Color::from_rgba(r, g, b, a);
+}
+
+// Like an icon or a sprite: mostly opaque, a transparent border and
+// antialiased edges in between.
+static void make_image(Color *pixels, int edge)
+{
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            int distance = MIN(MIN(x, WIDTH - 1 - x), MIN(y, HEIGHT - 1 - y));
+            uint8_t alpha = distance < edge ? 0 : (distance < edge + 8 ? (distance - edge) * 32 : 255);
+
+            pixels[y * WIDTH + x] = Color::from_byte(x & 0xff, y & 0xff, (x ^ y) & 0xff, alpha);
+        }
+    }
+}
+
+static void reset(Color *pixels)
+{
+    for (size_t i = 0; i < PIXELS; i++)
+    {
+        pixels[i] = Color::from_byte(i & 0xff, 0x40, 0x80, 0xff);
+    }
+}
+
+static void blit_float(Color *destination, const Color *source)
+{
+    // The old blit walked columns first and blended every pixel.
+    for (int x = 0; x < WIDTH; x++)
+    {
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            Color &background = destination[y * WIDTH + x];
+            background = float_blend(source[y * WIDTH + x], background);
+        }
+    }
+}
+
+static void blit_integer(Color *destination, const Color *source)
+{
+    for (int x = 0; x < WIDTH; x++)
+    {
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            Color &background = destination[y * WIDTH + x];
+            background = Color::blend(source[y * WIDTH + x], background);
+        }
+    }
+}
+
+static void blit_spans(Color *destination, const Color *source, bool premultiplied)
+{
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        blend_span(destination + y * WIDTH, source + y * WIDTH, WIDTH, premultiplied);
+    }
+}
+
+int main(int, char const *[])
+{
+    Color *image = (Color *)malloc(PIXELS * sizeof(Color));
+    Color *premultiplied = (Color *)malloc(PIXELS * sizeof(Color));
+    Color *translucent = (Color *)malloc(PIXELS * sizeof(Color));
+    Color *screen = (Color *)malloc(PIXELS * sizeof(Color));
+
+    make_image(image, 32);
+
+    for (size_t i = 0; i < PIXELS; i++)
+    {
+        premultiplied[i] = image[i].premultiplied();
+        translucent[i] = image[i].with_alpha(0.5).premultiplied();
+    }
+
+    reset(screen);
+
+    size_t bytes = PIXELS * sizeof(Color);
+
+    BENCHMARK("blit sprite, float blend", 50, bytes, {
+        blit_float(screen, image);
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("blit sprite, integer blend", 50, bytes, {
+        blit_integer(screen, image);
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("blit sprite, straight spans", 50, bytes, {
+        blit_spans(screen, image, false);
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("blit sprite, premultiplied spans", 50, bytes, {
+        blit_spans(screen, premultiplied, true);
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("blit translucent, float blend", 50, bytes, {
+        blit_float(screen, translucent);
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("blit translucent, premultiplied spans", 50, bytes, {
+        blit_spans(screen, translucent, true);
+        _sink = _sink + screen[0].red();
+    });
+
+    Color shade = Color::from_byte(0, 0, 0, 100);
+
+    BENCHMARK("fill translucent, float blend", 50, bytes, {
+        for (size_t i = 0; i < PIXELS; i++)
+        {
+            screen[i] = float_blend(shade, screen[i]);
+        }
+        _sink = _sink + screen[0].red();
+    });
+
+    BENCHMARK("fill translucent, span", 50, bytes, {
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            blend_span(screen + y * WIDTH, shade, WIDTH);
+        }
+        _sink = _sink + screen[0].red();
+    });
+
+    free(image);
+    free(premultiplied);
+    free(translucent);
+    free(screen);
+
+    return 0;
+}
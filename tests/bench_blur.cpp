@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libgraphic/Blur.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr int WIDTH = 1920;
+static constexpr int HEIGHT = 1080;
+
+static void fill(Color *pixels)
+{
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            pixels[y * WIDTH + x] = Color::from_byte(x & 0xff, y & 0xff, (x * y) & 0xff, 0xff);
+        }
+    }
+}
+
+int main(int, char const *[])
+{
+    Color *pixels = (Color *)malloc(WIDTH * HEIGHT * sizeof(Color));
+    fill(pixels);
+
+    size_t bytes = WIDTH * HEIGHT * sizeof(Color);
+
+    BENCHMARK("box blur 1080p, radius 4, full size", 10, bytes, {
+        box_blur(pixels, WIDTH, WIDTH, HEIGHT, 4);
+        _sink = _sink + pixels[0].red();
+    });
+
+    BENCHMARK("box blur 1080p, radius 24, full size", 10, bytes, {
+        box_blur(pixels, WIDTH, WIDTH, HEIGHT, 24);
+        _sink = _sink + pixels[0].red();
+    });
+
+    int radii[] = {8, 16, 48, 96};
+
+    for (int radius : radii)
+    {
+        char name[64];
+        snprintf(name, 64, "blur 1080p, radius %d", radius);
+
+        BENCHMARK(name, 20, bytes, {
+            blur(pixels, WIDTH, Recti(WIDTH, HEIGHT), radius);
+            _sink = _sink + pixels[0].red();
+        });
+    }
+
+    // A panel across the top of the screen.
+    BENCHMARK("blur 1920x32 panel, radius 48", 200, WIDTH * 32 * sizeof(Color), {
+        blur(pixels, WIDTH, Recti(0, 0, WIDTH, 32), 48);
+        _sink = _sink + pixels[0].red();
+    });
+
+    free(pixels);
+
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include <stdio.h>
+
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#include "bench.h"
+
+// The previous implementation: 256 fixed buckets and a byte per byte djb2.
+
+static inline uint32_t legacy_hash(const void *object, size_t size)
+{
+    uint32_t hash = 5381;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = ((hash << 5) + hash) + ((const uint8_t *)object)[i];
+    }
+
+    return hash;
+}
+
+static inline uint32_t legacy_hash(const String &value)
+{
+    return legacy_hash(value.cstring(), value.length());
+}
+
+static inline uint32_t legacy_hash(const uint32_t &value)
+{
+    return legacy_hash(&value, sizeof(value));
+}
+
+template <typename TKey, typename TValue>
+class LegacyHashMap
+{
+private:
+    struct Item
+    {
+        uint32_t hash;
+        TKey key;
+        TValue value;
+    };
+
+    static constexpr int BUCKET_COUNT = 256;
+
+    Vector<Vector<Item>> _buckets{};
+
+    Vector<Item> &bucket(uint32_t hash)
+    {
+        return _buckets[hash % BUCKET_COUNT];
+    }
+
+    Item *item_by_key(const TKey &key)
+    {
+        return item_by_key(key, legacy_hash(key));
+    }
+
+    Item *item_by_key(const TKey &key, uint32_t hash)
+    {
+        Item *result = nullptr;
+        auto &b = bucket(hash);
+
+        b.foreach ([&](Item &item) {
+            if (item.hash == hash && item.key == key)
+            {
+                result = &item;
+                return Iteration::STOP;
+            }
+            else
+            {
+                return Iteration::CONTINUE;
+            }
+        });
+
+        return result;
+    }
+
+public:
+    size_t count()
+    {
+        size_t result = 0;
+
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            result += _buckets[i].count();
+        }
+
+        return result;
+    }
+
+    LegacyHashMap()
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            _buckets.push_back({});
+        }
+    }
+
+    LegacyHashMap(const LegacyHashMap &other)
+        : _buckets(other._buckets)
+    {
+    }
+
+    LegacyHashMap(LegacyHashMap &&other)
+        : _buckets(move(other._buckets))
+    {
+    }
+
+    void clear()
+    {
+        _buckets.clear();
+    }
+
+    void remove_key(TKey &key)
+    {
+        uint32_t h = legacy_hash(key);
+
+        bucket(h).remove_all_match([&](auto &item) {
+            return item.hash == h && item.key == key;
+        });
+    }
+
+    void remove_value(TValue &value)
+    {
+        _buckets.foreach ([&](auto &bucket) {
+            bucket.remove_all_match([&](auto &item) {
+                return item.value == value;
+            });
+
+            return Iteration::CONTINUE;
+        });
+    }
+
+    bool has_key(const TKey &key)
+    {
+        return item_by_key(key) != nullptr;
+    }
+
+    bool has_value(const TValue &value)
+    {
+        bool result = false;
+
+        this->foreach ([&](auto &, auto &v) {
+            if (v == value)
+            {
+                result = true;
+                return Iteration::STOP;
+            }
+            else
+            {
+                return Iteration::CONTINUE;
+            }
+        });
+
+        return result;
+    }
+
+    template <typename TCallback>
+    Iteration foreach (TCallback callback) const
+    {
+        return _buckets.foreach ([&](auto &bucket) {
+            return bucket.foreach ([&](auto &item) {
+                return callback(item.key, item.value);
+            });
+        });
+    }
+
+    LegacyHashMap &operator=(const LegacyHashMap &other)
+    {
+        _buckets = other._buckets;
+        return *this;
+    }
+
+    LegacyHashMap &operator=(LegacyHashMap &&other)
+    {
+        swap(_buckets, other._buckets);
+        return *this;
+    }
+
+    TValue &operator[](const TKey &key)
+    {
+        auto h = legacy_hash(key);
+        auto *i = item_by_key(key, h);
+
+        if (i)
+        {
+            return i->value;
+        }
+        else
+        {
+            auto &b = bucket(h);
+            return b.push_back({h, key, {}}).value;
+        }
+    }
+};
+
+static Vector<String> generate_keys(size_t count)
+{
+    Vector<String> keys;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char buffer[64];
+        snprintf(buffer, 64, "/System/Binaries/some-key-%zu", i * 7919);
+        keys.push_back(buffer);
+    }
+
+    return keys;
+}
+
+template <typename TMap>
+static void bench_map(const char *name, Vector<String> &keys, size_t iterations)
+{
+    char label[128];
+
+    snprintf(label, 128, "%s insert %zu", name, keys.count());
+    BENCHMARK(label, iterations, 0, {
+        TMap map;
+
+        for (size_t i = 0; i < keys.count(); i++)
+        {
+            map[keys[i]] = i;
+        }
+    });
+
+    TMap map;
+
+    for (size_t i = 0; i < keys.count(); i++)
+    {
+        map[keys[i]] = i;
+    }
+
+    volatile size_t found = 0;
+
+    snprintf(label, 128, "%s lookup %zu", name, keys.count());
+    BENCHMARK(label, iterations, 0, {
+        for (size_t i = 0; i < keys.count(); i++)
+        {
+            found = found + map.has_key(keys[i]);
+        }
+    });
+}
+
+int main(int, char const *[])
+{
+    size_t sizes[] = {16, 1000, 100000};
+
+    for (size_t size : sizes)
+    {
+        auto keys = generate_keys(size);
+        size_t iterations = 1000000 / size;
+
+        bench_map<LegacyHashMap<String, size_t>>("legacy", keys, iterations);
+        bench_map<HashMap<String, size_t>>("robinhood", keys, iterations);
+    }
+
+    char text[4096];
+    memset(text, 'a', sizeof(text));
+
+    volatile uint32_t result = 0;
+
+    BENCHMARK("djb2 hash 4KiB", 10000, sizeof(text), {
+        result = result + legacy_hash(text, sizeof(text));
+    });
+
+    BENCHMARK("wyhash32 hash 4KiB", 10000, sizeof(text), {
+        result = result + hash(text, sizeof(text));
+    });
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/json/Json.h>
+#include <libutils/Scanner.h>
+
+#include "bench.h"
+
+// Something shaped like /System/processes with a few thousand processes.
+static char *generate_processes(size_t count, size_t *size)
+{
+    size_t capacity = count * 256 + 16;
+    char *buffer = (char *)malloc(capacity);
+    size_t length = 0;
+
+    length += snprintf(buffer + length, capacity - length, "[");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        length += snprintf(
+            buffer + length, capacity - length,
+            "%s{\"id\": %zu, \"name\": \"process-%zu\", \"state\": \"running\", "
+            "\"directory\": \"/User/Documents/\\\"quoted\\\"\", \"cpu\": %zu, "
+            "\"ram\": %zu, \"user\": true}",
+            i ? ", " : "", i, i, i % 100, i * 4096);
+    }
+
+    length += snprintf(buffer + length, capacity - length, "]");
+
+    *size = length;
+    return buffer;
+}
+
+// Indented nested objects, mostly whitespace and long strings.
+static char *generate_pretty(size_t count, size_t *size)
+{
+    size_t capacity = count * 512 + 16;
+    char *buffer = (char *)malloc(capacity);
+    size_t length = 0;
+
+    length += snprintf(buffer + length, capacity - length, "{\n");
+
+    for (size_t i = 0; i < count; i++)
+    {
+        length += snprintf(
+            buffer + length, capacity - length,
+            "%s    \"entry-%zu\": {\n"
+            "        \"description\": \"A rather long description of the entry which goes on and on\",\n"
+            "        \"values\": [\n"
+            "            1.5,\n"
+            "            -2,\n"
+            "            3e4\n"
+            "        ],\n"
+            "        \"enabled\": false\n"
+            "    }",
+            i ? ",\n" : "", i);
+    }
+
+    length += snprintf(buffer + length, capacity - length, "\n}\n");
+
+    *size = length;
+    return buffer;
+}
+
+static size_t count_tokens(const char *buffer, size_t size)
+{
+    json::Reader reader{buffer, size};
+    size_t tokens = 0;
+
+    while (reader.next() < json::Token::END)
+    {
+        tokens++;
+    }
+
+    return tokens;
+}
+
+static void bench_document(const char *name, const char *buffer, size_t size, size_t iterations)
+{
+    char label[64];
+
+    snprintf(label, sizeof(label), "%s scanner parse", name);
+    BENCHMARK(label, iterations, size, {
+        StringScanner scan{buffer, size};
+        auto value = json::parse(scan);
+    });
+
+    snprintf(label, sizeof(label), "%s reader parse", name);
+    BENCHMARK(label, iterations, size, {
+        auto value = json::parse(buffer, size);
+    });
+
+    snprintf(label, sizeof(label), "%s document", name);
+    BENCHMARK(label, iterations, size, {
+        json::Document document{buffer, size};
+    });
+
+    size_t tokens = 0;
+    snprintf(label, sizeof(label), "%s tokens", name);
+    BENCHMARK(label, iterations, size, {
+        tokens = count_tokens(buffer, size);
+    });
+
+    printf("%s: %zu bytes, %zu tokens\n", name, size, tokens);
+}
+
+int main(int, char const *[])
+{
+    size_t size = 0;
+
+    char *processes = generate_processes(10000, &size);
+    bench_document("processes", processes, size, 20);
+    free(processes);
+
+    char *pretty = generate_pretty(5000, &size);
+    bench_document("pretty", pretty, size, 20);
+    free(pretty);
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libmarkup/Markup.h>
+#include <libwidget/CompiledMarkup.h>
+
+#include "bench.h"
+
+// Everything window_create_from_file() does short of creating the widgets:
+// getting the tree, resolving the widget type and pulling the attributes
+// out as strings.
+
+static const char *APPLICATIONS[] = {"about", "calculator", "settings"};
+
+static const char *WIDGETS[] = {"Container", "Panel", "Button", "Label", "Image", "Slider"};
+
+static volatile size_t _sink = 0;
+
+static char *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "r");
+
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s\n", path);
+        abort();
+    }
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buffer = (char *)malloc(*size);
+    fread(buffer, 1, *size, file);
+    fclose(file);
+
+    return buffer;
+}
+
+static void walk_text(markup::Node &node)
+{
+    size_t type = 0;
+
+    for (size_t i = 0; i < sizeof(WIDGETS) / sizeof(WIDGETS[0]); i++)
+    {
+        if (node.is(WIDGETS[i]))
+        {
+            type = i;
+        }
+    }
+
+    auto id = node.get_attribute("id");
+    auto text = node.get_attribute_or_default("text", "Label");
+    auto layout = node.get_attribute("layout");
+    auto padding = node.get_attribute("padding");
+
+    _sink = _sink + type + id.length() + text.length() + layout.length() + padding.length() + node.has_attribute("fill");
+
+    node.foreach_child([](auto &child) {
+        walk_text(child);
+        return Iteration::CONTINUE;
+    });
+}
+
+static void walk_compiled(CompiledMarkup &compiled)
+{
+    for (size_t i = 0; i < compiled.node_count(); i++)
+    {
+        auto &node = compiled.node(i);
+
+        String id{compiled.string(node.id)};
+        String text{compiled.string(node.text)};
+
+        _sink = _sink + node.type + id.length() + text.length() + node.layout + node.insets[0] + (node.flags & COMPILED_MARKUP_FILL);
+    }
+}
+
+int main(int, char const *[])
+{
+    for (auto application : APPLICATIONS)
+    {
+        char path[256];
+        size_t text_size;
+        size_t compiled_size;
+
+        snprintf(path, sizeof(path), "../applications/%s/%s.markup", application, application);
+        char *text = read_file(path, &text_size);
+
+        snprintf(path, sizeof(path), "compiled/%s/%s.markup", application, application);
+        char *buffer = read_file(path, &compiled_size);
+
+        char label[64];
+
+        snprintf(label, sizeof(label), "%s text", application);
+        BENCHMARK(label, 10000, text_size, {
+            auto document = markup::parse(text, text_size);
+            walk_text(document.root());
+        });
+
+        snprintf(label, sizeof(label), "%s compiled", application);
+        BENCHMARK(label, 10000, compiled_size, {
+            CompiledMarkup compiled{buffer, compiled_size};
+
+            if (compiled.valid())
+            {
+                walk_compiled(compiled);
+            }
+        });
+
+        free(text);
+        free(buffer);
+    }
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+
+#include <libutils/HashMap.h>
+#include <libutils/Path.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#include "bench.h"
+
+// The kernel VFS can't run on the host, this models its lookup path:
+// Path::parse, then one FsDirectory::find per component under the node
+// lock, either with the old linear scan of the entries or the hashed index.
+
+struct Node;
+
+struct Entry
+{
+    String name;
+    Node *node;
+};
+
+struct BenchLock
+{
+    bool locked = false;
+
+    void acquire()
+    {
+        while (__atomic_test_and_set(&locked, __ATOMIC_ACQUIRE))
+        {
+        }
+    }
+
+    void release()
+    {
+        __atomic_clear(&locked, __ATOMIC_RELEASE);
+    }
+};
+
+struct Node
+{
+    BenchLock lock{};
+    Vector<Entry> childs{};
+    HashMap<String, Node *> index{};
+
+    ~Node()
+    {
+        childs.foreach ([](auto &entry) {
+            delete entry.node;
+            return Iteration::CONTINUE;
+        });
+    }
+
+    Node *link(String name)
+    {
+        auto node = new Node();
+        childs.push_back({name, node});
+        index[name] = node;
+        return node;
+    }
+
+    Node *find_linear(const String &name)
+    {
+        Node *result = nullptr;
+
+        childs.foreach ([&](auto &entry) {
+            if (entry.name == name)
+            {
+                result = entry.node;
+                return Iteration::STOP;
+            }
+
+            return Iteration::CONTINUE;
+        });
+
+        return result;
+    }
+
+    Node *find_hashed(const String &name)
+    {
+        if (!index.has_key(name))
+        {
+            return nullptr;
+        }
+
+        return index[name];
+    }
+};
+
+template <typename TFind>
+static Node *resolve(Node *root, Path &path, TFind find)
+{
+    Node *current = root;
+
+    for (size_t i = 0; current && i < path.length(); i++)
+    {
+        current->lock.acquire();
+        Node *found = find(current, path[i]);
+        current->lock.release();
+
+        current = found;
+    }
+
+    return current;
+}
+
+static void populate(Node &root, Vector<String> &paths)
+{
+    const char *top_levels[] = {"Applications", "Configs", "Devices", "Session", "System", "User"};
+
+    for (auto name : top_levels)
+    {
+        auto node = root.link(name);
+
+        for (int i = 0; i < 64; i++)
+        {
+            char buffer[64];
+            snprintf(buffer, 64, "entry-%d", i);
+            node->link(buffer);
+        }
+    }
+
+    auto icons = root.link("Files")->link("Icons");
+
+    for (int theme = 0; theme < 4; theme++)
+    {
+        char theme_name[64];
+        snprintf(theme_name, 64, "theme-%d", theme);
+        auto theme_node = icons->link(theme_name);
+
+        for (int size = 18; size <= 48; size += 6)
+        {
+            char size_name[64];
+            snprintf(size_name, 64, "%dpx", size);
+            auto size_node = theme_node->link(size_name);
+
+            for (int icon = 0; icon < 300; icon++)
+            {
+                char icon_name[64];
+                snprintf(icon_name, 64, "icon-%d.png", icon);
+                size_node->link(icon_name);
+
+                char path[256];
+                snprintf(path, 256, "/Files/Icons/%s/%s/%s", theme_name, size_name, icon_name);
+                paths.push_back(path);
+            }
+        }
+    }
+}
+
+int main(int, char const *[])
+{
+    Node root;
+    Vector<String> paths;
+
+    populate(root, paths);
+
+    volatile size_t found = 0;
+    size_t iterations = 20;
+
+    BENCHMARK("Path::parse deep paths", iterations, 0, {
+        for (size_t i = 0; i < paths.count(); i++)
+        {
+            found = found + Path::parse(paths[i]).length();
+        }
+    });
+
+    BENCHMARK("linear lookup deep paths", iterations, 0, {
+        for (size_t i = 0; i < paths.count(); i++)
+        {
+            auto path = Path::parse(paths[i]);
+            found = found + (resolve(&root, path, [](Node *node, const String &name) { return node->find_linear(name); }) != nullptr);
+        }
+    });
+
+    BENCHMARK("hashed lookup deep paths", iterations, 0, {
+        for (size_t i = 0; i < paths.count(); i++)
+        {
+            auto path = Path::parse(paths[i]);
+            found = found + (resolve(&root, path, [](Node *node, const String &name) { return node->find_hashed(name); }) != nullptr);
+        }
+    });
+
+    printf("%zu paths resolved per iteration\n", paths.count());
+
+    return 0;
+}
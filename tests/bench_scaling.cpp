@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libgraphic/Scaling.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static Color *make_image(int width, int height)
+{
+    Color *pixels = (Color *)malloc(width * height * sizeof(Color));
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            pixels[y * width + x] = Color::from_byte(x & 0xff, y & 0xff, (x * y) & 0xff, 0xff);
+        }
+    }
+
+    return pixels;
+}
+
+// What Painter used to do: a floating point bilinear sample per pixel,
+// column after column.
+static void scale_per_pixel(const Color *pixels, int stride, Recti source, Color *destination, int width, int height)
+{
+    for (int x = 0; x < width; x++)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            float xx = source.x() + (x / (float)width) * source.width();
+            float yy = source.y() + (y / (float)height) * source.height();
+
+            int x0 = MIN((int)xx, source.right() - 1);
+            int y0 = MIN((int)yy, source.bottom() - 1);
+            int x1 = MIN(x0 + 1, source.right() - 1);
+            int y1 = MIN(y0 + 1, source.bottom() - 1);
+
+            float fx = xx - (int)xx;
+            float fy = yy - (int)yy;
+
+            Color top = Color::lerp(pixels[y0 * stride + x0], pixels[y0 * stride + x1], fx);
+            Color bottom = Color::lerp(pixels[y1 * stride + x0], pixels[y1 * stride + x1], fx);
+
+            destination[y * width + x] = Color::lerp(top, bottom, fy);
+        }
+    }
+}
+
+static void bench(const char *name, int source_width, int source_height, int width, int height)
+{
+    Color *pixels = make_image(source_width, source_height);
+    Color *destination = (Color *)malloc(width * height * sizeof(Color));
+
+    size_t bytes = width * height * sizeof(Color);
+
+    char title[96];
+
+    snprintf(title, 96, "%s, per pixel sample", name);
+    BENCHMARK(title, 5, bytes, {
+        scale_per_pixel(pixels, source_width, Recti(source_width, source_height), destination, width, height);
+        _sink = _sink + destination[0].red();
+    });
+
+    BitmapFiltering filterings[] = {BITMAP_FILTERING_LINEAR, BITMAP_FILTERING_NEAREST};
+    const char *filtering_names[] = {"linear", "nearest"};
+
+    for (int i = 0; i < 2; i++)
+    {
+        snprintf(title, 96, "%s, %s", name, filtering_names[i]);
+        BENCHMARK(title, 20, bytes, {
+            scale(pixels, source_width, Recti(source_width, source_height), Recti(width, height), Recti(width, height), filterings[i],
+                  [&](int y, int x, const Color *row, int count) {
+                      memcpy(destination + y * width + x, row, count * sizeof(Color));
+                  });
+            _sink = _sink + destination[0].red();
+        });
+    }
+
+    free(destination);
+    free(pixels);
+}
+
+int main(int, char const *[])
+{
+    bench("720p to 1080p", 1280, 720, 1920, 1080);
+    bench("2160p to 1080p", 3840, 2160, 1920, 1080);
+    bench("1080p to 1366x768", 1920, 1080, 1366, 768);
+
+    // An image viewer showing a photo as a thumbnail.
+    bench("4000x3000 to 400x300", 4000, 3000, 400, 300);
+
+    return 0;
+}
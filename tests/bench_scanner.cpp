@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libutils/Path.h>
+#include <libutils/Scanner.h>
+#include <libutils/SpanScanner.h>
+#include <libutils/Strings.h>
+
+#include "bench.h"
+
+static constexpr size_t SIZE = 1024 * 1024;
+
+// Keeps the compiler from throwing away loops whose result is unused.
+static volatile size_t _sink = 0;
+
+int main(int, char const *[])
+{
+    char *text = (char *)malloc(SIZE);
+
+    // Long runs of text with a delimiter from time to time, like attribute
+    // values and path elements.
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        text[i] = (i % 97 == 96) ? '"' : 'a' + (i % 26);
+    }
+
+    size_t runs = 0;
+
+    BENCHMARK("StringScanner until quote", 20, SIZE, {
+        StringScanner scan{text, SIZE};
+        runs = 0;
+
+        while (scan.do_continue())
+        {
+            while (scan.do_continue() && scan.current() != '"')
+            {
+                scan.foreward();
+            }
+
+            scan.skip('"');
+            runs++;
+        }
+
+        _sink = runs;
+    });
+
+    BENCHMARK("SpanScanner take_until quote", 20, SIZE, {
+        SpanScanner scan{text, SIZE};
+        runs = 0;
+
+        while (scan.do_continue())
+        {
+            scan.take_until('"');
+            scan.skip('"');
+            runs++;
+        }
+
+        _sink = runs;
+    });
+
+    printf("%zu runs\n", runs);
+
+    for (size_t i = 0; i < SIZE; i++)
+    {
+        text[i] = (i % 64 == 63) ? 'x' : " \n\t "[i % 4];
+    }
+
+    BENCHMARK("StringScanner eat whitespace", 20, SIZE, {
+        StringScanner scan{text, SIZE};
+
+        while (scan.do_continue())
+        {
+            scan.eat(Strings::WHITESPACE);
+            _sink = _sink + scan.position();
+            scan.foreward();
+        }
+    });
+
+    BENCHMARK("SpanScanner eat_whitespace", 20, SIZE, {
+        SpanScanner scan{text, SIZE};
+
+        while (scan.do_continue())
+        {
+            scan.eat_whitespace();
+            _sink = _sink + scan.position();
+            scan.foreward();
+        }
+    });
+
+    const char *path = "/Applications/file-manager/icons/folder-documents.icon";
+
+    BENCHMARK("Path::parse", 100000, 0, {
+        auto p = Path::parse(path);
+        _sink = p.length();
+    });
+
+    free(text);
+
+    return 0;
+}
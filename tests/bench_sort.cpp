@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libutils/Vector.h>
+
+#include "bench.h"
+
+static int compare_int(const int &left, const int &right)
+{
+    return (left > right) - (left < right);
+}
+
+static int compare_int_ptr(const void *left, const void *right)
+{
+    return compare_int(*(const int *)left, *(const int *)right);
+}
+
+// The previous Vector::sort.
+template <typename T, typename Comparator>
+static void exchange_sort(Vector<T> &vector, Comparator comparator)
+{
+    for (size_t i = 0; i < vector.count() - 1; i++)
+    {
+        for (size_t j = i + 1; j < vector.count(); j++)
+        {
+            if (comparator(vector[i], vector[j]) > 0)
+            {
+                swap(vector[i], vector[j]);
+            }
+        }
+    }
+}
+
+static Vector<int> random_values(size_t count)
+{
+    Vector<int> values;
+
+    srand(42);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        values.push_back(rand());
+    }
+
+    return values;
+}
+
+int main(int, char const *[])
+{
+    auto small = random_values(10000);
+    auto large = random_values(1000000);
+
+    BENCHMARK("exchange sort 10k", 1, 0, {
+        auto values = small;
+        exchange_sort(values, compare_int);
+    });
+
+    BENCHMARK("introsort 10k", 10, 0, {
+        auto values = small;
+        values.sort(compare_int);
+    });
+
+    BENCHMARK("introsort 1M", 5, 0, {
+        auto values = large;
+        values.sort(compare_int);
+    });
+
+    BENCHMARK("introsort 1M already sorted", 5, 0, {
+        auto values = large;
+        values.sort(compare_int);
+        values.sort(compare_int);
+    });
+
+    BENCHMARK("stable merge sort 1M", 5, 0, {
+        auto values = large;
+        values.stable_sort(compare_int);
+    });
+
+    BENCHMARK("partial sort top 10 of 1M", 5, 0, {
+        auto values = large;
+        values.partial_sort(10, compare_int);
+    });
+
+    BENCHMARK("sort engine with qsort byte swaps 1M", 5, 0, {
+        auto values = large;
+        char *bytes = (char *)values.raw_storage();
+        size_t size = sizeof(int);
+
+        sort(
+            0, values.count(),
+            [&](size_t a, size_t b) { return compare_int_ptr(bytes + a * size, bytes + b * size); },
+            [&](size_t a, size_t b) {
+                for (size_t i = 0; i < size; i++)
+                {
+                    swap(bytes[a * size + i], bytes[b * size + i]);
+                }
+            });
+    });
+
+    BENCHMARK("host qsort 1M", 5, 0, {
+        auto values = large;
+        qsort(values.raw_storage(), values.count(), sizeof(int), compare_int_ptr);
+    });
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/json/Json.h>
+#include <libutils/String.h>
+
+#include "bench.h"
+
+// Count every allocation made by the process, the host libc still does the
+// actual work.
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+static size_t _allocations = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    _allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    _allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    _allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+void *operator new(size_t size) { return malloc(size); }
+void *operator new[](size_t size) { return malloc(size); }
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+static char *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "r");
+
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s\n", path);
+        abort();
+    }
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buffer = (char *)malloc(*size);
+    fread(buffer, 1, *size, file);
+    fclose(file);
+
+    return buffer;
+}
+
+static const char *_theme_colors_names[] = {
+    "border", "background", "middleground", "foreground", "foreground-inactive",
+    "foreground-disabled", "selection", "selection-inactive", "accent",
+    "accent-inactive", "ansi-cursor", "ansi-background", "ansi-foreground",
+    "ansi-black", "ansi-red", "ansi-green", "ansi-yellow", "ansi-blue",
+    "ansi-magenta", "ansi-cyan", "ansi-white", "ansi-bright-black",
+    "ansi-bright-red", "ansi-bright-green", "ansi-bright-yellow",
+    "ansi-bright-blue", "ansi-bright-magenta", "ansi-bright-cyan",
+    "ansi-bright-white",
+};
+
+// Does what theme_load() does minus the color parsing.
+static size_t load_theme(const char *buffer, size_t size)
+{
+    auto root = json::parse(buffer, size);
+    auto &colors = root.get("colors");
+
+    size_t length = 0;
+
+    for (auto name : _theme_colors_names)
+    {
+        auto &color = colors.get(name);
+
+        if (color.is(json::STRING))
+        {
+            length += color.as_string().length();
+        }
+    }
+
+    return length;
+}
+
+static size_t load_environment(const char *buffer, size_t size)
+{
+    auto root = json::parse(buffer, size);
+    return root.get("POSIX").get("PATH").length();
+}
+
+int main(int, char const *[])
+{
+    size_t environment_size;
+    char *environment = read_file("../sysroot/Configs/environment.json", &environment_size);
+
+    size_t theme_size;
+    char *theme = read_file("../sysroot/Files/Themes/skift-dark.json", &theme_size);
+
+    volatile size_t result = 0;
+
+    size_t before = _allocations;
+    result = result + load_environment(environment, environment_size);
+    printf("%-40s %12zu allocations\n", "environment.json", _allocations - before);
+
+    before = _allocations;
+    result = result + load_theme(theme, theme_size);
+    printf("%-40s %12zu allocations\n", "skift-dark.json", _allocations - before);
+
+    before = _allocations;
+    for (int i = 0; i < 1000; i++)
+    {
+        String empty{};
+        String small{"accent-inactive"};
+        String copy = small;
+        result = result + empty.length() + copy.length();
+    }
+    printf("%-40s %12zu allocations\n", "1000 empty and short strings", _allocations - before);
+
+    BENCHMARK("parse environment.json", 10000, environment_size, {
+        result = result + load_environment(environment, environment_size);
+    });
+
+    BENCHMARK("parse and query skift-dark.json", 10000, theme_size, {
+        result = result + load_theme(theme, theme_size);
+    });
+
+    free(environment);
+    free(theme);
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libwidget/model/TableModel.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr int ROWS = 100000;
+
+class BenchModel : public TableModel
+{
+public:
+    Vector<int> keys{};
+    Vector<int> values{};
+
+    int rows() override { return keys.count(); }
+
+    void refresh(Vector<int> &new_keys, Vector<int> &new_values)
+    {
+        did_diff_rows(
+            keys.count(), new_keys.count(),
+            [&](int old_row, int new_row) {
+                return (keys[old_row] > new_keys[new_row]) - (keys[old_row] < new_keys[new_row]);
+            },
+            [&](int old_row, int new_row) {
+                return values[old_row] == new_values[new_row];
+            });
+
+        _sink = _sink + changes().count();
+        did_update();
+    }
+};
+
+int main(int, char const *[])
+{
+    auto model = make<BenchModel>();
+
+    Vector<int> keys(ROWS);
+    Vector<int> values(ROWS);
+
+    for (int i = 0; i < ROWS; i++)
+    {
+        keys.push_back(i * 2);
+        values.push_back(i);
+    }
+
+    model->keys = keys;
+    model->values = values;
+
+    // A task list refreshed every second: a few rows come, go or change.
+    Vector<int> new_keys = keys;
+    Vector<int> new_values = values;
+
+    for (int i = 0; i < 10; i++)
+    {
+        new_values[i * 1000] = -1;
+        new_keys[i * 5000 + 1] = i * 10000 + 3;
+    }
+
+    BENCHMARK("diff 100k rows, 20 changes", 50, 0, {
+        model->refresh(new_keys, new_values);
+    });
+
+    BENCHMARK("diff 100k rows, nothing changed", 50, 0, {
+        model->refresh(keys, values);
+    });
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <libsystem/math/MinMax.h>
+#include <libterminal/Terminal.h>
+
+#include "bench.h"
+
+static constexpr size_t TEXT_SIZE = 8 * 1024 * 1024;
+
+enum class Text
+{
+    PLAIN,
+    COLORED,
+    UNICODE,
+};
+
+static char *generate_text(size_t size, Text kind)
+{
+    char *text = (char *)malloc(size);
+    size_t offset = 0;
+    int line = 0;
+
+    while (offset < size)
+    {
+        char buffer[128];
+        int length;
+
+        if (kind == Text::COLORED && line % 4 == 0)
+        {
+            length = snprintf(buffer, 128, "\e[3%dm%06d\e[0m The quick brown fox jumps over the lazy dog.\n", line % 8, line);
+        }
+        else if (kind == Text::UNICODE)
+        {
+            length = snprintf(buffer, 128, "%06d Portez ce vieux whisky au juge blond qui fume ✓ ½ ß\n", line);
+        }
+        else
+        {
+            length = snprintf(buffer, 128, "%06d The quick brown fox jumps over the lazy dog.\n", line);
+        }
+
+        size_t copied = MIN((size_t)length, size - offset);
+        memcpy(text + offset, buffer, copied);
+        offset += copied;
+        line++;
+    }
+
+    return text;
+}
+
+int main(int, char const *[])
+{
+    char *plain = generate_text(TEXT_SIZE, Text::PLAIN);
+    char *colored = generate_text(TEXT_SIZE, Text::COLORED);
+    char *unicode = generate_text(TEXT_SIZE, Text::UNICODE);
+
+    BENCHMARK("terminal write plain 80x24", 4, TEXT_SIZE, {
+        terminal::Terminal terminal{80, 24};
+        terminal.write(plain, TEXT_SIZE);
+    });
+
+    BENCHMARK("terminal write colored 80x24", 4, TEXT_SIZE, {
+        terminal::Terminal terminal{80, 24};
+        terminal.write(colored, TEXT_SIZE);
+    });
+
+    BENCHMARK("terminal write unicode 80x24", 4, TEXT_SIZE, {
+        terminal::Terminal terminal{80, 24};
+        terminal.write(unicode, TEXT_SIZE);
+    });
+
+    BENCHMARK("terminal write plain 240x80", 4, TEXT_SIZE, {
+        terminal::Terminal terminal{240, 80};
+        terminal.write(plain, TEXT_SIZE);
+    });
+
+    BENCHMARK("terminal write plain no scrollback", 4, TEXT_SIZE, {
+        terminal::Terminal terminal{80, 24, 0};
+        terminal.write(plain, TEXT_SIZE);
+    });
+
+    free(plain);
+    free(colored);
+    free(unicode);
+
+    return 0;
+}
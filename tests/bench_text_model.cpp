@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/core/CString.h>
+#include <libutils/OwnPtr.h>
+#include <libutils/Vector.h>
+#include <libwidget/model/TextModel.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr size_t TEXT_SIZE = 10 * 1024 * 1024;
+static constexpr size_t SPAN_COUNT = 100000;
+static constexpr size_t VISIBLE_LINES = 50;
+
+// The model as it was before the piece table: one vector of codepoints
+// per line and a sorted vector of spans scanned linearly.
+struct OldLine
+{
+    Vector<Codepoint> codepoints{};
+};
+
+struct OldModel
+{
+    Vector<OwnPtr<OldLine>> lines{1024};
+    Vector<TextModelSpan> spans{1024};
+
+    static OldModel load(const char *buffer, size_t size)
+    {
+        OldModel model{};
+        auto line = own<OldLine>();
+
+        for (size_t i = 0; i < size;)
+        {
+            if (buffer[i] == '\n')
+            {
+                model.lines.push_back(line);
+                line = own<OldLine>();
+                i++;
+                continue;
+            }
+
+            Codepoint codepoint = 0;
+            i += utf8_to_codepoint((const uint8_t *)buffer + i, &codepoint);
+            line->codepoints.push_back(codepoint);
+        }
+
+        model.lines.push_back(line);
+
+        return model;
+    }
+
+    void append_at(size_t line, size_t column, Codepoint codepoint)
+    {
+        lines[line]->codepoints.insert(column, codepoint);
+    }
+
+    void newline_at(size_t line, size_t column)
+    {
+        auto right = own<OldLine>();
+
+        while (lines[line]->codepoints.count() > column)
+        {
+            right->codepoints.push_back(lines[line]->codepoints.take_at(column));
+        }
+
+        lines.insert(line + 1, right);
+    }
+
+    void span_add(TextModelSpan span)
+    {
+        spans.insert_sorted(span, [](auto &left, auto &right) {
+            return left.line() < right.line() ||
+                   (left.line() == right.line() && left.start() < right.start());
+        });
+    }
+
+    TextModelSpan span_at(size_t line, size_t column)
+    {
+        for (size_t i = 0; i < spans.count(); i++)
+        {
+            auto &span = spans[i];
+
+            if (span.line() == line && column >= span.start() && column < span.end())
+            {
+                return span;
+            }
+        }
+
+        return {line, column, column + 1};
+    }
+};
+
+static char *generate_text(size_t size)
+{
+    const char *words[] = {"int", "return", "while", "café", "for", "x", "value", "→", "if", "buffer"};
+
+    char *buffer = (char *)malloc(size);
+    size_t used = 0;
+    size_t column = 0;
+    unsigned seed = 42;
+
+    while (used < size)
+    {
+        seed = seed * 1103515245 + 12345;
+        const char *word = words[(seed >> 16) % 10];
+        size_t length = strlen(word);
+
+        if (used + length + 1 > size)
+        {
+            memset(buffer + used, ' ', size - used);
+            break;
+        }
+
+        memcpy(buffer + used, word, length);
+        used += length;
+        column += length + 1;
+
+        buffer[used++] = column > 60 ? '\n' : ' ';
+        column = column > 60 ? 0 : column;
+    }
+
+    return buffer;
+}
+
+static char *copy_text(const char *text, size_t size)
+{
+    char *buffer = (char *)malloc(size);
+    memcpy(buffer, text, size);
+    return buffer;
+}
+
+int main(int, char const *[])
+{
+    char *text = generate_text(TEXT_SIZE);
+
+    BENCHMARK("load 10MB (old)", 3, TEXT_SIZE, {
+        auto model = OldModel::load(text, TEXT_SIZE);
+        _sink = _sink + model.lines.count();
+    });
+
+    BENCHMARK("load 10MB (piece table)", 3, TEXT_SIZE, {
+        auto model = TextModel::from_buffer(copy_text(text, TEXT_SIZE), TEXT_SIZE);
+        _sink = _sink + model->line_count();
+    });
+
+    auto old_model = OldModel::load(text, TEXT_SIZE);
+    auto model = TextModel::from_buffer(copy_text(text, TEXT_SIZE), TEXT_SIZE);
+    size_t middle = model->line_count() / 2;
+
+    printf("%zu lines\n", model->line_count());
+
+    BENCHMARK("type 1000 chars mid-file (old)", 10, 0, {
+        for (size_t i = 0; i < 1000; i++)
+        {
+            old_model.append_at(middle, 4 + i, U'a');
+        }
+    });
+
+    BENCHMARK("type 1000 chars mid-file (piece table)", 10, 0, {
+        TextCursor cursor{};
+        cursor.move_to_within(*model, middle);
+        cursor.move_to_within(model->line(middle), 4);
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            model->append_at(cursor, U'a');
+        }
+    });
+
+    BENCHMARK("100 newlines mid-file (old)", 3, 0, {
+        for (size_t i = 0; i < 100; i++)
+        {
+            old_model.newline_at(middle + i, 2);
+        }
+    });
+
+    BENCHMARK("100 newlines mid-file (piece table)", 3, 0, {
+        TextCursor cursor{};
+        cursor.move_to_within(*model, middle);
+        cursor.move_to_within(model->line(middle), 2);
+
+        for (size_t i = 0; i < 100; i++)
+        {
+            model->newline_at(cursor);
+            cursor.move_to_within(model->line(cursor.line()), 2);
+        }
+    });
+
+    for (size_t i = 0; i < SPAN_COUNT; i++)
+    {
+        size_t line = i * (model->line_count() / SPAN_COUNT);
+
+        old_model.span_add(TextModelSpan(line, 0, 3, THEME_ANSI_BLUE, THEME_BACKGROUND));
+        model->span_add(TextModelSpan(line, 0, 3, THEME_ANSI_BLUE, THEME_BACKGROUND));
+    }
+
+    // The first lookup after adding spans sorts them.
+    BENCHMARK("first span_at after adding 100k spans", 1, 0, {
+        _sink = _sink + model->span_at(0, 0).foreground();
+    });
+
+    // Paint a screen of lines scrolled to a quarter of the file, reading
+    // every codepoint and looking up its span like TextField does.
+    size_t scroll = model->line_count() / 4;
+
+    BENCHMARK("paint 50 lines with 100k spans (old)", 5, 0, {
+        for (size_t i = scroll; i < scroll + VISIBLE_LINES; i++)
+        {
+            auto &line = *old_model.lines[i];
+
+            for (size_t j = 0; j < line.codepoints.count(); j++)
+            {
+                _sink = _sink + line.codepoints[j] + old_model.span_at(i, j).foreground();
+            }
+        }
+    });
+
+    BENCHMARK("paint 50 lines with 100k spans (piece table)", 5, 0, {
+        for (size_t i = scroll; i < scroll + VISIBLE_LINES; i++)
+        {
+            auto line = model->line(i);
+
+            for (size_t j = 0; j < line.length(); j++)
+            {
+                _sink = _sink + line[j] + model->span_at(i, j).foreground();
+            }
+        }
+    });
+
+    free(text);
+
+    return 0;
+}
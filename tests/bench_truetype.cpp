@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libgraphic/font/GlyphCache.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static RefPtr<graphic::TrueType> load_roboto()
+{
+    FILE *file = fopen("../sysroot/Files/Fonts/Roboto/Roboto-Regular.ttf", "rb");
+
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *buffer = (uint8_t *)malloc(size);
+    _sink = _sink + fread(buffer, 1, size, file);
+    fclose(file);
+
+    return graphic::TrueType::parse(Vector(ADOPT, buffer, size)).take_value();
+}
+
+int main(int, char const *[])
+{
+    auto font = load_roboto();
+
+    int sizes[] = {11, 16, 24, 48};
+
+    for (int size : sizes)
+    {
+        char name[64];
+
+        // What a first draw_string() with this size pays.
+        snprintf(name, 64, "rasterize ascii at %dpx", size);
+
+        BENCHMARK(name, 20, 0, {
+            graphic::GlyphCache cache{GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT};
+
+            for (Codepoint codepoint = 32; codepoint < 127; codepoint++)
+            {
+                _sink = _sink + cache.lookup(*font, size, font->glyph_index(codepoint)).advance;
+            }
+        });
+    }
+
+    graphic::GlyphCache cache{GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT};
+
+    for (int size : sizes)
+    {
+        for (Codepoint codepoint = 32; codepoint < 127; codepoint++)
+        {
+            cache.lookup(*font, size, font->glyph_index(codepoint));
+        }
+    }
+
+    BENCHMARK("cached lookup of ascii, 4 sizes", 1000, 0, {
+        for (int size : sizes)
+        {
+            for (Codepoint codepoint = 32; codepoint < 127; codepoint++)
+            {
+                _sink = _sink + cache.lookup(*font, size, font->glyph_index(codepoint)).advance;
+            }
+        }
+    });
+
+    printf("%zu glyphs of 4 sizes in a %dx%d atlas, %d KiB, %zu evictions\n",
+           cache.count(), GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT,
+           GLYPH_CACHE_WIDTH * GLYPH_CACHE_HEIGHT / 1024, cache.evictions());
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/algebra/Rect.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#include "bench.h"
+
+static volatile size_t _sink = 0;
+
+static constexpr size_t COUNT = 100000;
+
+int main(int, char const *[])
+{
+    BENCHMARK("push_back int x 100000", 100, 0, {
+        Vector<int> vector{};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.push_back(i);
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("push_back int x 100000 reserved", 100, 0, {
+        Vector<int> vector(COUNT);
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.push_back(i);
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("push_back Recti x 100000", 100, 0, {
+        Vector<Recti> vector{};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.push_back(Recti(i, i, 16, 16));
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("emplace_back Recti x 100000", 100, 0, {
+        Vector<Recti> vector{};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.emplace_back(i, i, 16, 16);
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("push_back String x 100000", 20, 0, {
+        Vector<String> vector{};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.push_back("hello");
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("insert front int x 10000", 20, 0, {
+        Vector<int> vector{};
+
+        for (size_t i = 0; i < 10000; i++)
+        {
+            vector.insert(0, i);
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    Vector<int> source{};
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        source.push_back(i);
+    }
+
+    BENCHMARK("copy int x 100000", 100, COUNT * sizeof(int), {
+        Vector<int> copy = source;
+        _sink = _sink + copy[COUNT / 2];
+    });
+
+    BENCHMARK("remove_index front int x 10000", 20, 0, {
+        Vector<int> vector{};
+
+        for (size_t i = 0; i < 10000; i++)
+        {
+            vector.push_back(i);
+        }
+
+        while (vector.any())
+        {
+            vector.remove_index(0);
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    BENCHMARK("pop_back String x 100000", 20, 0, {
+        Vector<String> vector{};
+
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            vector.push_back("a string that doesn't fit inline");
+        }
+
+        while (vector.any())
+        {
+            vector.pop_back();
+        }
+
+        _sink = _sink + vector.count();
+    });
+
+    return 0;
+}
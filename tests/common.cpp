@@ -1,7 +1,10 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include <libsystem/Assert.h>
+#include <libsystem/Logger.h>
+#include <libsystem/thread/Lock.h>
 
 void assert_failed(const char *expr, const char *file, const char *function, int line)
 {
@@ -9,3 +12,29 @@ void assert_failed(const char *expr, const char *file, const char *function, int
 
     abort();
 }
+
+// Tests are single threaded, locks only have to link.
+
+void __lock_acquire(Lock *lock)
+{
+    lock->locked = true;
+}
+
+void __lock_release(Lock *lock, const char *, const char *, int)
+{
+    lock->locked = false;
+}
+
+// Logs from the code under test go to the host stderr.
+
+void logger_log(LogLevel, const char *file, uint line, const char *fmt, ...)
+{
+    va_list va;
+    va_start(va, fmt);
+
+    fprintf(stderr, "%s:%u: ", file, line);
+    vfprintf(stderr, fmt, va);
+    fprintf(stderr, "\n");
+
+    va_end(va);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// <emmintrin.h> pulls this in for _mm_malloc(), the host one includes the
+// host <stdlib.h> which clashes with libsystem allocator declarations when
+// a header with SIMD code is included after them.
@@ -0,0 +1,174 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libutils/Arena.h>
+
+#define TEST(__func) void __func()
+
+struct Point
+{
+    int x;
+    int y;
+
+    Point() : x(0), y(0) {}
+
+    Point(int x, int y) : x(x), y(y) {}
+};
+
+TEST(allocations_are_aligned_and_distinct)
+{
+    Arena arena{};
+
+    char *c = (char *)arena.allocate(1, 1);
+    uint64_t *u = (uint64_t *)arena.allocate(sizeof(uint64_t), alignof(uint64_t));
+    void *wide = arena.allocate(32, 16);
+
+    assert((uintptr_t)u % alignof(uint64_t) == 0);
+    assert((uintptr_t)wide % 16 == 0);
+    assert((void *)c != (void *)u);
+
+    *c = 'a';
+    *u = 0xdeadbeef;
+    assert(*c == 'a');
+
+    auto point = arena.make<Point>(4, 2);
+    assert(point->x == 4 && point->y == 2);
+
+    auto points = arena.make_array<Point>(3);
+    assert(points[2].x == 0 && points[2].y == 0);
+}
+
+TEST(large_allocations_get_their_own_chunk)
+{
+    Arena arena{64};
+
+    char *small = (char *)arena.allocate(16);
+    char *large = (char *)arena.allocate(1000);
+
+    memset(large, 'x', 1000);
+    assert(small != large);
+    assert(arena.reserved() >= 1064);
+    assert(arena.used() == 1016);
+}
+
+TEST(reset_rolls_back_to_the_marker)
+{
+    Arena arena{64};
+
+    arena.allocate(16);
+    auto marker = arena.mark();
+
+    void *first = arena.allocate(16);
+
+    for (int i = 0; i < 32; i++)
+    {
+        arena.allocate(32);
+    }
+
+    arena.reset(marker);
+    assert(arena.used() == 16);
+
+    void *again = arena.allocate(16);
+    assert(again == first);
+
+    arena.reset();
+    assert(arena.used() == 0);
+    assert(arena.reserved() == 64);
+}
+
+TEST(scopes_nest)
+{
+    Arena arena{};
+
+    arena.copy("outer");
+
+    {
+        ArenaScope outer{arena};
+        arena.copy("first");
+
+        {
+            ArenaScope inner{arena};
+            arena.allocate(10000);
+        }
+
+        assert(arena.used() == 12);
+    }
+
+    assert(arena.used() == 6);
+}
+
+TEST(reallocate_grows_in_place)
+{
+    Arena arena{};
+
+    char *buffer = (char *)arena.allocate(8, 1);
+    memcpy(buffer, "abcdefgh", 8);
+
+    assert(arena.reallocate(buffer, 8, 64, 1) == buffer);
+
+    arena.allocate(1, 1);
+
+    char *moved = (char *)arena.reallocate(buffer, 64, 128, 1);
+    assert(moved != buffer);
+    assert(memcmp(moved, "abcdefgh", 8) == 0);
+}
+
+TEST(vector_and_string)
+{
+    Arena arena{128};
+
+    ArenaVector<int> numbers{arena};
+
+    for (int i = 0; i < 1000; i++)
+    {
+        numbers.push_back(i);
+    }
+
+    assert(numbers.count() == 1000);
+
+    int sum = 0;
+
+    for (auto number : numbers)
+    {
+        sum += number;
+    }
+
+    assert(sum == 999 * 1000 / 2);
+    assert(numbers.pop_back() == 999);
+
+    ArenaString string{arena};
+    string.append("Hello");
+    string.append(',');
+    string.append(StringView{" world!!!", 7});
+
+    auto view = string.finalize();
+    assert(view == "Hello, world!");
+    assert(view.buffer()[view.length()] == '\0');
+
+    assert(arena.copy(StringView{"abcdef", 3}) == "abc");
+}
+
+TEST(moved_arena_keeps_its_allocations)
+{
+    Arena arena{};
+    auto view = arena.copy("still here");
+
+    Arena other = move(arena);
+
+    assert(view == "still here");
+    assert(other.used() == 11);
+    assert(arena.used() == 0);
+}
+
+int main(int, char const *[])
+{
+    allocations_are_aligned_and_distinct();
+    large_allocations_get_their_own_chunk();
+    reset_rolls_back_to_the_marker();
+    scopes_nest();
+    reallocate_grows_in_place();
+    vector_and_string();
+    moved_arena_keeps_its_allocations();
+
+    return 0;
+}
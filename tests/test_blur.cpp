@@ -0,0 +1,156 @@
+#include <stdlib.h>
+
+#include <libgraphic/Blur.h>
+#include <libsystem/Assert.h>
+
+#define TEST(__func) void __func()
+
+static constexpr int WIDTH = 300;
+static constexpr int HEIGHT = 200;
+
+static Color *make_image(Color color)
+{
+    Color *pixels = (Color *)malloc(WIDTH * HEIGHT * sizeof(Color));
+
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+    {
+        pixels[i] = color;
+    }
+
+    return pixels;
+}
+
+static Color *make_split_image()
+{
+    Color *pixels = make_image(Colors::BLACK);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = WIDTH / 2; x < WIDTH; x++)
+        {
+            pixels[y * WIDTH + x] = Colors::WHITE;
+        }
+    }
+
+    return pixels;
+}
+
+TEST(flat_color_is_unchanged)
+{
+    Color color = Color::from_byte(12, 200, 99, 255);
+
+    int radii[] = {1, 4, 8, 16, 48, 200};
+
+    for (int radius : radii)
+    {
+        Color *pixels = make_image(color);
+
+        blur(pixels, WIDTH, Recti(WIDTH, HEIGHT), radius);
+
+        for (int i = 0; i < WIDTH * HEIGHT; i++)
+        {
+            assert(pixels[i] == color);
+        }
+
+        free(pixels);
+    }
+}
+
+TEST(outside_of_the_region_is_untouched)
+{
+    int radii[] = {4, 48};
+
+    for (int radius : radii)
+    {
+        Color *pixels = make_split_image();
+        Recti region(WIDTH / 2 - 40, 50, 80, 60);
+
+        blur(pixels, WIDTH, region, radius);
+
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            for (int x = 0; x < WIDTH; x++)
+            {
+                if (!region.contains(Vec2i(x, y)))
+                {
+                    assert(pixels[y * WIDTH + x] == (x < WIDTH / 2 ? Colors::BLACK : Colors::WHITE));
+                }
+            }
+        }
+
+        free(pixels);
+    }
+}
+
+TEST(edges_are_smoothed)
+{
+    int radii[] = {4, 48};
+
+    for (int radius : radii)
+    {
+        Color *pixels = make_split_image();
+
+        blur(pixels, WIDTH, Recti(WIDTH, HEIGHT), radius);
+
+        Color *row = pixels + (HEIGHT / 2) * WIDTH;
+
+        // Far from the edge nothing changes, across it the values only grow.
+        assert(row[0] == Colors::BLACK);
+        assert(row[WIDTH - 1] == Colors::WHITE);
+
+        for (int x = 1; x < WIDTH; x++)
+        {
+            assert(row[x].red() >= row[x - 1].red());
+            assert(row[x].alpha() == 255);
+        }
+
+        int middle = row[WIDTH / 2].red();
+        assert(middle > 64 && middle < 192);
+
+        // The edge is spread over about the radius.
+        assert(row[WIDTH / 2 - radius * 2].red() < 16);
+        assert(row[WIDTH / 2 + radius * 2].red() > 240);
+        assert(row[WIDTH / 2 - radius / 4].red() > 16);
+
+        free(pixels);
+    }
+}
+
+TEST(box_blur_averages)
+{
+    Color pixels[7];
+
+    for (auto &pixel : pixels)
+    {
+        pixel = Colors::BLACK;
+    }
+
+    pixels[3] = Colors::WHITE;
+
+    box_blur(pixels, 7, 7, 1, 1);
+
+    int total = 0;
+
+    for (auto pixel : pixels)
+    {
+        total += pixel.red();
+    }
+
+    // Three passes over three pixels, the energy is kept give or take the
+    // rounding.
+    assert(pixels[3].red() > pixels[2].red());
+    assert(pixels[2].red() > pixels[1].red());
+    assert(pixels[2] == pixels[4]);
+    assert(pixels[0].red() > 0);
+    assert(total > 240 && total < 270);
+}
+
+int main(int, char const *[])
+{
+    flat_color_is_unchanged();
+    outside_of_the_region_is_untouched();
+    edges_are_smoothed();
+    box_blur_averages();
+
+    return 0;
+}
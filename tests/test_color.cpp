@@ -0,0 +1,197 @@
+#include <libgraphic/Blending.h>
+#include <libgraphic/Color.h>
+#include <libsystem/Assert.h>
+
+#define TEST(__func) void __func()
+
+static int distance(uint8_t a, uint8_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+static bool close_to(Color a, Color b)
+{
+    return distance(a.red(), b.red()) <= 1 &&
+           distance(a.green(), b.green()) <= 1 &&
+           distance(a.blue(), b.blue()) <= 1 &&
+           distance(a.alpha(), b.alpha()) <= 1;
+}
+
+static Color reference_blend(Color fg, Color bg)
+{
+    double fa = fg.alpha() / 255.0;
+    double ba = bg.alpha() / 255.0;
+    double a = (1 - fa) * ba + fa;
+
+    auto channel = [&](uint8_t f, uint8_t b) {
+        return (uint8_t)(((1 - fa) * ba * b + fa * f) / a + 0.5);
+    };
+
+    return Color::from_byte(
+        channel(fg.red(), bg.red()),
+        channel(fg.green(), bg.green()),
+        channel(fg.blue(), bg.blue()),
+        (uint8_t)(a * 255 + 0.5));
+}
+
+TEST(div255_is_exact)
+{
+    for (uint32_t x = 0; x <= 255 * 255; x++)
+    {
+        assert(Color::div255(x) == (x * 2 + 255) / 510);
+    }
+}
+
+TEST(blend_matches_the_reference_on_opaque_background)
+{
+    for (int alpha = 0; alpha < 256; alpha += 5)
+    {
+        for (int value = 0; value < 256; value += 15)
+        {
+            Color fg = Color::from_byte(value, 255 - value, value / 2, alpha);
+            Color bg = Color::from_byte(255 - value, value, 200, 255);
+
+            assert(close_to(Color::blend(fg, bg), reference_blend(fg, bg)));
+            assert(close_to(Color::blend_premultiplied(fg.premultiplied(), bg), reference_blend(fg, bg)));
+        }
+    }
+}
+
+TEST(blend_matches_the_reference_on_translucent_background)
+{
+    for (int alpha = 1; alpha < 256; alpha += 17)
+    {
+        Color fg = Color::from_byte(200, 100, 50, alpha);
+        Color bg = Color::from_byte(10, 220, 130, 255 - alpha / 2);
+
+        Color expected = reference_blend(fg, bg);
+        Color result = Color::blend(fg, bg);
+
+        // Premultiplying loses some precision on dark, translucent colors.
+        assert(distance(result.alpha(), expected.alpha()) <= 1);
+        assert(distance(result.red(), expected.red()) <= 3);
+        assert(distance(result.green(), expected.green()) <= 3);
+        assert(distance(result.blue(), expected.blue()) <= 3);
+    }
+}
+
+TEST(blend_shortcuts)
+{
+    Color bg = Color::from_byte(1, 2, 3, 255);
+
+    assert(Color::blend(Colors::RED, bg) == Colors::RED);
+    assert(Color::blend(Color::from_byte(9, 9, 9, 0), bg) == bg);
+    assert(Color::blend_premultiplied(Color::from_byte(0, 0, 0, 0), bg) == bg);
+}
+
+TEST(premultiply_round_trip)
+{
+    Color color = Color::from_byte(255, 128, 0, 128);
+    Color premultiplied = color.premultiplied();
+
+    assert(premultiplied.red() == 128);
+    assert(premultiplied.green() == 64);
+    assert(premultiplied.blue() == 0);
+    assert(premultiplied.alpha() == 128);
+
+    assert(close_to(premultiplied.unpremultiplied(), color));
+    assert(Colors::BLUE.premultiplied() == Colors::BLUE);
+}
+
+TEST(blend_span_copies_opaque_and_skips_transparent)
+{
+    Color source[6] = {
+        Colors::RED,
+        Colors::RED,
+        Color::from_byte(0, 0, 0, 0),
+        Color::from_byte(0, 0, 128, 128),
+        Colors::GREEN,
+        Color::from_byte(0, 0, 0, 0),
+    };
+
+    Color destination[6];
+
+    for (auto &pixel : destination)
+    {
+        pixel = Colors::WHITE;
+    }
+
+    blend_span(destination, source, 6, true);
+
+    assert(destination[0] == Colors::RED);
+    assert(destination[1] == Colors::RED);
+    assert(destination[2] == Colors::WHITE);
+    assert(close_to(destination[3], Color::from_byte(127, 127, 255, 255)));
+    assert(destination[4] == Colors::GREEN);
+    assert(destination[5] == Colors::WHITE);
+}
+
+TEST(blend_span_with_a_color)
+{
+    Color destination[4];
+
+    for (auto &pixel : destination)
+    {
+        pixel = Colors::BLACK;
+    }
+
+    blend_span(destination, Color::from_byte(255, 255, 255, 51), 4);
+
+    for (auto &pixel : destination)
+    {
+        assert(pixel == Color::from_byte(51, 51, 51, 255));
+    }
+
+    blend_span(destination, Colors::RED, 2);
+
+    assert(destination[0] == Colors::RED);
+    assert(destination[2] == Color::from_byte(51, 51, 51, 255));
+}
+
+TEST(blend_span_with_coverage)
+{
+    Color color = Color::from_byte(200, 100, 50, 230);
+
+    Color destination[11];
+    Color expected[11];
+    uint8_t coverage[11];
+
+    for (int i = 0; i < 11; i++)
+    {
+        destination[i] = Color::from_byte(i * 20, 255 - i * 20, 128, 255);
+        coverage[i] = i * 25;
+    }
+
+    // A translucent pixel in the second group of four.
+    destination[5] = Color::from_byte(10, 20, 30, 100);
+
+    // The first group is left untouched.
+    coverage[0] = coverage[1] = coverage[2] = coverage[3] = 0;
+    coverage[10] = 255;
+
+    for (int i = 0; i < 11; i++)
+    {
+        expected[i] = coverage[i] ? blend_coverage(color.premultiplied(), coverage[i], destination[i]) : destination[i];
+    }
+
+    blend_span(destination, color, coverage, 11);
+
+    for (int i = 0; i < 11; i++)
+    {
+        assert(destination[i] == expected[i]);
+    }
+}
+
+int main(int, char const *[])
+{
+    div255_is_exact();
+    blend_matches_the_reference_on_opaque_background();
+    blend_matches_the_reference_on_translucent_background();
+    blend_shortcuts();
+    premultiply_round_trip();
+    blend_span_copies_opaque_and_skips_transparent();
+    blend_span_with_a_color();
+    blend_span_with_coverage();
+
+    return 0;
+}
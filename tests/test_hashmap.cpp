@@ -0,0 +1,124 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+
+#define TEST(__func) void __func()
+
+TEST(inserted_items_can_be_found)
+{
+    HashMap<String, int> map;
+
+    map["hello"] = 1;
+    map["world"] = 2;
+
+    assert(map.count() == 2);
+    assert(map.has_key("hello"));
+    assert(map.has_key(String("world")));
+    assert(!map.has_key("something else"));
+    assert(map["hello"] == 1);
+    assert(map[String("world")] == 2);
+}
+
+TEST(map_grows_past_its_initial_capacity)
+{
+    HashMap<uint32_t, uint32_t> map;
+
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        map[i] = i * 2;
+    }
+
+    assert(map.count() == 10000);
+
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        assert(map.has_key(i));
+        assert(map[i] == i * 2);
+    }
+
+    assert(!map.has_key(10000));
+}
+
+TEST(removed_items_are_gone_and_others_are_kept)
+{
+    HashMap<uint32_t, uint32_t> map;
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        map[i] = i;
+    }
+
+    for (uint32_t i = 0; i < 1000; i += 2)
+    {
+        map.remove_key(i);
+    }
+
+    assert(map.count() == 500);
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        assert(map.has_key(i) == (i % 2 == 1));
+    }
+
+    map.remove_value(1);
+    map.remove_value(999);
+
+    assert(map.count() == 498);
+    assert(!map.has_key(1));
+    assert(!map.has_key(999));
+    assert(map.has_key(3));
+}
+
+TEST(map_can_be_used_after_being_cleared)
+{
+    HashMap<String, String> map;
+
+    map["key"] = "value";
+    map.clear();
+
+    assert(map.count() == 0);
+    assert(!map.has_key("key"));
+
+    map["key"] = "other value";
+
+    assert(map["key"] == "other value");
+}
+
+TEST(copied_map_are_independent)
+{
+    HashMap<String, int> map;
+
+    map["a"] = 1;
+    map["b"] = 2;
+
+    HashMap<String, int> copy = map;
+    copy["a"] = 3;
+    copy["c"] = 4;
+
+    assert(map.count() == 2);
+    assert(map["a"] == 1);
+    assert(copy.count() == 3);
+    assert(copy["a"] == 3);
+
+    int sum = 0;
+
+    copy.foreach ([&](auto &, auto &value) {
+        sum += value;
+        return Iteration::CONTINUE;
+    });
+
+    assert(sum == 9);
+}
+
+int main(int, char const *[])
+{
+    inserted_items_can_be_found();
+    map_grows_past_its_initial_capacity();
+    removed_items_are_gone_and_others_are_kept();
+    map_can_be_used_after_being_cleared();
+    copied_map_are_independent();
+
+    return 0;
+}
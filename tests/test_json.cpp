@@ -0,0 +1,206 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libsystem/json/Json.h>
+
+#define TEST(__func) void __func()
+
+static const char *DOCUMENT = R"({
+    "name": "Skift Dark",
+    "dark": true,
+    "light": false,
+    "nothing": null,
+    "count": -42,
+    "ratio": 1.5e2,
+    "escaped": "a\"b\\c\ndé",
+    "list": [1, [2, 3], {"four": 4}, []],
+    "empty": {}
+})";
+
+TEST(reader_returns_every_token)
+{
+    json::Reader reader{DOCUMENT, strlen(DOCUMENT)};
+
+    json::Token expected[] = {
+        json::Token::BEGIN_OBJECT,
+        json::Token::KEY, json::Token::STRING,
+        json::Token::KEY, json::Token::TRUE,
+        json::Token::KEY, json::Token::FALSE,
+        json::Token::KEY, json::Token::NIL,
+        json::Token::KEY, json::Token::INTEGER,
+        json::Token::KEY, json::Token::DOUBLE,
+        json::Token::KEY, json::Token::STRING,
+        json::Token::KEY, json::Token::BEGIN_ARRAY,
+        json::Token::INTEGER,
+        json::Token::BEGIN_ARRAY, json::Token::INTEGER, json::Token::INTEGER, json::Token::END_ARRAY,
+        json::Token::BEGIN_OBJECT, json::Token::KEY, json::Token::INTEGER, json::Token::END_OBJECT,
+        json::Token::BEGIN_ARRAY, json::Token::END_ARRAY,
+        json::Token::END_ARRAY,
+        json::Token::KEY, json::Token::BEGIN_OBJECT, json::Token::END_OBJECT,
+        json::Token::END_OBJECT,
+        json::Token::END,
+    };
+
+    for (auto token : expected)
+    {
+        assert(reader.next() == token);
+    }
+}
+
+TEST(reader_values)
+{
+    json::Reader reader{DOCUMENT, strlen(DOCUMENT)};
+
+    assert(reader.next() == json::Token::BEGIN_OBJECT);
+    assert(reader.next() == json::Token::KEY);
+    assert(reader.raw_string() == "name");
+    assert(reader.next() == json::Token::STRING);
+    assert(reader.raw_string() == "Skift Dark");
+    assert(!reader.escaped());
+
+    while (reader.next() != json::Token::INTEGER)
+    {
+    }
+
+    assert(reader.integer() == -42);
+
+    assert(reader.next() == json::Token::KEY);
+    assert(reader.next() == json::Token::DOUBLE);
+    assert(reader.as_double() == 150);
+
+    assert(reader.next() == json::Token::KEY);
+    assert(reader.next() == json::Token::STRING);
+    assert(reader.escaped());
+    assert(reader.string() == "a\"b\\c\nd\xc3\xa9");
+
+    char buffer[64];
+    assert(reader.unescape(buffer) == 9);
+    assert(memcmp(buffer, "a\"b\\c\nd\xc3\xa9", 9) == 0);
+}
+
+TEST(reader_skip_nested_containers)
+{
+    json::Reader reader{DOCUMENT, strlen(DOCUMENT)};
+
+    while (reader.next() != json::Token::BEGIN_ARRAY)
+    {
+    }
+
+    reader.skip();
+
+    assert(reader.next() == json::Token::KEY);
+    assert(reader.raw_string() == "empty");
+}
+
+TEST(reader_reports_errors)
+{
+    const char *truncated = "{\"a\": [1, 2";
+    json::Reader reader{truncated, strlen(truncated)};
+
+    json::Token token;
+    while ((token = reader.next()) != json::Token::ERROR)
+    {
+        assert(token != json::Token::END);
+    }
+
+    const char *mismatched = "[1}";
+    json::Reader other{mismatched, strlen(mismatched)};
+
+    assert(other.next() == json::Token::BEGIN_ARRAY);
+    assert(other.next() == json::Token::INTEGER);
+    assert(other.next() == json::Token::ERROR);
+    assert(other.next() == json::Token::ERROR);
+}
+
+TEST(parse_builds_values)
+{
+    auto root = json::parse(DOCUMENT, strlen(DOCUMENT));
+
+    assert(root.is(json::OBJECT));
+    assert(root.get("name").as_string() == "Skift Dark");
+    assert(root.get("dark").is(json::TRUE));
+    assert(root.get("nothing").is(json::NIL));
+    assert(root.get("count").as_integer() == -42);
+    assert(root.get("escaped").as_string() == "a\"b\\c\nd\xc3\xa9");
+    assert(root.get("list").length() == 4);
+    assert(root.get("list").get(1).get(1).as_integer() == 3);
+    assert(root.get("list").get(2).get("four").as_integer() == 4);
+    assert(root.get("empty").is(json::OBJECT));
+}
+
+TEST(looking_keys_up_does_not_intern_them)
+{
+    auto root = json::parse(DOCUMENT, strlen(DOCUMENT));
+    Atom atom;
+
+    assert(!root.has("looked-up-only"));
+    assert(root.get("looked-up-only").is(json::NIL));
+    root.with("looked-up-only", [](auto &) { assert(false); });
+    root.remove("looked-up-only");
+
+    assert(!Atom::lookup("looked-up-only", &atom));
+    assert(root.length() == 9);
+
+    root.put("looked-up-only", 7);
+
+    assert(Atom::lookup("looked-up-only", &atom));
+    assert(atom == "looked-up-only");
+    assert(root.get("looked-up-only").as_integer() == 7);
+}
+
+TEST(document_points_into_the_buffer)
+{
+    json::Document document{DOCUMENT, strlen(DOCUMENT)};
+    auto &root = document.root();
+
+    assert(root.is(json::OBJECT));
+    assert(root.length() == 9);
+    assert(root.member(0).key == "name");
+
+    auto name = root.get("name").as_string();
+    assert(name == "Skift Dark");
+    assert(name.buffer() > DOCUMENT && name.buffer() < DOCUMENT + strlen(DOCUMENT));
+
+    assert(root.get("escaped").as_string() == "a\"b\\c\nd\xc3\xa9");
+    assert(root.get("count").as_integer() == -42);
+    assert(root.get("ratio").as_double() == 150);
+    assert(root.get("list").get(1).get(0).as_integer() == 2);
+    assert(root.get("list").get(2).get("four").as_integer() == 4);
+    assert(root.get("list").get(3).length() == 0);
+
+    assert(!root.has("missing"));
+    assert(root.get("missing").is(json::NIL));
+    assert(root.get("list").get(42).is(json::NIL));
+}
+
+TEST(document_move)
+{
+    json::Document document{DOCUMENT, strlen(DOCUMENT)};
+    json::Document other = move(document);
+
+    assert(document.root().is(json::NIL));
+    assert(other.root().get("dark").is(json::TRUE));
+}
+
+TEST(invalid_document_is_null)
+{
+    const char *invalid = "{\"a\": [1, 2}";
+    json::Document document{invalid, strlen(invalid)};
+
+    assert(document.root().is(json::NIL));
+}
+
+int main(int, char const *[])
+{
+    reader_returns_every_token();
+    reader_values();
+    reader_skip_nested_containers();
+    reader_reports_errors();
+    parse_builds_values();
+    looking_keys_up_does_not_intern_them();
+    document_points_into_the_buffer();
+    document_move();
+    invalid_document_is_null();
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libmarkup/Markup.h>
+#include <libsystem/Assert.h>
+#include <libwidget/CompiledMarkup.h>
+
+#define TEST(__func) void __func()
+
+static const char *APPLICATIONS[] = {"about", "calculator", "settings"};
+
+static char *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "r");
+
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s\n", path);
+        abort();
+    }
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buffer = (char *)malloc(*size);
+    assert(fread(buffer, 1, *size, file) == *size);
+    fclose(file);
+
+    return buffer;
+}
+
+static void assert_same_string(CompiledMarkup &compiled, const CompiledMarkupString &string, markup::Node &node, const char *attribute)
+{
+    assert(compiled.has(string) == node.has_attribute(attribute));
+
+    if (node.has_attribute(attribute))
+    {
+        assert(compiled.string(string) == node.get_attribute(attribute).cstring());
+    }
+}
+
+static void assert_same_flag(const CompiledMarkupNode &compiled, int flag, markup::Node &node, const char *attribute)
+{
+    assert(((compiled.flags & flag) == flag) == node.has_attribute(attribute));
+}
+
+static void assert_same_tree(CompiledMarkup &compiled, size_t &index, markup::Node &node)
+{
+    auto &compiled_node = compiled.node(index++);
+
+    assert(compiled.string(compiled_node.name) == node.type());
+    assert(compiled_node.childs == (uint32_t)node.count_child());
+
+    assert_same_string(compiled, compiled_node.id, node, "id");
+    assert_same_string(compiled, compiled_node.text, node, node.is("Window") ? "title" : "text");
+    assert_same_string(compiled, compiled_node.icon, node, "icon");
+
+    assert_same_flag(compiled_node, COMPILED_MARKUP_HAS_LAYOUT, node, "layout");
+    assert_same_flag(compiled_node, COMPILED_MARKUP_HAS_INSETS, node, "padding");
+    assert_same_flag(compiled_node, COMPILED_MARKUP_FILL, node, "fill");
+    assert_same_flag(compiled_node, COMPILED_MARKUP_FILLED, node, "filled");
+    assert_same_flag(compiled_node, COMPILED_MARKUP_OUTLINED, node, "outlined");
+    assert_same_flag(compiled_node, COMPILED_MARKUP_ROUNDED, node, "rounded");
+
+    node.foreach_child([&](auto &child) {
+        assert_same_tree(compiled, index, child);
+        return Iteration::CONTINUE;
+    });
+}
+
+TEST(compiled_markup_matches_the_source)
+{
+    for (auto application : APPLICATIONS)
+    {
+        char path[256];
+        size_t size;
+
+        snprintf(path, sizeof(path), "../applications/%s/%s.markup", application, application);
+        char *source = read_file(path, &size);
+        auto document = markup::parse(source, size);
+
+        snprintf(path, sizeof(path), "compiled/%s/%s.markup", application, application);
+        char *buffer = read_file(path, &size);
+        CompiledMarkup compiled{buffer, size};
+
+        assert(compiled.valid());
+
+        size_t index = 0;
+        assert_same_tree(compiled, index, document.root());
+        assert(index == compiled.node_count());
+
+        free(source);
+        free(buffer);
+    }
+}
+
+TEST(compiled_markup_values_are_resolved)
+{
+    size_t size;
+    char *buffer = read_file("compiled/calculator/calculator.markup", &size);
+    CompiledMarkup compiled{buffer, size};
+
+    auto &window = compiled.node(0);
+    assert(window.type == COMPILED_WIDGET_WINDOW);
+    assert(window.width == 260 && window.height == 320);
+    assert(window.layout == 4); // vflow(8)
+    assert(window.layout_spacing[0] == 0 && window.layout_spacing[1] == 8);
+    assert(window.insets[0] == 6 && window.insets[3] == 6);
+
+    auto &panel = compiled.node(1);
+    assert(panel.type == COMPILED_WIDGET_PANEL);
+    assert(panel.insets[1] == 12);
+
+    auto &label = compiled.node(2);
+    assert(label.type == COMPILED_WIDGET_LABEL);
+    assert(compiled.string(label.id) == "screen");
+
+    auto &grid = compiled.node(3);
+    assert(grid.type == COMPILED_WIDGET_CONTAINER);
+    assert(grid.layout == 1); // grid(4, 6, 4, 4)
+    assert(grid.layout_cells[0] == 4 && grid.layout_cells[1] == 6);
+    assert(grid.layout_spacing[0] == 4 && grid.layout_spacing[1] == 4);
+
+    assert(compiled.node(4).type == COMPILED_WIDGET_BUTTON);
+
+    free(buffer);
+}
+
+TEST(corrupted_compiled_markup_is_rejected)
+{
+    size_t size;
+    char *buffer = read_file("compiled/calculator/calculator.markup", &size);
+
+    assert(!CompiledMarkup(buffer, size - 1).valid());
+    assert(!CompiledMarkup(buffer, sizeof(CompiledMarkupHeader)).valid());
+
+    auto nodes = reinterpret_cast<CompiledMarkupNode *>(buffer + sizeof(CompiledMarkupHeader));
+
+    nodes[0].childs++;
+    assert(!CompiledMarkup(buffer, size).valid());
+    nodes[0].childs--;
+
+    nodes[1].name.offset = 0xfffffff0;
+    assert(!CompiledMarkup(buffer, size).valid());
+
+    free(buffer);
+}
+
+TEST(text_markup_is_not_compiled)
+{
+    const char *text = "<Window></Window>";
+    assert(!CompiledMarkup(text, strlen(text)).valid());
+}
+
+TEST(text_markup_tree_outlives_the_source)
+{
+    char *text = strdup("<Window title=\"A \\\"B\\\"\" resizable><Label text=\"x\" text=\"y\"/><Button/></Window>");
+
+    auto document = markup::parse(text, strlen(text));
+    free(text);
+
+    auto &root = document.root();
+
+    assert(root.is("Window"));
+    assert(root.get_attribute("title") == "A \"B\"");
+    assert(root.has_attribute("resizable"));
+    assert(root.get_attribute("resizable") == "");
+    assert(!root.has_attribute("borderless"));
+    assert(root.count_child() == 2);
+
+    size_t index = 0;
+
+    root.foreach_child([&](auto &child) {
+        if (index == 0)
+        {
+            assert(child.is("Label"));
+            assert(child.get_attribute("text") == "y");
+            assert(child.flags() & markup::Node::SELF_CLOSING);
+        }
+        else
+        {
+            assert(child.is("Button"));
+            assert(child.count_child() == 0);
+        }
+
+        index++;
+        return Iteration::CONTINUE;
+    });
+
+    assert(index == 2);
+
+    auto moved = move(document);
+    assert(moved.root().is("Window"));
+}
+
+int main(int, char const *[])
+{
+    compiled_markup_matches_the_source();
+    compiled_markup_values_are_resolved();
+    corrupted_compiled_markup_is_rejected();
+    text_markup_is_not_compiled();
+    text_markup_tree_outlives_the_source();
+
+    return 0;
+}
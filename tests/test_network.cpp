@@ -0,0 +1,110 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libsystem/network/IPv4.h>
+#include <libsystem/network/TCP.h>
+#include <libsystem/network/UDP.h>
+
+#define TEST(__func) void __func()
+
+TEST(checksum_matches_rfc_1071)
+{
+    uint8_t data[] = {0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7};
+
+    assert(checksum_add(0, data, sizeof(data)) == 0x2ddf0);
+    assert(checksum(data, sizeof(data)) == (uint16_t)~0xddf2);
+}
+
+TEST(checksum_pads_odd_sizes)
+{
+    uint8_t odd[] = {0x12, 0x34, 0x56};
+    uint8_t even[] = {0x12, 0x34, 0x56, 0x00};
+
+    assert(checksum(odd, sizeof(odd)) == checksum(even, sizeof(even)));
+}
+
+TEST(checksum_of_a_checksummed_header_is_zero)
+{
+    IPv4Header header = {};
+    header.version_and_length = (IPV4_VERSION << 4) | (sizeof(IPv4Header) / 4);
+    header.total_length = 84;
+    header.identification = 0x1c46;
+    header.fragment = IPV4_FLAG_DONT_FRAGMENT;
+    header.ttl = IPV4_DEFAULT_TTL;
+    header.protocol = IPV4_PROTOCOL_ICMP;
+    header.source = {{10, 0, 2, 15}};
+    header.destination = {{10, 0, 2, 2}};
+
+    header.checksum = checksum(&header, sizeof(IPv4Header));
+
+    assert(checksum(&header, sizeof(IPv4Header)) == 0);
+    assert(header.header_size() == 20);
+    assert(header.version() == IPV4_VERSION);
+}
+
+TEST(pseudo_header_sums_like_the_bytes)
+{
+    IPv4Address source = {{192, 168, 1, 1}};
+    IPv4Address destination = {{192, 168, 1, 254}};
+
+    uint8_t pseudo[] = {192, 168, 1, 1, 192, 168, 1, 254, 0, IPV4_PROTOCOL_UDP, 0x01, 0x02};
+
+    assert(checksum_finalize(ipv4_pseudo_header_sum(source, destination, IPV4_PROTOCOL_UDP, 0x0102)) ==
+           checksum(pseudo, sizeof(pseudo)));
+}
+
+TEST(headers_are_big_endian)
+{
+    UDPHeader header = {};
+    header.source_port = 0x1234;
+    header.length = 8;
+
+    auto bytes = reinterpret_cast<uint8_t *>(&header);
+
+    assert(bytes[0] == 0x12 && bytes[1] == 0x34);
+    assert(bytes[4] == 0x00 && bytes[5] == 0x08);
+    assert(header.source_port() == 0x1234);
+
+    TCPHeader tcp = {};
+    tcp.data_offset = 8 << 4;
+
+    assert(tcp.header_size() == 32);
+}
+
+TEST(addresses_parse)
+{
+    IPv4Address address = {};
+
+    assert(ipv4_address_parse("10.0.2.15", address));
+    assert(address == (IPv4Address{{10, 0, 2, 15}}));
+    assert(address.value() == 0x0a00020f);
+    assert(IPv4Address::from_value(0x0a00020f) == address);
+
+    assert(!ipv4_address_parse("10.0.2", address));
+    assert(!ipv4_address_parse("10.0.2.256", address));
+    assert(!ipv4_address_parse("10.0.2.15.1", address));
+    assert(!ipv4_address_parse("10..2.15", address));
+    assert(!ipv4_address_parse("", address));
+}
+
+TEST(sequence_numbers_wrap_around)
+{
+    assert(tcp_sequence_before(1, 2));
+    assert(!tcp_sequence_before(2, 2));
+    assert(tcp_sequence_before_or_equal(2, 2));
+    assert(tcp_sequence_before(0xfffffff0, 0x10));
+    assert(!tcp_sequence_before(0x10, 0xfffffff0));
+}
+
+int main(int, char const *[])
+{
+    checksum_matches_rfc_1071();
+    checksum_pads_odd_sizes();
+    checksum_of_a_checksummed_header_is_zero();
+    pseudo_header_sums_like_the_bytes();
+    headers_are_big_endian();
+    addresses_parse();
+    sequence_numbers_wrap_around();
+
+    return 0;
+}
@@ -71,6 +71,22 @@ TEST(joined_path_is_equal_to_its_normalized_counter_part)
     assert(p2.string() == "/home/user/local");
 }
 
+TEST(path_extension)
+{
+    auto p = Path::parse("/home/user/archive.tar.gz");
+
+    assert(p.extension() == ".tar.gz");
+    assert(p.basename_without_extension() == "archive");
+}
+
+TEST(hidden_file_is_not_an_extension)
+{
+    auto p = Path::parse("/home/user/.profile");
+
+    assert(p.extension() == "");
+    assert(p.basename_without_extension() == ".profile");
+}
+
 int main(int, char const *[])
 {
     absolute_path_are_absolute();
@@ -82,6 +98,8 @@ int main(int, char const *[])
     a_path_and_its_string_representation_are_equals();
     path_is_equal_to_its_normalized_counter_part();
     joined_path_is_equal_to_its_normalized_counter_part();
+    path_extension();
+    hidden_file_is_not_an_extension();
 
     return 0;
 }
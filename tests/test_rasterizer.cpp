@@ -0,0 +1,193 @@
+#include <stdlib.h>
+
+#include <libgraphic/vector/Rasterizer.h>
+#include <libsystem/Assert.h>
+
+#define TEST(__func) void __func()
+
+static constexpr int WIDTH = 32;
+static constexpr int HEIGHT = 32;
+
+static uint8_t _coverage[HEIGHT][WIDTH];
+
+static void rasterize(const graphic::Path &path, Recti clip, graphic::FillRule rule)
+{
+    for (auto &row : _coverage)
+    {
+        for (auto &cell : row)
+        {
+            cell = 0;
+        }
+    }
+
+    graphic::Rasterizer rasterizer;
+
+    rasterizer.fill(path, {0, 0}, Trans2f::identity(), clip, rule, [&](int y, int x, const uint8_t *coverage, int count) {
+        assert(y >= clip.top() && y < clip.bottom());
+        assert(x >= clip.left() && x + count <= clip.right());
+
+        for (int i = 0; i < count; i++)
+        {
+            _coverage[y][x + i] = coverage[i];
+        }
+    });
+}
+
+static void rasterize(const graphic::Path &path)
+{
+    rasterize(path, Recti(WIDTH, HEIGHT), graphic::FillRule::NONZERO);
+}
+
+static void add_square(graphic::Path &path, float x, float y, float size, bool clockwise)
+{
+    path.move_to({x, y});
+
+    if (clockwise)
+    {
+        path.line_to({x + size, y});
+        path.line_to({x + size, y + size});
+        path.line_to({x, y + size});
+    }
+    else
+    {
+        path.line_to({x, y + size});
+        path.line_to({x + size, y + size});
+        path.line_to({x + size, y});
+    }
+
+    path.close_subpath();
+}
+
+TEST(aligned_square_is_exact)
+{
+    graphic::Path path;
+    add_square(path, 4, 4, 8, true);
+
+    rasterize(path);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            bool inside = x >= 4 && x < 12 && y >= 4 && y < 12;
+            assert(_coverage[y][x] == (inside ? 255 : 0));
+        }
+    }
+}
+
+TEST(half_pixel_edges_are_half_covered)
+{
+    graphic::Path path;
+    add_square(path, 4.5, 4, 8, true);
+
+    rasterize(path);
+
+    for (int y = 4; y < 12; y++)
+    {
+        assert(_coverage[y][4] >= 127 && _coverage[y][4] <= 128);
+        assert(_coverage[y][8] == 255);
+        assert(_coverage[y][12] >= 127 && _coverage[y][12] <= 128);
+        assert(_coverage[y][13] == 0);
+    }
+}
+
+TEST(diagonal_is_antialiased)
+{
+    // Right triangle, the hypotenuse goes through the corners of the
+    // pixels so each one on it is cut in half.
+    auto path = graphic::Path::parse("M0,0L16,0L0,16Z");
+
+    rasterize(path);
+
+    for (int y = 0; y < 16; y++)
+    {
+        int diagonal = 15 - y;
+
+        assert(_coverage[y][diagonal] >= 127 && _coverage[y][diagonal] <= 128);
+
+        if (diagonal > 0)
+        {
+            assert(_coverage[y][diagonal - 1] == 255);
+        }
+
+        assert(_coverage[y][diagonal + 1] == 0);
+    }
+}
+
+TEST(fill_rules)
+{
+    graphic::Path path;
+    add_square(path, 2, 2, 20, true);
+    add_square(path, 8, 8, 8, true);
+
+    rasterize(path, Recti(WIDTH, HEIGHT), graphic::FillRule::NONZERO);
+    assert(_coverage[12][12] == 255);
+    assert(_coverage[4][4] == 255);
+
+    rasterize(path, Recti(WIDTH, HEIGHT), graphic::FillRule::EVENODD);
+    assert(_coverage[12][12] == 0);
+    assert(_coverage[4][4] == 255);
+
+    graphic::Path hole;
+    add_square(hole, 2, 2, 20, true);
+    add_square(hole, 8, 8, 8, false);
+
+    rasterize(hole, Recti(WIDTH, HEIGHT), graphic::FillRule::NONZERO);
+    assert(_coverage[12][12] == 0);
+    assert(_coverage[4][4] == 255);
+}
+
+TEST(clipped_fill)
+{
+    graphic::Path path;
+    add_square(path, -10, -10, 30, true);
+
+    Recti clip{5, 6, 10, 4};
+    rasterize(path, clip, graphic::FillRule::NONZERO);
+
+    for (int y = 0; y < HEIGHT; y++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            assert(_coverage[y][x] == (clip.contains(Vec2i(x, y)) ? 255 : 0));
+        }
+    }
+}
+
+TEST(shapes_with_curves_are_closed)
+{
+    // A circle made of two arcs, without closing it explicitly.
+    auto path = graphic::Path::parse("M6,16A10,10 0 0,1 26,16A10,10 0 0,1 6,16");
+
+    rasterize(path);
+
+    assert(_coverage[16][16] == 255);
+    assert(_coverage[16][7] == 255);
+    assert(_coverage[1][1] == 0);
+    assert(_coverage[30][30] == 0);
+
+    int total = 0;
+
+    for (auto &row : _coverage)
+    {
+        for (auto cell : row)
+        {
+            total += cell;
+        }
+    }
+
+    // Close to pi * r^2 pixels.
+    assert(total / 255 > 300 && total / 255 < 328);
+}
+
+int main(int, char const *[])
+{
+    aligned_square_is_exact();
+    half_pixel_edges_are_half_covered();
+    diagonal_is_antialiased();
+    fill_rules();
+    clipped_fill();
+    shapes_with_curves_are_closed();
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include <stdlib.h>
+
+#include <libgraphic/Scaling.h>
+#include <libsystem/Assert.h>
+
+#define TEST(__func) void __func()
+
+static Color *make_image(int width, int height, Color color)
+{
+    Color *pixels = (Color *)malloc(width * height * sizeof(Color));
+
+    for (int i = 0; i < width * height; i++)
+    {
+        pixels[i] = color;
+    }
+
+    return pixels;
+}
+
+// Scaled into a `width` by `height` image, rows out of the clip are left
+// transparent.
+static Color *scale_image(const Color *pixels, int stride, Recti source, int width, int height, Recti clip, BitmapFiltering filtering)
+{
+    Color *result = make_image(width, height, Colors::TRANSPARENT);
+
+    scale(pixels, stride, source, Recti(width, height), clip, filtering, [&](int y, int x, const Color *row, int count) {
+        assert(y >= clip.top() && y < clip.bottom());
+        assert(x == clip.x() && count == clip.width());
+
+        for (int i = 0; i < count; i++)
+        {
+            result[y * width + x + i] = row[i];
+        }
+    });
+
+    return result;
+}
+
+static int distance(Color a, Color b)
+{
+    return MAX(MAX(abs(a.red() - b.red()), abs(a.green() - b.green())),
+               MAX(abs(a.blue() - b.blue()), abs(a.alpha() - b.alpha())));
+}
+
+TEST(flat_color_stays_flat)
+{
+    Color color = Color::from_byte(12, 200, 99, 255);
+    Color *pixels = make_image(64, 48, color);
+
+    int sizes[][2] = {{64, 48}, {100, 75}, {37, 13}, {32, 24}, {7, 5}, {640, 480}};
+
+    for (auto &size : sizes)
+    {
+        Recti bound(size[0], size[1]);
+
+        Color *result = scale_image(pixels, 64, Recti(64, 48), size[0], size[1], bound, BITMAP_FILTERING_LINEAR);
+
+        for (int i = 0; i < size[0] * size[1]; i++)
+        {
+            assert(result[i] == color);
+        }
+
+        free(result);
+    }
+
+    free(pixels);
+}
+
+TEST(same_size_is_a_copy)
+{
+    Color *pixels = make_image(40, 30, Colors::BLACK);
+
+    for (int i = 0; i < 40 * 30; i++)
+    {
+        pixels[i] = Color::from_byte(i & 0xff, (i * 7) & 0xff, (i * 13) & 0xff, 255);
+    }
+
+    Color *result = scale_image(pixels, 40, Recti(40, 30), 40, 30, Recti(40, 30), BITMAP_FILTERING_LINEAR);
+
+    for (int i = 0; i < 40 * 30; i++)
+    {
+        assert(result[i] == pixels[i]);
+    }
+
+    free(result);
+    free(pixels);
+}
+
+TEST(upscaling_interpolates_between_pixels)
+{
+    // A black pixel next to a white one.
+    Color *pixels = make_image(2, 1, Colors::BLACK);
+    pixels[1] = Colors::WHITE;
+
+    Color *result = scale_image(pixels, 2, Recti(2, 1), 8, 1, Recti(8, 1), BITMAP_FILTERING_LINEAR);
+
+    // The outer pixels are clamped to the edges, the others go up steadily.
+    assert(result[0] == Colors::BLACK);
+    assert(result[7] == Colors::WHITE);
+
+    for (int x = 1; x < 8; x++)
+    {
+        assert(result[x].red() >= result[x - 1].red());
+    }
+
+    assert(distance(result[3], Color::from_byte(96, 96, 96, 255)) <= 2);
+    assert(distance(result[4], Color::from_byte(159, 159, 159, 255)) <= 2);
+
+    free(result);
+    free(pixels);
+}
+
+TEST(upscaling_with_nearest_filtering_repeats_pixels)
+{
+    Color *pixels = make_image(2, 2, Colors::BLACK);
+    pixels[1] = Colors::WHITE;
+    pixels[2] = Colors::WHITE;
+
+    Color *result = scale_image(pixels, 2, Recti(2, 2), 6, 6, Recti(6, 6), BITMAP_FILTERING_NEAREST);
+
+    for (int y = 0; y < 6; y++)
+    {
+        for (int x = 0; x < 6; x++)
+        {
+            assert(result[y * 6 + x] == pixels[(y / 3) * 2 + x / 3]);
+        }
+    }
+
+    free(result);
+    free(pixels);
+}
+
+TEST(downscaling_averages_every_pixel)
+{
+    Color *pixels = make_image(64, 64, Colors::BLACK);
+
+    for (int y = 0; y < 64; y++)
+    {
+        for (int x = 0; x < 64; x++)
+        {
+            if ((x + y) % 2)
+            {
+                pixels[y * 64 + x] = Colors::WHITE;
+            }
+        }
+    }
+
+    int sizes[] = {32, 16, 10, 3};
+
+    for (int size : sizes)
+    {
+        Color *result = scale_image(pixels, 64, Recti(64, 64), size, size, Recti(size, size), BITMAP_FILTERING_LINEAR);
+
+        for (int i = 0; i < size * size; i++)
+        {
+            assert(distance(result[i], Color::from_byte(128, 128, 128, 255)) <= 16);
+        }
+
+        free(result);
+    }
+
+    free(pixels);
+}
+
+TEST(only_the_source_rectangle_is_read)
+{
+    // A gray square in the middle of a red image.
+    Color gray = Color::from_byte(100, 100, 100, 255);
+    Color *pixels = make_image(50, 50, Colors::RED);
+
+    for (int y = 10; y < 30; y++)
+    {
+        for (int x = 10; x < 30; x++)
+        {
+            pixels[y * 50 + x] = gray;
+        }
+    }
+
+    int sizes[] = {7, 33, 80};
+
+    for (int size : sizes)
+    {
+        Color *result = scale_image(pixels, 50, Recti(10, 10, 20, 20), size, size, Recti(size, size), BITMAP_FILTERING_LINEAR);
+
+        for (int i = 0; i < size * size; i++)
+        {
+            assert(result[i] == gray);
+        }
+
+        free(result);
+    }
+
+    free(pixels);
+}
+
+TEST(only_the_clip_is_produced)
+{
+    Color color = Color::from_byte(1, 2, 3, 255);
+    Color *pixels = make_image(30, 30, color);
+
+    Recti clips[] = {
+        Recti(5, 7, 20, 3),
+        Recti(50, 50, 100, 100),
+        Recti(-10, -10, 20, 20),
+    };
+
+    for (Recti clip : clips)
+    {
+        Recti clipped = clip.clipped_with(Recti(90, 90));
+
+        Color *result = scale_image(pixels, 30, Recti(30, 30), 90, 90, clipped, BITMAP_FILTERING_LINEAR);
+
+        for (int y = 0; y < 90; y++)
+        {
+            for (int x = 0; x < 90; x++)
+            {
+                bool inside = x >= clipped.x() && x < clipped.right() && y >= clipped.top() && y < clipped.bottom();
+                assert(result[y * 90 + x] == (inside ? color : Colors::TRANSPARENT));
+            }
+        }
+
+        free(result);
+    }
+
+    free(pixels);
+}
+
+int main(int, char const *[])
+{
+    flat_color_stays_flat();
+    same_size_is_a_copy();
+    upscaling_interpolates_between_pixels();
+    upscaling_with_nearest_filtering_repeats_pixels();
+    downscaling_averages_every_pixel();
+    only_the_source_rectangle_is_read();
+    only_the_clip_is_produced();
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libutils/ScannerUtils.h>
+#include <libutils/SpanScanner.h>
+
+#define TEST(__func) void __func()
+
+TEST(span_scanner_peek_past_the_end_is_null)
+{
+    SpanScanner scan{"ab", 2};
+
+    assert(scan.current() == 'a');
+    assert(scan.peek(1) == 'b');
+    assert(scan.peek(2) == '\0');
+
+    scan.foreward(10);
+
+    assert(scan.ended());
+    assert(scan.current() == '\0');
+    assert(scan.position() == 2);
+}
+
+TEST(span_scanner_eat_while)
+{
+    SpanScanner scan{"12345abc"};
+
+    auto digits = scan.eat_while([](char c) { return c >= '0' && c <= '9'; });
+
+    assert(digits == "12345");
+    assert(scan.current() == 'a');
+    assert(scan.eat("abc") == "abc");
+    assert(scan.ended());
+    assert(scan.eat("abc").empty());
+}
+
+TEST(span_scanner_take_until_across_chunks)
+{
+    // Long enough to go through the wide path and land in the tail.
+    const char *text = "0123456789abcdef0123456789abcdef0123456789|rest";
+    SpanScanner scan{text};
+
+    auto head = scan.take_until('|');
+
+    assert(head.length() == 42);
+    assert(head.buffer() == text);
+    assert(scan.skip('|'));
+    assert(scan.rest() == "rest");
+
+    assert(scan.take_until('|') == "rest");
+    assert(scan.ended());
+}
+
+TEST(span_scanner_take_until_either)
+{
+    const char *text = "0123456789abcdef0123456789abcdef\\\"escaped\"";
+    SpanScanner scan{text};
+
+    assert(scan.take_until('"', '\\').length() == 32);
+    assert(scan.current() == '\\');
+
+    scan.foreward(2);
+
+    assert(scan.take_until('"', '\\') == "escaped");
+    assert(scan.current() == '"');
+}
+
+TEST(span_scanner_eat_whitespace)
+{
+    SpanScanner scan{"                    \n\t\r    x"};
+
+    assert(scan.eat_whitespace().length() == 27);
+    assert(scan.current() == 'x');
+    assert(scan.eat_whitespace().empty());
+}
+
+TEST(span_scanner_skip_word)
+{
+    SpanScanner scan{"grid(1, 2)"};
+
+    assert(!scan.skip_word("gridd"));
+    assert(!scan.skip_word("grid(1, 2)!"));
+    assert(scan.skip_word("grid"));
+    assert(scan.skip('('));
+    assert(scan_int(scan, 10) == 1);
+}
+
+TEST(span_scanner_codepoints)
+{
+    SpanScanner scan{"é€x"};
+
+    assert(scan.current_codepoint() == 0xe9);
+    scan.foreward_codepoint();
+    assert(scan.current_codepoint() == 0x20ac);
+    scan.foreward_codepoint();
+    assert(scan.current() == 'x');
+}
+
+TEST(span_scanner_json_escape_sequence)
+{
+    SpanScanner scan{"\\n\\u00e9"};
+
+    assert(strcmp(scan_json_escape_sequence(scan), "\n") == 0);
+    assert(strcmp(scan_json_escape_sequence(scan), "é") == 0);
+    assert(scan.ended());
+}
+
+int main(int, char const *[])
+{
+    span_scanner_peek_past_the_end_is_null();
+    span_scanner_eat_while();
+    span_scanner_take_until_across_chunks();
+    span_scanner_take_until_either();
+    span_scanner_eat_whitespace();
+    span_scanner_skip_word();
+    span_scanner_codepoints();
+    span_scanner_json_escape_sequence();
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/Assert.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#define TEST(__func) void __func()
+
+static int compare_int(const int &left, const int &right)
+{
+    return left - right;
+}
+
+static Vector<int> random_values(size_t count, int range)
+{
+    Vector<int> values;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        values.push_back(rand() % range);
+    }
+
+    return values;
+}
+
+static bool is_sorted(Vector<int> &values, size_t count)
+{
+    for (size_t i = 1; i < count; i++)
+    {
+        if (values[i - 1] > values[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST(empty_and_single_element_vectors_can_be_sorted)
+{
+    Vector<int> empty;
+    empty.sort(compare_int);
+    empty.stable_sort(compare_int);
+    assert(empty.count() == 0);
+
+    Vector<int> single;
+    single.push_back(42);
+    single.sort(compare_int);
+    assert(single[0] == 42);
+}
+
+TEST(random_values_are_sorted)
+{
+    size_t sizes[] = {2, 15, 17, 100, 10000};
+
+    for (size_t size : sizes)
+    {
+        auto values = random_values(size, 1000000);
+        values.sort(compare_int);
+        assert(is_sorted(values, values.count()));
+
+        auto duplicated = random_values(size, 4);
+        duplicated.sort(compare_int);
+        assert(is_sorted(duplicated, duplicated.count()));
+
+        auto stable = random_values(size, 1000000);
+        stable.stable_sort(compare_int);
+        assert(is_sorted(stable, stable.count()));
+    }
+}
+
+TEST(sorted_and_reversed_values_are_sorted)
+{
+    Vector<int> sorted;
+    Vector<int> reversed;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        sorted.push_back(i);
+        reversed.push_back(5000 - i);
+    }
+
+    sorted.sort(compare_int);
+    reversed.sort(compare_int);
+
+    assert(is_sorted(sorted, sorted.count()));
+    assert(is_sorted(reversed, reversed.count()));
+}
+
+TEST(stable_sort_keeps_the_order_of_equal_elements)
+{
+    struct Entry
+    {
+        int key;
+        int order;
+    };
+
+    Vector<Entry> entries;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        entries.push_back({rand() % 10, i});
+    }
+
+    entries.stable_sort([](auto &left, auto &right) { return left.key - right.key; });
+
+    for (size_t i = 1; i < entries.count(); i++)
+    {
+        assert(entries[i - 1].key <= entries[i].key);
+
+        if (entries[i - 1].key == entries[i].key)
+        {
+            assert(entries[i - 1].order < entries[i].order);
+        }
+    }
+}
+
+TEST(partial_sort_puts_the_smallest_elements_first)
+{
+    auto values = random_values(1000, 1000000);
+
+    auto sorted = values;
+    sorted.sort(compare_int);
+
+    values.partial_sort(10, compare_int);
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        assert(values[i] == sorted[i]);
+    }
+}
+
+TEST(non_trivial_elements_are_sorted)
+{
+    Vector<String> strings;
+
+    for (int i = 0; i < 200; i++)
+    {
+        char buffer[16];
+        snprintf(buffer, 16, "%05d", rand() % 100000);
+        strings.push_back(buffer);
+    }
+
+    auto compare = [](auto &left, auto &right) { return strcmp(left.cstring(), right.cstring()); };
+
+    auto stable = strings;
+
+    strings.sort(compare);
+    stable.stable_sort(compare);
+
+    for (size_t i = 1; i < strings.count(); i++)
+    {
+        assert(strcmp(strings[i - 1].cstring(), strings[i].cstring()) <= 0);
+        assert(strings[i] == stable[i]);
+    }
+}
+
+int main(int, char const *[])
+{
+    empty_and_single_element_vectors_can_be_sorted();
+    random_values_are_sorted();
+    sorted_and_reversed_values_are_sorted();
+    stable_sort_keeps_the_order_of_equal_elements();
+    partial_sort_puts_the_smallest_elements_first();
+    non_trivial_elements_are_sorted();
+
+    return 0;
+}
@@ -1,7 +1,10 @@
 #include <stdio.h>
 
 #include <libsystem/Assert.h>
+#include <libutils/Atom.h>
 #include <libutils/String.h>
+#include <libutils/StringBuilder.h>
+#include <libutils/StringView.h>
 
 int main(int, char const *[])
 {
@@ -25,5 +28,61 @@ int main(int, char const *[])
     assert(first == "second");
     assert(second == "first");
 
+    String inline_string = "abcdefghijklmnopqrstuvw";
+    String heap_string = "abcdefghijklmnopqrstuvwx";
+
+    assert(inline_string.length() == String::INLINE_CAPACITY);
+    assert(heap_string.length() == String::INLINE_CAPACITY + 1);
+    assert(inline_string != heap_string);
+
+    String heap_copy = heap_string;
+    assert(heap_copy == heap_string);
+    assert(heap_copy.cstring() == heap_string.cstring());
+
+    String moved = move(heap_copy);
+    assert(moved == "abcdefghijklmnopqrstuvwx");
+    assert(heap_copy.null_or_empty());
+
+    inline_string += heap_string;
+    assert(inline_string.length() == 47);
+    assert(inline_string == "abcdefghijklmnopqrstuvwabcdefghijklmnopqrstuvwx");
+
+    StringBuilder short_builder{};
+    short_builder.append("short");
+    assert(short_builder.finalize() == "short");
+
+    StringBuilder long_builder{};
+    for (int i = 0; i < 10; i++)
+    {
+        long_builder.append("0123456789");
+    }
+    auto long_string = long_builder.finalize();
+    assert(long_string.length() == 100);
+    assert(long_string[99] == '9');
+
+    StringView view{"hello, world", 5};
+    assert(view == "hello");
+    assert(view.substring(1, 100) == "ello");
+    assert(String{view} == "hello");
+    assert(hash<StringView>(view) == hash<String>("hello"));
+
+    Atom atom = "accent";
+    Atom same_atom = String{"accent"};
+    Atom other_atom = "accent-inactive";
+
+    assert(atom == same_atom);
+    assert(atom.cstring() == same_atom.cstring());
+    assert(atom != other_atom);
+    assert(atom == "accent");
+    assert(atom.string() == "accent");
+
+    Atom empty_atom;
+    Atom found;
+
+    assert(empty_atom == Atom{""});
+    assert(empty_atom == "");
+    assert(empty_atom.length() == 0);
+    assert(Atom::lookup("", &found) && found == empty_atom);
+
     return 0;
 }
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/Assert.h>
+#include <libwidget/model/TableModel.h>
+
+#define TEST(__func) void __func()
+
+struct Row
+{
+    int key;
+    int value;
+};
+
+class TestModel : public TableModel
+{
+public:
+    Vector<Row> rows_{};
+
+    int rows() override { return rows_.count(); }
+
+    void replace(Vector<Row> rows)
+    {
+        did_diff_rows(
+            rows_.count(), rows.count(),
+            [&](int old_row, int new_row) {
+                int left = rows_[old_row].key;
+                int right = rows[new_row].key;
+
+                return (left > right) - (left < right);
+            },
+            [&](int old_row, int new_row) {
+                return rows_[old_row].value == rows[new_row].value;
+            });
+
+        rows_ = rows;
+    }
+
+    void replace_and_reset(Vector<Row> rows)
+    {
+        rows_ = rows;
+    }
+};
+
+// What a table does with the changes: replay them on its own copy.
+static void apply(Vector<Row> &mirror, TestModel &model)
+{
+    for (size_t i = 0; i < model.changes().count(); i++)
+    {
+        auto &change = model.changes()[i];
+
+        switch (change.type)
+        {
+        case TableModelChange::INSERTED:
+            for (int j = 0; j < change.count; j++)
+            {
+                mirror.insert(change.row + j, model.rows_[change.row + j]);
+            }
+            break;
+
+        case TableModelChange::REMOVED:
+            for (int j = 0; j < change.count; j++)
+            {
+                mirror.remove_index(change.row);
+            }
+            break;
+
+        case TableModelChange::CHANGED:
+            for (int j = 0; j < change.count; j++)
+            {
+                mirror[change.row + j] = model.rows_[change.row + j];
+            }
+            break;
+        }
+    }
+}
+
+static bool same_rows(Vector<Row> &left, Vector<Row> &right)
+{
+    if (left.count() != right.count())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < left.count(); i++)
+    {
+        if (left[i].key != right[i].key || left[i].value != right[i].value)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TEST(diff_reports_minimal_changes)
+{
+    auto model = make<TestModel>();
+    model->replace({{1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}});
+    model->did_update();
+
+    Vector<Row> mirror = model->rows_;
+
+    size_t notified = 0;
+    auto observer = model->observe([&](TableModel &subject) {
+        assert(!subject.everything_changed());
+        assert(subject.changes().count() == 3);
+
+        auto &removed = subject.changes()[0];
+        assert(removed.type == TableModelChange::REMOVED && removed.row == 1 && removed.count == 2);
+
+        auto &changed = subject.changes()[1];
+        assert(changed.type == TableModelChange::CHANGED && changed.row == 2 && changed.count == 1);
+
+        auto &inserted = subject.changes()[2];
+        assert(inserted.type == TableModelChange::INSERTED && inserted.row == 3 && inserted.count == 2);
+
+        apply(mirror, static_cast<TestModel &>(subject));
+        notified++;
+    });
+
+    model->replace({{1, 0}, {4, 0}, {5, 1}, {6, 0}, {7, 0}});
+    model->did_update();
+
+    assert(notified == 1);
+    assert(same_rows(mirror, model->rows_));
+
+    // Changes are dropped once observers were notified.
+    assert(model->changes().count() == 0);
+    assert(model->everything_changed());
+}
+
+TEST(diff_survives_random_edits)
+{
+    srand(42);
+
+    auto model = make<TestModel>();
+    Vector<Row> mirror{};
+
+    for (int round = 0; round < 200; round++)
+    {
+        Vector<Row> rows{};
+
+        for (int key = 0; key < 64; key++)
+        {
+            if (rand() % 3)
+            {
+                rows.push_back({key, rand() % 4});
+            }
+        }
+
+        // Shuffle a few rows, diffing must stay correct out of order.
+        if (round % 5 == 0 && rows.count() > 2)
+        {
+            swap(rows[0], rows[rows.count() - 1]);
+        }
+
+        model->replace(rows);
+        apply(mirror, *model);
+        model->did_update();
+
+        assert(same_rows(mirror, model->rows_));
+    }
+}
+
+TEST(models_without_changes_are_reset)
+{
+    auto model = make<TestModel>();
+
+    bool reset = false;
+    auto observer = model->observe([&](TableModel &subject) {
+        reset = subject.everything_changed();
+    });
+
+    model->replace_and_reset({{1, 1}});
+    model->did_update();
+
+    assert(reset);
+}
+
+int main(int, char const *[])
+{
+    diff_reports_minimal_changes();
+    diff_survives_random_edits();
+    models_without_changes_are_reset();
+
+    return 0;
+}
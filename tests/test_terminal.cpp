@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libsystem/Assert.h>
+#include <libterminal/Terminal.h>
+
+#define TEST(__func) void __func()
+
+static void write(terminal::Terminal &terminal, const char *str)
+{
+    terminal.write(str, strlen(str));
+}
+
+TEST(lines_are_scrolled_up_when_the_screen_is_full)
+{
+    terminal::Terminal terminal{8, 3};
+
+    write(terminal, "a\nb\nc\nd");
+
+    assert(terminal.cell_at(0, 0).codepoint == U'b');
+    assert(terminal.cell_at(0, 1).codepoint == U'c');
+    assert(terminal.cell_at(0, 2).codepoint == U'd');
+}
+
+TEST(scrolled_lines_are_kept_in_the_scrollback)
+{
+    terminal::Terminal terminal{8, 2};
+
+    write(terminal, "hello\n\e[31mworld\e[0m!\nfoo\nbar");
+
+    assert(terminal.scrollback().count() == 2);
+
+    terminal::Cell cells[8];
+
+    terminal.scrollback().line(0, cells, 8);
+    assert(cells[0].codepoint == U'h');
+    assert(cells[4].codepoint == U'o');
+    assert(cells[7].codepoint == U' ');
+
+    terminal.scrollback().line(1, cells, 8);
+    assert(cells[0].codepoint == U'w');
+    assert(cells[0].attributes.foreground == terminal::RED);
+    assert(cells[5].codepoint == U'!');
+    assert(cells[5].attributes == terminal::Attributes::defaults());
+}
+
+TEST(scrollback_is_bounded)
+{
+    terminal::Terminal terminal{8, 2, 4};
+
+    for (int i = 0; i < 16; i++)
+    {
+        char line[] = {(char)('a' + i), '\n', '\0'};
+        write(terminal, line);
+    }
+
+    assert(terminal.scrollback().count() == 4);
+
+    terminal::Cell cells[8];
+    terminal.scrollback().line(3, cells, 8);
+    assert(cells[0].codepoint == U'o');
+
+    terminal.scrollback().resize(2);
+    assert(terminal.scrollback().count() == 2);
+
+    terminal.scrollback().line(1, cells, 8);
+    assert(cells[0].codepoint == U'o');
+}
+
+TEST(only_modified_lines_are_dirty)
+{
+    terminal::Terminal terminal{8, 4};
+
+    for (int y = 0; y < terminal.height(); y++)
+    {
+        terminal.line_undirty(y);
+    }
+
+    write(terminal, "\n\nx");
+
+    assert(!terminal.line_dirty(0));
+    assert(!terminal.line_dirty(1));
+    assert(terminal.line_dirty(2));
+    assert(!terminal.line_dirty(3));
+
+    write(terminal, "yz");
+
+    assert(terminal.line_damage(2).from == 0);
+    assert(terminal.line_damage(2).to == 3);
+}
+
+TEST(bulk_and_byte_per_byte_writes_are_the_same)
+{
+    const char *text =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit\n"
+        "\e[1;32mbold green\e[0m \t tab\r\nhéllo wörld ✓ \x7f\b!\n"
+        "A very long line which is going to wrap around the edge of the screen, "
+        "multiple times since the screen is very narrow.\e[2A\e[4Cmoved\n";
+
+    terminal::Terminal bulk{16, 6};
+    terminal::Terminal bytes{16, 6};
+
+    write(bulk, text);
+
+    for (size_t i = 0; i < strlen(text); i++)
+    {
+        bytes.write(text[i]);
+    }
+
+    for (int y = 0; y < 6; y++)
+    {
+        for (int x = 0; x < 16; x++)
+        {
+            assert(bulk.cell_at(x, y) == bytes.cell_at(x, y));
+        }
+    }
+
+    assert(bulk.cursor().x == bytes.cursor().x);
+    assert(bulk.cursor().y == bytes.cursor().y);
+    assert(bulk.scrollback().count() == bytes.scrollback().count());
+}
+
+TEST(invalid_codepoints_are_replaced_in_the_scrollback)
+{
+    terminal::Terminal terminal{8, 2};
+
+    // 0xf7 decodes to a codepoint above U+10FFFF.
+    write(terminal, "\xf7\xbf\xbf\xbf"
+                    "ab\nc\nd\n");
+
+    assert(terminal.scrollback().count() == 2);
+
+    terminal::Cell cells[8];
+    terminal.scrollback().line(0, cells, 8);
+
+    assert(cells[0].codepoint == 0xFFFD);
+    assert(cells[1].codepoint == U'a');
+    assert(cells[2].codepoint == U'b');
+    assert(cells[3].codepoint == U' ');
+}
+
+int main(int, char const *[])
+{
+    lines_are_scrolled_up_when_the_screen_is_full();
+    scrolled_lines_are_kept_in_the_scrollback();
+    scrollback_is_bounded();
+    only_modified_lines_are_dirty();
+    bulk_and_byte_per_byte_writes_are_the_same();
+    invalid_codepoints_are_replaced_in_the_scrollback();
+
+    return 0;
+}
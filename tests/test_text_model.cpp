@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+#include <libutils/IntervalTree.h>
+#include <libutils/PieceTable.h>
+#include <libwidget/model/TextModel.h>
+
+#define TEST(__func) void __func()
+
+static char *duplicate(const char *text)
+{
+    char *buffer = (char *)malloc(strlen(text));
+    memcpy(buffer, text, strlen(text));
+    return buffer;
+}
+
+static bool piece_table_equals(const PieceTable &table, const char *expected)
+{
+    if (table.length() != strlen(expected))
+    {
+        return false;
+    }
+
+    char buffer[256] = {};
+    table.copy(0, table.length(), buffer);
+
+    return strcmp(buffer, expected) == 0;
+}
+
+TEST(piece_table_insert_and_remove)
+{
+    PieceTable table{duplicate("hello world"), 11};
+
+    table.insert(5, ",");
+    table.insert(12, "!");
+    table.insert(0, ">> ");
+    assert(piece_table_equals(table, ">> hello, world!"));
+
+    table.remove(0, 3);
+    table.remove(5, 7);
+    assert(piece_table_equals(table, "hello!"));
+
+    table.remove(0, table.length());
+    assert(piece_table_equals(table, ""));
+    assert(table.piece_count() == 0);
+}
+
+TEST(piece_table_typing_grows_one_piece)
+{
+    PieceTable table{duplicate("ac"), 2};
+
+    table.insert(1, "b");
+    size_t pieces = table.piece_count();
+
+    table.insert(2, "b");
+    table.insert(3, "b");
+    assert(table.piece_count() == pieces);
+    assert(piece_table_equals(table, "abbbc"));
+}
+
+TEST(interval_tree_containing)
+{
+    IntervalTree<int, char> tree{};
+
+    tree.add(0, 10, 'a');
+    tree.add(5, 15, 'b');
+    tree.add(20, 30, 'c');
+    tree.add(6, 7, 'd');
+
+    char found[8] = {};
+    size_t count = 0;
+
+    tree.containing(6, [&](int, int, char value) {
+        found[count++] = value;
+        return Iteration::CONTINUE;
+    });
+
+    assert(count == 3);
+    assert(strcmp(found, "abd") == 0);
+
+    count = 0;
+    tree.containing(15, [&](int, int, char) {
+        count++;
+        return Iteration::CONTINUE;
+    });
+
+    assert(count == 0);
+
+    tree.clear();
+    assert(tree.containing(6, [](int, int, char) { return Iteration::STOP; }) == Iteration::CONTINUE);
+}
+
+TEST(model_lines_from_buffer)
+{
+    auto model = TextModel::from_buffer(duplicate("\xEF\xBB\xBFone\ntwo\n\nfour"), 16);
+
+    assert(model->line_count() == 4);
+    assert(model->line(0).length() == 3);
+    assert(model->line(1)[2] == U'o');
+    assert(model->line(2).length() == 0);
+    assert(model->line(3)[0] == U'f');
+    assert(model->string() == "one\ntwo\n\nfour");
+}
+
+TEST(model_utf8_columns)
+{
+    auto model = TextModel::from_buffer(duplicate("h\xC3\xA9llo w\xE2\x82\xACrld"), 14);
+    auto line = model->line(0);
+
+    assert(line.length() == 11);
+    assert(line[1] == U'é');
+    assert(line[7] == U'€');
+    assert(line[10] == U'd');
+    assert(line[0] == U'h');
+
+    TextCursor cursor{};
+    cursor.move_to_within(model->line(0), 2);
+    model->backspace_at(cursor);
+    model->append_at(cursor, U'ö');
+
+    assert(model->string() == "h\xC3\xB6llo w\xE2\x82\xACrld");
+}
+
+TEST(model_editing_across_lines)
+{
+    auto model = TextModel::empty();
+    TextCursor cursor{};
+
+    model->append_at(cursor, U'a');
+    model->append_at(cursor, U'b');
+    model->newline_at(cursor);
+    model->append_at(cursor, U'c');
+
+    assert(model->line_count() == 2);
+    assert(model->string() == "ab\nc");
+    assert(cursor.line() == 1 && cursor.column() == 1);
+
+    cursor.move_to_beginning_of_the_line();
+    model->backspace_at(cursor);
+
+    assert(model->line_count() == 1);
+    assert(model->string() == "abc");
+    assert(cursor.line() == 0 && cursor.column() == 2);
+
+    model->newline_at(cursor);
+    cursor.move_up_within(*model);
+    cursor.move_end_within(model->line(0));
+    model->delete_at(cursor);
+
+    assert(model->string() == "abc");
+
+    cursor.move_home_within(model->line(0));
+    model->delete_at(cursor);
+
+    assert(model->string() == "bc");
+}
+
+TEST(model_move_lines)
+{
+    auto model = TextModel::from_buffer(duplicate("1\n22\n333"), 8);
+    TextCursor cursor{};
+
+    model->move_line_down_at(cursor);
+    assert(model->string() == "22\n1\n333");
+    assert(cursor.line() == 1);
+
+    model->move_line_down_at(cursor);
+    assert(model->string() == "22\n333\n1");
+    assert(cursor.line() == 2);
+
+    model->move_line_down_at(cursor);
+    assert(model->string() == "22\n333\n1");
+
+    model->move_line_up_at(cursor);
+    model->move_line_up_at(cursor);
+    assert(model->string() == "1\n22\n333");
+    assert(model->line(2).length() == 3);
+}
+
+TEST(model_spans)
+{
+    auto model = TextModel::from_buffer(duplicate("int main()"), 10);
+
+    model->span_add(TextModelSpan(0, 0, 3, THEME_ANSI_BLUE, THEME_BACKGROUND));
+    model->span_add(TextModelSpan(0, 4, 10, THEME_ANSI_RED, THEME_BACKGROUND));
+    model->span_add(TextModelSpan(0, 8, 10, THEME_ANSI_GREEN, THEME_BACKGROUND));
+
+    assert(model->span_at(0, 1).foreground() == THEME_ANSI_BLUE);
+    assert(model->span_at(0, 3).foreground() == THEME_FOREGROUND);
+    assert(model->span_at(0, 5).foreground() == THEME_ANSI_RED);
+    assert(model->span_at(0, 9).foreground() == THEME_ANSI_GREEN);
+    assert(model->span_at(1, 1).foreground() == THEME_FOREGROUND);
+
+    model->span_clear();
+    assert(model->span_at(0, 1).foreground() == THEME_FOREGROUND);
+}
+
+int main(int, char const *[])
+{
+    piece_table_insert_and_remove();
+    piece_table_typing_grows_one_piece();
+    interval_tree_containing();
+    model_lines_from_buffer();
+    model_utf8_columns();
+    model_editing_across_lines();
+    model_move_lines();
+    model_spans();
+
+    return 0;
+}
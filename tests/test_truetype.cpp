@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libgraphic/font/GlyphCache.h>
+#include <libsystem/Assert.h>
+
+#define TEST(__func) void __func()
+
+static RefPtr<graphic::TrueType> load_roboto()
+{
+    FILE *file = fopen("../sysroot/Files/Fonts/Roboto/Roboto-Regular.ttf", "rb");
+    assert(file);
+
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *buffer = (uint8_t *)malloc(size);
+    assert(fread(buffer, 1, size, file) == size);
+    fclose(file);
+
+    auto font_or_error = graphic::TrueType::parse(Vector(ADOPT, buffer, size));
+    assert(font_or_error.success());
+
+    return font_or_error.take_value();
+}
+
+static int coverage_sum(graphic::GlyphCache &cache, Recti bound)
+{
+    int sum = 0;
+
+    for (int y = bound.top(); y < bound.bottom(); y++)
+    {
+        for (int x = bound.left(); x < bound.right(); x++)
+        {
+            sum += cache.coverage()[y * cache.width() + x];
+        }
+    }
+
+    return sum;
+}
+
+TEST(metrics_are_read)
+{
+    auto font = load_roboto();
+
+    assert(font->units_per_em() == 2048);
+    assert(font->ascent() == 1900);
+    assert(font->descent() == -500);
+    assert(font->glyph_count() == 1294);
+}
+
+TEST(codepoints_are_mapped)
+{
+    auto font = load_roboto();
+
+    assert(font->glyph_index(U'A') == 37);
+    assert(font->glyph_index(U'H') == 44);
+    assert(font->glyph_index(U'é') != 0);
+
+    // Not in the font.
+    assert(font->glyph_index(U'\U0001F600') == 0);
+}
+
+TEST(outlines_are_read)
+{
+    auto font = load_roboto();
+
+    int a = font->glyph_index(U'A');
+    assert(font->advance(a) == 1336);
+    Recti bound = font->glyph_bound(a);
+    assert(bound.position() == Vec2i(28, 0));
+    assert(bound.size() == Vec2i(1281, 1456));
+    assert(font->glyph_path(a).subpath_count() == 2);
+
+    assert(font->glyph_path(font->glyph_index(U'H')).subpath_count() == 1);
+
+    // The e and its accent.
+    assert(font->glyph_path(font->glyph_index(U'é')).subpath_count() == 3);
+
+    int space = font->glyph_index(U' ');
+    assert(font->advance(space) > 0);
+    assert(font->glyph_bound(space).is_empty());
+    assert(font->glyph_path(space).subpath_count() == 0);
+}
+
+TEST(garbage_is_rejected)
+{
+    uint8_t *buffer = (uint8_t *)calloc(64, 1);
+    buffer[1] = 1;
+
+    auto font_or_error = graphic::TrueType::parse(Vector(ADOPT, buffer, (size_t)64));
+    assert(!font_or_error.success());
+}
+
+TEST(glyphs_are_rasterized_once)
+{
+    auto font = load_roboto();
+    graphic::GlyphCache cache{GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT};
+
+    int h = font->glyph_index(U'H');
+
+    Glyph glyph = cache.lookup(*font, 32, h);
+
+    // 1456 units at 32 pixels per 2048 units.
+    assert(glyph.bound.height() == 23);
+    assert(glyph.origin.y() == 23);
+    assert(glyph.advance == 23);
+    assert(cache.misses() == 1);
+
+    // Somewhere in the left stem.
+    Vec2i stem = glyph.bound.position() + Vec2i(glyph.origin.x() + 4, 10);
+    assert(cache.coverage()[stem.y() * cache.width() + stem.x()] == 255);
+
+    Glyph again = cache.lookup(*font, 32, h);
+    assert(again.bound.position() == glyph.bound.position());
+    assert(cache.hits() == 1);
+    assert(cache.misses() == 1);
+
+    Glyph smaller = cache.lookup(*font, 16, h);
+    assert(smaller.bound.height() == 12);
+    assert(!smaller.bound.colide_with(glyph.bound));
+    assert(cache.misses() == 2);
+
+    Glyph space = cache.lookup(*font, 32, font->glyph_index(U' '));
+    assert(space.bound.is_empty());
+    assert(space.advance == 8);
+}
+
+TEST(least_recently_used_shelves_are_evicted)
+{
+    auto font = load_roboto();
+
+    // Room for two shelves of 24px glyphs.
+    graphic::GlyphCache cache{64, 48};
+    graphic::GlyphCache reference{GLYPH_CACHE_WIDTH, GLYPH_CACHE_HEIGHT};
+
+    int h = font->glyph_index(U'H');
+    cache.lookup(*font, 32, h);
+
+    const char32_t letters[] = U"ABCDEFGIJKLMN";
+
+    for (int i = 0; letters[i]; i++)
+    {
+        int index = font->glyph_index(letters[i]);
+
+        Glyph glyph = cache.lookup(*font, 32, index);
+        Glyph expected = reference.lookup(*font, 32, index);
+
+        assert(glyph.bound.size() == expected.bound.size());
+        assert(coverage_sum(cache, glyph.bound) == coverage_sum(reference, expected.bound));
+
+        // Keep the H around.
+        cache.lookup(*font, 32, h);
+    }
+
+    assert(cache.evictions() > 0);
+
+    size_t misses = cache.misses();
+    cache.lookup(*font, 32, h);
+    assert(cache.misses() == misses);
+}
+
+int main(int, char const *[])
+{
+    metrics_are_read();
+    codepoints_are_mapped();
+    outlines_are_read();
+    garbage_is_rejected();
+    glyphs_are_rasterized_once();
+    least_recently_used_shelves_are_evicted();
+
+    return 0;
+}
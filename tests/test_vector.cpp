@@ -0,0 +1,177 @@
+#include <stdio.h>
+
+#include <libsystem/Assert.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#define TEST(__func) void __func()
+
+// Not relocatable on purpose, it keeps a pointer to itself.
+struct Tracked
+{
+    static inline int alive = 0;
+
+    Tracked *self;
+    int value;
+
+    Tracked(int value) : self(this), value(value) { alive++; }
+
+    Tracked(const Tracked &other) : self(this), value(other.value) { alive++; }
+
+    Tracked(Tracked &&other) : self(this), value(other.value) { alive++; }
+
+    Tracked &operator=(const Tracked &other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    ~Tracked()
+    {
+        assert(self == this);
+        alive--;
+    }
+};
+
+static_assert(IsTriviallyRelocatable<int>::value);
+static_assert(IsTriviallyRelocatable<String>::value);
+static_assert(IsTriviallyRelocatable<Vector<String>>::value);
+static_assert(!IsTriviallyRelocatable<Tracked>::value);
+
+TEST(empty_vector_does_not_allocate)
+{
+    Vector<int> vector{};
+
+    assert(vector.capacity() == 0);
+    assert(vector.raw_storage() == nullptr);
+
+    Vector<int> copy = vector;
+    assert(copy.empty());
+}
+
+TEST(growth_and_reserve)
+{
+    Vector<int> vector{};
+
+    size_t reallocations = 0;
+    size_t capacity = 0;
+
+    for (int i = 0; i < 100000; i++)
+    {
+        vector.push_back(i);
+
+        if (vector.capacity() != capacity)
+        {
+            capacity = vector.capacity();
+            reallocations++;
+        }
+    }
+
+    assert(reallocations < 30);
+
+    for (int i = 0; i < 100000; i++)
+    {
+        assert(vector[i] == i);
+    }
+
+    Vector<int> reserved{};
+    reserved.reserve(1000);
+    assert(reserved.capacity() == 1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        reserved.push_back(i);
+    }
+
+    assert(reserved.capacity() == 1000);
+
+    while (reserved.count() > 10)
+    {
+        reserved.pop_back();
+    }
+
+    reserved.shrink_to_fit();
+    assert(reserved.capacity() == 10);
+    assert(reserved[9] == 9);
+
+    reserved.clear();
+    reserved.shrink_to_fit();
+    assert(reserved.capacity() == 0);
+}
+
+TEST(push_back_an_item_of_the_same_vector)
+{
+    Vector<String> strings{};
+    strings.push_back("a string long enough to be on the heap");
+
+    for (int i = 0; i < 100; i++)
+    {
+        strings.push_back(strings[0]);
+        strings.emplace_back(strings[i]);
+    }
+
+    assert(strings.count() == 201);
+    assert(strings[200] == "a string long enough to be on the heap");
+}
+
+TEST(insert_remove_and_emplace)
+{
+    Vector<String> strings{"b", "d"};
+
+    strings.insert(0, "a");
+    strings.insert(2, "c");
+    strings.emplace_at(4, "e");
+    strings.emplace("0");
+
+    assert(strings.count() == 6);
+    assert(strings[0] == "0");
+    assert(strings[1] == "a");
+    assert(strings[3] == "c");
+    assert(strings[5] == "e");
+
+    strings.remove_index(0);
+    strings.remove_value("c");
+
+    assert(strings.count() == 4);
+    assert(strings[2] == "d");
+}
+
+TEST(non_relocatable_items_are_moved_one_by_one)
+{
+    {
+        Vector<Tracked> items{};
+
+        for (int i = 0; i < 1000; i++)
+        {
+            items.emplace_back(i);
+        }
+
+        items.insert(0, Tracked{-1});
+        items.emplace_at(500, -2);
+
+        assert(items[0].value == -1);
+        assert(items[500].value == -2);
+        assert(items[1001].value == 999);
+
+        while (items.count() > 1)
+        {
+            items.remove_index(items.count() / 2);
+        }
+
+        assert(items[0].value == -1);
+        assert(Tracked::alive == 1);
+    }
+
+    assert(Tracked::alive == 0);
+}
+
+int main(int, char const *[])
+{
+    empty_vector_does_not_allocate();
+    growth_and_reserve();
+    push_back_an_item_of_the_same_vector();
+    insert_remove_and_emplace();
+    non_relocatable_items_are_moved_one_by_one();
+
+    return 0;
+}
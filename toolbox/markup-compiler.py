@@ -0,0 +1,324 @@
+#!/usr/bin/python3
+
+# Compile a libwidget .markup file to the binary form described in
+# libraries/libwidget/CompiledMarkup.h.
+
+import json
+import re
+import struct
+import sys
+
+MAGIC = b"MKUP"
+VERSION = 1
+
+NO_STRING = 0xffffffff
+
+WIDGETS = {
+    "Window": 1,
+    "Container": 2,
+    "Panel": 3,
+    "Button": 4,
+    "Label": 5,
+    "Image": 6,
+    "Slider": 7,
+}
+
+LAYOUTS = {
+    "stack": 0,
+    "grid": 1,
+    "vgrid": 2,
+    "hgrid": 3,
+    "vflow": 4,
+    "hflow": 5,
+}
+
+ANCHORS = {
+    "left": 0,
+    "center": 1,
+    "right": 2,
+    "top_left": 3,
+    "top_center": 4,
+    "top_right": 5,
+    "bottom_left": 6,
+    "bottom_center": 7,
+    "bottom_right": 8,
+}
+
+FLAGS = {
+    "fill": 1 << 2,
+    "rounded": 1 << 3,
+    "filled": 1 << 4,
+    "outlined": 1 << 5,
+    "borderless": 1 << 6,
+    "resizable": 1 << 7,
+    "always-focused": 1 << 8,
+    "swallow": 1 << 9,
+    "transparent": 1 << 10,
+}
+
+HAS_LAYOUT = 1 << 0
+HAS_INSETS = 1 << 1
+
+
+class Node:
+    def __init__(self, name):
+        self.name = name
+        self.attributes = {}
+        self.childs = []
+
+
+class Parser:
+    def __init__(self, text):
+        self.text = text
+        self.offset = 0
+
+        if self.text.startswith("\ufeff"):
+            self.offset = 1
+
+    def error(self, message):
+        line = self.text.count("\n", 0, self.offset) + 1
+        raise SyntaxError(f"line {line}: {message}")
+
+    def current(self):
+        return self.text[self.offset] if self.offset < len(self.text) else ""
+
+    def whitespace(self):
+        while self.current() and self.current() in " \n\r\t":
+            self.offset += 1
+
+    def skip(self, what):
+        if self.text.startswith(what, self.offset):
+            self.offset += len(what)
+            return True
+        return False
+
+    def expect(self, what):
+        if not self.skip(what):
+            self.error(f"expected '{what}'")
+
+    def identifier(self):
+        match = re.compile(r"[A-Za-z\-]*").match(self.text, self.offset)
+        self.offset = match.end()
+        return match.group(0)
+
+    def string(self):
+        self.expect('"')
+
+        start = self.offset
+
+        while self.current() and self.current() != '"':
+            if self.current() == "\\":
+                self.offset += 1
+            self.offset += 1
+
+        raw = self.text[start:self.offset]
+        self.expect('"')
+
+        return json.loads('"' + raw + '"')
+
+    def node(self):
+        self.whitespace()
+        self.expect("<")
+        self.whitespace()
+
+        node = Node(self.identifier())
+
+        self.whitespace()
+
+        while self.current().isalpha():
+            name = self.identifier()
+            self.whitespace()
+
+            if self.skip("="):
+                self.whitespace()
+                node.attributes[name] = self.string()
+            else:
+                node.attributes[name] = ""
+
+            self.whitespace()
+
+        if self.skip("/"):
+            self.expect(">")
+            return node
+
+        self.expect(">")
+        self.whitespace()
+
+        while self.text.startswith("<", self.offset) and not self.text.startswith("</", self.offset):
+            node.childs.append(self.node())
+            self.whitespace()
+
+        self.expect("</")
+        self.whitespace()
+
+        closing = self.identifier()
+
+        if closing != node.name:
+            self.error(f"opening tag <{node.name}> doesn't match closing tag </{closing}>")
+
+        self.whitespace()
+        self.expect(">")
+
+        return node
+
+
+def parse_arguments(value, name):
+    match = re.fullmatch(r"\s*" + name + r"\s*\(([^)]*)\)?\s*", value)
+
+    if not match:
+        return None
+
+    return [int(argument) for argument in match.group(1).split(",") if argument.strip()]
+
+
+def parse_layout(value):
+    for name in ["vgrid", "hgrid", "vflow", "hflow", "grid", "stack"]:
+        arguments = parse_arguments(value, name)
+
+        if arguments is None:
+            continue
+
+        arguments += [0] * (4 - len(arguments))
+
+        if name == "grid":
+            return LAYOUTS[name], arguments[0:2], arguments[2:4]
+        elif name in ["vgrid", "vflow"]:
+            return LAYOUTS[name], [0, 0], [0, arguments[0]]
+        elif name in ["hgrid", "hflow"]:
+            return LAYOUTS[name], [0, 0], [arguments[0], 0]
+        else:
+            return LAYOUTS[name], [0, 0], [0, 0]
+
+    raise SyntaxError(f"invalid layout '{value}'")
+
+
+def parse_insets(value):
+    arguments = parse_arguments(value, "insets")
+
+    if arguments is None or len(arguments) > 4:
+        raise SyntaxError(f"invalid insets '{value}'")
+
+    if len(arguments) == 0:
+        return [0, 0, 0, 0]
+    elif len(arguments) == 1:
+        return arguments * 4
+    elif len(arguments) == 2:
+        return [arguments[0], arguments[0], arguments[1], arguments[1]]
+    elif len(arguments) == 3:
+        return [arguments[0], arguments[1], arguments[2], arguments[2]]
+    else:
+        return arguments
+
+
+class Compiler:
+    def __init__(self):
+        self.nodes = b""
+        self.count = 0
+        self.strings = b""
+        self.interned = {}
+
+    def string(self, value):
+        if value is None:
+            return struct.pack("<II", NO_STRING, 0)
+
+        encoded = value.encode("utf-8")
+
+        if encoded not in self.interned:
+            self.interned[encoded] = len(self.strings)
+            self.strings += encoded
+
+        return struct.pack("<II", self.interned[encoded], len(encoded))
+
+    def node(self, node):
+        attributes = node.attributes
+
+        flags = 0
+
+        for name, flag in FLAGS.items():
+            if name in attributes:
+                flags |= flag
+
+        layout, cells, spacing = 0, [0, 0], [0, 0]
+
+        if "layout" in attributes:
+            flags |= HAS_LAYOUT
+            layout, cells, spacing = parse_layout(attributes["layout"])
+
+        insets = [0, 0, 0, 0]
+
+        if "padding" in attributes:
+            flags |= HAS_INSETS
+            insets = parse_insets(attributes["padding"])
+
+        anchor = ANCHORS.get(attributes.get("anchor", "left"), 0)
+
+        width = int(attributes.get("width", "250"))
+        height = int(attributes.get("height", "250"))
+
+        text = attributes.get("title" if node.name == "Window" else "text")
+
+        self.nodes += struct.pack(
+            "<HHIBBH2h2h4hhh",
+            WIDGETS.get(node.name, 0),
+            flags,
+            len(node.childs),
+            layout,
+            anchor,
+            0,
+            *cells,
+            *spacing,
+            *insets,
+            width,
+            height)
+
+        self.nodes += self.string(node.name)
+        self.nodes += self.string(attributes.get("id"))
+        self.nodes += self.string(text)
+        self.nodes += self.string(attributes.get("icon"))
+        self.nodes += self.string(attributes.get("path"))
+
+        self.count += 1
+
+        for child in node.childs:
+            self.node(child)
+
+    def finalize(self):
+        header_size = 20
+        strings_offset = header_size + len(self.nodes)
+
+        header = struct.pack(
+            "<4sIIII",
+            MAGIC,
+            VERSION,
+            self.count,
+            strings_offset,
+            len(self.strings))
+
+        return header + self.nodes + self.strings
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"usage: {sys.argv[0]} INPUT OUTPUT")
+        sys.exit(1)
+
+    in_filename = sys.argv[1]
+    out_filename = sys.argv[2]
+
+    with open(in_filename, "r", encoding="utf-8") as infp:
+        text = infp.read()
+
+    try:
+        root = Parser(text).node()
+    except SyntaxError as error:
+        print(f"{in_filename}: {error}")
+        sys.exit(1)
+
+    compiler = Compiler()
+    compiler.node(root)
+
+    with open(out_filename, "wb") as outfp:
+        outfp.write(compiler.finalize())
+
+
+main()